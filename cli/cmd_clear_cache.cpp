@@ -0,0 +1,96 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "cli/cmd_clear_cache.hpp"
+
+#include <cstdlib>
+
+#include "cli/common.ipp"
+#include "store/exceptions.hpp"
+#include "store/layout.hpp"
+#include "store/list_cache.hpp"
+#include "store/result_cache.hpp"
+#include "utils/cmdline/ui.hpp"
+#include "utils/defs.hpp"
+#include "utils/format/macros.hpp"
+#include "utils/fs/operations.hpp"
+#include "utils/fs/path.hpp"
+
+namespace cmdline = utils::cmdline;
+namespace config = utils::config;
+namespace fs = utils::fs;
+namespace layout = store::layout;
+
+using cli::cmd_clear_cache;
+
+
+/// Default constructor for cmd_clear_cache.
+cmd_clear_cache::cmd_clear_cache(void) : cli_command(
+    "clear-cache", "", 0, 0,
+    "Forgets the results of the tests recorded by 'test --cache' so that "
+    "they run again, and the cached test cases lists of all test programs")
+{
+}
+
+
+/// Entry point for the "clear-cache" subcommand.
+///
+/// \param ui Object to interact with the I/O of the program.
+/// \param unused_cmdline Representation of the command line to the subcommand.
+/// \param unused_user_config The runtime configuration of the program.
+///
+/// \return 0 if everything is OK, 1 if the cache cannot be cleared.
+int
+cmd_clear_cache::run(cmdline::ui* ui,
+                     const cmdline::parsed_cmdline& UTILS_UNUSED_PARAM(cmdline),
+                     const config::tree& UTILS_UNUSED_PARAM(user_config))
+{
+    const fs::path cache_file = layout::query_cache_db();
+    if (!fs::exists(cache_file)) {
+        ui->out("Removed 0 cached results");
+        ui->out("Removed 0 cached test cases lists");
+        return EXIT_SUCCESS;
+    }
+
+    try {
+        store::result_cache cache = store::result_cache::open_rw(cache_file);
+        const int64_t count = cache.clear();
+        cache.close();
+        ui->out(F("Removed %s cached results") % count);
+
+        store::list_cache lists = store::list_cache::open_rw(cache_file);
+        const int64_t lists_count = lists.clear();
+        lists.close();
+        ui->out(F("Removed %s cached test cases lists") % lists_count);
+        return EXIT_SUCCESS;
+    } catch (const store::error& e) {
+        cmdline::print_error(ui, F("Cannot clear the result cache: %s.") %
+                             e.what());
+        return EXIT_FAILURE;
+    }
+}
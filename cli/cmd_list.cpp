@@ -154,7 +154,8 @@ cli::cmd_list::run(cmdline::ui* ui, const cmdline::parsed_cmdline& cmdline,
     progress_hooks hooks(ui, cmdline.has_option("verbose"));
     const drivers::list_tests::result result = drivers::list_tests::drive(
         kyuafile_path(cmdline), build_root_path(cmdline),
-        parse_filters(cmdline.arguments()), user_config, hooks);
+        parse_filters(cmdline.arguments()), user_config,
+        list_cache_path(user_config), hooks);
 
     return report_unused_filters(result.unused_filters, ui) ?
         EXIT_FAILURE : EXIT_SUCCESS;
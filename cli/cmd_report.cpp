@@ -33,6 +33,7 @@
 #include <cstdlib>
 #include <map>
 #include <ostream>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -55,6 +56,7 @@
 #include "utils/format/macros.hpp"
 #include "utils/fs/path.hpp"
 #include "utils/optional.ipp"
+#include "utils/process/resource_usage.hpp"
 #include "utils/sanity.hpp"
 #include "utils/stream.hpp"
 #include "utils/text/operations.ipp"
@@ -111,18 +113,23 @@ class report_console_hooks : public drivers::scan_results::base_hooks {
         /// The duration of the test case execution.
         utils::datetime::delta duration;
 
+        /// The number of times the test case ran.
+        int attempts;
+
         /// Constructs a new results data.
         ///
         /// \param binary_path_ The relative path to the test program.
         /// \param test_case_name_ The name of the test case.
         /// \param result_ The result of the test case.
         /// \param duration_ The duration of the test case execution.
+        /// \param attempts_ The number of times the test case ran.
         result_data(const utils::fs::path& binary_path_,
                     const std::string& test_case_name_,
                     const model::test_result& result_,
-                    const utils::datetime::delta& duration_) :
+                    const utils::datetime::delta& duration_,
+                    const int attempts_) :
             binary_path(binary_path_), test_case_name(test_case_name_),
-            result(result_), duration(duration_)
+            result(result_), duration(duration_), attempts(attempts_)
         {
         }
     };
@@ -200,6 +207,13 @@ class report_console_hooks : public drivers::scan_results::base_hooks {
         _output << F("Duration:   %s\n") %
             cli::format_delta(result_iter.end_time() -
                               result_iter.start_time());
+        if (result_iter.attempts() > 1)
+            _output << F("Attempts:   %s (%s)\n") % result_iter.attempts() %
+                cli::format_retries(result_iter.result(),
+                                    result_iter.attempts() - 1);
+        const std::set< int > cpus = result_iter.cpus();
+        if (!cpus.empty())
+            _output << F("CPUs:       %s\n") % text::join(cpus, ",");
 
         _output << "\n";
         _output << "Metadata:\n";
@@ -212,6 +226,18 @@ class report_console_hooks : public drivers::scan_results::base_hooks {
             }
         }
 
+        const optional< utils::process::resource_usage > usage =
+            result_iter.usage();
+        if (usage) {
+            const model::properties_map usage_props =
+                cli::format_usage(usage.get());
+            _output << "\n";
+            _output << "Resource usage:\n";
+            for (model::properties_map::const_iterator iter =
+                     usage_props.begin(); iter != usage_props.end(); ++iter)
+                _output << F("    %s = %s\n") % (*iter).first % (*iter).second;
+        }
+
         const std::string stdout_contents = result_iter.stdout_contents();
         if (!stdout_contents.empty()) {
             _output << "\n"
@@ -255,10 +281,14 @@ class report_console_hooks : public drivers::scan_results::base_hooks {
         _output << F("===> %s\n") % title;
         for (std::vector< result_data >::const_iterator iter = all.begin();
              iter != all.end(); iter++) {
-            _output << F("%s:%s  ->  %s  [%s]\n") % (*iter).binary_path %
+            _output << F("%s:%s  ->  %s  [%s]") % (*iter).binary_path %
                 (*iter).test_case_name %
                 cli::format_result((*iter).result) %
                 cli::format_delta((*iter).duration);
+            if ((*iter).attempts > 1)
+                _output << F("  (%s)") % cli::format_retries(
+                    (*iter).result, (*iter).attempts - 1);
+            _output << "\n";
         }
     }
 
@@ -308,7 +338,8 @@ public:
         const model::test_result result = iter.result();
         _results[result.type()].push_back(
             result_data(iter.test_program()->relative_path(),
-                        iter.test_case_name(), iter.result(), duration));
+                        iter.test_case_name(), iter.result(), duration,
+                        iter.attempts()));
 
         if (_verbose) {
             // TODO(jmmv): _results_filters is a list and is small enough for
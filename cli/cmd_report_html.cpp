@@ -54,6 +54,7 @@
 #include "utils/fs/operations.hpp"
 #include "utils/fs/path.hpp"
 #include "utils/optional.ipp"
+#include "utils/process/resource_usage.hpp"
 #include "utils/text/templates.hpp"
 
 namespace cmdline = utils::cmdline;
@@ -351,7 +352,14 @@ public:
                                                         test_case_name));
         templates.add_variable("test_program",
                                test_program->absolute_path().str());
-        templates.add_variable("result", cli::format_result(result));
+        if (iter.attempts() > 1) {
+            templates.add_variable("result", F("%s (%s)") %
+                                   cli::format_result(result) %
+                                   cli::format_retries(result,
+                                                       iter.attempts() - 1));
+        } else {
+            templates.add_variable("result", cli::format_result(result));
+        }
         templates.add_variable("start_time",
                                iter.start_time().to_iso8601_in_utc());
         templates.add_variable("end_time",
@@ -361,6 +369,10 @@ public:
         const model::test_case& test_case = test_program->find(test_case_name);
         add_map(templates, test_case.get_metadata().to_properties(),
                 "metadata_var", "metadata_value");
+        const optional< utils::process::resource_usage > usage = iter.usage();
+        if (usage)
+            add_map(templates, cli::format_usage(usage.get()), "usage_var",
+                    "usage_value");
 
         {
             const std::string stdout_text = iter.stdout_contents();
@@ -29,27 +29,43 @@
 #include "cli/cmd_test.hpp"
 
 #include <cstdlib>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
 #include "cli/common.ipp"
 #include "drivers/run_tests.hpp"
+#include "engine/config.hpp"
 #include "model/test_program.hpp"
 #include "model/test_result.hpp"
 #include "store/layout.hpp"
+#include "utils/cmdline/exceptions.hpp"
 #include "utils/cmdline/options.hpp"
 #include "utils/cmdline/parser.ipp"
 #include "utils/cmdline/ui.hpp"
 #include "utils/config/tree.ipp"
 #include "utils/datetime.hpp"
 #include "utils/format/macros.hpp"
+#include "utils/fs/operations.hpp"
 #include "utils/fs/path.hpp"
+#include "utils/logging/macros.hpp"
+#include "utils/noncopyable.hpp"
+#include "utils/optional.ipp"
+#include "utils/text/exceptions.hpp"
+#include "utils/text/operations.ipp"
+#include "utils/trace.hpp"
 
 namespace cmdline = utils::cmdline;
 namespace config = utils::config;
 namespace datetime = utils::datetime;
 namespace fs = utils::fs;
 namespace layout = store::layout;
+namespace text = utils::text;
+namespace trace = utils::trace;
 
 using cli::cmd_test;
+using utils::optional;
 
 
 namespace {
@@ -63,6 +79,12 @@ class print_hooks : public drivers::run_tests::base_hooks {
     /// Whether the tests are executed in parallel or not.
     bool _parallel;
 
+    /// Identifier of a test case: its test program path and its name.
+    typedef std::pair< fs::path, std::string > test_case_id;
+
+    /// Number of failed attempts of the test cases that are being retried.
+    std::map< test_case_id, int > _failed_attempts;
+
 public:
     /// The amount of positive test results found so far.
     unsigned long good_count;
@@ -70,6 +92,9 @@ public:
     /// The amount of negative test results found so far.
     unsigned long bad_count;
 
+    /// The amount of positive test results that needed retries.
+    unsigned long flaky_count;
+
     /// Constructor for the hooks.
     ///
     /// \param ui_ Object to interact with the I/O of the program.
@@ -78,7 +103,8 @@ public:
         _ui(ui_),
         _parallel(parallel_),
         good_count(0),
-        bad_count(0)
+        bad_count(0),
+        flaky_count(0)
     {
     }
 
@@ -114,13 +140,103 @@ public:
                      cli::format_test_case_id(test_program, test_case_name),
                      false);
         }
-        _ui->out(F("%s  [%s]") % cli::format_result(result) %
-            cli::format_delta(duration));
+        const std::map< test_case_id, int >::iterator retried =
+            _failed_attempts.find(std::make_pair(
+                test_program.relative_path(), test_case_name));
+        if (retried == _failed_attempts.end()) {
+            _ui->out(F("%s  [%s]") % cli::format_result(result) %
+                     cli::format_delta(duration));
+        } else {
+            _ui->out(F("%s  [%s]  (%s)") % cli::format_result(result) %
+                     cli::format_delta(duration) %
+                     cli::format_retries(result, (*retried).second));
+            if (result.good())
+                flaky_count++;
+            _failed_attempts.erase(retried);
+        }
         if (result.good())
             good_count++;
         else
             bad_count++;
     }
+
+    /// Called when a test case failed and is going to run again.
+    ///
+    /// \param test_program The test program containing the test case.
+    /// \param test_case_name The name of the executed test case.
+    /// \param result The result of the failed attempt.
+    /// \param duration The time it took to run the failed attempt.
+    /// \param attempt The number of the failed attempt, starting at 1.
+    virtual void
+    got_retry(const model::test_program& test_program,
+              const std::string& test_case_name,
+              const model::test_result& result,
+              const datetime::delta& duration,
+              const int attempt)
+    {
+        if (_parallel) {
+            _ui->out(F("%s  ->  ") %
+                     cli::format_test_case_id(test_program, test_case_name),
+                     false);
+        }
+        _ui->out(F("%s  [%s]  (retrying)") % cli::format_result(result) %
+                 cli::format_delta(duration));
+        _failed_attempts[std::make_pair(test_program.relative_path(),
+                                        test_case_name)] = attempt;
+    }
+};
+
+
+/// Parses the value of the --shard flag.
+///
+/// \param str The value of the flag, of the form 'index/count'.
+///
+/// \return The parsed shard.
+///
+/// \throw cmdline::usage_error If the value is invalid.
+static drivers::run_tests::shard
+parse_shard(const std::string& str)
+{
+    const std::string::size_type slash = str.find('/');
+    if (slash == std::string::npos)
+        throw cmdline::usage_error(F("Invalid value passed to --shard '%s'; "
+                                     "must be of the form index/count") % str);
+
+    int index, count;
+    try {
+        index = text::to_type< int >(str.substr(0, slash));
+        count = text::to_type< int >(str.substr(slash + 1));
+    } catch (const text::value_error& e) {
+        throw cmdline::usage_error(F("Invalid value passed to --shard '%s'; "
+                                     "%s") % str % e.what());
+    }
+    if (index < 1 || index > count)
+        throw cmdline::usage_error(F("Invalid value passed to --shard '%s'; "
+                                     "the index must be between 1 and the "
+                                     "count") % str);
+    return drivers::run_tests::shard(index, count);
+}
+
+
+/// Writes the trace of the run if it was not finished explicitly.
+///
+/// The normal completion of a run finishes the trace itself so that any write
+/// errors are reported to the user.  This guard only takes care of the runs
+/// that are aborted by an exception, such as an interrupt, so that the
+/// timeline recorded until then is not lost.
+class trace_guard : utils::noncopyable {
+public:
+    /// Destructor; writes the trace if it is still being recorded.
+    ~trace_guard(void)
+    {
+        if (!trace::enabled())
+            return;
+        try {
+            trace::finish();
+        } catch (const std::runtime_error& e) {
+            LW(F("Failed to write the trace: %s") % e.what());
+        }
+    }
 };
 
 
@@ -134,6 +250,24 @@ cmd_test::cmd_test(void) : cli_command(
     add_option(build_root_option);
     add_option(kyuafile_option);
     add_option(results_file_create_option);
+    add_option(cmdline::string_option(
+        "history", "Path to the results file of a previous run, or its "
+        "identifier for automatic lookup, from which to load the duration of "
+        "the tests; if given, the longest tests are run first", "file"));
+    add_option(cmdline::string_option(
+        "shard", "Run only the given subset of the tests, as in '2/4' for the "
+        "second of four disjoint subsets", "index/count"));
+    add_option(cmdline::bool_option(
+        "cache", "Do not run the tests that passed in a previous run with the "
+        "same test program binary, metadata, configuration and environment; "
+        "report their previous results instead"));
+    add_option(cmdline::int_option(
+        "retries", "Number of times to run again the tests that fail or "
+        "break; tests can ask for more retries in their metadata", "num",
+        "0"));
+    add_option(cmdline::path_option(
+        "trace", "Path to a file in which to write a timeline of the run in "
+        "the trace-event format of Chrome and Perfetto", "file"));
 }
 
 
@@ -151,13 +285,45 @@ cmd_test::run(cmdline::ui* ui, const cmdline::parsed_cmdline& cmdline,
     const layout::results_id_file_pair results = layout::new_db(
         results_file_create(cmdline), kyuafile_path(cmdline).branch_path());
 
-    const bool parallel = (user_config.lookup< config::positive_int_node >(
-                               "parallelism") > 1);
+    const bool parallel = (user_config.lookup< engine::parallelism_node >(
+                               "parallelism").max > 1);
+
+    optional< drivers::run_tests::durations_map > durations;
+    if (cmdline.has_option("history")) {
+        durations = drivers::run_tests::load_durations(layout::find_results(
+            cmdline.get_option< cmdline::string_option >("history")));
+    }
+
+    optional< drivers::run_tests::shard > shard;
+    if (cmdline.has_option("shard")) {
+        shard = parse_shard(
+            cmdline.get_option< cmdline::string_option >("shard"));
+    }
+
+    const int retries = cmdline.get_option< cmdline::int_option >("retries");
+    if (retries < 0)
+        throw cmdline::usage_error(F("Invalid value passed to --retries '%s'; "
+                                     "must be a non-negative integer") %
+                                   retries);
+
+    optional< fs::path > result_cache_path;
+    if (cmdline.has_option("cache")) {
+        result_cache_path = layout::query_cache_db();
+        fs::mkdir_p(result_cache_path.get().branch_path(), 0755);
+    }
+
+    if (cmdline.has_option("trace"))
+        trace::start(cmdline.get_option< cmdline::path_option >("trace"));
+    trace_guard trace_finisher;
 
     print_hooks hooks(ui, parallel);
     const drivers::run_tests::result result = drivers::run_tests::drive(
         kyuafile_path(cmdline), build_root_path(cmdline), results.second,
-        parse_filters(cmdline.arguments()), user_config, hooks);
+        parse_filters(cmdline.arguments()), user_config, durations, shard,
+        retries, result_cache_path, list_cache_path(user_config), hooks);
+
+    if (trace::enabled())
+        trace::finish();
 
     int exit_code;
     if (hooks.good_count > 0 || hooks.bad_count > 0) {
@@ -170,6 +336,14 @@ cmd_test::run(cmdline::ui* ui, const cmdline::parsed_cmdline& cmdline,
 
         ui->out(F("%s/%s passed (%s failed)") % hooks.good_count %
                 (hooks.good_count + hooks.bad_count) % hooks.bad_count);
+        if (hooks.flaky_count > 0) {
+            ui->out(F("%s passed only after being retried") %
+                    hooks.flaky_count);
+        }
+        if (parallel && result.exclusive_barrier_time != datetime::delta()) {
+            ui->out(F("Slot time lost to exclusive tests: %s") %
+                    cli::format_delta(result.exclusive_barrier_time));
+        }
 
         exit_code = (hooks.bad_count == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
     } else {
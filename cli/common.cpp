@@ -41,6 +41,7 @@
 #include "utils/cmdline/options.hpp"
 #include "utils/cmdline/parser.ipp"
 #include "utils/cmdline/ui.hpp"
+#include "utils/config/tree.ipp"
 #include "utils/datetime.hpp"
 #include "utils/env.hpp"
 #include "utils/format/macros.hpp"
@@ -49,6 +50,7 @@
 #include "utils/fs/operations.hpp"
 #include "utils/fs/path.hpp"
 #include "utils/optional.ipp"
+#include "utils/process/resource_usage.hpp"
 #include "utils/sanity.hpp"
 
 #if defined(HAVE_CONFIG_H)
@@ -56,6 +58,7 @@
 #endif
 
 namespace cmdline = utils::cmdline;
+namespace config = utils::config;
 namespace datetime = utils::datetime;
 namespace fs = utils::fs;
 namespace layout = store::layout;
@@ -263,6 +266,34 @@ cli::results_file_open(const cmdline::parsed_cmdline& cmdline)
 }
 
 
+/// Gets the path to the cache of test cases lists, creating its directory.
+///
+/// The cache is an optimization, so failing to create its directory disables
+/// it instead of failing the command that wanted to use it.
+///
+/// \param user_config The runtime configuration of the program.
+///
+/// \return The path to the database holding the cache, or none if it is
+/// disabled or cannot be used.
+optional< fs::path >
+cli::list_cache_path(const config::tree& user_config)
+{
+    // The cache is enabled unless explicitly disabled.
+    if (user_config.is_set("list_cache") &&
+        !user_config.lookup< config::bool_node >("list_cache"))
+        return none;
+
+    const fs::path path = layout::query_cache_db();
+    try {
+        fs::mkdir_p(path.branch_path(), 0755);
+    } catch (const fs::error& e) {
+        LW(F("Not caching test cases lists: %s") % e.what());
+        return none;
+    }
+    return utils::make_optional(path);
+}
+
+
 /// Gets the filters for the result types.
 ///
 /// \param cmdline The parsed command line.
@@ -373,6 +404,44 @@ cli::format_result(const model::test_result& result)
 }
 
 
+/// Formats the outcome of a test case that was retried for user presentation.
+///
+/// \param result The result of the last attempt of the test case.
+/// \param retries The number of times the test case ran again after failing.
+///
+/// \return A user-friendly description of the retries.
+std::string
+cli::format_retries(const model::test_result& result, const int retries)
+{
+    PRE(retries > 0);
+    return F("%s on retry %s") % (result.good() ? "passed" : "still failed") %
+        retries;
+}
+
+
+/// Formats the resources consumed by a test case for user presentation.
+///
+/// \param usage The resource usage to format.
+///
+/// \return A collection of property/value pairs, one per resource, suitable
+/// to be listed in the same way as the metadata of a test case.
+model::properties_map
+cli::format_usage(const utils::process::resource_usage& usage)
+{
+    model::properties_map props;
+    props["user_time"] = format_delta(usage.user_time);
+    props["system_time"] = format_delta(usage.system_time);
+    props["max_rss"] = usage.max_rss.format();
+    props["minor_faults"] = F("%s") % usage.minor_faults;
+    props["major_faults"] = F("%s") % usage.major_faults;
+    props["block_inputs"] = F("%s") % usage.block_inputs;
+    props["block_outputs"] = F("%s") % usage.block_outputs;
+    props["voluntary_switches"] = F("%s") % usage.voluntary_switches;
+    props["involuntary_switches"] = F("%s") % usage.involuntary_switches;
+    return props;
+}
+
+
 /// Formats the identifier of a test case for user presentation.
 ///
 /// \param test_program The test program containing the test case.
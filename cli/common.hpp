@@ -39,6 +39,7 @@
 #include "engine/filters_fwd.hpp"
 #include "model/test_program_fwd.hpp"
 #include "model/test_result.hpp"
+#include "model/types.hpp"
 #include "utils/cmdline/base_command.hpp"
 #include "utils/cmdline/options_fwd.hpp"
 #include "utils/cmdline/parser_fwd.hpp"
@@ -47,6 +48,7 @@
 #include "utils/datetime_fwd.hpp"
 #include "utils/fs/path_fwd.hpp"
 #include "utils/optional_fwd.hpp"
+#include "utils/process/resource_usage_fwd.hpp"
 
 namespace cli {
 
@@ -84,6 +86,8 @@ utils::fs::path kyuafile_path(const utils::cmdline::parsed_cmdline&);
 std::string results_file_create(const utils::cmdline::parsed_cmdline&);
 std::string results_file_open(const utils::cmdline::parsed_cmdline&);
 result_types get_result_types(const utils::cmdline::parsed_cmdline&);
+utils::optional< utils::fs::path > list_cache_path(
+    const utils::config::tree&);
 
 std::set< engine::test_filter > parse_filters(
     const utils::cmdline::args_vector&);
@@ -92,6 +96,8 @@ bool report_unused_filters(const std::set< engine::test_filter >&,
 
 std::string format_delta(const utils::datetime::delta&);
 std::string format_result(const model::test_result&);
+std::string format_retries(const model::test_result&, const int);
+model::properties_map format_usage(const utils::process::resource_usage&);
 std::string format_test_case_id(const model::test_program&, const std::string&);
 std::string format_test_case_id(const engine::test_filter&);
 
@@ -32,6 +32,7 @@
 
 #include <atf-c++.hpp>
 
+#include "engine/config.hpp"
 #include "engine/exceptions.hpp"
 #include "engine/filters.hpp"
 #include "model/metadata.hpp"
@@ -43,6 +44,7 @@
 #include "utils/cmdline/options.hpp"
 #include "utils/cmdline/parser.ipp"
 #include "utils/cmdline/ui_mock.hpp"
+#include "utils/config/tree.ipp"
 #include "utils/datetime.hpp"
 #include "utils/env.hpp"
 #include "utils/format/macros.hpp"
@@ -50,6 +52,7 @@
 #include "utils/fs/operations.hpp"
 #include "utils/fs/path.hpp"
 #include "utils/optional.ipp"
+#include "utils/process/resource_usage.hpp"
 #include "utils/sanity.hpp"
 
 namespace cmdline = utils::cmdline;
@@ -57,6 +60,8 @@ namespace config = utils::config;
 namespace datetime = utils::datetime;
 namespace fs = utils::fs;
 namespace layout = store::layout;
+namespace process = utils::process;
+namespace units = utils::units;
 
 using utils::optional;
 
@@ -290,6 +295,33 @@ ATF_TEST_CASE_BODY(results_file_open__explicit)
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(list_cache_path__enabled);
+ATF_TEST_CASE_BODY(list_cache_path__enabled)
+{
+    const fs::path home = fs::current_path() / "homedir";
+    utils::setenv("HOME", home.str());
+
+    const optional< fs::path > path = cli::list_cache_path(
+        engine::default_config());
+    ATF_REQUIRE(path);
+    ATF_REQUIRE_EQ(layout::query_cache_db(), path.get());
+    ATF_REQUIRE(fs::exists(path.get().branch_path()));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(list_cache_path__disabled);
+ATF_TEST_CASE_BODY(list_cache_path__disabled)
+{
+    const fs::path home = fs::current_path() / "homedir";
+    utils::setenv("HOME", home.str());
+
+    config::tree user_config = engine::default_config();
+    user_config.set_string("list_cache", "false");
+    ATF_REQUIRE(!cli::list_cache_path(user_config));
+    ATF_REQUIRE(!fs::exists(home / ".kyua"));
+}
+
+
 ATF_TEST_CASE_WITHOUT_HEAD(parse_filters__none);
 ATF_TEST_CASE_BODY(parse_filters__none)
 {
@@ -408,6 +440,39 @@ ATF_TEST_CASE_BODY(format_result__with_reason)
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(format_retries);
+ATF_TEST_CASE_BODY(format_retries)
+{
+    ATF_REQUIRE_EQ("passed on retry 1", cli::format_retries(
+        model::test_result(model::test_result_passed), 1));
+    ATF_REQUIRE_EQ("passed on retry 2", cli::format_retries(
+        model::test_result(model::test_result_expected_failure, "Foo"), 2));
+    ATF_REQUIRE_EQ("still failed on retry 3", cli::format_retries(
+        model::test_result(model::test_result_broken, "Bar"), 3));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(format_usage);
+ATF_TEST_CASE_BODY(format_usage)
+{
+    const process::resource_usage usage(
+        datetime::delta(1, 500000), datetime::delta(0, 20000),
+        units::bytes(3 * units::MB), 100, 2, 8, 16, 42, 7);
+
+    model::properties_map exp_props;
+    exp_props["user_time"] = "1.500s";
+    exp_props["system_time"] = "0.020s";
+    exp_props["max_rss"] = "3.00M";
+    exp_props["minor_faults"] = "100";
+    exp_props["major_faults"] = "2";
+    exp_props["block_inputs"] = "8";
+    exp_props["block_outputs"] = "16";
+    exp_props["voluntary_switches"] = "42";
+    exp_props["involuntary_switches"] = "7";
+    ATF_REQUIRE(exp_props == cli::format_usage(usage));
+}
+
+
 ATF_TEST_CASE_WITHOUT_HEAD(format_test_case_id__test_case);
 ATF_TEST_CASE_BODY(format_test_case_id__test_case)
 {
@@ -462,6 +527,9 @@ ATF_INIT_TEST_CASES(tcs)
     ATF_ADD_TEST_CASE(tcs, results_file_open__default__historical);
     ATF_ADD_TEST_CASE(tcs, results_file_open__explicit);
 
+    ATF_ADD_TEST_CASE(tcs, list_cache_path__enabled);
+    ATF_ADD_TEST_CASE(tcs, list_cache_path__disabled);
+
     ATF_ADD_TEST_CASE(tcs, parse_filters__none);
     ATF_ADD_TEST_CASE(tcs, parse_filters__ok);
     ATF_ADD_TEST_CASE(tcs, parse_filters__duplicate);
@@ -475,6 +543,9 @@ ATF_INIT_TEST_CASES(tcs)
     ATF_ADD_TEST_CASE(tcs, format_result__no_reason);
     ATF_ADD_TEST_CASE(tcs, format_result__with_reason);
 
+    ATF_ADD_TEST_CASE(tcs, format_retries);
+    ATF_ADD_TEST_CASE(tcs, format_usage);
+
     ATF_ADD_TEST_CASE(tcs, format_test_case_id__test_case);
     ATF_ADD_TEST_CASE(tcs, format_test_case_id__test_filter);
 
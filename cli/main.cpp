@@ -43,8 +43,10 @@ extern "C" {
 #include <utility>
 
 #include "cli/cmd_about.hpp"
+#include "cli/cmd_clear_cache.hpp"
 #include "cli/cmd_config.hpp"
 #include "cli/cmd_db_exec.hpp"
+#include "cli/cmd_db_merge.hpp"
 #include "cli/cmd_db_migrate.hpp"
 #include "cli/cmd_debug.hpp"
 #include "cli/cmd_help.hpp"
@@ -56,9 +58,11 @@ extern "C" {
 #include "cli/common.ipp"
 #include "cli/config.hpp"
 #include "engine/atf.hpp"
+#include "engine/googletest.hpp"
 #include "engine/plain.hpp"
 #include "engine/scheduler.hpp"
 #include "engine/tap.hpp"
+#include "engine/worker.hpp"
 #include "store/exceptions.hpp"
 #include "utils/cmdline/commands_map.ipp"
 #include "utils/cmdline/exceptions.hpp"
@@ -102,12 +106,18 @@ register_scheduler_interfaces(void)
     scheduler::register_interface(
         "atf", std::shared_ptr< scheduler::interface >(
             new engine::atf_interface()));
+    scheduler::register_interface(
+        "googletest", std::shared_ptr< scheduler::interface >(
+            new engine::googletest_interface()));
     scheduler::register_interface(
         "plain", std::shared_ptr< scheduler::interface >(
             new engine::plain_interface()));
     scheduler::register_interface(
         "tap", std::shared_ptr< scheduler::interface >(
             new engine::tap_interface()));
+    scheduler::register_interface(
+        "worker", std::shared_ptr< scheduler::interface >(
+            new engine::worker_interface()));
 }
 
 
@@ -186,9 +196,11 @@ safe_main(cmdline::ui* ui, int argc, const char* const argv[],
     commands.insert(new cli::cmd_about());
     commands.insert(new cli::cmd_config());
     commands.insert(new cli::cmd_db_exec());
+    commands.insert(new cli::cmd_db_merge());
     commands.insert(new cli::cmd_db_migrate());
     commands.insert(new cli::cmd_help(&options, &commands));
 
+    commands.insert(new cli::cmd_clear_cache(), "Workspace");
     commands.insert(new cli::cmd_debug(), "Workspace");
     commands.insert(new cli::cmd_list(), "Workspace");
     commands.insert(new cli::cmd_test(), "Workspace");
@@ -28,12 +28,14 @@
 
 #include "drivers/list_tests.hpp"
 
+#include "engine/config.hpp"
 #include "engine/exceptions.hpp"
 #include "engine/filters.hpp"
 #include "engine/kyuafile.hpp"
 #include "engine/scanner.hpp"
 #include "engine/scheduler.hpp"
 #include "model/test_program.hpp"
+#include "utils/config/tree.ipp"
 #include "utils/optional.ipp"
 
 namespace config = utils::config;
@@ -55,6 +57,9 @@ drivers::list_tests::base_hooks::~base_hooks(void)
 /// \param build_root If not none, path to the built test programs.
 /// \param filters The test case filters as provided by the user.
 /// \param user_config The end-user configuration properties.
+/// \param list_cache_path If not none, path to the cache of test cases lists.
+///     Test programs whose binaries did not change since they were cached are
+///     not executed to list their test cases.
 /// \param hooks The hooks for this execution.
 ///
 /// \returns A structure with all results computed by this driver.
@@ -63,16 +68,32 @@ drivers::list_tests::drive(const fs::path& kyuafile_path,
                            const optional< fs::path > build_root,
                            const std::set< engine::test_filter >& filters,
                            const config::tree& user_config,
+                           const optional< fs::path >& list_cache_path,
                            base_hooks& hooks)
 {
     scheduler::scheduler_handle handle = scheduler::setup();
+    if (list_cache_path)
+        handle.enable_list_cache(list_cache_path.get());
 
     const engine::kyuafile kyuafile = engine::kyuafile::load(
         kyuafile_path, build_root, user_config, handle);
 
     engine::scanner scanner(kyuafile.test_programs(), filters);
 
+    // Fall back to a single background list operation if the configuration
+    // does not specify the parallelism (e.g. when it is empty).
+    const std::size_t lookahead = user_config.is_set("parallelism") ?
+        user_config.lookup< engine::parallelism_node >("parallelism").max : 1;
     while (!scanner.done()) {
+        // Load the test cases of the upcoming test programs in parallel.  The
+        // active test program has already been loaded by done() above.
+        const model::test_programs_vector upcoming =
+            scanner.upcoming_test_programs(lookahead + 1);
+        for (model::test_programs_vector::const_iterator iter =
+                 upcoming.begin(); iter != upcoming.end(); ++iter) {
+            handle.start_list_tests(*iter, user_config);
+        }
+
         const optional< engine::scan_result > result = scanner.yield();
         INV(result);
         hooks.got_test_case(*result.get().first, result.get().second);
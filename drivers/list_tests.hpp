@@ -83,7 +83,8 @@ public:
 
 result drive(const utils::fs::path&, const utils::optional< utils::fs::path >,
              const std::set< engine::test_filter >&,
-             const utils::config::tree&, base_hooks&);
+             const utils::config::tree&,
+             const utils::optional< utils::fs::path >&, base_hooks&);
 
 
 }  // namespace list_tests
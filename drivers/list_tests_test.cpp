@@ -172,7 +172,7 @@ run_helpers(const fs::path& source_root,
     }
 
     return drivers::list_tests::drive(source_root / "Kyuafile", build_root,
-                                      filters, user_config, hooks);
+                                      filters, user_config, none, hooks);
 }
 
 
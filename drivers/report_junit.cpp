@@ -40,12 +40,16 @@
 #include "utils/datetime.hpp"
 #include "utils/defs.hpp"
 #include "utils/format/macros.hpp"
+#include "utils/optional.ipp"
+#include "utils/process/resource_usage.hpp"
 #include "utils/text/operations.hpp"
 
 namespace config = utils::config;
 namespace datetime = utils::datetime;
 namespace text = utils::text;
 
+using utils::optional;
+
 
 /// Converts a test program name into a class-like name.
 ///
@@ -89,6 +93,14 @@ const char* const drivers::junit_timing_header =
     "\n";
 
 
+/// String to prepend to the formatted test case resource usage.
+const char* const drivers::junit_usage_header =
+    "\n"
+    "Resource usage\n"
+    "--------------\n"
+    "\n";
+
+
 /// String to append to the formatted test case metadata.
 const char* const drivers::junit_stderr_header =
     "\n"
@@ -144,6 +156,30 @@ drivers::junit_timing(const datetime::timestamp& start_time,
 }
 
 
+/// Formats the resources consumed by a test for recording in stderr.
+///
+/// \param usage The resource usage of the test.
+///
+/// \return A string with the resource usage that can be prepended to the
+/// original test's stderr.
+std::string
+drivers::junit_usage(const utils::process::resource_usage& usage)
+{
+    std::ostringstream output;
+    output << junit_usage_header;
+    output << F("block_inputs = %s\n") % usage.block_inputs;
+    output << F("block_outputs = %s\n") % usage.block_outputs;
+    output << F("involuntary_switches = %s\n") % usage.involuntary_switches;
+    output << F("major_faults = %s\n") % usage.major_faults;
+    output << F("max_rss = %s\n") % usage.max_rss.format();
+    output << F("minor_faults = %s\n") % usage.minor_faults;
+    output << F("system_time = %ss\n") % junit_duration(usage.system_time);
+    output << F("user_time = %ss\n") % junit_duration(usage.user_time);
+    output << F("voluntary_switches = %s\n") % usage.voluntary_switches;
+    return output.str();
+}
+
+
 /// Constructor for the hooks.
 ///
 /// \param [out] output_ Stream to which to write the report.
@@ -222,6 +258,16 @@ drivers::report_junit_hooks::got_result(store::results_iterator& iter)
             % text::escape_xml(result.reason());
     }
 
+    if (iter.attempts() > 1) {
+        stderr_contents += F("Retry details\n"
+                             "-------------\n"
+                             "\n"
+                             "Ran %s times; %s\n"
+                             "\n") % iter.attempts() %
+            (result.good() ? "passed on the last attempt" :
+             "failed on every attempt");
+    }
+
     const std::string stdout_contents = iter.stdout_contents();
     if (!stdout_contents.empty()) {
         _output << F("<system-out>%s</system-out>\n")
@@ -234,6 +280,11 @@ drivers::report_junit_hooks::got_result(store::results_iterator& iter)
         stderr_contents += junit_metadata(test_case.get_metadata());
     }
     stderr_contents += junit_timing(iter.start_time(), iter.end_time());
+    {
+        const optional< utils::process::resource_usage > usage = iter.usage();
+        if (usage)
+            stderr_contents += junit_usage(usage.get());
+    }
     {
         stderr_contents += junit_stderr_header;
         const std::string real_stderr_contents = iter.stderr_contents();
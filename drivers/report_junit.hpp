@@ -39,12 +39,14 @@
 #include "model/metadata_fwd.hpp"
 #include "model/test_program_fwd.hpp"
 #include "utils/datetime_fwd.hpp"
+#include "utils/process/resource_usage_fwd.hpp"
 
 namespace drivers {
 
 
 extern const char* const junit_metadata_header;
 extern const char* const junit_timing_header;
+extern const char* const junit_usage_header;
 extern const char* const junit_stderr_header;
 
 
@@ -53,6 +55,7 @@ std::string junit_duration(const utils::datetime::delta&);
 std::string junit_metadata(const model::metadata&);
 std::string junit_timing(const utils::datetime::timestamp&,
                          const utils::datetime::timestamp&);
+std::string junit_usage(const utils::process::resource_usage&);
 
 
 /// Hooks for the scan_results driver to generate a JUnit report.
@@ -46,10 +46,12 @@
 #include "utils/format/macros.hpp"
 #include "utils/fs/path.hpp"
 #include "utils/optional.ipp"
+#include "utils/process/resource_usage.hpp"
 #include "utils/units.hpp"
 
 namespace datetime = utils::datetime;
 namespace fs = utils::fs;
+namespace process = utils::process;
 namespace units = utils::units;
 
 using utils::none;
@@ -62,15 +64,19 @@ namespace {
 static const char* const default_metadata =
     "allowed_architectures is empty\n"
     "allowed_platforms is empty\n"
+    "cpu_time_limit = 0\n"
     "description is empty\n"
     "has_cleanup = false\n"
     "is_exclusive = false\n"
+    "memory_limit = 0\n"
     "required_configs is empty\n"
     "required_disk_space = 0\n"
     "required_files is empty\n"
     "required_memory = 0\n"
     "required_programs is empty\n"
+    "required_resources is empty\n"
     "required_user is empty\n"
+    "retries = 0\n"
     "timeout = 300\n";
 
 
@@ -79,15 +85,19 @@ static const char* const default_metadata =
 static const char* const overriden_metadata =
     "allowed_architectures is empty\n"
     "allowed_platforms is empty\n"
+    "cpu_time_limit = 0\n"
     "description = Textual description\n"
     "has_cleanup = false\n"
     "is_exclusive = false\n"
+    "memory_limit = 0\n"
     "required_configs is empty\n"
     "required_disk_space = 0\n"
     "required_files is empty\n"
     "required_memory = 0\n"
     "required_programs is empty\n"
+    "required_resources is empty\n"
     "required_user is empty\n"
+    "retries = 0\n"
     "timeout = 5678\n";
 
 
@@ -113,7 +123,8 @@ add_context(store::write_transaction& tx, const std::size_t env_vars)
 /// \param results Collection of results for the added test cases.  The size of
 ///     this vector indicates the number of tests in the test program.
 /// \param with_metadata Whether to add metadata overrides to the test cases.
-/// \param with_output Whether to add stdout/stderr messages to the test cases.
+/// \param with_output Whether to add stdout/stderr messages and resource usage
+///     to the test cases.
 static void
 add_tests(store::write_transaction& tx,
           const char* prog,
@@ -149,6 +160,9 @@ add_tests(store::write_transaction& tx,
             tx.put_test_case_file("__STDOUT__", fs::path("fake-out"), tc_id);
             atf::utils::create_file("fake-err", F("stderr file %s") % j);
             tx.put_test_case_file("__STDERR__", fs::path("fake-err"), tc_id);
+            tx.put_resource_usage(tc_id, process::resource_usage(
+                datetime::delta(j, 250000), datetime::delta(0, 1000),
+                units::bytes(2 * units::MB), j, 0, 0, 0, 3, 4));
         }
     }
 }
@@ -198,15 +212,19 @@ ATF_TEST_CASE_BODY(junit_metadata__overrides)
     const model::metadata metadata = model::metadata_builder()
         .add_allowed_architecture("arch1")
         .add_allowed_platform("platform1")
+        .set_cpu_time_limit(datetime::delta(7, 0))
         .set_description("This is a test")
         .set_has_cleanup(true)
         .set_is_exclusive(true)
+        .set_memory_limit(units::bytes(789))
         .add_required_config("config1")
         .set_required_disk_space(units::bytes(456))
         .add_required_file(fs::path("file1"))
         .set_required_memory(units::bytes(123))
         .add_required_program(fs::path("prog1"))
+        .add_required_resource("port:8080")
         .set_required_user("root")
+        .set_retries(2)
         .set_timeout(datetime::delta(10, 0))
         .build();
 
@@ -214,15 +232,19 @@ ATF_TEST_CASE_BODY(junit_metadata__overrides)
         + drivers::junit_metadata_header
         + "allowed_architectures = arch1\n"
         + "allowed_platforms = platform1\n"
+        + "cpu_time_limit = 7\n"
         + "description = This is a test\n"
         + "has_cleanup = true\n"
         + "is_exclusive = true\n"
+        + "memory_limit = 789\n"
         + "required_configs = config1\n"
         + "required_disk_space = 456\n"
         + "required_files = file1\n"
         + "required_memory = 123\n"
         + "required_programs = prog1\n"
+        + "required_resources = port:8080\n"
         + "required_user = root\n"
+        + "retries = 2\n"
         + "timeout = 10\n";
 
     ATF_REQUIRE_EQ(expected, drivers::junit_metadata(metadata));
@@ -247,6 +269,29 @@ ATF_TEST_CASE_BODY(junit_timing)
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(junit_usage);
+ATF_TEST_CASE_BODY(junit_usage)
+{
+    const std::string expected = std::string()
+        + drivers::junit_usage_header +
+        "block_inputs = 8\n"
+        "block_outputs = 16\n"
+        "involuntary_switches = 7\n"
+        "major_faults = 2\n"
+        "max_rss = 3.00M\n"
+        "minor_faults = 100\n"
+        "system_time = 0.020s\n"
+        "user_time = 1.500s\n"
+        "voluntary_switches = 42\n";
+
+    const process::resource_usage usage(
+        datetime::delta(1, 500000), datetime::delta(0, 20000),
+        units::bytes(3 * units::MB), 100, 2, 8, 16, 42, 7);
+
+    ATF_REQUIRE_EQ(expected, drivers::junit_usage(usage));
+}
+
+
 ATF_TEST_CASE_WITHOUT_HEAD(report_junit_hooks__minimal);
 ATF_TEST_CASE_BODY(report_junit_hooks__minimal)
 {
@@ -371,6 +416,16 @@ ATF_TEST_CASE_BODY(report_junit_hooks__some_tests)
         "Start time: 1970-01-01T00:00:00.000000Z\n"
         "End time:   1970-01-01T00:00:00.500000Z\n"
         "Duration:   0.500s\n"
+        + drivers::junit_usage_header +
+        "block_inputs = 0\n"
+        "block_outputs = 0\n"
+        "involuntary_switches = 4\n"
+        "major_faults = 0\n"
+        "max_rss = 2.00M\n"
+        "minor_faults = 0\n"
+        "system_time = 0.001s\n"
+        "user_time = 0.250s\n"
+        "voluntary_switches = 3\n"
         + drivers::junit_stderr_header +
         "stderr file 0</system-err>\n"
         "</testcase>\n"
@@ -390,6 +445,16 @@ ATF_TEST_CASE_BODY(report_junit_hooks__some_tests)
         "Start time: 1970-01-01T00:00:00.000000Z\n"
         "End time:   1970-01-01T00:00:01.500000Z\n"
         "Duration:   1.500s\n"
+        + drivers::junit_usage_header +
+        "block_inputs = 0\n"
+        "block_outputs = 0\n"
+        "involuntary_switches = 4\n"
+        "major_faults = 0\n"
+        "max_rss = 2.00M\n"
+        "minor_faults = 1\n"
+        "system_time = 0.001s\n"
+        "user_time = 1.250s\n"
+        "voluntary_switches = 3\n"
         + drivers::junit_stderr_header +
         "stderr file 1</system-err>\n"
         "</testcase>\n"
@@ -410,6 +475,8 @@ ATF_INIT_TEST_CASES(tcs)
 
     ATF_ADD_TEST_CASE(tcs, junit_timing);
 
+    ATF_ADD_TEST_CASE(tcs, junit_usage);
+
     ATF_ADD_TEST_CASE(tcs, report_junit_hooks__minimal);
     ATF_ADD_TEST_CASE(tcs, report_junit_hooks__some_tests);
 }
@@ -28,11 +28,25 @@
 
 #include "drivers/run_tests.hpp"
 
+#if defined(HAVE_CONFIG_H)
+#   include "config.h"
+#endif
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
 #include <utility>
 
 #include "engine/config.hpp"
 #include "engine/filters.hpp"
 #include "engine/kyuafile.hpp"
+#include "engine/parallelism.hpp"
 #include "engine/scanner.hpp"
 #include "engine/scheduler.hpp"
 #include "model/context.hpp"
@@ -40,17 +54,26 @@
 #include "model/test_case.hpp"
 #include "model/test_program.hpp"
 #include "model/test_result.hpp"
+#include "store/exceptions.hpp"
+#include "store/read_backend.hpp"
+#include "store/read_transaction.hpp"
+#include "store/result_cache.hpp"
 #include "store/write_backend.hpp"
 #include "store/write_transaction.hpp"
 #include "utils/config/tree.ipp"
 #include "utils/datetime.hpp"
 #include "utils/defs.hpp"
 #include "utils/format/macros.hpp"
+#include "utils/hash.hpp"
+#include "utils/jobserver.hpp"
+#include "utils/load.hpp"
 #include "utils/logging/macros.hpp"
 #include "utils/noncopyable.hpp"
 #include "utils/optional.ipp"
 #include "utils/passwd.hpp"
+#include "utils/stream.hpp"
 #include "utils/text/operations.ipp"
+#include "utils/trace.hpp"
 
 namespace config = utils::config;
 namespace datetime = utils::datetime;
@@ -58,6 +81,7 @@ namespace fs = utils::fs;
 namespace passwd = utils::passwd;
 namespace scheduler = engine::scheduler;
 namespace text = utils::text;
+namespace trace = utils::trace;
 
 using utils::none;
 using utils::optional;
@@ -81,6 +105,17 @@ typedef std::map< int, int64_t > pid_to_id_map;
 typedef pid_to_id_map::value_type pid_and_id_pair;
 
 
+/// Map of test case IDs to the number of the attempt they are going through.
+///
+/// Only the test cases that have been retried at least once are tracked; all
+/// others are going through their first attempt.
+typedef std::map< int64_t, int > attempts_map;
+
+
+/// A test case that has to run again, along with its ID in the store.
+typedef std::pair< int64_t, engine::scan_result > retry_entry;
+
+
 /// Puts a test program in the store and returns its identifier.
 ///
 /// This function is idempotent: we maintain a side cache of already-put test
@@ -111,21 +146,19 @@ find_test_program_id(const model::test_program_ptr test_program,
 }
 
 
-/// Stores the result of an execution in the database.
+/// Stores the output files of an execution in the database.
 ///
 /// \param test_case_id Identifier of the test case in the database.
 /// \param result The result of the execution.
-/// \param [in,out] tx Writable transaction where to store the result data.
+/// \param [in,out] tx Writable transaction where to store the files.
 static void
-put_test_result(const int64_t test_case_id,
-                const scheduler::test_result_handle& result,
-                store::write_transaction& tx)
+put_test_files(const int64_t test_case_id,
+               const scheduler::test_result_handle& result,
+               store::write_transaction& tx)
 {
-    tx.put_result(result.test_result(), test_case_id,
-                  result.start_time(), result.end_time());
+    trace::span span("put_test_case_file", trace::main_track);
     tx.put_test_case_file("__STDOUT__", result.stdout_file(), test_case_id);
     tx.put_test_case_file("__STDERR__", result.stderr_file(), test_case_id);
-
 }
 
 
@@ -150,6 +183,352 @@ safe_cleanup(scheduler::test_result_handle handle) throw()
 }
 
 
+/// Formats a 64-bit hash as a fixed-length hexadecimal string.
+///
+/// \param hash The hash to format.
+///
+/// \return The textual representation of the hash.
+static std::string
+format_hash(const uint64_t hash)
+{
+    std::ostringstream output;
+    output << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return output.str();
+}
+
+
+/// Appends a field to a cache key descriptor.
+///
+/// Fields are prefixed by their length so that the concatenation of different
+/// fields can never yield the same descriptor.
+///
+/// \param [in,out] descriptor The descriptor to extend.
+/// \param value The value of the field.
+static void
+append_field(std::string& descriptor, const std::string& value)
+{
+    descriptor += F("%s:") % value.length();
+    descriptor += value;
+}
+
+
+/// Appends a collection of properties to a cache key descriptor.
+///
+/// \param [in,out] descriptor The descriptor to extend.
+/// \param properties The properties to append, in their sorted order.
+static void
+append_properties(std::string& descriptor,
+                  const std::map< std::string, std::string >& properties)
+{
+    append_field(descriptor, F("%s") % properties.size());
+    for (std::map< std::string, std::string >::const_iterator iter =
+             properties.begin(); iter != properties.end(); ++iter) {
+        append_field(descriptor, (*iter).first);
+        append_field(descriptor, (*iter).second);
+    }
+}
+
+
+/// Reason given to the results of tests replayed from the cache.
+static const char* cached_reason = "Cached result of a previous run";
+
+
+/// Cache of the outputs of passing tests across runs.
+///
+/// Tests are identified by a key that covers the contents of their test program
+/// binary and everything else that Kyua feeds into their execution: the name of
+/// the test case, its metadata, the configuration variables of its test suite
+/// and the environment.  A change to any of these causes the test to run again.
+/// Anything else that a test may depend on, such as data files or helper
+/// programs, is not tracked, which is why the cache is opt-in.
+class test_cache : utils::noncopyable {
+    /// The persistent cache, or none if caching is disabled.
+    optional< store::result_cache > _cache;
+
+    /// The end-user configuration properties.
+    const config::tree& _user_config;
+
+    /// The context in which the tests run.
+    const model::context _context;
+
+    /// Digests of the test program binaries, or empty if unreadable.
+    std::map< fs::path, std::string > _digests;
+
+    /// Keys of the test cases seen so far, or empty if they are not cacheable.
+    std::map< drivers::run_tests::test_case_id, std::string > _keys;
+
+    /// Computes the digest of the contents of a test program binary.
+    ///
+    /// \param program Absolute path to the test program.
+    ///
+    /// \return The digest, or an empty string if the binary cannot be read.
+    const std::string&
+    digest(const fs::path& program)
+    {
+        std::map< fs::path, std::string >::const_iterator iter =
+            _digests.find(program);
+        if (iter != _digests.end())
+            return (*iter).second;
+
+        std::string digest;
+        std::ifstream input(program.c_str(), std::ios::binary);
+        if (input) {
+            uint64_t hash = utils::fnv1a_64_basis;
+            uint64_t length = 0;
+            char buffer[65536];
+            while (input.read(buffer, sizeof(buffer)) || input.gcount() > 0) {
+                hash = utils::fnv1a_64(hash, buffer, input.gcount());
+                length += input.gcount();
+            }
+            if (input.eof())
+                digest = F("%s-%s") % format_hash(hash) % length;
+        }
+        if (digest.empty())
+            LW(F("Cannot read test program %s; not caching its results") %
+               program);
+        return (*_digests.insert(std::make_pair(program, digest)).first).second;
+    }
+
+    /// Computes the key of a test case.
+    ///
+    /// \param test_program The test program containing the test case.
+    /// \param test_case_name The name of the test case.
+    ///
+    /// \return The key, or an empty string if the test case is not cacheable.
+    const std::string&
+    key(const model::test_program& test_program,
+        const std::string& test_case_name)
+    {
+        const drivers::run_tests::test_case_id id(
+            test_program.relative_path(), test_case_name);
+        std::map< drivers::run_tests::test_case_id,
+                  std::string >::const_iterator iter = _keys.find(id);
+        if (iter != _keys.end())
+            return (*iter).second;
+
+        std::string key;
+        const std::string& binary = digest(test_program.absolute_path());
+        if (!binary.empty()) {
+            std::string descriptor;
+            append_field(descriptor, PACKAGE_VERSION);
+            append_field(descriptor, binary);
+            append_field(descriptor, test_program.interface_name());
+            append_field(descriptor, test_program.absolute_path().str());
+            append_field(descriptor, test_program.test_suite_name());
+            append_field(descriptor, test_case_name);
+            append_properties(descriptor, test_program.find(
+                test_case_name).get_metadata().to_properties());
+            append_properties(descriptor, scheduler::generate_config(
+                _user_config, test_program.test_suite_name()));
+            append_field(descriptor, _context.cwd().str());
+            append_properties(descriptor, _context.env());
+
+            key = F("%s-%s") % binary % format_hash(
+                utils::fnv1a_64(descriptor));
+        }
+        return (*_keys.insert(std::make_pair(id, key)).first).second;
+    }
+
+public:
+    /// Outputs of a test read before its cleanup, keyed by the cache key.
+    typedef std::pair< std::string, store::cached_output > pending_output;
+
+    /// Constructor.
+    ///
+    /// \param path Path to the persistent cache, or none to disable caching.
+    /// \param user_config The end-user configuration properties.
+    /// \param context The context in which the tests run.
+    ///
+    /// \throw store::error If the cache cannot be opened.
+    test_cache(const optional< fs::path >& path,
+               const config::tree& user_config,
+               const model::context& context) :
+        _user_config(user_config),
+        _context(context)
+    {
+        if (path)
+            _cache = store::result_cache::open_rw(path.get());
+    }
+
+    /// Destructor.
+    ~test_cache(void)
+    {
+        if (_cache)
+            _cache.get().close();
+    }
+
+    /// Looks up the outputs of a previous passing execution of a test case.
+    ///
+    /// \param test_program The test program containing the test case.
+    /// \param test_case_name The name of the test case.
+    ///
+    /// \return The outputs of the test case, or none if it has to run.
+    optional< store::cached_output >
+    lookup(const model::test_program& test_program,
+           const std::string& test_case_name)
+    {
+        if (!_cache)
+            return none;
+
+        const std::string& test_key = key(test_program, test_case_name);
+        if (test_key.empty())
+            return none;
+
+        try {
+            return _cache.get().lookup(test_key);
+        } catch (const store::error& e) {
+            LW(F("Failed to query the result cache: %s") % e.what());
+            return none;
+        }
+    }
+
+    /// Reads the outputs of a passing execution of a test case.
+    ///
+    /// This must happen before the cleanup of the test deletes its outputs,
+    /// but the outputs must only be passed to put() if the cleanup does not
+    /// turn the result into a failure.
+    ///
+    /// \param handle The result handle of the test, which must have passed.
+    ///
+    /// \return The outputs to cache, or none if the test is not cacheable.
+    optional< pending_output >
+    read(const scheduler::test_result_handle& handle)
+    {
+        PRE(handle.test_result().type() == model::test_result_passed);
+        if (!_cache)
+            return none;
+
+        const std::string& test_key = key(*handle.test_program(),
+                                          handle.test_case_name());
+        if (test_key.empty())
+            return none;
+
+        try {
+            return utils::make_optional(pending_output(
+                test_key, store::cached_output(
+                    utils::read_file(handle.stdout_file()),
+                    utils::read_file(handle.stderr_file()))));
+        } catch (const std::runtime_error& e) {
+            LW(F("Failed to read the outputs of the test to cache them: %s") %
+               e.what());
+            return none;
+        }
+    }
+
+    /// Records the outputs of a passing execution of a test case.
+    ///
+    /// Failures to update the cache are not fatal: they only cause the test to
+    /// run again next time.
+    ///
+    /// \param output The outputs returned by read().
+    void
+    put(const pending_output& output)
+    {
+        PRE(_cache);
+        try {
+            _cache.get().put(output.first, output.second);
+        } catch (const store::error& e) {
+            LW(F("Failed to update the result cache: %s") % e.what());
+        }
+    }
+};
+
+
+/// Records a test as passed if it passed before under the same conditions.
+///
+/// \param match Test program and test case to check.
+/// \param [in,out] tx Writable transaction to put the test results.
+/// \param [in,out] ids_cache Cache of already-put test cases.
+/// \param [in,out] cache Cache of the outputs of passing tests.
+/// \param hooks The hooks for this execution.
+///
+/// \return True if the result of the test was replayed from the cache and thus
+/// is complete; false if the test has to be started.
+static bool
+replay_cached_test(const engine::scan_result& match,
+                   store::write_transaction& tx,
+                   path_to_id_map& ids_cache,
+                   test_cache& cache,
+                   drivers::run_tests::base_hooks& hooks)
+{
+    const model::test_program_ptr test_program = match.first;
+    const std::string& test_case_name = match.second;
+
+    const optional< store::cached_output > output = cache.lookup(
+        *test_program, test_case_name);
+    if (!output)
+        return false;
+
+    hooks.got_test_case(*test_program, test_case_name);
+
+    const int64_t test_program_id = find_test_program_id(
+        test_program, tx, ids_cache);
+    const int64_t test_case_id = tx.put_test_case(
+        *test_program, test_case_name, test_program_id);
+
+    tx.put_test_case_contents("__STDOUT__", output.get().stdout_contents,
+                              test_case_id);
+    tx.put_test_case_contents("__STDERR__", output.get().stderr_contents,
+                              test_case_id);
+
+    const model::test_result test_result(model::test_result_passed,
+                                         cached_reason);
+    const datetime::timestamp now = datetime::timestamp::now();
+    tx.put_result(test_result, test_case_id, now, now);
+    hooks.got_result(*test_program, test_case_name, test_result,
+                     datetime::delta());
+    return true;
+}
+
+
+/// Records a test as skipped if its static requirements are not met.
+///
+/// This avoids spawning tests that are known upfront to be skipped, which is
+/// significantly cheaper than running them for suites that are mostly skipped
+/// on a given platform.
+///
+/// \param handle Scheduler handle.
+/// \param match Test program and test case to check.
+/// \param [in,out] tx Writable transaction to put the test results.
+/// \param [in,out] ids_cache Cache of already-put test cases.
+/// \param user_config The end-user configuration properties.
+/// \param hooks The hooks for this execution.
+///
+/// \return True if the test was skipped and thus is complete; false if the
+/// test has to be started.
+static bool
+skip_test(scheduler::scheduler_handle& handle,
+          const engine::scan_result& match,
+          store::write_transaction& tx,
+          path_to_id_map& ids_cache,
+          const config::tree& user_config,
+          drivers::run_tests::base_hooks& hooks)
+{
+    const model::test_program_ptr test_program = match.first;
+    const std::string& test_case_name = match.second;
+
+    const std::string skip_reason = handle.static_skip_reason(
+        test_program, test_case_name, user_config);
+    if (skip_reason.empty())
+        return false;
+
+    hooks.got_test_case(*test_program, test_case_name);
+
+    const int64_t test_program_id = find_test_program_id(
+        test_program, tx, ids_cache);
+    const int64_t test_case_id = tx.put_test_case(
+        *test_program, test_case_name, test_program_id);
+
+    const model::test_result test_result(model::test_result_skipped,
+                                         skip_reason);
+    const datetime::timestamp now = datetime::timestamp::now();
+    tx.put_result(test_result, test_case_id, now, now);
+    hooks.got_result(*test_program, test_case_name, test_result,
+                     datetime::delta());
+    return true;
+}
+
+
 /// Starts a test asynchronously.
 ///
 /// \param handle Scheduler handle.
@@ -185,32 +564,583 @@ start_test(scheduler::scheduler_handle& handle,
 }
 
 
+/// Starts a new attempt of a test that failed before asynchronously.
+///
+/// \param handle Scheduler handle.
+/// \param retry Test program and test case to start, and the identifier of the
+///     test case in the store as returned by the first start_test() call.
+/// \param user_config The end-user configuration properties.
+/// \param hooks The hooks for this execution.
+///
+/// \returns The PID for the started test and the test case's identifier in the
+/// store.
+static pid_and_id_pair
+restart_test(scheduler::scheduler_handle& handle,
+             const retry_entry& retry,
+             const config::tree& user_config,
+             drivers::run_tests::base_hooks& hooks)
+{
+    const model::test_program_ptr test_program = retry.second.first;
+    const std::string& test_case_name = retry.second.second;
+
+    hooks.got_test_case(*test_program, test_case_name);
+
+    const scheduler::exec_handle exec_handle = handle.spawn_test(
+        test_program, test_case_name, user_config);
+    return std::make_pair(exec_handle, retry.first);
+}
+
+
+/// Computes how many times a test case may run after failing.
+///
+/// \param test_program The test program containing the test case.
+/// \param test_case_name The name of the test case.
+/// \param retries The number of retries requested by the user for all tests.
+///
+/// \return The number of retries, which is the highest of those requested by
+/// the user and by the test case itself.
+static int
+allowed_retries(const model::test_program& test_program,
+                const std::string& test_case_name,
+                const int retries)
+{
+    return std::max(retries, test_program.find(test_case_name)
+                    .get_metadata().retries());
+}
+
+
 /// Processes the completion of a test.
 ///
+/// Tests that fail or break while they still have retries left are not given
+/// a result.  Instead, the attempt is recorded in the store and the caller is
+/// told to run the test again.
+///
 /// \param [in,out] result_handle The completion handle of the test subprocess.
 /// \param test_case_id Identifier of the test case as returned by start_test().
 /// \param [in,out] tx Writable transaction to put the test results.
+/// \param [in,out] cache Cache of the outputs of passing tests.
+/// \param retries The number of retries requested by the user for all tests.
+/// \param [in,out] attempts The attempts of the tests that have been retried.
 /// \param hooks The hooks for this execution.
 ///
+/// \return True if the test has to run again; false if it is complete.
+///
 /// \post result_handle is cleaned up.  The caller cannot clean it up again.
-void
+bool
 finish_test(scheduler::result_handle_ptr result_handle,
             const int64_t test_case_id,
             store::write_transaction& tx,
+            test_cache& cache,
+            const int retries,
+            attempts_map& attempts,
             drivers::run_tests::base_hooks& hooks)
 {
     const scheduler::test_result_handle* test_result_handle =
         dynamic_cast< const scheduler::test_result_handle* >(
             result_handle.get());
+    const model::test_program_ptr test_program =
+        test_result_handle->test_program();
+    const std::string& test_case_name = test_result_handle->test_case_name();
+
+    const attempts_map::iterator attempt_iter = attempts.find(test_case_id);
+    const int attempt = attempt_iter == attempts.end() ?
+        1 : (*attempt_iter).second;
+
+    if (!test_result_handle->test_result().good() &&
+        attempt <= allowed_retries(*test_program, test_case_name, retries)) {
+        // The attempt is recorded with the result the test reported: a failure
+        // to clean up after it is only worth a warning because the test will
+        // run again in a new work directory anyway.
+        const model::test_result test_result =
+            test_result_handle->test_result();
+        tx.put_attempt(test_result, test_case_id, attempt,
+                       result_handle->start_time(), result_handle->end_time(),
+                       test_result_handle->stdout_file(),
+                       test_result_handle->stderr_file());
+        if (safe_cleanup(*test_result_handle) != test_result)
+            LW(F("Failed to clean up attempt %s of test case %s") % attempt %
+               test_case_id);
+        attempts[test_case_id] = attempt + 1;
+
+        hooks.got_retry(
+            *test_program, test_case_name, test_result,
+            result_handle->end_time() - result_handle->start_time(), attempt);
+        return true;
+    }
+    if (attempt_iter != attempts.end())
+        attempts.erase(attempt_iter);
 
-    put_test_result(test_case_id, *test_result_handle, tx);
+    // The output files are deleted by the cleanup, so we must store them
+    // first.  The result, however, must wait for the cleanup
+    // so that any failure to remove the work directory is reported.
+    put_test_files(test_case_id, *test_result_handle, tx);
+    // A test that only passed after failing is flaky: do not cache its result
+    // so that it keeps being exercised.
+    optional< test_cache::pending_output > pending;
+    if (test_result_handle->test_result().type() ==
+        model::test_result_passed && attempt == 1)
+        pending = cache.read(*test_result_handle);
 
     const model::test_result test_result = safe_cleanup(*test_result_handle);
+    // The cleanup may still break the test, such as if its work directory
+    // cannot be removed, in which case it must run again next time.
+    if (pending && test_result.type() == model::test_result_passed)
+        cache.put(pending.get());
+    {
+        trace::span span("put_result", trace::main_track);
+        tx.put_result(test_result, test_case_id, result_handle->start_time(),
+                      result_handle->end_time());
+#if defined(HAVE_WAIT4)
+        // Without wait4(2) we cannot tell the resources of a test apart from
+        // those of its siblings, so leave the usage unset rather than
+        // recording zeros.  The same applies to tests run by a worker.
+        if (result_handle->has_usage())
+            tx.put_resource_usage(test_case_id, result_handle->usage());
+#endif
+        const std::set< int > cpus = result_handle->cpus();
+        if (!cpus.empty())
+            tx.put_cpu_affinity(test_case_id, cpus);
+    }
     hooks.got_result(
-        *test_result_handle->test_program(),
-        test_result_handle->test_case_name(),
-        test_result_handle->test_result(),
+        *test_program, test_case_name, test_result,
         result_handle->end_time() - result_handle->start_time());
+    return false;
+}
+
+
+/// Starts loading the test cases of the upcoming test programs.
+///
+/// \param handle Scheduler handle.
+/// \param scanner Scanner from which the test programs will be yielded.
+/// \param user_config The end-user configuration properties.
+/// \param lookahead Maximum number of test programs to prefetch.  This must
+///     not exceed the number of idle execution slots so that the list
+///     operations and the tests together stay within the parallelism limit.
+static void
+prefetch_test_cases(scheduler::scheduler_handle& handle,
+                    const engine::scanner& scanner,
+                    const config::tree& user_config,
+                    const std::size_t lookahead)
+{
+    const model::test_programs_vector upcoming =
+        scanner.upcoming_test_programs(lookahead);
+    for (model::test_programs_vector::const_iterator iter = upcoming.begin();
+         iter != upcoming.end(); ++iter) {
+        handle.start_list_tests(*iter, user_config);
+    }
+}
+
+
+/// Records the current value of a scheduling counter in the trace, if enabled.
+///
+/// \param name The name of the counter.
+/// \param value The value of the counter.
+static void
+trace_counter(const char* name, const std::size_t value)
+{
+    if (trace::enabled())
+        trace::counter(name, datetime::timestamp::now(), value);
+}
+
+
+/// Runs a batch of exclusive tests sequentially.
+///
+/// \pre There must be no tests in flight.
+///
+/// \param handle Scheduler handle.
+/// \param tests The exclusive tests to run.
+/// \param [in,out] tx Writable transaction to obtain test IDs.
+/// \param [in,out] ids_cache Cache of already-put test cases.
+/// \param [in,out] cache Cache of the outputs of passing tests.
+/// \param retries The number of retries requested by the user for all tests.
+/// \param [in,out] attempts The attempts of the tests that have been retried.
+/// \param user_config The end-user configuration properties.
+/// \param hooks The hooks for this execution.
+/// \param slots Number of execution slots.
+/// \param idle_since Times at which the slots drained in preparation for this
+///     batch became idle.
+///
+/// \return The slot time lost to the exclusivity barrier: the time the slots
+/// spent idle waiting for the barrier plus the time all slots but one spent
+/// idle while the exclusive tests ran.
+static datetime::delta
+run_exclusive_tests(scheduler::scheduler_handle& handle,
+                    const std::vector< engine::scan_result >& tests,
+                    store::write_transaction& tx,
+                    path_to_id_map& ids_cache,
+                    test_cache& cache,
+                    const int retries,
+                    attempts_map& attempts,
+                    const config::tree& user_config,
+                    drivers::run_tests::base_hooks& hooks,
+                    const std::size_t slots,
+                    const std::vector< datetime::timestamp >& idle_since)
+{
+    trace::span span("exclusive_batch", trace::main_track,
+                     F("%s tests") % tests.size());
+    const datetime::timestamp start_time = datetime::timestamp::now();
+
+    datetime::delta lost;
+    for (std::vector< datetime::timestamp >::const_iterator
+             iter = idle_since.begin(); iter != idle_since.end(); ++iter) {
+        if (start_time >= *iter)
+            lost += start_time - *iter;
+    }
+
+    for (std::vector< engine::scan_result >::const_iterator
+             iter = tests.begin(); iter != tests.end(); ++iter) {
+        // Retries of exclusive tests cannot overlap with any other work, so
+        // run them right away instead of requeuing them.
+        const pid_and_id_pair data = start_test(
+            handle, *iter, tx, ids_cache, user_config, hooks);
+        scheduler::result_handle_ptr result_handle = handle.wait_any();
+        while (finish_test(result_handle, data.second, tx, cache, retries,
+                           attempts, hooks)) {
+            restart_test(handle, std::make_pair(data.second, *iter),
+                         user_config, hooks);
+            result_handle = handle.wait_any();
+        }
+    }
+
+    const datetime::timestamp end_time = datetime::timestamp::now();
+    if (end_time >= start_time)
+        lost += (end_time - start_time) * (slots - 1);
+
+    LI(F("Ran %s exclusive tests; %s of slot time lost to the barrier") %
+       tests.size() % lost);
+    return lost;
+}
+
+
+/// Checks if a test case belongs to a shard by hashing its identifier.
+///
+/// We use FNV-1a instead of any library-provided hash because its result must
+/// not vary across platforms nor builds: every machine taking part in a
+/// sharded run must compute the same partition.  The 32-bit variant is used
+/// on purpose: switching hashes would reshuffle the shards of existing users.
+///
+/// \param match The test case to query.
+/// \param shard The shard to check.
+///
+/// \return True if the test case belongs to the shard; false otherwise.
+static bool
+in_hashed_shard(const engine::scan_result& match,
+                const drivers::run_tests::shard& shard)
+{
+    const std::string id = F("%s:%s") % match.first->relative_path() %
+        match.second;
+    return utils::fnv1a_32(id) % shard.count + 1 == shard.index;
+}
+
+
+/// A test case to run along with its expected duration.
+typedef std::pair< datetime::delta, engine::scan_result > timed_scan_result;
+
+
+/// Sorting predicate to put the longest tests first.
+///
+/// \param a The first test case to compare.
+/// \param b The second test case to compare.
+///
+/// \return True if a is expected to take longer than b.
+static bool
+longest_first(const timed_scan_result& a, const timed_scan_result& b)
+{
+    return a.first > b.first;
+}
+
+
+/// Computes the expected duration of a test case.
+///
+/// \param match The test case to query.
+/// \param durations Past durations of the test cases.
+///
+/// \return The duration of the test case in the past run if known; otherwise,
+/// its timeout, which is the worst case.
+static datetime::delta
+expected_duration(const engine::scan_result& match,
+                  const drivers::run_tests::durations_map& durations)
+{
+    const model::test_program_ptr test_program = match.first;
+    const std::string& test_case_name = match.second;
+
+    const drivers::run_tests::durations_map::const_iterator iter =
+        durations.find(std::make_pair(test_program->relative_path(),
+                                      test_case_name));
+    if (iter != durations.end()) {
+        return (*iter).second;
+    } else {
+        return test_program->find(test_case_name).get_metadata().timeout();
+    }
+}
+
+
+/// Keeps only the test cases that belong to a shard, balancing the shards.
+///
+/// The test cases are assigned, longest first, to the shard with the least
+/// expected work so far, which is the LPT heuristic applied to whole machines
+/// instead of to execution slots.
+///
+/// \param timed_matches The test cases with their expected durations, sorted
+///     longest first.  Every shard must compute the same collection.
+/// \param shard The shard to select.
+///
+/// \return The test cases that belong to the shard, in their original order.
+static std::vector< timed_scan_result >
+select_balanced_shard(const std::vector< timed_scan_result >& timed_matches,
+                      const drivers::run_tests::shard& shard)
+{
+    std::vector< datetime::delta > loads(shard.count);
+
+    std::vector< timed_scan_result > selected;
+    for (std::vector< timed_scan_result >::const_iterator iter =
+             timed_matches.begin(); iter != timed_matches.end(); ++iter) {
+        // min_element returns the first of the least loaded shards, which
+        // keeps the assignment deterministic when there are ties.
+        const std::vector< datetime::delta >::iterator target =
+            std::min_element(loads.begin(), loads.end());
+        *target += (*iter).first;
+        if (static_cast< std::size_t >(target - loads.begin()) + 1 ==
+            shard.index)
+            selected.push_back(*iter);
+    }
+
+    LI(F("Shard %s of %s got %s of %s test cases; expected work %s") %
+       shard.index % shard.count % selected.size() % timed_matches.size() %
+       loads[shard.index - 1]);
+    return selected;
+}
+
+
+/// Scans all test cases and sorts them to run the longest ones first.
+///
+/// This is the classic LPT (longest processing time) heuristic: dispatching the
+/// longest tests first prevents a long test from ending up alone at the tail of
+/// the run while all other execution slots sit idle.
+///
+/// \param handle Scheduler handle.
+/// \param [in,out] scanner Scanner from which to yield the test cases.  Will
+///     be done on return.
+/// \param user_config The end-user configuration properties.
+/// \param durations Past durations of the test cases.
+/// \param shard If not none, the shard to select the test cases of.
+/// \param lookahead Maximum number of test programs to list concurrently.
+///
+/// \return The collection of test cases, in the order in which to run them.
+static std::deque< engine::scan_result >
+sort_longest_first(scheduler::scheduler_handle& handle,
+                   engine::scanner& scanner,
+                   const config::tree& user_config,
+                   const drivers::run_tests::durations_map& durations,
+                   const optional< drivers::run_tests::shard >& shard,
+                   const std::size_t lookahead)
+{
+    std::vector< timed_scan_result > timed_matches;
+    for (;;) {
+        prefetch_test_cases(handle, scanner, user_config, lookahead);
+
+        const optional< engine::scan_result > match = scanner.yield();
+        if (!match)
+            break;
+        timed_matches.push_back(std::make_pair(
+            expected_duration(match.get(), durations), match.get()));
+    }
+
+    // Use a stable sort so that tests with equal durations keep the order of
+    // the scanner, which keeps the results reproducible.
+    std::stable_sort(timed_matches.begin(), timed_matches.end(),
+                     longest_first);
+    if (shard)
+        timed_matches = select_balanced_shard(timed_matches, shard.get());
+
+    std::deque< engine::scan_result > matches;
+    for (std::vector< timed_scan_result >::const_iterator iter =
+             timed_matches.begin(); iter != timed_matches.end(); ++iter) {
+        matches.push_back((*iter).second);
+    }
+    return matches;
+}
+
+
+/// Map of resource names to the number of tests that may hold them at once.
+typedef std::map< std::string, std::size_t > resources_map;
+
+
+/// Computes the resources that a test case needs while it runs.
+///
+/// The resources of a test case are the union of those declared by the test
+/// case and those declared by its test program.  The latter allows capping the
+/// concurrency of a whole test program by giving it a resource token of its
+/// own, even if the test cases override the property.
+///
+/// \param match Test program and test case to query.
+///
+/// \return The resources needed by the test.  If the same resource is named
+/// more than once, the most restrictive capacity wins.
+static resources_map
+required_resources(const engine::scan_result& match)
+{
+    const model::test_program_ptr test_program = match.first;
+    const model::test_case& test_case = test_program->find(match.second);
+
+    const model::strings_set* sources[2] = {
+        &test_program->get_metadata().required_resources(),
+        &test_case.get_metadata().required_resources(),
+    };
+
+    resources_map resources;
+    for (std::size_t i = 0; i < 2; ++i) {
+        for (model::strings_set::const_iterator iter = sources[i]->begin();
+             iter != sources[i]->end(); ++iter) {
+            const model::resource_token token = model::parse_resource(*iter);
+            const resources_map::iterator existing = resources.find(
+                token.first);
+            if (existing == resources.end())
+                resources.insert(token);
+            else
+                (*existing).second = std::min((*existing).second,
+                                              token.second);
+        }
+    }
+    return resources;
+}
+
+
+/// Tracks the resources held by the tests in flight.
+///
+/// A test may acquire a resource if the number of tests already holding it is
+/// lower than the capacity requested by the test and by all the current
+/// holders.  Honoring the capacity of the holders keeps a test that asked for
+/// exclusive access from sharing the resource with a more lenient one.
+class resource_pool : utils::noncopyable {
+    /// Capacities requested by the holders of each resource.
+    typedef std::map< std::string, std::multiset< std::size_t > > holders_map;
+
+    /// Current holders of every resource in use.
+    holders_map _holders;
+
+    /// Resources held by every in-flight test, keyed by PID.
+    std::map< int, resources_map > _held;
+
+public:
+    /// Checks if a test could acquire its resources right now.
+    ///
+    /// \param resources The resources needed by the test.
+    ///
+    /// \return True if none of the resources is exhausted.
+    bool
+    can_acquire(const resources_map& resources) const
+    {
+        for (resources_map::const_iterator iter = resources.begin();
+             iter != resources.end(); ++iter) {
+            const holders_map::const_iterator holders = _holders.find(
+                (*iter).first);
+            if (holders == _holders.end())
+                continue;
+            const std::multiset< std::size_t >& capacities = (*holders).second;
+            INV(!capacities.empty());
+            const std::size_t limit = std::min((*iter).second,
+                                               *capacities.begin());
+            if (capacities.size() >= limit)
+                return false;
+        }
+        return true;
+    }
+
+    /// Records that a test holds a set of resources.
+    ///
+    /// \pre can_acquire(resources) must be true.
+    ///
+    /// \param pid PID of the test that acquires the resources.
+    /// \param resources The resources needed by the test.
+    void
+    acquire(const int pid, const resources_map& resources)
+    {
+        PRE(can_acquire(resources));
+        if (resources.empty())
+            return;
+
+        PRE(_held.find(pid) == _held.end());
+        _held.insert(std::make_pair(pid, resources));
+        for (resources_map::const_iterator iter = resources.begin();
+             iter != resources.end(); ++iter) {
+            _holders[(*iter).first].insert((*iter).second);
+        }
+    }
+
+    /// Returns the resources held by a test to the pool.
+    ///
+    /// \param pid PID of the test that finished.
+    ///
+    /// \return True if the test held any resources.
+    bool
+    release(const int pid)
+    {
+        const std::map< int, resources_map >::iterator held = _held.find(pid);
+        if (held == _held.end())
+            return false;
+
+        const resources_map& resources = (*held).second;
+        for (resources_map::const_iterator iter = resources.begin();
+             iter != resources.end(); ++iter) {
+            const holders_map::iterator holders = _holders.find(
+                (*iter).first);
+            INV(holders != _holders.end());
+            std::multiset< std::size_t >& capacities = (*holders).second;
+            capacities.erase(capacities.find((*iter).second));
+            if (capacities.empty())
+                _holders.erase(holders);
+        }
+        _held.erase(held);
+        return true;
+    }
+};
+
+
+/// Extracts the first blocked test that can acquire its resources.
+///
+/// \param [in,out] blocked_tests Tests waiting for resources, in the order in
+///     which they were deferred.
+/// \param resources The resources held by the tests in flight.
+///
+/// \return The test to run, if any.
+static optional< engine::scan_result >
+pop_runnable(std::deque< engine::scan_result >& blocked_tests,
+             const resource_pool& resources)
+{
+    for (std::deque< engine::scan_result >::iterator
+             iter = blocked_tests.begin(); iter != blocked_tests.end();
+         ++iter) {
+        if (resources.can_acquire(required_resources(*iter))) {
+            const engine::scan_result match = *iter;
+            blocked_tests.erase(iter);
+            return utils::make_optional(match);
+        }
+    }
+    return none;
+}
+
+
+/// Extracts the first test to retry that can acquire its resources.
+///
+/// \param [in,out] retry_tests Tests waiting to run again, in the order in
+///     which they failed.
+/// \param resources The resources held by the tests in flight.
+///
+/// \return The test to run, if any.
+static optional< retry_entry >
+pop_runnable_retry(std::deque< retry_entry >& retry_tests,
+                   const resource_pool& resources)
+{
+    for (std::deque< retry_entry >::iterator iter = retry_tests.begin();
+         iter != retry_tests.end(); ++iter) {
+        if (resources.can_acquire(required_resources((*iter).second))) {
+            const retry_entry retry = *iter;
+            retry_tests.erase(iter);
+            return utils::make_optional(retry);
+        }
+    }
+    return none;
 }
 
 
@@ -231,6 +1161,24 @@ format_pids(const pid_to_id_map& map)
 }
 
 
+/// Returns the jobserver tokens that the tests in flight do not need.
+///
+/// The first test in flight runs on the implicit token that make grants to
+/// every recipe, so we only need one token for every other test.
+///
+/// \param jobserver The jobserver to return the tokens to, if any.
+/// \param in_flight Number of tests currently running.
+static void
+release_tokens(optional< utils::jobserver >& jobserver,
+               const std::size_t in_flight)
+{
+    if (!jobserver)
+        return;
+    while (jobserver.get().held() > 0 && jobserver.get().held() >= in_flight)
+        jobserver.get().release();
+}
+
+
 }  // anonymous namespace
 
 
@@ -240,6 +1188,38 @@ drivers::run_tests::base_hooks::~base_hooks(void)
 }
 
 
+/// Loads the durations of the test cases of a previous run.
+///
+/// \param results_file The path to the results file of the previous run.
+///
+/// \return The duration of every test case in the results file.
+///
+/// \throw store::error If the results file cannot be read.
+drivers::run_tests::durations_map
+drivers::run_tests::load_durations(const fs::path& results_file)
+{
+    durations_map durations;
+
+    store::read_backend db = store::read_backend::open_ro(results_file);
+    store::read_transaction tx = db.start_read();
+    for (store::results_iterator iter = tx.get_results(); iter; ++iter) {
+        // Guard against clock adjustments during the previous run, which could
+        // yield negative durations.
+        const datetime::timestamp start_time = iter.start_time();
+        const datetime::timestamp end_time = iter.end_time();
+        const datetime::delta duration = end_time >= start_time ?
+            end_time - start_time : datetime::delta();
+
+        durations[std::make_pair(iter.test_program()->relative_path(),
+                                 iter.test_case_name())] = duration;
+    }
+    tx.finish();
+    db.close();
+
+    return durations;
+}
+
+
 /// Executes the operation.
 ///
 /// \param kyuafile_path The path to the Kyuafile to be loaded.
@@ -247,6 +1227,19 @@ drivers::run_tests::base_hooks::~base_hooks(void)
 /// \param store_path The path to the store to be used.
 /// \param filters The test case filters as provided by the user.
 /// \param user_config The end-user configuration properties.
+/// \param durations If not none, past durations of the test cases, in which
+///     case the test cases are run longest-first instead of in scanning order.
+/// \param shard If not none, the subset of the test cases to run.  The shards
+///     are balanced by the past durations of the test cases if known, so all
+///     the shards of a run must be given the same durations.
+/// \param retries Number of times to run again the tests that fail or break.
+///     Test cases can ask for more retries in their metadata.
+/// \param result_cache_path If not none, path to the cache of the outputs of
+///     passing tests.  Tests found in the cache are not run and are reported as
+///     passed with their cached outputs.
+/// \param list_cache_path If not none, path to the cache of test cases lists.
+///     Test programs whose binaries did not change since they were cached are
+///     not executed to list their test cases.
 /// \param hooks The hooks for this execution.
 ///
 /// \returns A structure with all results computed by this driver.
@@ -256,47 +1249,184 @@ drivers::run_tests::drive(const fs::path& kyuafile_path,
                           const fs::path& store_path,
                           const std::set< engine::test_filter >& filters,
                           const config::tree& user_config,
+                          const optional< durations_map >& durations,
+                          const optional< shard >& shard,
+                          const int retries,
+                          const optional< fs::path >& result_cache_path,
+                          const optional< fs::path >& list_cache_path,
                           base_hooks& hooks)
 {
+    INV(!shard || (shard.get().index >= 1 &&
+                   shard.get().index <= shard.get().count));
+    PRE(retries >= 0);
+
     scheduler::scheduler_handle handle = scheduler::setup();
+    if (list_cache_path)
+        handle.enable_list_cache(list_cache_path.get());
 
     const engine::kyuafile kyuafile = engine::kyuafile::load(
         kyuafile_path, build_root, user_config, handle);
     store::write_backend db = store::write_backend::open_rw(store_path);
     store::write_transaction tx = db.start_write();
 
-    {
-        const model::context context = scheduler::current_context();
-        (void)tx.put_context(context);
-    }
+    const model::context context = scheduler::current_context();
+    (void)tx.put_context(context);
+
+    test_cache cache(result_cache_path, user_config, context);
 
     engine::scanner scanner(kyuafile.test_programs(), filters);
 
     path_to_id_map ids_cache;
     pid_to_id_map in_flight;
+    resource_pool resources;
+    std::deque< engine::scan_result > blocked_tests;
+    bool retry_blocked = false;
+    std::deque< retry_entry > retry_tests;
+    attempts_map attempts;
     std::vector< engine::scan_result > exclusive_tests;
+    std::vector< datetime::timestamp > idle_since;
+    datetime::delta barrier_time;
 
-    const std::size_t slots = user_config.lookup< config::positive_int_node >(
-        "parallelism");
+    // The number of execution slots may vary during the run within these
+    // bounds; see the update of the slots below.
+    const engine::parallelism_range parallelism =
+        user_config.lookup< engine::parallelism_node >("parallelism");
+    engine::parallelism_controller controller(parallelism);
+    const std::size_t max_slots = parallelism.max;
+    std::size_t slots = controller.slots();
     INV(slots >= 1);
+
+    // When run from make -jN, every test beyond the first needs a token from
+    // the jobserver of make so that we do not oversubscribe the machine along
+    // with the other recipes of the build.
+    optional< utils::jobserver > jobserver =
+        utils::jobserver::from_environment();
+
+    // Exclusive tests are deferred until we have accumulated one of these
+    // batches.  At that point, we stop spawning other tests, let the slots
+    // drain, and run the batch before resuming.  Batching amortizes the cost
+    // of draining the slots while keeping the end of the run parallel.
+    const std::size_t exclusive_batch_size = max_slots;
+    bool draining = false;
+
+    // When running longest-first, we must know all test cases upfront to sort
+    // them, so drain the scanner now.
+    std::deque< engine::scan_result > sorted_tests;
+    if (durations) {
+        sorted_tests = sort_longest_first(handle, scanner, user_config,
+                                          durations.get(), shard, slots);
+    }
+
     do {
-        INV(in_flight.size() <= slots);
+        // Adapt the number of slots to the pressure of the system.  Shrinking
+        // them below the number of tests in flight just holds off new tests
+        // until enough of the running ones finish.
+        if (parallelism.adaptive()) {
+            const datetime::timestamp now = datetime::timestamp::now();
+            if (controller.due(now)) {
+                slots = controller.update(utils::system_pressure(), now);
+                trace_counter("slots", slots);
+            }
+        }
+        INV(in_flight.size() <= max_slots);
 
         // Spawn as many jobs as needed to fill our execution slots.  We do this
         // first with the assumption that the spawning is faster than any single
         // job, so we want to keep as many jobs in the background as possible.
-        while (in_flight.size() < slots) {
-            optional< engine::scan_result > match = scanner.yield();
-            if (!match)
+        while (!draining && in_flight.size() < slots) {
+            // If no token is available, we just wait for one of our own tests
+            // to finish and try again.  The tokens we already hold but did
+            // not use because the previous iterations spawned nothing stay
+            // with us for the next test.
+            if (jobserver && in_flight.size() > jobserver.get().held() &&
+                !jobserver.get().try_acquire())
                 break;
+
+            // Tests that were waiting for resources take precedence over new
+            // ones so that they are not starved.  Acquiring resources never
+            // unblocks anything, so we only look at the blocked tests again
+            // after a release.
+            optional< engine::scan_result > match;
+            if (retry_blocked) {
+                match = pop_runnable(blocked_tests, resources);
+                if (!match)
+                    retry_blocked = false;
+            }
+            if (!match && !sorted_tests.empty()) {
+                match = sorted_tests.front();
+                sorted_tests.pop_front();
+            } else if (!match) {
+                // Keep the list operations of the test programs we will soon
+                // need running in parallel with the tests so that yield()
+                // rarely has to block on a listing.  Listings occupy the idle
+                // slots only, so that they never oversubscribe the machine.
+                prefetch_test_cases(handle, scanner, user_config,
+                                    slots - in_flight.size());
+
+                match = scanner.yield();
+
+                // Without durations to balance the shards with, test cases are
+                // assigned to the shards by a stable hash of their identifiers.
+                if (match && shard &&
+                    !in_hashed_shard(match.get(), shard.get()))
+                    continue;
+            }
+            if (!match) {
+                // Failed tests run again only once there is no new work left
+                // so that their retries fill the slots that would otherwise
+                // sit idle at the end of the run.
+                const optional< retry_entry > retry = pop_runnable_retry(
+                    retry_tests, resources);
+                if (!retry)
+                    break;
+
+                const pid_and_id_pair pid_id = restart_test(
+                    handle, retry.get(), user_config, hooks);
+                INV_MSG(in_flight.find(pid_id.first) == in_flight.end(),
+                        F("Spawned test has PID of still-tracked process %s") %
+                        pid_id.first);
+                in_flight.insert(pid_id);
+                trace_counter("in_flight", in_flight.size());
+                resources.acquire(pid_id.first,
+                                  required_resources(retry.get().second));
+                continue;
+            }
             const model::test_program_ptr test_program = match.get().first;
             const std::string& test_case_name = match.get().second;
 
+            // Tests that are going to be skipped need neither a slot nor any
+            // of the exclusivity and resource handling below.
+            if (skip_test(handle, match.get(), tx, ids_cache, user_config,
+                          hooks))
+                continue;
+
+            // Tests that passed before under the same conditions need neither.
+            if (replay_cached_test(match.get(), tx, ids_cache, cache, hooks))
+                continue;
+
             const model::test_case& test_case = test_program->find(
                 test_case_name);
             if (test_case.get_metadata().is_exclusive()) {
-                // Exclusive tests get processed later, separately.
+                // Exclusive tests get processed later, in batches.
                 exclusive_tests.push_back(match.get());
+                if (exclusive_tests.size() >= exclusive_batch_size) {
+                    // Any slots that we cannot fill any longer are idle from
+                    // now on until the batch runs.
+                    draining = true;
+                    if (slots > in_flight.size()) {
+                        idle_since.insert(idle_since.end(),
+                                          slots - in_flight.size(),
+                                          datetime::timestamp::now());
+                    }
+                }
+                continue;
+            }
+
+            // Tests that share a resource with the tests in flight wait until
+            // the resource is released.
+            const resources_map needed = required_resources(match.get());
+            if (!resources.can_acquire(needed)) {
+                blocked_tests.push_back(match.get());
                 continue;
             }
 
@@ -306,13 +1436,23 @@ drivers::run_tests::drive(const fs::path& kyuafile_path,
                     F("Spawned test has PID of still-tracked process %s") %
                     pid_id.first);
             in_flight.insert(pid_id);
+            trace_counter("in_flight", in_flight.size());
+            resources.acquire(pid_id.first, needed);
         }
 
+        // Do not sit on tokens that we acquired but found nothing to run with
+        // while we block waiting for our tests.
+        release_tokens(jobserver, in_flight.size());
+
         // If there are any used slots, consume any at random and return the
         // result.  We consume slots one at a time to give preference to the
         // spawning of new tests as detailed above.
         if (!in_flight.empty()) {
-            scheduler::result_handle_ptr result_handle = handle.wait_any();
+            scheduler::result_handle_ptr result_handle;
+            {
+                trace::span span("wait_any", trace::main_track);
+                result_handle = handle.wait_any();
+            }
 
             const pid_to_id_map::iterator iter = in_flight.find(
                 result_handle->original_pid());
@@ -321,24 +1461,48 @@ drivers::run_tests::drive(const fs::path& kyuafile_path,
                     result_handle->original_pid() % format_pids(in_flight));
             const int64_t test_case_id = (*iter).second;
             in_flight.erase(iter);
+            trace_counter("in_flight", in_flight.size());
+            if (resources.release(result_handle->original_pid()))
+                retry_blocked = true;
+
+            const scheduler::test_result_handle* test_result_handle =
+                dynamic_cast< const scheduler::test_result_handle* >(
+                    result_handle.get());
+            const engine::scan_result match(
+                test_result_handle->test_program(),
+                test_result_handle->test_case_name());
+            if (finish_test(result_handle, test_case_id, tx, cache, retries,
+                            attempts, hooks))
+                retry_tests.push_back(std::make_pair(test_case_id, match));
 
-            finish_test(result_handle, test_case_id, tx, hooks);
+            if (draining)
+                idle_since.push_back(datetime::timestamp::now());
+
+            release_tokens(jobserver, in_flight.size());
         }
-    } while (!in_flight.empty() || !scanner.done());
 
-    // Run any exclusive tests that we spotted earlier sequentially.
-    for (std::vector< engine::scan_result >::const_iterator
-             iter = exclusive_tests.begin(); iter != exclusive_tests.end();
-             ++iter) {
-        const pid_and_id_pair data = start_test(
-            handle, *iter, tx, ids_cache, user_config, hooks);
-        scheduler::result_handle_ptr result_handle = handle.wait_any();
-        finish_test(result_handle, data.second, tx, hooks);
+        if (draining && in_flight.empty()) {
+            barrier_time += run_exclusive_tests(
+                handle, exclusive_tests, tx, ids_cache, cache, retries,
+                attempts, user_config, hooks, slots, idle_since);
+            exclusive_tests.clear();
+            idle_since.clear();
+            draining = false;
+        }
+    } while (!in_flight.empty() || !blocked_tests.empty() ||
+             !retry_tests.empty() || !sorted_tests.empty() ||
+             !scanner.done());
+
+    // Run any exclusive tests that did not fill a whole batch.
+    if (!exclusive_tests.empty()) {
+        barrier_time += run_exclusive_tests(
+            handle, exclusive_tests, tx, ids_cache, cache, retries, attempts,
+            user_config, hooks, slots, idle_since);
     }
 
     tx.commit();
 
     handle.cleanup();
 
-    return result(scanner.unused_filters());
+    return result(scanner.unused_filters(), barrier_time);
 }
@@ -36,14 +36,17 @@
 #if !defined(DRIVERS_RUN_TESTS_HPP)
 #define DRIVERS_RUN_TESTS_HPP
 
+#include <cstddef>
+#include <map>
 #include <set>
 #include <string>
+#include <utility>
 
 #include "engine/filters.hpp"
 #include "model/test_program.hpp"
 #include "model/test_result_fwd.hpp"
 #include "utils/config/tree_fwd.hpp"
-#include "utils/datetime_fwd.hpp"
+#include "utils/datetime.hpp"
 #include "utils/fs/path_fwd.hpp"
 #include "utils/optional_fwd.hpp"
 
@@ -73,6 +76,52 @@ public:
                             const std::string& test_case_name,
                             const model::test_result& result,
                             const utils::datetime::delta& duration) = 0;
+
+    /// Called when a test case failed and is going to run again.
+    ///
+    /// \param test_program The test program containing the test case.
+    /// \param test_case_name The name of the executed test case.
+    /// \param result The result of the failed attempt.
+    /// \param duration The time it took to run the failed attempt.
+    /// \param attempt The number of the failed attempt, starting at 1.
+    virtual void got_retry(const model::test_program& test_program,
+                           const std::string& test_case_name,
+                           const model::test_result& result,
+                           const utils::datetime::delta& duration,
+                           const int attempt) = 0;
+};
+
+
+/// Identifier of a test case: its test program path and its name.
+typedef std::pair< utils::fs::path, std::string > test_case_id;
+
+
+/// Collection of the past durations of test cases.
+typedef std::map< test_case_id, utils::datetime::delta > durations_map;
+
+
+/// Selection of the subset of the tests to run on this machine.
+///
+/// The tests are partitioned into a number of shards in a deterministic manner
+/// so that separate runs, possibly on different machines, can execute disjoint
+/// subsets of the same test suite.
+class shard {
+public:
+    /// One-based index of the shard to run.
+    std::size_t index;
+
+    /// Total number of shards.
+    std::size_t count;
+
+    /// Initializer for the tuple's fields.
+    ///
+    /// \param index_ One-based index of the shard to run.
+    /// \param count_ Total number of shards.
+    shard(const std::size_t index_, const std::size_t count_) :
+        index(index_),
+        count(count_)
+    {
+    }
 };
 
 
@@ -85,19 +134,37 @@ public:
     /// test filter does not match any test case, it is probably a typo.
     std::set< engine::test_filter > unused_filters;
 
+    /// Slot time lost because of the execution of exclusive tests.
+    ///
+    /// This accounts for the time during which execution slots sat idle, either
+    /// waiting for other tests to finish before running exclusive tests or
+    /// while the exclusive tests ran.
+    utils::datetime::delta exclusive_barrier_time;
+
     /// Initializer for the tuple's fields.
     ///
     /// \param unused_filters_ The filters that did not match any test case.
-    result(const std::set< engine::test_filter >& unused_filters_) :
-        unused_filters(unused_filters_)
+    /// \param exclusive_barrier_time_ Slot time lost because of the execution
+    ///     of exclusive tests.
+    result(const std::set< engine::test_filter >& unused_filters_,
+           const utils::datetime::delta& exclusive_barrier_time_) :
+        unused_filters(unused_filters_),
+        exclusive_barrier_time(exclusive_barrier_time_)
     {
     }
 };
 
 
+durations_map load_durations(const utils::fs::path&);
+
+
 result drive(const utils::fs::path&, const utils::optional< utils::fs::path >,
              const utils::fs::path&, const std::set< engine::test_filter >&,
-             const utils::config::tree&, base_hooks&);
+             const utils::config::tree&,
+             const utils::optional< durations_map >&,
+             const utils::optional< shard >&, const int,
+             const utils::optional< utils::fs::path >&,
+             const utils::optional< utils::fs::path >&, base_hooks&);
 
 
 }  // namespace run_tests
@@ -49,11 +49,13 @@ extern "C" {
 #include "utils/logging/macros.hpp"
 #include "utils/optional.ipp"
 #include "utils/process/exceptions.hpp"
+#include "utils/process/executor.hpp"
 #include "utils/process/operations.hpp"
 #include "utils/process/status.hpp"
 #include "utils/stream.hpp"
 
 namespace config = utils::config;
+namespace executor = utils::process::executor;
 namespace fs = utils::fs;
 namespace process = utils::process;
 
@@ -163,6 +165,35 @@ engine::atf_interface::parse_list(const optional< process::status >& status,
 }
 
 
+/// Describes the program that exec_test() executes.
+///
+/// \param test_program The test program to execute.
+/// \param test_case_name Name of the test case to invoke.
+/// \param vars User-provided variables to pass to the test program.
+/// \param control_directory Directory where the interface may place control
+///     files.
+///
+/// \return The program to execute.
+optional< executor::command >
+engine::atf_interface::test_command(const model::test_program& test_program,
+                                    const std::string& test_case_name,
+                                    const config::properties_map& vars,
+                                    const fs::path& control_directory) const
+{
+    executor::command command(test_program.absolute_path());
+    command.environment["__RUNNING_INSIDE_ATF_RUN"] = "internal-yes-value";
+
+    for (config::properties_map::const_iterator iter = vars.begin();
+         iter != vars.end(); ++iter) {
+        command.args.push_back(F("-v%s=%s") % (*iter).first % (*iter).second);
+    }
+
+    command.args.push_back(F("-r%s") % (control_directory / result_name));
+    command.args.push_back(test_case_name);
+    return utils::make_optional(command);
+}
+
+
 /// Executes a test case of the test program.
 ///
 /// This method is intended to be called within a subprocess and is expected
@@ -180,17 +211,8 @@ engine::atf_interface::exec_test(const model::test_program& test_program,
                                  const config::properties_map& vars,
                                  const fs::path& control_directory) const
 {
-    utils::setenv("__RUNNING_INSIDE_ATF_RUN", "internal-yes-value");
-
-    process::args_vector args;
-    for (config::properties_map::const_iterator iter = vars.begin();
-         iter != vars.end(); ++iter) {
-        args.push_back(F("-v%s=%s") % (*iter).first % (*iter).second);
-    }
-
-    args.push_back(F("-r%s") % (control_directory / result_name));
-    args.push_back(test_case_name);
-    process::exec(test_program.absolute_path(), args);
+    executor::exec(atf_interface::test_command(
+        test_program, test_case_name, vars, control_directory).get());
 }
 
 
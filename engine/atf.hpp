@@ -48,6 +48,11 @@ public:
         const utils::fs::path&,
         const utils::fs::path&) const;
 
+    utils::optional< utils::process::executor::command > test_command(
+        const model::test_program&, const std::string&,
+        const utils::config::properties_map&,
+        const utils::fs::path&) const;
+
     void exec_test(const model::test_program&, const std::string&,
                    const utils::config::properties_map&,
                    const utils::fs::path&) const
@@ -38,14 +38,17 @@
 #include "utils/config/exceptions.hpp"
 #include "utils/config/parser.hpp"
 #include "utils/config/tree.ipp"
+#include "utils/format/macros.hpp"
 #include "utils/passwd.hpp"
 #include "utils/text/exceptions.hpp"
 #include "utils/text/operations.ipp"
+#include "utils/units.hpp"
 
 namespace config = utils::config;
 namespace fs = utils::fs;
 namespace passwd = utils::passwd;
 namespace text = utils::text;
+namespace units = utils::units;
 
 
 namespace {
@@ -59,7 +62,11 @@ static void
 init_tree(config::tree& tree)
 {
     tree.define< config::string_node >("architecture");
-    tree.define< config::positive_int_node >("parallelism");
+    tree.define< config::bool_node >("cpu_affinity");
+    tree.define< config::positive_int_node >("cpu_time_limit");
+    tree.define< config::bool_node >("list_cache");
+    tree.define< engine::bytes_node >("memory_limit");
+    tree.define< engine::parallelism_node >("parallelism");
     tree.define< config::string_node >("platform");
     tree.define< engine::user_node >("unprivileged_user");
     tree.define_dynamic("test_suites");
@@ -77,7 +84,8 @@ set_defaults(config::tree& tree)
     // TODO(jmmv): Automatically derive this from the number of CPUs in the
     // machine and forcibly set to a value greater than 1.  Still testing
     // the new parallel implementation as of 2015-02-27 though.
-    tree.set< config::positive_int_node >("parallelism", 1);
+    tree.set< engine::parallelism_node >("parallelism",
+                                         engine::parallelism_range(1, 1));
     tree.set< config::string_node >("platform", KYUA_PLATFORM);
 }
 
@@ -198,6 +206,155 @@ engine::user_node::to_string(void) const
 }
 
 
+/// Copies the node.
+///
+/// \return A dynamically-allocated node.
+config::detail::base_node*
+engine::bytes_node::deep_copy(void) const
+{
+    std::auto_ptr< bytes_node > new_node(new bytes_node());
+    new_node->_value = _value;
+    return new_node.release();
+}
+
+
+/// Pushes the node's value onto the Lua stack.
+///
+/// \param state The Lua state onto which to push the value.
+void
+engine::bytes_node::push_lua(lutok::state& state) const
+{
+    state.push_string(F("%s") % static_cast< uint64_t >(value()));
+}
+
+
+/// Sets the value of the node from an entry in the Lua stack.
+///
+/// \param state The Lua state from which to get the value.
+/// \param value_index The stack index in which the value resides.
+///
+/// \throw value_error If the value in state(value_index) cannot be
+///     processed by this node.
+void
+engine::bytes_node::set_lua(lutok::state& state, const int value_index)
+{
+    if (state.is_number(value_index)) {
+        const long raw_value = state.to_integer(value_index);
+        if (raw_value < 0)
+            throw config::value_error("Bytes quantity cannot be negative");
+        config::typed_leaf_node< units::bytes >::set(
+            units::bytes(static_cast< uint64_t >(raw_value)));
+    } else if (state.is_string(value_index)) {
+        set_string(state.to_string(value_index));
+    } else
+        throw config::value_error("Invalid bytes quantity");
+}
+
+
+void
+engine::bytes_node::set_string(const std::string& raw_value)
+{
+    try {
+        config::typed_leaf_node< units::bytes >::set(
+            units::bytes::parse(raw_value));
+    } catch (const std::runtime_error& e) {
+        throw config::value_error(e.what());
+    }
+}
+
+
+std::string
+engine::bytes_node::to_string(void) const
+{
+    return config::typed_leaf_node< units::bytes >::value().format();
+}
+
+
+/// Copies the node.
+///
+/// \return A dynamically-allocated node.
+config::detail::base_node*
+engine::parallelism_node::deep_copy(void) const
+{
+    std::auto_ptr< parallelism_node > new_node(new parallelism_node());
+    new_node->_value = _value;
+    return new_node.release();
+}
+
+
+/// Pushes the node's value onto the Lua stack.
+///
+/// Fixed values are pushed as numbers to remain compatible with the
+/// configuration files that predate adaptive parallelism.
+///
+/// \param state The Lua state onto which to push the value.
+void
+engine::parallelism_node::push_lua(lutok::state& state) const
+{
+    if (value().adaptive())
+        state.push_string(value().format());
+    else
+        state.push_integer(static_cast< int >(value().max));
+}
+
+
+/// Sets the value of the node from an entry in the Lua stack.
+///
+/// \param state The Lua state from which to get the value.
+/// \param value_index The stack index in which the value resides.
+///
+/// \throw value_error If the value in state(value_index) cannot be
+///     processed by this node.
+void
+engine::parallelism_node::set_lua(lutok::state& state, const int value_index)
+{
+    if (state.is_number(value_index) || state.is_string(value_index))
+        set_string(state.to_string(value_index));
+    else
+        throw config::value_error("Invalid parallelism");
+}
+
+
+/// Sets the value of the node from a raw string representation.
+///
+/// \param raw_value Either a single positive integer for a fixed parallelism
+///     or two of them separated by two dots, as in "4..32", for an adaptive
+///     one.
+///
+/// \throw value_error If the value is invalid.
+void
+engine::parallelism_node::set_string(const std::string& raw_value)
+{
+    const std::string::size_type pos = raw_value.find("..");
+    const std::string min_str = raw_value.substr(0, pos);
+    const std::string max_str = pos == std::string::npos ?
+        raw_value : raw_value.substr(pos + 2);
+
+    int min, max;
+    try {
+        min = text::to_type< int >(min_str);
+        max = text::to_type< int >(max_str);
+    } catch (const text::value_error& e) {
+        throw config::value_error(F("Invalid parallelism '%s'") % raw_value);
+    }
+    if (min <= 0 || max <= 0)
+        throw config::value_error("Must be a positive integer");
+    if (min > max)
+        throw config::value_error(
+            F("Minimum parallelism %s is greater than the maximum %s") %
+            min % max);
+
+    set(engine::parallelism_range(min, max));
+}
+
+
+std::string
+engine::parallelism_node::to_string(void) const
+{
+    return value().format();
+}
+
+
 /// Constructs a config with the built-in settings.
 config::tree
 engine::default_config(void)
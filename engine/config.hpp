@@ -34,10 +34,12 @@
 
 #include "engine/config_fwd.hpp"
 
+#include "engine/parallelism.hpp"
 #include "utils/config/nodes.hpp"
 #include "utils/config/tree_fwd.hpp"
 #include "utils/fs/path_fwd.hpp"
 #include "utils/passwd_fwd.hpp"
+#include "utils/units.hpp"
 
 namespace engine {
 
@@ -55,6 +57,34 @@ public:
 };
 
 
+/// Tree node to hold a quantity of bytes.
+class bytes_node :
+    public utils::config::typed_leaf_node< utils::units::bytes > {
+public:
+    virtual base_node* deep_copy(void) const;
+
+    void push_lua(lutok::state&) const;
+    void set_lua(lutok::state&, const int);
+
+    void set_string(const std::string&);
+    std::string to_string(void) const;
+};
+
+
+/// Tree node to hold the bounds on the number of concurrent test cases.
+class parallelism_node :
+    public utils::config::typed_leaf_node< parallelism_range > {
+public:
+    virtual base_node* deep_copy(void) const;
+
+    void push_lua(lutok::state&) const;
+    void set_lua(lutok::state&, const int);
+
+    void set_string(const std::string&);
+    std::string to_string(void) const;
+};
+
+
 utils::config::tree default_config(void);
 utils::config::tree empty_config(void);
 utils::config::tree load_config(const utils::fs::path&);
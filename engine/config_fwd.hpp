@@ -35,6 +35,8 @@
 namespace engine {
 
 
+class bytes_node;
+class parallelism_node;
 class user_node;
 
 
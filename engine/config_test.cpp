@@ -42,10 +42,12 @@
 #include "utils/cmdline/parser.hpp"
 #include "utils/config/tree.ipp"
 #include "utils/passwd.hpp"
+#include "utils/units.hpp"
 
 namespace config = utils::config;
 namespace fs = utils::fs;
 namespace passwd = utils::passwd;
+namespace units = utils::units;
 
 using utils::none;
 using utils::optional;
@@ -78,9 +80,17 @@ validate_defaults(const config::tree& config)
         KYUA_ARCHITECTURE,
         config.lookup< config::string_node >("architecture"));
 
+    ATF_REQUIRE(!config.is_set("cpu_affinity"));
+
+    ATF_REQUIRE(!config.is_set("cpu_time_limit"));
+
+    ATF_REQUIRE(!config.is_set("list_cache"));
+
+    ATF_REQUIRE(!config.is_set("memory_limit"));
+
     ATF_REQUIRE_EQ(
-        1,
-        config.lookup< config::positive_int_node >("parallelism"));
+        engine::parallelism_range(1, 1),
+        config.lookup< engine::parallelism_node >("parallelism"));
 
     ATF_REQUIRE_EQ(
         KYUA_PLATFORM,
@@ -108,12 +118,95 @@ ATF_TEST_CASE_BODY(config__set__parallelism)
 {
     config::tree user_config = engine::default_config();
     user_config.set_string("parallelism", "8");
+    ATF_REQUIRE_EQ(engine::parallelism_range(8, 8),
+                   user_config.lookup< engine::parallelism_node >(
+                       "parallelism"));
     ATF_REQUIRE_THROW_RE(
         config::error, "parallelism.*Must be a positive integer",
         user_config.set_string("parallelism", "0"));
     ATF_REQUIRE_THROW_RE(
         config::error, "parallelism.*Must be a positive integer",
         user_config.set_string("parallelism", "-1"));
+    ATF_REQUIRE_THROW_RE(
+        config::error, "parallelism.*Invalid parallelism 'many'",
+        user_config.set_string("parallelism", "many"));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(config__set__parallelism_range);
+ATF_TEST_CASE_BODY(config__set__parallelism_range)
+{
+    config::tree user_config = engine::default_config();
+    user_config.set_string("parallelism", "4..32");
+    ATF_REQUIRE_EQ(engine::parallelism_range(4, 32),
+                   user_config.lookup< engine::parallelism_node >(
+                       "parallelism"));
+    ATF_REQUIRE_EQ("4..32", user_config.lookup_string("parallelism"));
+
+    user_config.set_string("parallelism", "3..3");
+    ATF_REQUIRE_EQ("3", user_config.lookup_string("parallelism"));
+
+    ATF_REQUIRE_THROW_RE(
+        config::error, "parallelism.*Must be a positive integer",
+        user_config.set_string("parallelism", "0..4"));
+    ATF_REQUIRE_THROW_RE(
+        config::error, "parallelism.*greater than the maximum",
+        user_config.set_string("parallelism", "8..4"));
+    ATF_REQUIRE_THROW_RE(
+        config::error, "parallelism.*Invalid parallelism '4..'",
+        user_config.set_string("parallelism", "4.."));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(config__set__cpu_affinity);
+ATF_TEST_CASE_BODY(config__set__cpu_affinity)
+{
+    config::tree user_config = engine::default_config();
+    user_config.set_string("cpu_affinity", "true");
+    ATF_REQUIRE(user_config.lookup< config::bool_node >("cpu_affinity"));
+    ATF_REQUIRE_THROW_RE(
+        config::error, "cpu_affinity",
+        user_config.set_string("cpu_affinity", "sometimes"));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(config__set__list_cache);
+ATF_TEST_CASE_BODY(config__set__list_cache)
+{
+    config::tree user_config = engine::default_config();
+    user_config.set_string("list_cache", "false");
+    ATF_REQUIRE(!user_config.lookup< config::bool_node >("list_cache"));
+    ATF_REQUIRE_THROW_RE(
+        config::error, "list_cache",
+        user_config.set_string("list_cache", "sometimes"));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(config__set__cpu_time_limit);
+ATF_TEST_CASE_BODY(config__set__cpu_time_limit)
+{
+    config::tree user_config = engine::default_config();
+    user_config.set_string("cpu_time_limit", "60");
+    ATF_REQUIRE_EQ(
+        60, user_config.lookup< config::positive_int_node >("cpu_time_limit"));
+    ATF_REQUIRE_THROW_RE(
+        config::error, "cpu_time_limit.*Must be a positive integer",
+        user_config.set_string("cpu_time_limit", "0"));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(config__set__memory_limit);
+ATF_TEST_CASE_BODY(config__set__memory_limit)
+{
+    config::tree user_config = engine::default_config();
+    user_config.set_string("memory_limit", "512M");
+    ATF_REQUIRE_EQ(
+        units::bytes(512 * units::MB),
+        user_config.lookup< engine::bytes_node >("memory_limit"));
+    ATF_REQUIRE_EQ("512.00M", user_config.lookup_string("memory_limit"));
+    ATF_REQUIRE_THROW_RE(
+        config::error, "memory_limit.*Invalid bytes quantity",
+        user_config.set_string("memory_limit", "lots"));
 }
 
 
@@ -136,6 +229,8 @@ ATF_TEST_CASE_BODY(config__load__overrides)
         "config",
         "syntax(2)\n"
         "architecture = 'test-architecture'\n"
+        "cpu_time_limit = 30\n"
+        "memory_limit = '2G'\n"
         "parallelism = 16\n"
         "platform = 'test-platform'\n"
         "unprivileged_user = 'user2'\n"
@@ -145,6 +240,10 @@ ATF_TEST_CASE_BODY(config__load__overrides)
 
     ATF_REQUIRE_EQ("test-architecture",
                    user_config.lookup_string("architecture"));
+    ATF_REQUIRE_EQ("30",
+                   user_config.lookup_string("cpu_time_limit"));
+    ATF_REQUIRE_EQ(units::bytes(2 * units::GB),
+                   user_config.lookup< engine::bytes_node >("memory_limit"));
     ATF_REQUIRE_EQ("16",
                    user_config.lookup_string("parallelism"));
     ATF_REQUIRE_EQ("test-platform",
@@ -162,6 +261,21 @@ ATF_TEST_CASE_BODY(config__load__overrides)
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(config__load__parallelism_range);
+ATF_TEST_CASE_BODY(config__load__parallelism_range)
+{
+    atf::utils::create_file(
+        "config",
+        "syntax(2)\n"
+        "parallelism = '2..8'\n");
+
+    const config::tree user_config = engine::load_config(fs::path("config"));
+    ATF_REQUIRE_EQ(engine::parallelism_range(2, 8),
+                   user_config.lookup< engine::parallelism_node >(
+                       "parallelism"));
+}
+
+
 ATF_TEST_CASE_WITHOUT_HEAD(config__load__lua_error);
 ATF_TEST_CASE_BODY(config__load__lua_error)
 {
@@ -195,8 +309,14 @@ ATF_INIT_TEST_CASES(tcs)
 {
     ATF_ADD_TEST_CASE(tcs, config__defaults);
     ATF_ADD_TEST_CASE(tcs, config__set__parallelism);
+    ATF_ADD_TEST_CASE(tcs, config__set__parallelism_range);
+    ATF_ADD_TEST_CASE(tcs, config__set__cpu_affinity);
+    ATF_ADD_TEST_CASE(tcs, config__set__list_cache);
+    ATF_ADD_TEST_CASE(tcs, config__set__cpu_time_limit);
+    ATF_ADD_TEST_CASE(tcs, config__set__memory_limit);
     ATF_ADD_TEST_CASE(tcs, config__load__defaults);
     ATF_ADD_TEST_CASE(tcs, config__load__overrides);
+    ATF_ADD_TEST_CASE(tcs, config__load__parallelism_range);
     ATF_ADD_TEST_CASE(tcs, config__load__lua_error);
     ATF_ADD_TEST_CASE(tcs, config__load__bad_syntax__version);
     ATF_ADD_TEST_CASE(tcs, config__load__missing_file);
@@ -0,0 +1,336 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "engine/googletest.hpp"
+
+extern "C" {
+#include <unistd.h>
+}
+
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+
+#include "engine/exceptions.hpp"
+#include "engine/googletest_parser.hpp"
+#include "model/metadata.hpp"
+#include "model/test_case.hpp"
+#include "model/test_program.hpp"
+#include "model/test_result.hpp"
+#include "utils/defs.hpp"
+#include "utils/env.hpp"
+#include "utils/format/macros.hpp"
+#include "utils/fs/path.hpp"
+#include "utils/logging/macros.hpp"
+#include "utils/optional.ipp"
+#include "utils/process/exceptions.hpp"
+#include "utils/process/executor.hpp"
+#include "utils/process/operations.hpp"
+#include "utils/process/status.hpp"
+#include "utils/stream.hpp"
+
+namespace config = utils::config;
+namespace executor = utils::process::executor;
+namespace fs = utils::fs;
+namespace process = utils::process;
+
+using utils::optional;
+
+
+namespace {
+
+
+/// Magic numbers returned by exec_list when exec(2) fails.
+enum list_exit_code {
+    exit_eacces = 90,
+    exit_enoent,
+    exit_enoexec,
+};
+
+
+/// Sets the user-provided variables and executes the test program.
+///
+/// \param test_program The test program to execute.
+/// \param vars User-provided variables to pass to the test program.
+/// \param args The arguments to pass to the test program.
+static void
+exec_googletest(const model::test_program& test_program,
+                const config::properties_map& vars,
+                const process::args_vector& args) UTILS_NORETURN;
+static void
+exec_googletest(const model::test_program& test_program,
+                const config::properties_map& vars,
+                const process::args_vector& args)
+{
+    for (config::properties_map::const_iterator iter = vars.begin();
+         iter != vars.end(); ++iter) {
+        utils::setenv(F("TEST_ENV_%s") % (*iter).first, (*iter).second);
+    }
+
+    try {
+        process::exec_unsafe(test_program.absolute_path(), args);
+    } catch (const process::system_error& e) {
+        if (e.original_errno() == EACCES)
+            ::_exit(exit_eacces);
+        else if (e.original_errno() == ENOENT)
+            ::_exit(exit_enoent);
+        else if (e.original_errno() == ENOEXEC)
+            ::_exit(exit_enoexec);
+        throw;
+    }
+}
+
+
+/// Checks the termination status of the subprocess that executed exec_list.
+///
+/// \param status The termination status of the subprocess.
+///
+/// \throw error If the status denotes a problem running the program.
+static void
+check_list_status(const optional< process::status >& status)
+{
+    if (!status)
+        throw engine::error("Test case list timed out");
+    if (status.get().exited()) {
+        const int exitstatus = status.get().exitstatus();
+        if (exitstatus == EXIT_SUCCESS) {
+            // Nothing to do; fall through.
+        } else if (exitstatus == exit_eacces) {
+            throw engine::error("Permission denied to run test program");
+        } else if (exitstatus == exit_enoent) {
+            throw engine::error("Cannot find test program");
+        } else if (exitstatus == exit_enoexec) {
+            throw engine::error("Invalid test program format");
+        } else {
+            throw engine::error("Test program did not exit cleanly");
+        }
+    }
+}
+
+
+/// Reads the results of the test cases from the output of the test program.
+///
+/// \param stdout_path Path to the file containing the stdout of the program.
+///
+/// \return The results of the test cases found in the output.
+///
+/// \throw load_error If the file cannot be read.
+static engine::googletest_results_map
+read_results(const fs::path& stdout_path)
+{
+    std::ifstream input(stdout_path.c_str());
+    if (!input)
+        throw engine::load_error(stdout_path, "Cannot open file for read");
+    return engine::parse_googletest_output(input);
+}
+
+
+}  // anonymous namespace
+
+
+/// Executes a test program's list operation.
+///
+/// This method is intended to be called within a subprocess and is expected
+/// to terminate execution either by exec(2)ing the test program or by
+/// exiting with a failure.
+///
+/// \param test_program The test program to execute.
+/// \param vars User-provided variables to pass to the test program.
+void
+engine::googletest_interface::exec_list(
+    const model::test_program& test_program,
+    const config::properties_map& vars) const
+{
+    process::args_vector args;
+    args.push_back("--gtest_list_tests");
+    exec_googletest(test_program, vars, args);
+}
+
+
+/// Computes the test cases list of a test program.
+///
+/// \param status The termination status of the subprocess used to execute
+///     the exec_test() method or none if the test timed out.
+/// \param stdout_path Path to the file containing the stdout of the test.
+/// \param stderr_path Path to the file containing the stderr of the test.
+///
+/// \return A list of test cases.
+///
+/// \throw error If there is a problem parsing the test case list.
+model::test_cases_map
+engine::googletest_interface::parse_list(
+    const optional< process::status >& status,
+    const fs::path& stdout_path,
+    const fs::path& stderr_path) const
+{
+    const std::string stderr_contents = utils::read_file(stderr_path);
+    if (!stderr_contents.empty())
+        LW("Test case list wrote to stderr: " + stderr_contents);
+
+    check_list_status(status);
+    if (status.get().signaled())
+        throw engine::error("Test program received signal");
+
+    std::ifstream input(stdout_path.c_str());
+    if (!input)
+        throw engine::load_error(stdout_path, "Cannot open file for read");
+    return parse_googletest_list(input);
+}
+
+
+/// Describes the program that exec_test() executes.
+///
+/// \param test_program The test program to execute.
+/// \param test_case_name Name of the test case to invoke.
+/// \param vars User-provided variables to pass to the test program.
+/// \param unused_control_directory Directory where the interface may place
+///     control files.
+///
+/// \return The program to execute.
+optional< executor::command >
+engine::googletest_interface::test_command(
+    const model::test_program& test_program,
+    const std::string& test_case_name,
+    const config::properties_map& vars,
+    const fs::path& UTILS_UNUSED_PARAM(control_directory)) const
+{
+    executor::command command(test_program.absolute_path());
+    for (config::properties_map::const_iterator iter = vars.begin();
+         iter != vars.end(); ++iter) {
+        command.environment[F("TEST_ENV_%s") % (*iter).first] =
+            (*iter).second;
+    }
+    command.args.push_back(F("--gtest_filter=%s") % test_case_name);
+    command.args.push_back("--gtest_color=no");
+    return utils::make_optional(command);
+}
+
+
+/// Executes a test case of the test program.
+///
+/// This method is intended to be called within a subprocess and is expected
+/// to terminate execution either by exec(2)ing the test program or by
+/// exiting with a failure.
+///
+/// \param test_program The test program to execute.
+/// \param test_case_name Name of the test case to invoke.
+/// \param vars User-provided variables to pass to the test program.
+/// \param control_directory Directory where the interface may place control
+///     files.
+void
+engine::googletest_interface::exec_test(
+    const model::test_program& test_program,
+    const std::string& test_case_name,
+    const config::properties_map& vars,
+    const fs::path& control_directory) const
+{
+    executor::exec(googletest_interface::test_command(
+        test_program, test_case_name, vars, control_directory).get());
+}
+
+
+/// Computes the result of a test case based on its termination status.
+///
+/// \param status The termination status of the subprocess used to execute
+///     the exec_test() method or none if the test timed out.
+/// \param unused_control_directory Directory where the interface may have
+///     placed control files.
+/// \param stdout_path Path to the file containing the stdout of the test.
+/// \param unused_stderr_path Path to the file containing the stderr of the
+///     test.
+///
+/// \return A test result.
+model::test_result
+engine::googletest_interface::compute_result(
+    const optional< process::status >& status,
+    const fs::path& UTILS_UNUSED_PARAM(control_directory),
+    const fs::path& stdout_path,
+    const fs::path& UTILS_UNUSED_PARAM(stderr_path)) const
+{
+    if (!status) {
+        return model::test_result(model::test_result_broken,
+                                  "Test case timed out");
+    } else if (status.get().signaled()) {
+        return model::test_result(
+            model::test_result_broken,
+            F("Received signal %s") % status.get().termsig());
+    }
+    const int exitstatus = status.get().exitstatus();
+
+    googletest_results_map results;
+    try {
+        results = read_results(stdout_path);
+    } catch (const load_error& e) {
+        return model::test_result(model::test_result_broken, e.what());
+    }
+
+    // We only asked the test program to run one test case, so the result in
+    // its output is the one we are looking for.  Its name may be different
+    // from the one we know if the test program mangles it, so do not rely on
+    // it.
+    if (results.size() > 1) {
+        return model::test_result(
+            model::test_result_broken,
+            F("Expected the result of one test case but found %s") %
+            results.size());
+    } else if (results.empty()) {
+        if (exitstatus == EXIT_SUCCESS) {
+            return model::test_result(
+                model::test_result_skipped,
+                "Test case was not run; it is probably disabled");
+        } else {
+            return model::test_result(
+                model::test_result_broken,
+                F("Test program exited with code %s before running the test "
+                  "case") % exitstatus);
+        }
+    }
+
+    const model::test_result& result = (*results.begin()).second;
+    switch (result.type()) {
+    case model::test_result_passed:
+    case model::test_result_skipped:
+        if (exitstatus != EXIT_SUCCESS)
+            return model::test_result(
+                model::test_result_broken,
+                F("Test case reported '%s' but the test program exited with "
+                  "code %s") % result % exitstatus);
+        return result;
+
+    case model::test_result_failed:
+        return result;
+
+    default:
+        return model::test_result(
+            model::test_result_broken,
+            F("%s; test program exited with code %s") % result.reason() %
+            exitstatus);
+    }
+}
+
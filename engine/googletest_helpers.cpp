@@ -0,0 +1,254 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// \file engine/googletest_helpers.cpp
+/// Fake googletest program to validate the googletest interfaces.
+///
+/// This mimics the command-line interface and the output of a test program
+/// built with googletest, which we cannot depend on.  The test cases are
+/// listed in the order in which they run.
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "utils/env.hpp"
+#include "utils/optional.ipp"
+#include "utils/test_utils.ipp"
+
+
+namespace {
+
+
+/// Possible outcomes of a test case.
+enum outcome {
+    outcome_ok,
+    outcome_failed,
+    outcome_skipped,
+};
+
+
+/// A test case that passes.
+///
+/// \return The outcome of the test case.
+static outcome
+test_pass(void)
+{
+    std::cout << "Some output from the test case\n";
+    return outcome_ok;
+}
+
+
+/// A test case that fails.
+///
+/// \return The outcome of the test case.
+static outcome
+test_fail(void)
+{
+    std::cout << "Some output before the failure\n"
+              << "helpers.cpp:10: Failure\n"
+              << "Expected equality of these values:\n"
+              << "  1\n"
+              << "  2\n";
+    return outcome_failed;
+}
+
+
+/// A test case that is skipped.
+///
+/// \return The outcome of the test case.
+static outcome
+test_skip(void)
+{
+    std::cout << "helpers.cpp:20: Skipped\n"
+              << "Not supported here\n"
+              << "\n";
+    return outcome_skipped;
+}
+
+
+/// A test case that validates the TEST_ENV_* variables.
+///
+/// \return The outcome of the test case.
+static outcome
+test_vars(void)
+{
+    const utils::optional< std::string > first = utils::getenv(
+        "TEST_ENV_first");
+    if (!first) {
+        std::cout << "helpers.cpp:30: Skipped\n"
+                  << "No configuration variables\n";
+        return outcome_skipped;
+    }
+    if (first.get() != "some value") {
+        std::cout << "helpers.cpp:30: Failure\n"
+                  << "Invalid value " << first.get() << "\n";
+        return outcome_failed;
+    }
+    return outcome_ok;
+}
+
+
+/// A test case that crashes.
+///
+/// \return Nothing; the test case never returns.
+static outcome
+test_crash(void)
+{
+    std::cout << "About to crash\n";
+    std::cout.flush();
+    utils::abort_without_coredump();
+}
+
+
+/// Definition of a test case of the fake test program.
+struct test_case_def {
+    /// Name of the test suite, including the trailing dot.
+    const char* suite;
+
+    /// Name of the test case within its suite.
+    const char* name;
+
+    /// Comment that googletest prints next to the name, or NULL.
+    const char* comment;
+
+    /// Function that runs the test case.
+    outcome (*hook)(void);
+};
+
+
+/// Collection of test cases of the fake test program.
+static const test_case_def test_cases[] = {
+    { "Suite.", "Pass", NULL, test_pass },
+    { "Suite.", "Fail", NULL, test_fail },
+    { "Suite.", "Skip", NULL, test_skip },
+    { "Suite.", "DISABLED_Off", NULL, test_pass },
+    { "Param/Suite.", "Vars/0", "GetParam() = 3", test_vars },
+    { "Death.", "Crash", NULL, test_crash },
+};
+
+
+/// Number of entries in test_cases.
+static const std::size_t num_test_cases =
+    sizeof(test_cases) / sizeof(test_cases[0]);
+
+
+/// Prints the list of test cases in the format of --gtest_list_tests.
+static void
+list_tests(void)
+{
+    const char* last_suite = NULL;
+    for (std::size_t i = 0; i < num_test_cases; ++i) {
+        const test_case_def& def = test_cases[i];
+        if (last_suite == NULL || std::strcmp(last_suite, def.suite) != 0) {
+            std::cout << def.suite << '\n';
+            last_suite = def.suite;
+        }
+        std::cout << "  " << def.name;
+        if (def.comment != NULL)
+            std::cout << "  # " << def.comment;
+        std::cout << '\n';
+    }
+}
+
+
+/// Runs the selected test cases.
+///
+/// \param filter Name of the only test case to run, or empty to run all.
+///
+/// \return True if all the test cases that ran passed; false otherwise.
+static bool
+run_tests(const std::string& filter)
+{
+    bool ok = true;
+    for (std::size_t i = 0; i < num_test_cases; ++i) {
+        const test_case_def& def = test_cases[i];
+        const std::string name = std::string(def.suite) + def.name;
+        if (!filter.empty() && filter != name)
+            continue;
+        if (std::strstr(def.name, "DISABLED_") == def.name)
+            continue;
+
+        std::cout << "[ RUN      ] " << name << '\n';
+        std::cout.flush();
+        switch (def.hook()) {
+        case outcome_ok:
+            std::cout << "[       OK ] " << name << " (0 ms)\n";
+            break;
+        case outcome_failed:
+            std::cout << "[  FAILED  ] " << name << " (0 ms)\n";
+            ok = false;
+            break;
+        case outcome_skipped:
+            std::cout << "[  SKIPPED ] " << name << " (0 ms)\n";
+            break;
+        }
+    }
+    std::cout << "[  PASSED  ] Summary line that must be ignored\n";
+    return ok;
+}
+
+
+}  // anonymous namespace
+
+
+/// Entry point to the test program.
+///
+/// \param argc The number of CLI arguments.
+/// \param argv The CLI arguments themselves.
+///
+/// \return An exit code.
+int
+main(const int argc, char* const* const argv)
+{
+    const std::string filter_flag = "--gtest_filter=";
+
+    bool list = false;
+    std::string filter;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--gtest_list_tests")
+            list = true;
+        else if (arg.compare(0, filter_flag.length(), filter_flag) == 0)
+            filter = arg.substr(filter_flag.length());
+        else if (arg == "--gtest_color=no")
+            ;
+        else {
+            std::cerr << "Unknown argument " << arg << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (list) {
+        list_tests();
+        return EXIT_SUCCESS;
+    }
+    std::cout << "Running tests\n";
+    return run_tests(filter) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,266 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "engine/googletest_parser.hpp"
+
+#include <string>
+#include <vector>
+
+#include "engine/exceptions.hpp"
+#include "model/test_case.hpp"
+#include "utils/format/macros.hpp"
+#include "utils/optional.ipp"
+#include "utils/sanity.hpp"
+#include "utils/text/operations.ipp"
+
+namespace text = utils::text;
+
+using utils::none;
+using utils::optional;
+
+
+namespace {
+
+
+/// Prefix of the line that marks the beginning of a test case.
+static const char* run_prefix = "[ RUN      ] ";
+
+
+/// Prefix of the line that marks the success of a test case.
+static const char* ok_prefix = "[       OK ] ";
+
+
+/// Prefix of the line that marks the failure of a test case.
+static const char* failed_prefix = "[  FAILED  ] ";
+
+
+/// Prefix of the line that marks a skipped test case.
+static const char* skipped_prefix = "[  SKIPPED ] ";
+
+
+/// Checks if a string starts with a given prefix.
+///
+/// \param str The string to check.
+/// \param prefix The prefix to look for.
+///
+/// \return True if str starts with prefix; false otherwise.
+static bool
+starts_with(const std::string& str, const char* prefix)
+{
+    return str.compare(0, std::string(prefix).length(), prefix) == 0;
+}
+
+
+/// Checks if a string ends with a given suffix.
+///
+/// \param str The string to check.
+/// \param suffix The suffix to look for.
+///
+/// \return True if str ends with suffix; false otherwise.
+static bool
+ends_with(const std::string& str, const std::string& suffix)
+{
+    return str.length() >= suffix.length() &&
+        str.compare(str.length() - suffix.length(), suffix.length(),
+                    suffix) == 0;
+}
+
+
+/// Removes the comment that googletest appends to some names.
+///
+/// Parameterized and typed tests are listed with a trailing comment that
+/// describes their parameter, as in "Name/0  # GetParam() = 3".
+///
+/// \param line The line to process.
+///
+/// \return The line without the comment nor trailing whitespace.
+static std::string
+strip_comment(const std::string& line)
+{
+    std::string stripped = line.substr(0, line.find('#'));
+    const std::string::size_type last = stripped.find_last_not_of(' ');
+    if (last == std::string::npos)
+        return "";
+    return stripped.substr(0, last + 1);
+}
+
+
+/// Extracts the name of a test case from a status line.
+///
+/// \param line The status line.
+/// \param prefix The prefix of the status line, which precedes the name.
+///
+/// \return The name of the test case, which ends at the first space or comma
+/// (as parameterized tests append ", where GetParam() = ..." to it).
+static std::string
+status_line_name(const std::string& line, const char* prefix)
+{
+    const std::string rest = line.substr(std::string(prefix).length());
+    return rest.substr(0, rest.find_first_of(" ,"));
+}
+
+
+/// Computes the reason of a failed or skipped test case from its output.
+///
+/// googletest prints "file:line: Failure" or "file:line: Skipped" followed by
+/// the details of the problem, possibly after other messages printed by the
+/// test case itself.  The reason is everything from the first such marker.
+///
+/// \param output The lines printed by the test case.
+/// \param marker The marker that precedes the details, including the colon.
+/// \param default_reason Reason to return if there are no details.
+///
+/// \return The reason, with its lines separated by newlines.
+static std::string
+compute_reason(const std::vector< std::string >& output,
+               const std::string& marker, const std::string& default_reason)
+{
+    std::vector< std::string >::const_iterator iter = output.begin();
+    while (iter != output.end() && !ends_with(*iter, marker))
+        ++iter;
+    if (iter == output.end())
+        iter = output.begin();
+
+    std::vector< std::string > lines;
+    for (; iter != output.end(); ++iter) {
+        if (!(*iter).empty())
+            lines.push_back(*iter);
+    }
+    if (lines.empty())
+        return default_reason;
+    return text::join(lines, "\n");
+}
+
+
+}  // anonymous namespace
+
+
+/// Parses the output of a googletest program run with --gtest_list_tests.
+///
+/// \param input The stream to read from.
+///
+/// \return The collection of parsed test cases.
+///
+/// \throw format_error If there is any problem in the input data.
+model::test_cases_map
+engine::parse_googletest_list(std::istream& input)
+{
+    model::test_cases_map_builder test_cases_builder;
+    optional< std::string > suite;
+    bool found_any = false;
+
+    std::string line;
+    while (std::getline(input, line).good()) {
+        const std::string entry = strip_comment(line);
+        if (entry.empty()) {
+            // Nothing to do.
+        } else if (entry[0] != ' ') {
+            if (entry[entry.length() - 1] != '.')
+                throw format_error(F("Invalid test suite line '%s'; expecting "
+                                     "a name followed by a dot") % line);
+            suite = entry;
+        } else {
+            if (!suite)
+                throw format_error(F("Test case '%s' does not belong to any "
+                                     "test suite") % line);
+            const std::string name = entry.substr(entry.find_first_not_of(' '));
+            test_cases_builder.add(suite.get() + name);
+            found_any = true;
+        }
+    }
+    if (!found_any)
+        throw format_error("No test cases");
+
+    return test_cases_builder.build();
+}
+
+
+/// Parses the output of a googletest program.
+///
+/// Only the output of the test cases that were run is recorded, so the result
+/// contains no entries for the test cases that were filtered out or disabled.
+///
+/// \param input The stream to read from, containing the stdout of the program.
+///
+/// \return The results of the test cases that were run.  A test case that
+/// started but did not report its result, which happens if the program
+/// crashed, is broken.
+engine::googletest_results_map
+engine::parse_googletest_output(std::istream& input)
+{
+    googletest_results_map results;
+
+    optional< std::string > current;
+    std::vector< std::string > output;
+
+    std::string line;
+    while (std::getline(input, line).good()) {
+        if (starts_with(line, run_prefix)) {
+            if (current)
+                results.insert(googletest_results_map::value_type(
+                    current.get(),
+                    model::test_result(model::test_result_broken,
+                                       "Test case did not complete")));
+            current = status_line_name(line, run_prefix);
+            output.clear();
+        } else if (!current) {
+            // Ignore the preamble and the summary, which also contain status
+            // lines that refer to test cases.
+        } else if (starts_with(line, ok_prefix) &&
+                   status_line_name(line, ok_prefix) == current.get()) {
+            results.insert(googletest_results_map::value_type(
+                current.get(), model::test_result(model::test_result_passed)));
+            current = none;
+        } else if (starts_with(line, failed_prefix) &&
+                   status_line_name(line, failed_prefix) == current.get()) {
+            results.insert(googletest_results_map::value_type(
+                current.get(), model::test_result(
+                    model::test_result_failed,
+                    compute_reason(output, ": Failure",
+                                   "Test case failed"))));
+            current = none;
+        } else if (starts_with(line, skipped_prefix) &&
+                   status_line_name(line, skipped_prefix) == current.get()) {
+            results.insert(googletest_results_map::value_type(
+                current.get(), model::test_result(
+                    model::test_result_skipped,
+                    compute_reason(output, ": Skipped",
+                                   "Test case was skipped"))));
+            current = none;
+        } else {
+            output.push_back(line);
+        }
+    }
+    if (current)
+        results.insert(googletest_results_map::value_type(
+            current.get(),
+            model::test_result(model::test_result_broken,
+                               "Test case did not complete")));
+
+    return results;
+}
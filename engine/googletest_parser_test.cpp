@@ -0,0 +1,197 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "engine/googletest_parser.hpp"
+
+#include <sstream>
+
+#include <atf-c++.hpp>
+
+#include "engine/exceptions.hpp"
+#include "model/metadata.hpp"
+#include "model/test_case.hpp"
+#include "model/test_result.hpp"
+#include "utils/format/containers.ipp"
+
+
+namespace {
+
+
+/// Adds an expected result to a results map.
+///
+/// \param results The map to modify.
+/// \param name The name of the test case.
+/// \param result The result of the test case.
+static void
+add_result(engine::googletest_results_map& results, const char* name,
+           const model::test_result& result)
+{
+    results.insert(engine::googletest_results_map::value_type(name, result));
+}
+
+
+}  // anonymous namespace
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parse_googletest_list__ok);
+ATF_TEST_CASE_BODY(parse_googletest_list__ok)
+{
+    std::istringstream input(
+        "FirstSuite.\n"
+        "  first\n"
+        "  DISABLED_second\n"
+        "Param/SecondSuite.  # TypeParam = int\n"
+        "  third/0  # GetParam() = 3\n"
+        "  third/1  # GetParam() = 4\n");
+    const model::test_cases_map exp_test_cases = model::test_cases_map_builder()
+        .add("FirstSuite.first")
+        .add("FirstSuite.DISABLED_second")
+        .add("Param/SecondSuite.third/0")
+        .add("Param/SecondSuite.third/1")
+        .build();
+    ATF_REQUIRE_EQ(exp_test_cases, engine::parse_googletest_list(input));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parse_googletest_list__empty);
+ATF_TEST_CASE_BODY(parse_googletest_list__empty)
+{
+    std::istringstream input("Suite.\n");
+    ATF_REQUIRE_THROW_RE(engine::format_error, "No test cases",
+                         engine::parse_googletest_list(input));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parse_googletest_list__invalid_suite);
+ATF_TEST_CASE_BODY(parse_googletest_list__invalid_suite)
+{
+    std::istringstream input("Running main() from gtest_main.cc\n"
+                             "Suite.\n"
+                             "  first\n");
+    ATF_REQUIRE_THROW_RE(engine::format_error, "Invalid test suite line "
+                         "'Running main",
+                         engine::parse_googletest_list(input));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parse_googletest_list__orphan_test_case);
+ATF_TEST_CASE_BODY(parse_googletest_list__orphan_test_case)
+{
+    std::istringstream input("  first\n");
+    ATF_REQUIRE_THROW_RE(engine::format_error, "'  first' does not belong",
+                         engine::parse_googletest_list(input));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parse_googletest_output__all_results);
+ATF_TEST_CASE_BODY(parse_googletest_output__all_results)
+{
+    std::istringstream input(
+        "Running main() from gtest_main.cc\n"
+        "[==========] Running 4 tests from 1 test suite.\n"
+        "[ RUN      ] Suite.pass\n"
+        "[       OK ] Suite.pass (0 ms)\n"
+        "[ RUN      ] Suite.fail\n"
+        "Some output\n"
+        "file.cpp:12: Failure\n"
+        "Expected equality of these values:\n"
+        "\n"
+        "  1\n"
+        "[  FAILED  ] Suite.fail (1 ms)\n"
+        "[ RUN      ] Suite.skip\n"
+        "file.cpp:20: Skipped\n"
+        "Not here\n"
+        "[  SKIPPED ] Suite.skip (0 ms)\n"
+        "[ RUN      ] Param/Suite.check/0\n"
+        "[  FAILED  ] Param/Suite.check/0, where GetParam() = 3 (0 ms)\n"
+        "[==========] 4 tests from 1 test suite ran. (1 ms total)\n"
+        "[  PASSED  ] 1 test.\n"
+        "[  FAILED  ] Suite.fail\n");
+
+    engine::googletest_results_map exp_results;
+    add_result(exp_results, "Suite.pass",
+               model::test_result(model::test_result_passed));
+    add_result(exp_results, "Suite.fail",
+               model::test_result(model::test_result_failed,
+                                  "file.cpp:12: Failure\n"
+                                  "Expected equality of these values:\n"
+                                  "  1"));
+    add_result(exp_results, "Suite.skip",
+               model::test_result(model::test_result_skipped,
+                                  "file.cpp:20: Skipped\nNot here"));
+    add_result(exp_results, "Param/Suite.check/0",
+               model::test_result(model::test_result_failed,
+                                  "Test case failed"));
+    ATF_REQUIRE_EQ(exp_results, engine::parse_googletest_output(input));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parse_googletest_output__incomplete);
+ATF_TEST_CASE_BODY(parse_googletest_output__incomplete)
+{
+    std::istringstream input(
+        "[ RUN      ] Suite.first\n"
+        "[ RUN      ] Suite.second\n"
+        "[       OK ] Suite.second (0 ms)\n"
+        "[ RUN      ] Suite.third\n"
+        "About to crash\n");
+
+    engine::googletest_results_map exp_results;
+    add_result(exp_results, "Suite.first",
+               model::test_result(model::test_result_broken,
+                                  "Test case did not complete"));
+    add_result(exp_results, "Suite.second",
+               model::test_result(model::test_result_passed));
+    add_result(exp_results, "Suite.third",
+               model::test_result(model::test_result_broken,
+                                  "Test case did not complete"));
+    ATF_REQUIRE_EQ(exp_results, engine::parse_googletest_output(input));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parse_googletest_output__nothing_run);
+ATF_TEST_CASE_BODY(parse_googletest_output__nothing_run)
+{
+    std::istringstream input(
+        "[==========] 0 tests from 0 test suites ran. (0 ms total)\n"
+        "[  PASSED  ] 0 tests.\n");
+    ATF_REQUIRE(engine::parse_googletest_output(input).empty());
+}
+
+
+ATF_INIT_TEST_CASES(tcs)
+{
+    ATF_ADD_TEST_CASE(tcs, parse_googletest_list__ok);
+    ATF_ADD_TEST_CASE(tcs, parse_googletest_list__empty);
+    ATF_ADD_TEST_CASE(tcs, parse_googletest_list__invalid_suite);
+    ATF_ADD_TEST_CASE(tcs, parse_googletest_list__orphan_test_case);
+
+    ATF_ADD_TEST_CASE(tcs, parse_googletest_output__all_results);
+    ATF_ADD_TEST_CASE(tcs, parse_googletest_output__incomplete);
+    ATF_ADD_TEST_CASE(tcs, parse_googletest_output__nothing_run);
+}
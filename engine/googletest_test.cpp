@@ -0,0 +1,219 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "engine/googletest.hpp"
+
+extern "C" {
+#include <signal.h>
+}
+
+#include <atf-c++.hpp>
+
+#include "engine/config.hpp"
+#include "engine/scheduler.hpp"
+#include "model/metadata.hpp"
+#include "model/test_case.hpp"
+#include "model/test_program.hpp"
+#include "model/test_result.hpp"
+#include "utils/config/tree.ipp"
+#include "utils/format/containers.ipp"
+#include "utils/format/macros.hpp"
+#include "utils/fs/operations.hpp"
+#include "utils/fs/path.hpp"
+#include "utils/optional.ipp"
+
+namespace config = utils::config;
+namespace fs = utils::fs;
+namespace scheduler = engine::scheduler;
+
+
+namespace {
+
+
+/// Copies the googletest helper to the work directory.
+///
+/// \param tc Pointer to the calling test case, to obtain srcdir.
+static void
+copy_googletest_helper(const atf::tests::tc* tc)
+{
+    const fs::path srcdir(tc->get_config_var("srcdir"));
+    atf::utils::copy_file((srcdir / "googletest_helpers").str(),
+                          "googletest_helpers");
+}
+
+
+/// Lists the test cases of the googletest helper.
+///
+/// \param tc Pointer to the calling test case, to obtain srcdir.
+/// \param interface Name of the interface to list the test cases with.
+///
+/// \return The test cases returned by the interface.
+static model::test_cases_map
+list_helper(const atf::tests::tc* tc, const char* interface)
+{
+    copy_googletest_helper(tc);
+    const model::test_program program = model::test_program_builder(
+        interface, fs::path("googletest_helpers"), fs::current_path(),
+        "the-suite").build();
+
+    scheduler::scheduler_handle handle = scheduler::setup();
+    const model::test_cases_map test_cases = handle.list_tests(
+        &program, engine::empty_config());
+    handle.cleanup();
+    return test_cases;
+}
+
+
+/// Runs one test case of the googletest helper and checks its result.
+///
+/// \param tc Pointer to the calling test case, to obtain srcdir.
+/// \param test_case_name Name of the test case to run.
+/// \param exp_result The expected result.
+/// \param user_config User-provided configuration variables.
+static void
+run_one(const atf::tests::tc* tc, const char* test_case_name,
+        const model::test_result& exp_result,
+        const config::tree& user_config = engine::empty_config())
+{
+    copy_googletest_helper(tc);
+    const model::test_program_ptr program = model::test_program_builder(
+        "googletest", fs::path("googletest_helpers"), fs::current_path(),
+        "the-suite").add_test_case(test_case_name).build_ptr();
+
+    scheduler::scheduler_handle handle = scheduler::setup();
+    (void)handle.spawn_test(program, test_case_name, user_config);
+
+    scheduler::result_handle_ptr result_handle = handle.wait_any();
+    const scheduler::test_result_handle* test_result_handle =
+        dynamic_cast< const scheduler::test_result_handle* >(
+            result_handle.get());
+    atf::utils::cat_file(result_handle->stdout_file().str(), "stdout: ");
+    atf::utils::cat_file(result_handle->stderr_file().str(), "stderr: ");
+    ATF_REQUIRE_EQ(exp_result, test_result_handle->test_result());
+    result_handle->cleanup();
+    result_handle.reset();
+
+    handle.cleanup();
+}
+
+
+}  // anonymous namespace
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(list);
+ATF_TEST_CASE_BODY(list)
+{
+    const model::test_cases_map exp_test_cases = model::test_cases_map_builder()
+        .add("Suite.Pass")
+        .add("Suite.Fail")
+        .add("Suite.Skip")
+        .add("Suite.DISABLED_Off")
+        .add("Param/Suite.Vars/0")
+        .add("Death.Crash")
+        .build();
+    ATF_REQUIRE_EQ(exp_test_cases, list_helper(this, "googletest"));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(test__pass);
+ATF_TEST_CASE_BODY(test__pass)
+{
+    const model::test_result exp_result(model::test_result_passed);
+    run_one(this, "Suite.Pass", exp_result);
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(test__fail);
+ATF_TEST_CASE_BODY(test__fail)
+{
+    const model::test_result exp_result(
+        model::test_result_failed,
+        "helpers.cpp:10: Failure\n"
+        "Expected equality of these values:\n"
+        "  1\n"
+        "  2");
+    run_one(this, "Suite.Fail", exp_result);
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(test__skip);
+ATF_TEST_CASE_BODY(test__skip)
+{
+    const model::test_result exp_result(
+        model::test_result_skipped, "helpers.cpp:20: Skipped\n"
+        "Not supported here");
+    run_one(this, "Suite.Skip", exp_result);
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(test__disabled);
+ATF_TEST_CASE_BODY(test__disabled)
+{
+    const model::test_result exp_result(
+        model::test_result_skipped,
+        "Test case was not run; it is probably disabled");
+    run_one(this, "Suite.DISABLED_Off", exp_result);
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(test__signal_is_broken);
+ATF_TEST_CASE_BODY(test__signal_is_broken)
+{
+    const model::test_result exp_result(model::test_result_broken,
+                                        F("Received signal %s") % SIGABRT);
+    run_one(this, "Death.Crash", exp_result);
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(test__configuration_variables);
+ATF_TEST_CASE_BODY(test__configuration_variables)
+{
+    config::tree user_config = engine::empty_config();
+    user_config.set_string("test_suites.a-suite.first", "unused");
+    user_config.set_string("test_suites.the-suite.first", "some value");
+
+    const model::test_result exp_result(model::test_result_passed);
+    run_one(this, "Param/Suite.Vars/0", exp_result, user_config);
+}
+
+
+ATF_INIT_TEST_CASES(tcs)
+{
+    scheduler::register_interface(
+        "googletest", std::shared_ptr< scheduler::interface >(
+            new engine::googletest_interface()));
+
+    ATF_ADD_TEST_CASE(tcs, list);
+
+    ATF_ADD_TEST_CASE(tcs, test__pass);
+    ATF_ADD_TEST_CASE(tcs, test__fail);
+    ATF_ADD_TEST_CASE(tcs, test__skip);
+    ATF_ADD_TEST_CASE(tcs, test__disabled);
+    ATF_ADD_TEST_CASE(tcs, test__signal_is_broken);
+    ATF_ADD_TEST_CASE(tcs, test__configuration_variables);
+}
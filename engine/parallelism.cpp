@@ -0,0 +1,245 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "engine/parallelism.hpp"
+
+#include <algorithm>
+
+#include "utils/datetime.hpp"
+#include "utils/format/macros.hpp"
+#include "utils/logging/macros.hpp"
+#include "utils/noncopyable.hpp"
+#include "utils/optional.ipp"
+#include "utils/sanity.hpp"
+
+namespace datetime = utils::datetime;
+
+using utils::none;
+using utils::optional;
+
+
+namespace {
+
+
+/// Pressure below which the system is considered idle, in percent.
+static const double grow_threshold = 10.0;
+
+
+/// Pressure above which the system is considered overloaded, in percent.
+static const double shrink_threshold = 40.0;
+
+
+/// Minimum time between two samples of the pressure of the system.
+///
+/// The pressure figures are averages over several seconds, so sampling more
+/// often would only react to the load that we caused with our last change.
+static const datetime::delta sampling_interval(5, 0);
+
+
+}  // anonymous namespace
+
+
+/// Constructs a new range.
+///
+/// \param min_ Minimum number of execution slots.  Must be positive.
+/// \param max_ Maximum number of execution slots.  Must not be lower than
+///     min_.
+engine::parallelism_range::parallelism_range(const std::size_t min_,
+                                             const std::size_t max_) :
+    min(min_),
+    max(max_)
+{
+    PRE(min >= 1);
+    PRE(min <= max);
+}
+
+
+/// Checks whether the range requests an adaptive parallelism.
+///
+/// \return True if the bounds differ; false if the parallelism is fixed.
+bool
+engine::parallelism_range::adaptive(void) const
+{
+    return min != max;
+}
+
+
+/// Formats the range for user presentation.
+///
+/// \return The single bound of a fixed range, or the two bounds separated by
+/// two dots for an adaptive one.
+std::string
+engine::parallelism_range::format(void) const
+{
+    if (adaptive())
+        return F("%s..%s") % min % max;
+    else
+        return F("%s") % max;
+}
+
+
+/// Equality comparator.
+///
+/// \param other The other object to compare this one to.
+///
+/// \return True if this object and other are equal; false otherwise.
+bool
+engine::parallelism_range::operator==(const parallelism_range& other) const
+{
+    return min == other.min && max == other.max;
+}
+
+
+/// Inequality comparator.
+///
+/// \param other The other object to compare this one to.
+///
+/// \return True if this object and other are different; false otherwise.
+bool
+engine::parallelism_range::operator!=(const parallelism_range& other) const
+{
+    return !(*this == other);
+}
+
+
+/// Injects the object into a stream.
+///
+/// \param output The stream into which to inject the object.
+/// \param object The object to format.
+///
+/// \return The output stream.
+std::ostream&
+engine::operator<<(std::ostream& output, const parallelism_range& object)
+{
+    output << object.format();
+    return output;
+}
+
+
+/// Internal implementation for the parallelism_controller class.
+struct engine::parallelism_controller::impl : utils::noncopyable {
+    /// Bounds on the number of execution slots.
+    const parallelism_range range;
+
+    /// Current number of execution slots.
+    std::size_t slots;
+
+    /// Time of the last sample of the pressure, if any.
+    optional< datetime::timestamp > last_sample;
+
+    /// Constructor.
+    ///
+    /// \param range_ Bounds on the number of execution slots.
+    impl(const parallelism_range& range_) :
+        range(range_),
+        slots(range_.min)
+    {
+    }
+};
+
+
+/// Constructs a new controller.
+///
+/// \param range Bounds on the number of execution slots.
+engine::parallelism_controller::parallelism_controller(
+    const parallelism_range& range) :
+    _pimpl(new impl(range))
+{
+}
+
+
+/// Destructor.
+engine::parallelism_controller::~parallelism_controller(void)
+{
+}
+
+
+/// Returns the current number of execution slots.
+///
+/// \return A number within the range of the controller.
+std::size_t
+engine::parallelism_controller::slots(void) const
+{
+    return _pimpl->slots;
+}
+
+
+/// Checks whether the controller wants a new sample of the system pressure.
+///
+/// \param now The current time.
+///
+/// \return True if the range is adaptive and the sampling interval has elapsed
+/// since the last call to update(); false otherwise.
+bool
+engine::parallelism_controller::due(const datetime::timestamp& now) const
+{
+    if (!_pimpl->range.adaptive())
+        return false;
+    if (!_pimpl->last_sample)
+        return true;
+    // Tolerate clocks that go backwards by sampling right away.
+    return now < _pimpl->last_sample.get() ||
+        now - _pimpl->last_sample.get() >= sampling_interval;
+}
+
+
+/// Adjusts the number of execution slots to the pressure of the system.
+///
+/// The slots change by a quarter of their current count, or by one if that
+/// is smaller, so that large ranges are covered in a few steps.
+///
+/// \param pressure The pressure of the system, as returned by
+///     utils::system_pressure(), or none if it is unknown.  An unknown
+///     pressure leaves the slots untouched.
+/// \param now The current time.
+///
+/// \return The new number of execution slots.
+std::size_t
+engine::parallelism_controller::update(const optional< double >& pressure,
+                                       const datetime::timestamp& now)
+{
+    _pimpl->last_sample = now;
+    if (!pressure)
+        return _pimpl->slots;
+
+    const parallelism_range& range = _pimpl->range;
+    const std::size_t old_slots = _pimpl->slots;
+    const std::size_t step = std::max(std::size_t(1), old_slots / 4);
+    if (pressure.get() < grow_threshold && old_slots < range.max) {
+        _pimpl->slots = std::min(range.max, old_slots + step);
+    } else if (pressure.get() > shrink_threshold && old_slots > range.min) {
+        _pimpl->slots = old_slots - std::min(step, old_slots - range.min);
+    }
+
+    if (_pimpl->slots != old_slots) {
+        LI(F("Adjusting parallelism from %s to %s; system pressure is %.1s%%")
+           % old_slots % _pimpl->slots % pressure.get());
+    }
+    POST(_pimpl->slots >= range.min && _pimpl->slots <= range.max);
+    return _pimpl->slots;
+}
@@ -0,0 +1,99 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// \file engine/parallelism.hpp
+/// Computation of the number of test cases to run concurrently.
+
+#if !defined(ENGINE_PARALLELISM_HPP)
+#define ENGINE_PARALLELISM_HPP
+
+#include "engine/parallelism_fwd.hpp"
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+#include "utils/datetime_fwd.hpp"
+#include "utils/optional_fwd.hpp"
+#include "utils/shared_ptr.hpp"
+
+namespace engine {
+
+
+/// Bounds on the number of test cases to run concurrently.
+///
+/// A range with equal bounds denotes a fixed parallelism.  Otherwise, the
+/// number of execution slots adapts to the pressure of the system.
+class parallelism_range {
+public:
+    /// Minimum number of execution slots.
+    std::size_t min;
+
+    /// Maximum number of execution slots.
+    std::size_t max;
+
+    parallelism_range(const std::size_t, const std::size_t);
+
+    bool adaptive(void) const;
+    std::string format(void) const;
+
+    bool operator==(const parallelism_range&) const;
+    bool operator!=(const parallelism_range&) const;
+};
+
+
+std::ostream& operator<<(std::ostream&, const parallelism_range&);
+
+
+/// Adjusts the number of execution slots to the pressure of the system.
+///
+/// The number of slots starts at the minimum of the range and grows while the
+/// system is idle and shrinks when it is overloaded, always within the range.
+/// The thresholds to grow and to shrink are far apart, and the slots change at
+/// most once per sampling interval, so that the count does not oscillate with
+/// every small fluctuation of the load.
+class parallelism_controller {
+    struct impl;
+    /// Pointer to the internal implementation data.
+    std::shared_ptr< impl > _pimpl;
+
+public:
+    explicit parallelism_controller(const parallelism_range&);
+    ~parallelism_controller(void);
+
+    std::size_t slots(void) const;
+
+    bool due(const utils::datetime::timestamp&) const;
+    std::size_t update(const utils::optional< double >&,
+                       const utils::datetime::timestamp&);
+};
+
+
+}  // namespace engine
+
+#endif  // !defined(ENGINE_PARALLELISM_HPP)
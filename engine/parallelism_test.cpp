@@ -0,0 +1,185 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "engine/parallelism.hpp"
+
+#include <sstream>
+
+#include <atf-c++.hpp>
+
+#include "utils/datetime.hpp"
+#include "utils/optional.ipp"
+
+namespace datetime = utils::datetime;
+
+using utils::none;
+
+
+namespace {
+
+
+/// Constructs a timestamp a number of seconds after an arbitrary epoch.
+///
+/// \param seconds The seconds since the epoch.
+///
+/// \return A new timestamp.
+static datetime::timestamp
+at(const int seconds)
+{
+    return datetime::timestamp::from_microseconds(
+        1000000000000000LL + seconds * 1000000LL);
+}
+
+
+}  // anonymous namespace
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parallelism_range__fixed);
+ATF_TEST_CASE_BODY(parallelism_range__fixed)
+{
+    const engine::parallelism_range range(4, 4);
+    ATF_REQUIRE(!range.adaptive());
+    ATF_REQUIRE_EQ("4", range.format());
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parallelism_range__adaptive);
+ATF_TEST_CASE_BODY(parallelism_range__adaptive)
+{
+    const engine::parallelism_range range(2, 16);
+    ATF_REQUIRE(range.adaptive());
+    ATF_REQUIRE_EQ("2..16", range.format());
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parallelism_range__operators_eq_and_ne);
+ATF_TEST_CASE_BODY(parallelism_range__operators_eq_and_ne)
+{
+    ATF_REQUIRE(  engine::parallelism_range(1, 2) ==
+                  engine::parallelism_range(1, 2));
+    ATF_REQUIRE(!(engine::parallelism_range(1, 2) !=
+                  engine::parallelism_range(1, 2)));
+    ATF_REQUIRE(!(engine::parallelism_range(1, 2) ==
+                  engine::parallelism_range(1, 3)));
+    ATF_REQUIRE(  engine::parallelism_range(1, 2) !=
+                  engine::parallelism_range(2, 2));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parallelism_range__output);
+ATF_TEST_CASE_BODY(parallelism_range__output)
+{
+    std::ostringstream str;
+    str << engine::parallelism_range(3, 8);
+    ATF_REQUIRE_EQ("3..8", str.str());
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parallelism_controller__fixed);
+ATF_TEST_CASE_BODY(parallelism_controller__fixed)
+{
+    engine::parallelism_controller controller(
+        engine::parallelism_range(6, 6));
+    ATF_REQUIRE_EQ(6, controller.slots());
+    ATF_REQUIRE(!controller.due(at(0)));
+    ATF_REQUIRE_EQ(6, controller.update(utils::make_optional(0.0), at(0)));
+    ATF_REQUIRE_EQ(6, controller.update(utils::make_optional(99.0), at(10)));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parallelism_controller__grow_and_shrink);
+ATF_TEST_CASE_BODY(parallelism_controller__grow_and_shrink)
+{
+    engine::parallelism_controller controller(
+        engine::parallelism_range(4, 32));
+    ATF_REQUIRE_EQ(4, controller.slots());
+
+    ATF_REQUIRE_EQ(5, controller.update(utils::make_optional(0.0), at(0)));
+    ATF_REQUIRE_EQ(6, controller.update(utils::make_optional(5.0), at(10)));
+    ATF_REQUIRE_EQ(6, controller.update(utils::make_optional(20.0), at(20)));
+    ATF_REQUIRE_EQ(6, controller.update(utils::make_optional(40.0), at(30)));
+    ATF_REQUIRE_EQ(5, controller.update(utils::make_optional(60.0), at(40)));
+    ATF_REQUIRE_EQ(5, controller.update(none, at(50)));
+    ATF_REQUIRE_EQ(5, controller.slots());
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parallelism_controller__bounds);
+ATF_TEST_CASE_BODY(parallelism_controller__bounds)
+{
+    engine::parallelism_controller controller(
+        engine::parallelism_range(2, 20));
+
+    std::size_t last = controller.slots();
+    for (int i = 0; i < 50; ++i) {
+        const std::size_t slots = controller.update(
+            utils::make_optional(0.0), at(i * 10));
+        ATF_REQUIRE(slots >= last);
+        ATF_REQUIRE(slots <= 20);
+        last = slots;
+    }
+    ATF_REQUIRE_EQ(20, last);
+
+    for (int i = 50; i < 100; ++i) {
+        const std::size_t slots = controller.update(
+            utils::make_optional(100.0), at(i * 10));
+        ATF_REQUIRE(slots <= last);
+        ATF_REQUIRE(slots >= 2);
+        last = slots;
+    }
+    ATF_REQUIRE_EQ(2, last);
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parallelism_controller__due);
+ATF_TEST_CASE_BODY(parallelism_controller__due)
+{
+    engine::parallelism_controller controller(
+        engine::parallelism_range(1, 8));
+    ATF_REQUIRE(controller.due(at(100)));
+
+    (void)controller.update(utils::make_optional(0.0), at(100));
+    ATF_REQUIRE(!controller.due(at(100)));
+    ATF_REQUIRE(!controller.due(at(104)));
+    ATF_REQUIRE( controller.due(at(105)));
+    ATF_REQUIRE( controller.due(at(50)));
+}
+
+
+ATF_INIT_TEST_CASES(tcs)
+{
+    ATF_ADD_TEST_CASE(tcs, parallelism_range__fixed);
+    ATF_ADD_TEST_CASE(tcs, parallelism_range__adaptive);
+    ATF_ADD_TEST_CASE(tcs, parallelism_range__operators_eq_and_ne);
+    ATF_ADD_TEST_CASE(tcs, parallelism_range__output);
+
+    ATF_ADD_TEST_CASE(tcs, parallelism_controller__fixed);
+    ATF_ADD_TEST_CASE(tcs, parallelism_controller__grow_and_shrink);
+    ATF_ADD_TEST_CASE(tcs, parallelism_controller__bounds);
+    ATF_ADD_TEST_CASE(tcs, parallelism_controller__due);
+}
@@ -38,15 +38,15 @@ extern "C" {
 #include "model/test_program.hpp"
 #include "model/test_result.hpp"
 #include "utils/defs.hpp"
-#include "utils/env.hpp"
 #include "utils/format/macros.hpp"
 #include "utils/fs/path.hpp"
 #include "utils/optional.ipp"
-#include "utils/process/operations.hpp"
+#include "utils/process/executor.hpp"
 #include "utils/process/status.hpp"
 #include "utils/sanity.hpp"
 
 namespace config = utils::config;
+namespace executor = utils::process::executor;
 namespace fs = utils::fs;
 namespace process = utils::process;
 
@@ -90,19 +90,17 @@ engine::plain_interface::parse_list(
 }
 
 
-/// Executes a test case of the test program.
-///
-/// This method is intended to be called within a subprocess and is expected
-/// to terminate execution either by exec(2)ing the test program or by
-/// exiting with a failure.
+/// Describes the program that exec_test() executes.
 ///
 /// \param test_program The test program to execute.
 /// \param test_case_name Name of the test case to invoke.
 /// \param vars User-provided variables to pass to the test program.
 /// \param unused_control_directory Directory where the interface may place
 ///     control files.
-void
-engine::plain_interface::exec_test(
+///
+/// \return The program to execute.
+optional< executor::command >
+engine::plain_interface::test_command(
     const model::test_program& test_program,
     const std::string& test_case_name,
     const config::properties_map& vars,
@@ -110,13 +108,36 @@ engine::plain_interface::exec_test(
 {
     PRE(test_case_name == "main");
 
+    executor::command command(test_program.absolute_path());
     for (config::properties_map::const_iterator iter = vars.begin();
          iter != vars.end(); ++iter) {
-        utils::setenv(F("TEST_ENV_%s") % (*iter).first, (*iter).second);
+        command.environment[F("TEST_ENV_%s") % (*iter).first] =
+            (*iter).second;
     }
+    return utils::make_optional(command);
+}
+
 
-    process::args_vector args;
-    process::exec(test_program.absolute_path(), args);
+/// Executes a test case of the test program.
+///
+/// This method is intended to be called within a subprocess and is expected
+/// to terminate execution either by exec(2)ing the test program or by
+/// exiting with a failure.
+///
+/// \param test_program The test program to execute.
+/// \param test_case_name Name of the test case to invoke.
+/// \param vars User-provided variables to pass to the test program.
+/// \param control_directory Directory where the interface may place control
+///     files.
+void
+engine::plain_interface::exec_test(
+    const model::test_program& test_program,
+    const std::string& test_case_name,
+    const config::properties_map& vars,
+    const fs::path& control_directory) const
+{
+    executor::exec(test_command(
+        test_program, test_case_name, vars, control_directory).get());
 }
 
 
@@ -28,6 +28,9 @@
 
 #include "engine/requirements.hpp"
 
+#include <map>
+#include <utility>
+
 #include "model/metadata.hpp"
 #include "model/types.hpp"
 #include "utils/config/nodes.ipp"
@@ -36,6 +39,7 @@
 #include "utils/fs/operations.hpp"
 #include "utils/fs/path.hpp"
 #include "utils/memory.hpp"
+#include "utils/noncopyable.hpp"
 #include "utils/passwd.hpp"
 #include "utils/sanity.hpp"
 #include "utils/units.hpp"
@@ -236,22 +240,36 @@ check_required_disk_space(const units::bytes& required_disk_space,
 }
 
 
+/// Names of the metadata properties inspected by check_static_reqs().
+static const char* const static_properties[] = {
+    "allowed_architectures",
+    "allowed_platforms",
+    "required_configs",
+    "required_memory",
+    "required_programs",
+    "required_user",
+    NULL,
+};
+
+
 }  // anonymous namespace
 
 
-/// Checks if all the requirements specified by the test case are met.
+/// Checks the requirements of a test case that are constant during a run.
+///
+/// These requirements only depend on the test metadata, the configuration and
+/// the host, so their result is the same for every test case that shares these
+/// properties.  Callers can thus evaluate them once before spawning any test.
 ///
 /// \param md The test metadata.
 /// \param cfg The engine configuration.
 /// \param test_suite Name of the test suite the test belongs to.
-/// \param work_directory Path to where the test case will be run.
 ///
 /// \return A string describing the reason for skipping the test, or empty if
 /// the test should be executed.
 std::string
-engine::check_reqs(const model::metadata& md, const config::tree& cfg,
-                   const std::string& test_suite,
-                   const fs::path& work_directory)
+engine::check_static_reqs(const model::metadata& md, const config::tree& cfg,
+                          const std::string& test_suite)
 {
     std::string reason;
 
@@ -271,15 +289,36 @@ engine::check_reqs(const model::metadata& md, const config::tree& cfg,
     if (!reason.empty())
         return reason;
 
-    reason = check_required_files(md.required_files());
+    reason = check_required_programs(md.required_programs());
     if (!reason.empty())
         return reason;
 
-    reason = check_required_programs(md.required_programs());
+    reason = check_required_memory(md.required_memory());
     if (!reason.empty())
         return reason;
 
-    reason = check_required_memory(md.required_memory());
+    INV(reason.empty());
+    return reason;
+}
+
+
+/// Checks the requirements of a test case that depend on its environment.
+///
+/// These requirements must be evaluated right before the test runs, as other
+/// tests may change the state they depend on.
+///
+/// \param md The test metadata.
+/// \param work_directory Path to where the test case will be run.
+///
+/// \return A string describing the reason for skipping the test, or empty if
+/// the test should be executed.
+std::string
+engine::check_dynamic_reqs(const model::metadata& md,
+                           const fs::path& work_directory)
+{
+    std::string reason;
+
+    reason = check_required_files(md.required_files());
     if (!reason.empty())
         return reason;
 
@@ -291,3 +330,88 @@ engine::check_reqs(const model::metadata& md, const config::tree& cfg,
     INV(reason.empty());
     return reason;
 }
+
+
+/// Checks if all the requirements specified by the test case are met.
+///
+/// \param md The test metadata.
+/// \param cfg The engine configuration.
+/// \param test_suite Name of the test suite the test belongs to.
+/// \param work_directory Path to where the test case will be run.
+///
+/// \return A string describing the reason for skipping the test, or empty if
+/// the test should be executed.
+std::string
+engine::check_reqs(const model::metadata& md, const config::tree& cfg,
+                   const std::string& test_suite,
+                   const fs::path& work_directory)
+{
+    const std::string reason = check_static_reqs(md, cfg, test_suite);
+    if (!reason.empty())
+        return reason;
+
+    return check_dynamic_reqs(md, work_directory);
+}
+
+
+/// Internal implementation of the reqs_cache class.
+struct engine::reqs_cache::impl : utils::noncopyable {
+    /// The engine configuration.
+    const config::tree user_config;
+
+    /// Results of the checks performed so far, keyed by their inputs.
+    std::map< std::string, std::string > reasons;
+
+    /// Constructor.
+    ///
+    /// \param user_config_ The engine configuration.
+    impl(const config::tree& user_config_) : user_config(user_config_)
+    {
+    }
+};
+
+
+/// Constructor.
+///
+/// \param user_config The engine configuration.  Must not be modified while
+///     this object is alive.
+engine::reqs_cache::reqs_cache(const config::tree& user_config) :
+    _pimpl(new impl(user_config))
+{
+}
+
+
+/// Destructor.
+engine::reqs_cache::~reqs_cache(void)
+{
+}
+
+
+/// Checks the requirements of a test case that are constant during a run.
+///
+/// \param md The test metadata.
+/// \param test_suite Name of the test suite the test belongs to.
+///
+/// \return The same as check_static_reqs(), which is only invoked the first
+/// time a given combination of requirements and test suite is seen.
+const std::string&
+engine::reqs_cache::check_static(const model::metadata& md,
+                                 const std::string& test_suite)
+{
+    const model::properties_map props = md.to_properties();
+    std::string key = test_suite;
+    for (const char* const* name = static_properties; *name != NULL; ++name) {
+        const model::properties_map::const_iterator iter = props.find(*name);
+        INV(iter != props.end());
+        key += '\0';
+        key += (*iter).second;
+    }
+
+    std::map< std::string, std::string >::const_iterator iter =
+        _pimpl->reasons.find(key);
+    if (iter == _pimpl->reasons.end()) {
+        iter = _pimpl->reasons.insert(std::make_pair(
+            key, check_static_reqs(md, _pimpl->user_config, test_suite))).first;
+    }
+    return (*iter).second;
+}
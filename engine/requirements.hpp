@@ -37,10 +37,34 @@
 #include "model/metadata_fwd.hpp"
 #include "utils/config/tree_fwd.hpp"
 #include "utils/fs/path_fwd.hpp"
+#include "utils/shared_ptr.hpp"
 
 namespace engine {
 
 
+/// Memoized evaluator of the requirements that are constant during a run.
+///
+/// Checks such as looking up the required programs in the PATH are costly
+/// when repeated for thousands of test cases that share the same requirements,
+/// so this evaluates them once per distinct set of requirements.
+class reqs_cache {
+    struct impl;
+
+    /// Pointer to the shared internal implementation.
+    std::shared_ptr< impl > _pimpl;
+
+public:
+    explicit reqs_cache(const utils::config::tree&);
+    ~reqs_cache(void);
+
+    const std::string& check_static(const model::metadata&,
+                                    const std::string&);
+};
+
+
+std::string check_static_reqs(const model::metadata&,
+                              const utils::config::tree&, const std::string&);
+std::string check_dynamic_reqs(const model::metadata&, const utils::fs::path&);
 std::string check_reqs(const model::metadata&, const utils::config::tree&,
                        const std::string&, const utils::fs::path&);
 
@@ -478,6 +478,88 @@ ATF_TEST_CASE_BODY(check_reqs__required_programs__fail_relative)
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(check_static_reqs__ignores_dynamic);
+ATF_TEST_CASE_BODY(check_static_reqs__ignores_dynamic)
+{
+    const model::metadata md = model::metadata_builder()
+        .add_required_file(fs::current_path() / "missing")
+        .set_required_disk_space(units::bytes::parse("1000t"))
+        .build();
+
+    ATF_REQUIRE(engine::check_static_reqs(md, engine::empty_config(),
+                                          "").empty());
+    ATF_REQUIRE_MATCH("Required file '.*/missing' not found",
+                      engine::check_dynamic_reqs(md, fs::path(".")));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(check_dynamic_reqs__ignores_static);
+ATF_TEST_CASE_BODY(check_dynamic_reqs__ignores_static)
+{
+    const model::metadata md = model::metadata_builder()
+        .add_allowed_platform("other-platform")
+        .add_required_program(fs::path("/non-existent/program"))
+        .build();
+
+    ATF_REQUIRE(engine::check_dynamic_reqs(md, fs::path(".")).empty());
+    ATF_REQUIRE_MATCH("Current platform .* not supported",
+                      engine::check_static_reqs(md, engine::empty_config(),
+                                                ""));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(reqs_cache__memoized);
+ATF_TEST_CASE_BODY(reqs_cache__memoized)
+{
+    const model::metadata md = model::metadata_builder()
+        .add_required_program(fs::path("foo"))
+        .build();
+
+    fs::mkdir(fs::path("bin"), 0755);
+    utils::setenv("PATH", (fs::current_path() / "bin").str());
+
+    const config::tree user_config = engine::empty_config();
+    engine::reqs_cache cache(user_config);
+    ATF_REQUIRE_MATCH("'foo' not found in PATH$",
+                      cache.check_static(md, "the-suite"));
+
+    // Once checked, the requirements are not reevaluated for the same inputs
+    // even if the system changes.
+    atf::utils::create_file("bin/foo", "");
+    ATF_REQUIRE_MATCH("'foo' not found in PATH$",
+                      cache.check_static(md, "the-suite"));
+    ATF_REQUIRE(engine::reqs_cache(user_config).check_static(
+        md, "the-suite").empty());
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(reqs_cache__distinct_inputs);
+ATF_TEST_CASE_BODY(reqs_cache__distinct_inputs)
+{
+    const model::metadata md1 = model::metadata_builder()
+        .add_required_config("my-var")
+        .build();
+    const model::metadata md2 = model::metadata_builder()
+        .add_required_config("my-var")
+        .set_description("Same requirements as md1")
+        .build();
+    const model::metadata md3 = model::metadata_builder()
+        .add_required_config("other-var")
+        .build();
+
+    config::tree user_config = engine::empty_config();
+    user_config.set_string("test_suites.suite-a.my-var", "value");
+    engine::reqs_cache cache(user_config);
+
+    ATF_REQUIRE(cache.check_static(md1, "suite-a").empty());
+    ATF_REQUIRE(cache.check_static(md2, "suite-a").empty());
+    ATF_REQUIRE_MATCH("'my-var' not defined",
+                      cache.check_static(md1, "suite-b"));
+    ATF_REQUIRE_MATCH("'other-var' not defined",
+                      cache.check_static(md3, "suite-a"));
+}
+
+
 ATF_INIT_TEST_CASES(tcs)
 {
     ATF_ADD_TEST_CASE(tcs, check_reqs__none);
@@ -508,4 +590,10 @@ ATF_INIT_TEST_CASES(tcs)
     ATF_ADD_TEST_CASE(tcs, check_reqs__required_programs__ok);
     ATF_ADD_TEST_CASE(tcs, check_reqs__required_programs__fail_absolute);
     ATF_ADD_TEST_CASE(tcs, check_reqs__required_programs__fail_relative);
+
+    ATF_ADD_TEST_CASE(tcs, check_static_reqs__ignores_dynamic);
+    ATF_ADD_TEST_CASE(tcs, check_dynamic_reqs__ignores_static);
+
+    ATF_ADD_TEST_CASE(tcs, reqs_cache__memoized);
+    ATF_ADD_TEST_CASE(tcs, reqs_cache__distinct_inputs);
 }
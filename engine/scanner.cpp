@@ -91,9 +91,15 @@ struct engine::scanner::impl : utils::noncopyable {
     /// \param filters_ List of scan filters as provided by the user.
     impl(const model::test_programs_vector& test_programs_,
          const std::set< engine::test_filter >& filters_) :
-        pending_test_programs(test_programs_.begin(), test_programs_.end()),
         filters(filters_)
     {
+        // Discard the test programs that cannot possibly match upfront so that
+        // upcoming_test_programs() does not need to skip over them repeatedly.
+        for (model::test_programs_vector::const_iterator iter =
+                 test_programs_.begin(); iter != test_programs_.end(); ++iter) {
+            if (filters.match_test_program((*iter)->relative_path()))
+                pending_test_programs.push_back(*iter);
+        }
     }
 
     /// Positions the internal state to return the next element if any.
@@ -119,12 +125,6 @@ struct engine::scanner::impl : utils::noncopyable {
 
             model::test_program_ptr test_program = pending_test_programs[0];
             if (!first_test_cases) {
-                if (!filters.match_test_program(
-                        test_program->relative_path())) {
-                    pending_test_programs.pop_front();
-                    continue;
-                }
-
                 first_test_cases = utils::make_optional(
                     map_keys(test_program->test_cases()));
             }
@@ -206,6 +206,38 @@ engine::scanner::done(void)
 }
 
 
+/// Returns the test programs that the scanner will process next.
+///
+/// This does not trigger the loading of the test cases of any test program, so
+/// the caller can use this to start loading them ahead of time (e.g. in the
+/// background) before yield() gets to them.
+///
+/// \param max_count Maximum number of test programs to return.
+///
+/// \return The collection of test programs, in the order in which they will be
+/// scanned.  This includes the test program that is currently being scanned, if
+/// any.
+model::test_programs_vector
+engine::scanner::upcoming_test_programs(const std::size_t max_count) const
+{
+    std::deque< model::test_program_ptr >::const_iterator iter =
+        _pimpl->pending_test_programs.begin();
+    if (iter != _pimpl->pending_test_programs.end() &&
+        _pimpl->first_test_cases && _pimpl->first_test_cases.get().empty()) {
+        // The active test program has been fully consumed but advance() has not
+        // yet had a chance to discard it.
+        ++iter;
+    }
+
+    model::test_programs_vector upcoming;
+    for (; iter != _pimpl->pending_test_programs.end() &&
+             upcoming.size() < max_count; ++iter) {
+        upcoming.push_back(*iter);
+    }
+    return upcoming;
+}
+
+
 /// Returns the list of test filters that did not match any test case.
 ///
 /// \return The collection of unmatched test filters.
@@ -34,6 +34,7 @@
 
 #include "engine/scanner_fwd.hpp"
 
+#include <cstddef>
 #include <memory>
 #include <set>
 
@@ -67,6 +68,8 @@ public:
     bool done(void);
     utils::optional< scan_result > yield(void);
 
+    model::test_programs_vector upcoming_test_programs(const std::size_t) const;
+
     std::set< test_filter > unused_filters(void) const;
 };
 
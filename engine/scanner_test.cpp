@@ -460,6 +460,55 @@ ATF_TEST_CASE_BODY(scanner__with_filters__verify_lazy_loads)
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(scanner__upcoming_test_programs);
+ATF_TEST_CASE_BODY(scanner__upcoming_test_programs)
+{
+    const model::test_program_ptr test_program1(new mock_test_program(
+        fs::path("first")));
+    const mock_test_program* mock_program1 =
+        dynamic_cast< const mock_test_program* >(test_program1.get());
+    const model::test_program_ptr test_program2(new mock_test_program(
+        fs::path("second")));
+    const mock_test_program* mock_program2 =
+        dynamic_cast< const mock_test_program* >(test_program2.get());
+    const model::test_program_ptr test_program3(new mock_test_program(
+        fs::path("third")));
+    const mock_test_program* mock_program3 =
+        dynamic_cast< const mock_test_program* >(test_program3.get());
+
+    model::test_programs_vector test_programs;
+    test_programs.push_back(test_program1);
+    test_programs.push_back(test_program2);
+    test_programs.push_back(test_program3);
+
+    std::set< engine::test_filter > filters;
+    filters.insert(engine::test_filter(fs::path("first"), ""));
+    filters.insert(engine::test_filter(fs::path("third"), ""));
+
+    engine::scanner scanner(test_programs, filters);
+
+    model::test_programs_vector exp_upcoming;
+    exp_upcoming.push_back(test_program1);
+    ATF_REQUIRE_EQ(exp_upcoming, scanner.upcoming_test_programs(1));
+    exp_upcoming.push_back(test_program3);
+    ATF_REQUIRE_EQ(exp_upcoming, scanner.upcoming_test_programs(2));
+    ATF_REQUIRE_EQ(exp_upcoming, scanner.upcoming_test_programs(10));
+
+    ATF_REQUIRE_EQ(0, mock_program1->num_calls());
+    ATF_REQUIRE_EQ(0, mock_program2->num_calls());
+    ATF_REQUIRE_EQ(0, mock_program3->num_calls());
+
+    (void)scanner.yield();
+    (void)scanner.yield();
+    exp_upcoming.erase(exp_upcoming.begin());
+    ATF_REQUIRE_EQ(exp_upcoming, scanner.upcoming_test_programs(10));
+
+    ATF_REQUIRE_EQ(1, mock_program1->num_calls());
+    ATF_REQUIRE_EQ(0, mock_program2->num_calls());
+    ATF_REQUIRE_EQ(0, mock_program3->num_calls());
+}
+
+
 ATF_INIT_TEST_CASES(tcs)
 {
     ATF_ADD_TEST_CASE(tcs, scanner__no_filters__no_tests);
@@ -473,4 +522,6 @@ ATF_INIT_TEST_CASES(tcs)
     ATF_ADD_TEST_CASE(tcs, scanner__with_filters__no_matches);
     ATF_ADD_TEST_CASE(tcs, scanner__with_filters__some_matches);
     ATF_ADD_TEST_CASE(tcs, scanner__with_filters__verify_lazy_loads);
+
+    ATF_ADD_TEST_CASE(tcs, scanner__upcoming_test_programs);
 }
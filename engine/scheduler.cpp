@@ -29,12 +29,17 @@
 #include "engine/scheduler.hpp"
 
 extern "C" {
+#include <sys/stat.h>
+
+#include <signal.h>
 #include <unistd.h>
 }
 
 #include <cstdio>
 #include <cstdlib>
 #include <fstream>
+#include <map>
+#include <set>
 #include <stdexcept>
 
 #include "engine/config.hpp"
@@ -45,6 +50,8 @@ extern "C" {
 #include "model/test_case.hpp"
 #include "model/test_program.hpp"
 #include "model/test_result.hpp"
+#include "store/exceptions.hpp"
+#include "store/list_cache.hpp"
 #include "utils/config/tree.ipp"
 #include "utils/datetime.hpp"
 #include "utils/defs.hpp"
@@ -59,12 +66,16 @@ extern "C" {
 #include "utils/optional.ipp"
 #include "utils/passwd.hpp"
 #include "utils/process/executor.ipp"
+#include "utils/process/isolation.hpp"
+#include "utils/process/resource_usage.hpp"
 #include "utils/process/status.hpp"
 #include "utils/sanity.hpp"
 #include "utils/shared_ptr.hpp"
 #include "utils/stacktrace.hpp"
 #include "utils/stream.hpp"
 #include "utils/text/operations.ipp"
+#include "utils/trace.hpp"
+#include "utils/units.hpp"
 
 namespace config = utils::config;
 namespace datetime = utils::datetime;
@@ -75,6 +86,8 @@ namespace passwd = utils::passwd;
 namespace process = utils::process;
 namespace scheduler = engine::scheduler;
 namespace text = utils::text;
+namespace trace = utils::trace;
+namespace units = utils::units;
 
 using utils::none;
 using utils::optional;
@@ -113,6 +126,13 @@ static const int exit_skipped = 84;
 static const char* skipped_cookie = "skipped.txt";
 
 
+/// Text file containing the reason why a work directory could not be removed.
+///
+/// This is only created by the subprocesses that empty the work directories of
+/// finished tests in the background, and only if they fail to do so.
+static const char* removal_error_cookie = "removal_error.txt";
+
+
 /// Mapping of interface names to interface definitions.
 typedef std::map< std::string, std::shared_ptr< scheduler::interface > >
     interfaces_map;
@@ -158,6 +178,157 @@ append_files_listing(const fs::path& dir_path, const fs::path& output_file)
 }
 
 
+/// Checks if a directory contains any entries.
+///
+/// \param dir_path The directory to scan.
+///
+/// \return True if the directory has any entry other than . and ..
+///
+/// \throw fs::error If there are problems listing the directory.
+static bool
+has_entries(const fs::path& dir_path)
+{
+    const fs::directory dir(dir_path);
+    for (fs::directory::const_iterator iter = dir.begin(); iter != dir.end();
+         ++iter) {
+        if (iter->name != "." && iter->name != "..")
+            return true;
+    }
+    return false;
+}
+
+
+/// Computes the resource limits to apply to the body of a test case.
+///
+/// Limits defined in the metadata of the test case take precedence over the
+/// defaults provided by the user configuration.
+///
+/// \param md The metadata of the test case.
+/// \param user_config User-provided configuration variables.
+///
+/// \return The limits to apply; may be unlimited.
+static process::resource_limits
+test_limits(const model::metadata& md, const config::tree& user_config)
+{
+    process::resource_limits limits(md.cpu_time_limit(), md.memory_limit());
+    if (limits.cpu_time == datetime::delta() &&
+        user_config.is_set("cpu_time_limit")) {
+        limits.cpu_time = datetime::delta(
+            user_config.lookup< config::positive_int_node >("cpu_time_limit"),
+            0);
+    }
+    if (limits.memory == 0 && user_config.is_set("memory_limit")) {
+        limits.memory = user_config.lookup< engine::bytes_node >(
+            "memory_limit");
+    }
+    return limits;
+}
+
+
+/// Checks if a test case was terminated for exceeding its CPU time limit.
+///
+/// The system sends SIGXCPU when the soft limit is reached and SIGKILL if the
+/// process keeps running past the hard limit, so the latter is only attributed
+/// to the limit if the process did consume all of its allowed CPU time.
+///
+/// \param handle The exit handle of the test case body.
+/// \param limits The limits that were applied to the test case body.
+///
+/// \return True if the test case hit its CPU time limit; false otherwise.
+static bool
+exceeded_cpu_time(const executor::exit_handle& handle,
+                  const process::resource_limits& limits)
+{
+    if (limits.cpu_time == datetime::delta())
+        return false;
+    if (!handle.status() || !handle.status().get().signaled())
+        return false;
+
+    const int signo = handle.status().get().termsig();
+    if (signo == SIGXCPU)
+        return true;
+    return signo == SIGKILL && handle.usage().user_time +
+        handle.usage().system_time >= limits.cpu_time;
+}
+
+
+/// Frozen view of the user configuration shared by the subprocesses of a run.
+///
+/// The configuration variables of every test suite are computed once, the
+/// first time they are needed, and are then shared by all the subprocesses
+/// that belong to that test suite.  The same applies to the requirements of
+/// the test cases that do not depend on their environment.
+class config_snapshot : utils::noncopyable {
+    /// Deep copy of the user configuration.  Never modified.
+    const config::tree _user_config;
+
+    /// Configuration variables of the test suites queried so far.
+    mutable std::map< std::string, config::properties_map > _test_suites_vars;
+
+    /// Results of the static requirements checks performed so far.
+    mutable engine::reqs_cache _reqs_cache;
+
+public:
+    /// Constructor.
+    ///
+    /// \param user_config The user configuration to freeze.
+    explicit config_snapshot(const config::tree& user_config) :
+        _user_config(user_config.deep_copy()),
+        _reqs_cache(_user_config)
+    {
+    }
+
+    /// Gets the frozen user configuration.
+    ///
+    /// \return The user configuration.
+    const config::tree&
+    user_config(void) const
+    {
+        return _user_config;
+    }
+
+    /// Gets the configuration variables for a test suite.
+    ///
+    /// \param test_suite The name of the test suite.
+    ///
+    /// \return The variables as returned by scheduler::generate_config().  The
+    /// reference remains valid for as long as this object is alive.
+    const config::properties_map&
+    test_suite_vars(const std::string& test_suite) const
+    {
+        std::map< std::string, config::properties_map >::const_iterator iter =
+            _test_suites_vars.find(test_suite);
+        if (iter == _test_suites_vars.end()) {
+            iter = _test_suites_vars.insert(std::make_pair(
+                test_suite, scheduler::generate_config(
+                    _user_config, test_suite))).first;
+        }
+        return (*iter).second;
+    }
+
+    /// Checks the requirements of a test case that are constant during a run.
+    ///
+    /// \param test_program The test program containing the test case.
+    /// \param test_case_name The name of the test case.
+    ///
+    /// \return A string describing the reason for skipping the test, or empty
+    /// if the test should be executed.  The reference remains valid for as
+    /// long as this object is alive.
+    const std::string&
+    static_skip_reason(const model::test_program& test_program,
+                       const std::string& test_case_name) const
+    {
+        const model::test_case& test_case = test_program.find(test_case_name);
+        return _reqs_cache.check_static(test_case.get_metadata(),
+                                        test_program.test_suite_name());
+    }
+};
+
+
+/// Shared pointer to a config_snapshot.
+typedef std::shared_ptr< const config_snapshot > config_snapshot_ptr;
+
+
 /// Maintenance data held while a test is being executed.
 ///
 /// This data structure exists from the moment when a test is executed via
@@ -198,7 +369,7 @@ struct test_exec_data : public exec_data {
     /// User configuration passed to the execution of the test.  We need this
     /// here to recover it later when chaining the execution of a cleanup
     /// routine (if any).
-    const config::tree user_config;
+    const config_snapshot_ptr user_config;
 
     /// Whether this test case still needs to have its cleanup routine executed.
     ///
@@ -213,18 +384,34 @@ struct test_exec_data : public exec_data {
     /// as indicated by needs_cleanup.
     optional< executor::exit_handle > exit_handle;
 
+    /// Resources reserved by the interface via prepare_test().
+    const int reservation;
+
+    /// Resource limits applied to the test case body.
+    const process::resource_limits limits;
+
+    /// Trace track on which the activity of this test is recorded.
+    const int track;
+
     /// Constructor.
     ///
     /// \param test_program_ Test program data for this test case.
     /// \param test_case_name_ Name of the test case.
     /// \param interface_ Test program-specific execution interface.
     /// \param user_config_ User configuration passed to the test.
+    /// \param reservation_ Resources reserved by the interface for the test.
+    /// \param limits_ Resource limits applied to the test case body.
+    /// \param track_ Trace track on which to record the test.
     test_exec_data(const model::test_program_ptr test_program_,
                    const std::string& test_case_name_,
                    const std::shared_ptr< scheduler::interface > interface_,
-                   const config::tree& user_config_) :
+                   const config_snapshot_ptr user_config_,
+                   const int reservation_,
+                   const process::resource_limits& limits_,
+                   const int track_) :
         exec_data(test_program_, test_case_name_),
-        interface(interface_), user_config(user_config_)
+        interface(interface_), user_config(user_config_),
+        reservation(reservation_), limits(limits_), track(track_)
     {
         const model::test_case& test_case = test_program->find(test_case_name);
         needs_cleanup = test_case.get_metadata().has_cleanup();
@@ -266,6 +453,100 @@ struct cleanup_exec_data : public exec_data {
 };
 
 
+/// Maintenance data held while the work directory of a test is being emptied.
+///
+/// Instances of this object are related to a previous test_exec_data or
+/// cleanup_exec_data, as the work directory can only be removed once the test
+/// and its cleanup routine have finished.
+struct removal_exec_data : public exec_data {
+    /// The exit handle of the test.  This is necessary so that we can return
+    /// the correct exit_handle to the user of the scheduler.
+    executor::exit_handle body_exit_handle;
+
+    /// The final result of the test, including its cleanup routine.
+    model::test_result body_result;
+
+    /// Constructor.
+    ///
+    /// \param test_program_ Test program data for this test case.
+    /// \param test_case_name_ Name of the test case.
+    /// \param body_exit_handle_ Exit handle of the test whose work directory
+    ///     is being emptied.
+    /// \param body_result_ Final result of the test.
+    removal_exec_data(const model::test_program_ptr test_program_,
+                      const std::string& test_case_name_,
+                      const executor::exit_handle& body_exit_handle_,
+                      const model::test_result& body_result_) :
+        exec_data(test_program_, test_case_name_),
+        body_exit_handle(body_exit_handle_), body_result(body_result_)
+    {
+    }
+};
+
+
+/// Maintenance data held while the stack trace of a crashed test is gathered.
+///
+/// Instances of this object are related to a previous test_exec_data or
+/// cleanup_exec_data, which remain tracked under the PID of the crashed process
+/// until the stack trace has been appended to its stderr.
+struct stacktrace_exec_data : public exec_data {
+    /// The exit handle of the crashed process.  This is necessary so that we
+    /// can resume the processing of its result once GDB finishes.
+    executor::exit_handle body_exit_handle;
+
+    /// Constructor.
+    ///
+    /// \param test_program_ Test program data for this test case.
+    /// \param test_case_name_ Name of the test case.
+    /// \param body_exit_handle_ Exit handle of the crashed process.
+    stacktrace_exec_data(const model::test_program_ptr test_program_,
+                         const std::string& test_case_name_,
+                         const executor::exit_handle& body_exit_handle_) :
+        exec_data(test_program_, test_case_name_),
+        body_exit_handle(body_exit_handle_)
+    {
+    }
+};
+
+
+/// Maintenance data held while a test program is listed in the background.
+///
+/// Instances of this object only exist for list operations started via
+/// scheduler::start_list_tests() and are untracked as soon as the list of test
+/// cases has been collected, either by wait_any() or by list_tests().
+struct list_exec_data : public exec_data {
+    /// Test program-specific execution interface.
+    const std::shared_ptr< scheduler::interface > interface;
+
+    /// Handle of the subprocess running the list operation.
+    const executor::exec_handle exec_handle;
+
+    /// User-provided configuration variables given to the list operation.
+    const config_snapshot_ptr config;
+
+    /// Trace track on which the list operation is recorded.
+    const int track;
+
+    /// Constructor.
+    ///
+    /// \param test_program_ Test program being listed.
+    /// \param interface_ Test program-specific execution interface.
+    /// \param exec_handle_ Handle of the subprocess running the list operation.
+    /// \param config_ User-provided configuration variables.
+    /// \param track_ Trace track on which to record the list operation.
+    list_exec_data(const model::test_program_ptr test_program_,
+                   const std::shared_ptr< scheduler::interface > interface_,
+                   const executor::exec_handle& exec_handle_,
+                   const config_snapshot_ptr config_,
+                   const int track_) :
+        exec_data(test_program_, ""),
+        interface(interface_), exec_handle(exec_handle_), config(config_),
+        track(track_)
+    {
+    }
+};
+
+
 /// Shared pointer to exec_data.
 ///
 /// We require this because we want exec_data to not be copyable, and thus we
@@ -277,6 +558,54 @@ typedef std::shared_ptr< exec_data > exec_data_ptr;
 typedef std::map< int, exec_data_ptr > exec_data_map;
 
 
+/// Mapping of test programs to the PIDs of their in-flight list operations.
+typedef std::map< const model::test_program*, int > pending_listings_map;
+
+
+/// Mapping of test programs to their already-collected list of test cases.
+typedef std::map< const model::test_program*, model::test_cases_map >
+    ready_listings_map;
+
+
+/// Mapping of test programs to their snapshots with absolute paths.
+///
+/// Each snapshot is paired with the number of tests in flight that use it.
+typedef std::map< model::test_program_ptr,
+                  std::pair< model::test_program_ptr, std::size_t > >
+    absolute_programs_map;
+
+
+/// First trace track used to display the slots in which tests run.
+static const int first_slot_track = 1;
+
+
+/// First trace track used to display background list operations.
+///
+/// This is far enough from first_slot_track for the two ranges to never
+/// overlap in practice.
+static const int first_listing_track = 10000;
+
+
+/// Records the execution of a subprocess in the trace, if enabled.
+///
+/// \param name The name of the activity performed by the subprocess.
+/// \param track The trace track on which to record the activity.
+/// \param data The data of the test or test program the subprocess belongs to.
+/// \param handle The exit handle of the subprocess.
+static void
+trace_process(const char* name, const int track, const exec_data& data,
+              const executor::exit_handle& handle)
+{
+    if (!trace::enabled())
+        return;
+    const std::string detail = data.test_case_name.empty() ?
+        data.test_program->relative_path().str() :
+        F("%s:%s") % data.test_program->relative_path() % data.test_case_name;
+    trace::complete(name, track, handle.start_time(), handle.end_time(),
+                    detail);
+}
+
+
 /// Enforces a test program to hold an absolute path.
 ///
 /// TODO(jmmv): This function (which is a pretty ugly hack) exists because we
@@ -290,10 +619,14 @@ typedef std::map< int, exec_data_ptr > exec_data_map;
 /// current path at test_program creation time; or maybe something else.
 ///
 /// \param program The test program to modify.
+/// \param test_cases The test cases to place in the new test program.  This is
+///     explicit so that callers can avoid copying the (possibly huge) list of
+///     test cases of the program when they do not need it.
 ///
 /// \return A new test program whose internal paths are absolute.
-static model::test_program
-force_absolute_paths(const model::test_program program)
+static model::test_program_ptr
+force_absolute_paths(const model::test_program& program,
+                     const model::test_cases_map& test_cases)
 {
     const std::string& relative = program.relative_path().str();
     const std::string absolute = program.absolute_path().str();
@@ -301,11 +634,11 @@ force_absolute_paths(const model::test_program program)
     const std::string root = absolute.substr(
         0, absolute.length() - relative.length());
 
-    return model::test_program(
+    return model::test_program_ptr(new model::test_program(
         program.interface_name(),
         program.relative_path(), fs::path(root),
         program.test_suite_name(),
-        program.get_metadata(), program.test_cases());
+        program.get_metadata(), test_cases));
 }
 
 
@@ -314,35 +647,39 @@ class list_test_cases {
     /// Interface of the test program to execute.
     std::shared_ptr< scheduler::interface > _interface;
 
-    /// Test program to execute.
-    const model::test_program _test_program;
+    /// Test program to execute, with no test cases.
+    const model::test_program_ptr _test_program;
 
     /// User-provided configuration variables.
-    const config::tree& _user_config;
+    const config_snapshot_ptr _config;
 
 public:
     /// Constructor.
     ///
     /// \param interface Interface of the test program to execute.
     /// \param test_program Test program to execute.
-    /// \param user_config User-provided configuration variables.
+    /// \param config User-provided configuration variables.
     list_test_cases(
         const std::shared_ptr< scheduler::interface > interface,
         const model::test_program* test_program,
-        const config::tree& user_config) :
+        const config_snapshot_ptr config) :
         _interface(interface),
-        _test_program(force_absolute_paths(*test_program)),
-        _user_config(user_config)
+        _test_program(force_absolute_paths(*test_program,
+                                           model::test_cases_map())),
+        _config(config)
     {
+        // Compute the variables in the parent so that they are cached for any
+        // other subprocesses of the same test suite.
+        (void)_config->test_suite_vars(_test_program->test_suite_name());
     }
 
     /// Body of the subprocess.
     void
     operator()(const fs::path& UTILS_UNUSED_PARAM(control_directory))
     {
-        const config::properties_map vars = scheduler::generate_config(
-            _user_config, _test_program.test_suite_name());
-        _interface->exec_list(_test_program, vars);
+        _interface->exec_list(
+            *_test_program,
+            _config->test_suite_vars(_test_program->test_suite_name()));
     }
 };
 
@@ -352,22 +689,29 @@ class run_test_program {
     /// Interface of the test program to execute.
     std::shared_ptr< scheduler::interface > _interface;
 
-    /// Test program to execute.
-    const model::test_program _test_program;
+    /// Test program to execute, with absolute paths.
+    const model::test_program_ptr _test_program;
 
     /// Name of the test case to execute.
     const std::string& _test_case_name;
 
     /// User-provided configuration variables.
-    const config::tree& _user_config;
+    const config_snapshot_ptr _config;
+
+    /// Configuration variables of the test suite of the test program.
+    const config::properties_map& _vars;
+
+    /// Reason for skipping the test as determined by the static requirements.
+    const std::string& _static_skip_reason;
 
     /// Verifies if the test case needs to be skipped or not.
     ///
-    /// We could very well run this on the scheduler parent process before
-    /// issuing the fork.  However, doing this here in the child process is
-    /// better for two reasons: first, it allows us to continue using the simple
-    /// spawn/wait abstraction of the scheduler; and, second, we parallelize the
-    /// requirements checks among tests.
+    /// The requirements that are constant during a run are evaluated (and
+    /// memoized) by the scheduler parent process, which lets callers avoid
+    /// spawning tests that are going to be skipped.  The rest are checked here
+    /// in the child process, right before the test runs, as they depend on the
+    /// state of the system at that time.  Doing so also parallelizes them
+    /// among tests.
     ///
     /// \post If the test's preconditions are not met, the caller process is
     /// terminated with a special exit code and a "skipped cookie" is written to
@@ -378,13 +722,12 @@ class run_test_program {
     void
     do_requirements_check(const fs::path& skipped_cookie_path)
     {
-        const model::test_case& test_case = _test_program.find(
+        const model::test_case& test_case = _test_program->find(
             _test_case_name);
 
-        const std::string skip_reason = engine::check_reqs(
-            test_case.get_metadata(), _user_config,
-            _test_program.test_suite_name(),
-            fs::current_path());
+        const std::string skip_reason = !_static_skip_reason.empty() ?
+            _static_skip_reason : engine::check_dynamic_reqs(
+                test_case.get_metadata(), fs::current_path());
         if (skip_reason.empty())
             return;
 
@@ -407,35 +750,67 @@ public:
     /// Constructor.
     ///
     /// \param interface Interface of the test program to execute.
-    /// \param test_program Test program to execute.
+    /// \param test_program Test program to execute.  Must have been processed
+    ///     by force_absolute_paths().
     /// \param test_case_name Name of the test case to execute.
-    /// \param user_config User-provided configuration variables.
+    /// \param config User-provided configuration variables.
     run_test_program(
         const std::shared_ptr< scheduler::interface > interface,
         const model::test_program_ptr test_program,
         const std::string& test_case_name,
-        const config::tree& user_config) :
+        const config_snapshot_ptr config) :
         _interface(interface),
-        _test_program(force_absolute_paths(*test_program)),
+        _test_program(test_program),
         _test_case_name(test_case_name),
-        _user_config(user_config)
+        _config(config),
+        _vars(config->test_suite_vars(test_program->test_suite_name())),
+        _static_skip_reason(config->static_skip_reason(*test_program,
+                                                       test_case_name))
     {
     }
 
+    /// Describes the program that the subprocess would execute.
+    ///
+    /// This lets the executor start the test case without forking when the
+    /// subprocess has nothing to do other than executing the test program.
+    ///
+    /// \param control_directory Directory where the interface may place control
+    ///     files.
+    ///
+    /// \return The program to execute, or none if the subprocess has to run.
+    optional< executor::command >
+    command(const fs::path& control_directory) const
+    {
+        const model::test_case& test_case = _test_program->find(
+            _test_case_name);
+        if (test_case.fake_result() || !_static_skip_reason.empty())
+            return none;
+
+        // The subprocess would check these right before running the test case,
+        // which is no different from checking them here: the work directory
+        // already exists.  If they are not met, let the subprocess record the
+        // reason.
+        if (!engine::check_dynamic_reqs(
+                test_case.get_metadata(),
+                control_directory / executor::detail::work_subdir).empty())
+            return none;
+
+        return _interface->test_command(*_test_program, _test_case_name,
+                                        _vars, control_directory);
+    }
+
     /// Body of the subprocess.
     void
     operator()(const fs::path& control_directory)
     {
-        const model::test_case& test_case = _test_program.find(
+        const model::test_case& test_case = _test_program->find(
             _test_case_name);
         if (test_case.fake_result())
             ::_exit(EXIT_SUCCESS);
 
         do_requirements_check(control_directory / skipped_cookie);
 
-        const config::properties_map vars = scheduler::generate_config(
-            _user_config, _test_program.test_suite_name());
-        _interface->exec_test(_test_program, _test_case_name, vars,
+        _interface->exec_test(*_test_program, _test_case_name, _vars,
                               control_directory);
     }
 };
@@ -446,31 +821,36 @@ class run_test_cleanup {
     /// Interface of the test program to execute.
     std::shared_ptr< scheduler::interface > _interface;
 
-    /// Test program to execute.
-    const model::test_program _test_program;
+    /// Test program to execute, with absolute paths.
+    const model::test_program_ptr _test_program;
 
     /// Name of the test case to execute.
     const std::string& _test_case_name;
 
     /// User-provided configuration variables.
-    const config::tree& _user_config;
+    const config_snapshot_ptr _config;
+
+    /// Configuration variables of the test suite of the test program.
+    const config::properties_map& _vars;
 
 public:
     /// Constructor.
     ///
     /// \param interface Interface of the test program to execute.
-    /// \param test_program Test program to execute.
+    /// \param test_program Test program to execute.  Must have been processed
+    ///     by force_absolute_paths().
     /// \param test_case_name Name of the test case to execute.
-    /// \param user_config User-provided configuration variables.
+    /// \param config User-provided configuration variables.
     run_test_cleanup(
         const std::shared_ptr< scheduler::interface > interface,
         const model::test_program_ptr test_program,
         const std::string& test_case_name,
-        const config::tree& user_config) :
+        const config_snapshot_ptr config) :
         _interface(interface),
-        _test_program(force_absolute_paths(*test_program)),
+        _test_program(test_program),
         _test_case_name(test_case_name),
-        _user_config(user_config)
+        _config(config),
+        _vars(config->test_suite_vars(test_program->test_suite_name()))
     {
     }
 
@@ -478,14 +858,65 @@ public:
     void
     operator()(const fs::path& control_directory)
     {
-        const config::properties_map vars = scheduler::generate_config(
-            _user_config, _test_program.test_suite_name());
-        _interface->exec_cleanup(_test_program, _test_case_name, vars,
+        _interface->exec_cleanup(*_test_program, _test_case_name, _vars,
                                  control_directory);
     }
 };
 
 
+/// Functor to empty the work directory of a finished test in a child process.
+///
+/// The subprocess runs in the context of the test, so it starts within the work
+/// directory and has the same privileges as the test.  The directory itself is
+/// left behind, along with the control files, for the final cleanup of the
+/// test's exit handle to remove.
+class remove_work_directory {
+public:
+    /// Body of the subprocess.
+    ///
+    /// \param control_directory Directory where the error cookie is written if
+    ///     the removal fails.
+    void
+    operator()(const fs::path& control_directory)
+    {
+        try {
+            const fs::path work_directory = fs::current_path();
+            const fs::directory dir(work_directory);
+            for (fs::directory::const_iterator iter = dir.begin();
+                 iter != dir.end(); ++iter) {
+                if (iter->name == "." || iter->name == "..")
+                    continue;
+
+                // Symbolic links must be removed, not followed: fs::rm_r()
+                // refuses to traverse them.  If lstat(2) fails, unlink(2) will
+                // report the problem.
+                const fs::path entry = work_directory / iter->name;
+                struct ::stat sb;
+                if (::lstat(entry.c_str(), &sb) != -1 && S_ISDIR(sb.st_mode))
+                    fs::rm_r(entry);
+                else
+                    fs::unlink(entry);
+            }
+        } catch (const fs::error& e) {
+            const fs::path cookie = control_directory / removal_error_cookie;
+            std::ofstream output(cookie.c_str());
+            if (!output) {
+                std::perror((F("Failed to open %s for write") %
+                             cookie).str().c_str());
+                std::abort();
+            }
+            output << e.what();
+            output.close();
+            ::_exit(EXIT_FAILURE);
+        }
+
+        // Abruptly terminate the process.  We don't want to run any destructors
+        // inherited from the parent process by mistake.
+        ::_exit(EXIT_SUCCESS);
+    }
+};
+
+
 /// Obtains the right scheduler interface for a given test program.
 ///
 /// \param name The name of the interface of the test program.
@@ -500,9 +931,105 @@ find_interface(const std::string& name)
 }
 
 
+/// Constructs a test cases list that represents a failed list operation.
+///
+/// TODO(jmmv): This is a very ugly workaround for the fact that we cannot report
+/// failures at the test-program level.
+///
+/// \param reason The reason for the failure.
+///
+/// \return A test cases list with a single fake test case that is broken.
+static model::test_cases_map
+broken_test_cases_list(const std::string& reason)
+{
+    LW(F("Failed to load test cases list: %s") % reason);
+    model::test_cases_map fake_test_cases;
+    fake_test_cases.insert(model::test_cases_map::value_type(
+        "__test_cases_list__",
+        model::test_case(
+            "__test_cases_list__",
+            "Represents the correct processing of the test cases list",
+            model::test_result(model::test_result_broken, reason))));
+    return fake_test_cases;
+}
+
+
+/// Computes the list of test cases out of a terminated list operation.
+///
+/// This operation should never throw.  Any errors during the processing of the
+/// test case list are subsumed into a single test case in the return value that
+/// represents the failed retrieval.
+///
+/// \param interface Interface of the test program that was listed.
+/// \param [in,out] exit_handle Termination data of the list operation.  This is
+///     cleaned up on success.
+///
+/// \return The list of test cases.
+static model::test_cases_map
+collect_test_cases(const scheduler::interface& interface,
+                   executor::exit_handle& exit_handle)
+{
+    try {
+        const model::test_cases_map test_cases = interface.parse_list(
+            exit_handle.status(),
+            exit_handle.stdout_file(),
+            exit_handle.stderr_file());
+
+        exit_handle.cleanup();
+
+        if (test_cases.empty())
+            throw std::runtime_error("Empty test cases list");
+
+        return test_cases;
+    } catch (const std::runtime_error& e) {
+        return broken_test_cases_list(e.what());
+    }
+}
+
+
 }  // anonymous namespace
 
 
+int
+scheduler::interface::prepare_test(
+    const model::test_program& UTILS_UNUSED_PARAM(test_program),
+    const std::string& UTILS_UNUSED_PARAM(test_case_name),
+    const utils::config::properties_map& UTILS_UNUSED_PARAM(vars),
+    const process::resource_limits& UTILS_UNUSED_PARAM(limits))
+{
+    // Most test interfaces execute every test case in a fresh process and thus
+    // need no resources from the scheduler process.
+    return -1;
+}
+
+
+void
+scheduler::interface::finish_test(
+    const int UTILS_UNUSED_PARAM(reservation),
+    const optional< process::status >& UTILS_UNUSED_PARAM(status))
+{
+}
+
+
+bool
+scheduler::interface::measures_usage(
+    const int UTILS_UNUSED_PARAM(reservation)) const
+{
+    return true;
+}
+
+
+optional< executor::command >
+scheduler::interface::test_command(
+    const model::test_program& UTILS_UNUSED_PARAM(test_program),
+    const std::string& UTILS_UNUSED_PARAM(test_case_name),
+    const utils::config::properties_map& UTILS_UNUSED_PARAM(vars),
+    const fs::path& UTILS_UNUSED_PARAM(control_directory)) const
+{
+    return none;
+}
+
+
 void
 scheduler::interface::exec_cleanup(
     const model::test_program& UTILS_UNUSED_PARAM(test_program),
@@ -681,9 +1208,62 @@ scheduler::result_handle::end_time(void) const
 }
 
 
+/// Checks whether usage() reports the resources consumed by the test.
+///
+/// \return False if the body of the test was run outside of the subprocess
+/// that the scheduler measured, such as by a worker; true otherwise.
+bool
+scheduler::result_handle::has_usage(void) const
+{
+    const exec_data_map::const_iterator iter = _pbimpl->all_exec_data.find(
+        _pbimpl->generic.original_pid());
+    if (iter == _pbimpl->all_exec_data.end())
+        return true;
+
+    const test_exec_data* test_data =
+        dynamic_cast< const test_exec_data* >((*iter).second.get());
+    if (test_data == NULL)
+        return true;
+    return test_data->interface->measures_usage(test_data->reservation);
+}
+
+
+/// Returns the resources consumed by the body of the test.
+///
+/// \return The resource usage of the test, or all zeros if the platform cannot
+/// report it.  Only meaningful if has_usage() is true.
+const utils::process::resource_usage&
+scheduler::result_handle::usage(void) const
+{
+    return _pbimpl->generic.usage();
+}
+
+
+/// Returns the CPUs to which the body of the test was pinned.
+///
+/// \return The identifiers of the CPUs, or an empty set if the test was not
+/// pinned to any.
+std::set< int >
+scheduler::result_handle::cpus(void) const
+{
+    const exec_data_map::const_iterator iter = _pbimpl->all_exec_data.find(
+        _pbimpl->generic.original_pid());
+    if (iter == _pbimpl->all_exec_data.end())
+        return std::set< int >();
+
+    const test_exec_data* test_data =
+        dynamic_cast< const test_exec_data* >((*iter).second.get());
+    if (test_data == NULL)
+        return std::set< int >();
+    return test_data->limits.cpus;
+}
+
+
 /// Returns the path to the test-specific work directory.
 ///
-/// This is guaranteed to be clear of files created by the scheduler.
+/// This is guaranteed to be clear of files created by the scheduler.  Note that
+/// the files created by the test may have already been deleted in the
+/// background by the time the result is returned.
 ///
 /// \return The path to a directory that exists until cleanup() is called.
 fs::path
@@ -795,11 +1375,66 @@ struct engine::scheduler::scheduler_handle::impl : utils::noncopyable {
     /// Mapping of exec handles to the data required at run time.
     exec_data_map all_exec_data;
 
+    /// Test programs being listed in the background.
+    pending_listings_map pending_listings;
+
+    /// Test programs listed in the background but not yet queried.
+    ///
+    /// Entries are added here when wait_any() reaps a list operation that was
+    /// started by start_list_tests() and are removed as soon as list_tests()
+    /// hands them out to the caller.
+    ready_listings_map ready_listings;
+
+    /// Snapshots of the test programs with running test cases.
+    ///
+    /// Subprocesses need test programs with absolute paths.  Computing these
+    /// requires a copy of the test cases of a program, so we do it only once
+    /// per program and share the result with all of its test cases in flight.
+    /// Snapshots are dropped as soon as no test uses them so that we do not
+    /// hold two copies of every test program for the whole run.
+    absolute_programs_map absolute_programs;
+
+    /// User configuration from which frozen_config was built.
+    ///
+    /// This is a shallow copy of the caller's tree, so comparing it against
+    /// the tree given to later calls is cheap when they are the same object.
+    optional< config::tree > config_source;
+
+    /// Frozen view of config_source shared by all subprocesses.
+    config_snapshot_ptr frozen_config;
+
+    /// Persistent cache of test cases lists, if enabled.
+    optional< store::list_cache > list_cache;
+
+    /// Number of work directories being emptied in the background.
+    std::size_t pending_removals;
+
+    /// Number of stack traces being gathered in the background.
+    std::size_t pending_stacktraces;
+
+    /// Number of test bodies pinned to each of the CPUs we can use.
+    ///
+    /// This is only populated, with the CPUs on which the scheduler itself is
+    /// allowed to run, once a test asks to be pinned.
+    std::map< int, std::size_t > cpu_load;
+
+    /// Whether cpu_load has been populated already.
+    bool cpus_queried;
+
+    /// Trace tracks for the tests in flight, one per concurrently-used slot.
+    trace::track_pool slot_tracks;
+
+    /// Trace tracks for the list operations running in the background.
+    trace::track_pool listing_tracks;
+
     /// Collection of test_exec_data objects.
     typedef std::vector< const test_exec_data* > test_exec_data_vector;
 
     /// Constructor.
-    impl(void) : generic(executor::setup())
+    impl(void) :
+        generic(executor::setup()), pending_removals(0), pending_stacktraces(0),
+        cpus_queried(false), slot_tracks(first_slot_track, "slot"),
+        listing_tracks(first_listing_track, "listing")
     {
     }
 
@@ -826,6 +1461,75 @@ struct engine::scheduler::scheduler_handle::impl : utils::noncopyable {
         }
     }
 
+    /// Picks the CPU to pin a new test body to.
+    ///
+    /// Tests go to the CPU with the fewest tests pinned to it, so every test
+    /// gets a CPU of its own as long as there are no more tests in flight than
+    /// CPUs.
+    ///
+    /// \return The identifier of the CPU, or none if the system cannot tell
+    /// on which CPUs we can run.
+    optional< int >
+    acquire_cpu(void)
+    {
+        if (!cpus_queried) {
+            const std::set< int > cpus = process::allowed_cpus();
+            for (std::set< int >::const_iterator iter = cpus.begin();
+                 iter != cpus.end(); ++iter)
+                cpu_load[*iter] = 0;
+            if (cpu_load.empty())
+                LW("Cannot query the available CPUs; not pinning tests");
+            cpus_queried = true;
+        }
+        if (cpu_load.empty())
+            return none;
+
+        std::map< int, std::size_t >::iterator best = cpu_load.begin();
+        for (std::map< int, std::size_t >::iterator iter = cpu_load.begin();
+             iter != cpu_load.end(); ++iter) {
+            if ((*iter).second < (*best).second)
+                best = iter;
+        }
+        ++(*best).second;
+        return utils::make_optional((*best).first);
+    }
+
+    /// Releases the CPUs that a test body was pinned to.
+    ///
+    /// \param cpus The CPUs previously returned by acquire_cpu().
+    void
+    release_cpus(const std::set< int >& cpus)
+    {
+        for (std::set< int >::const_iterator iter = cpus.begin();
+             iter != cpus.end(); ++iter) {
+            const std::map< int, std::size_t >::iterator load =
+                cpu_load.find(*iter);
+            INV(load != cpu_load.end() && (*load).second > 0);
+            --(*load).second;
+        }
+    }
+
+    /// Gets the trace track of a test that is still tracked.
+    ///
+    /// \param handle The exit handle of the body or the cleanup routine of
+    ///     the test.
+    ///
+    /// \return The trace track on which the test is being recorded.
+    int
+    test_track(const executor::exit_handle& handle) const
+    {
+        const exec_data_map::const_iterator iter = all_exec_data.find(
+            handle.original_pid());
+        INV(iter != all_exec_data.end());
+
+        const cleanup_exec_data* cleanup_data =
+            dynamic_cast< const cleanup_exec_data* >((*iter).second.get());
+        if (cleanup_data != NULL)
+            return test_track(cleanup_data->body_exit_handle);
+        return dynamic_cast< const test_exec_data& >(
+            *(*iter).second.get()).track;
+    }
+
     /// Finds any pending exec_datas that correspond to tests needing cleanup.
     ///
     /// \return The collection of test_exec_data objects that have their
@@ -874,11 +1578,136 @@ struct engine::scheduler::scheduler_handle::impl : utils::noncopyable {
         generic.wait(cleanup_handle);
     }
 
+    /// Gets the frozen snapshot of a user configuration.
+    ///
+    /// Callers are expected to provide the same configuration during the whole
+    /// life of the scheduler, in which case a single snapshot is shared by all
+    /// subprocesses.  Providing a different configuration replaces the cached
+    /// snapshot for any subsequent subprocesses.
+    ///
+    /// \param user_config The user configuration to freeze.  Must not be
+    ///     modified afterwards.
+    ///
+    /// \return The shared snapshot.
+    config_snapshot_ptr
+    freeze_config(const config::tree& user_config)
+    {
+        if (!config_source || config_source.get() != user_config) {
+            frozen_config.reset(new config_snapshot(user_config));
+            config_source = user_config;
+        }
+        return frozen_config;
+    }
+
+    /// Looks up the test cases of a test program in the list cache.
+    ///
+    /// \param test_program The test program to query.
+    /// \param config User-provided configuration variables.
+    ///
+    /// \return The cached test cases, or none if the cache is disabled, if it
+    /// does not hold the test program or if it cannot be queried.
+    optional< model::test_cases_map >
+    cached_list(const model::test_program& test_program,
+                const config_snapshot& config)
+    {
+        if (!list_cache)
+            return none;
+
+        try {
+            const optional< model::test_cases_map > test_cases =
+                list_cache.get().lookup(test_program, config.test_suite_vars(
+                    test_program.test_suite_name()));
+            if (test_cases)
+                LI(F("Reusing cached list of %s") %
+                   test_program.absolute_path());
+            return test_cases;
+        } catch (const store::error& e) {
+            LW(F("Failed to query the list cache for %s: %s") %
+               test_program.absolute_path() % e.what());
+            return none;
+        }
+    }
+
+    /// Records the test cases of a test program in the list cache.
+    ///
+    /// \param test_program The test program that was listed.
+    /// \param config User-provided configuration variables.
+    /// \param test_cases The test cases of the test program.
+    void
+    cache_list(const model::test_program& test_program,
+               const config_snapshot& config,
+               const model::test_cases_map& test_cases)
+    {
+        if (!list_cache)
+            return;
+
+        try {
+            list_cache.get().put(test_program, config.test_suite_vars(
+                test_program.test_suite_name()), test_cases);
+        } catch (const store::error& e) {
+            LW(F("Failed to cache the list of %s: %s") %
+               test_program.absolute_path() % e.what());
+        }
+    }
+
+    /// Gets the snapshot with absolute paths of a test program for a new test.
+    ///
+    /// Every call must be paired with a call to release_program() once the
+    /// test, including its cleanup routine, has completed.
+    ///
+    /// \param test_program The test program to query.  Its test cases must be
+    ///     final at this point because the snapshot is not recomputed while in
+    ///     use.
+    ///
+    /// \return The shared snapshot of the test program.
+    model::test_program_ptr
+    acquire_program(const model::test_program_ptr test_program)
+    {
+        absolute_programs_map::iterator iter = absolute_programs.find(
+            test_program);
+        if (iter == absolute_programs.end()) {
+            iter = absolute_programs.insert(absolute_programs_map::value_type(
+                test_program, std::make_pair(
+                    force_absolute_paths(*test_program,
+                                         test_program->test_cases()),
+                    0))).first;
+        }
+        ++(*iter).second.second;
+        return (*iter).second.first;
+    }
+
+    /// Gets the snapshot of a test program used by a test in flight.
+    ///
+    /// \param test_program The test program to query.
+    ///
+    /// \return The shared snapshot of the test program.
+    model::test_program_ptr
+    absolute_program(const model::test_program_ptr test_program) const
+    {
+        const absolute_programs_map::const_iterator iter =
+            absolute_programs.find(test_program);
+        INV(iter != absolute_programs.end());
+        return (*iter).second.first;
+    }
+
+    /// Releases the snapshot of a test program once a test has completed.
+    ///
+    /// \param test_program The test program given to acquire_program().
+    void
+    release_program(const model::test_program_ptr test_program)
+    {
+        const absolute_programs_map::iterator iter = absolute_programs.find(
+            test_program);
+        INV(iter != absolute_programs.end() && (*iter).second.second > 0);
+        if (--(*iter).second.second == 0)
+            absolute_programs.erase(iter);
+    }
+
     /// Forks and executes a test case cleanup routine asynchronously.
     ///
     /// \param test_program The container test program.
     /// \param test_case_name The name of the test case to run.
-    /// \param user_config User-provided configuration variables.
+    /// \param config User-provided configuration variables.
     /// \param body_handle The exit handle of the test case's corresponding
     ///     body.  The cleanup will be executed in the same context.
     /// \param body_result The result of the test case's corresponding body.
@@ -888,7 +1717,7 @@ struct engine::scheduler::scheduler_handle::impl : utils::noncopyable {
     executor::exec_handle
     spawn_cleanup(const model::test_program_ptr test_program,
                   const std::string& test_case_name,
-                  const config::tree& user_config,
+                  const config_snapshot_ptr config,
                   const executor::exit_handle& body_handle,
                   const model::test_result& body_result)
     {
@@ -901,8 +1730,8 @@ struct engine::scheduler::scheduler_handle::impl : utils::noncopyable {
            test_case_name);
 
         const executor::exec_handle handle = generic.spawn_followup(
-            run_test_cleanup(interface, test_program, test_case_name,
-                             user_config),
+            run_test_cleanup(interface, absolute_program(test_program),
+                             test_case_name, config),
             body_handle, cleanup_timeout);
 
         const exec_data_ptr data(new cleanup_exec_data(
@@ -915,6 +1744,145 @@ struct engine::scheduler::scheduler_handle::impl : utils::noncopyable {
 
         return handle;
     }
+
+    /// Computes the maximum number of background jobs of a given type.
+    ///
+    /// \return The configured parallelism, so that there are never more
+    /// removals or stack trace collections in flight than tests.
+    std::size_t
+    max_background_jobs(void) const
+    {
+        if (!frozen_config ||
+            !frozen_config->user_config().is_set("parallelism"))
+            return 1;
+        return frozen_config->user_config().lookup< engine::parallelism_node >(
+            "parallelism").max;
+    }
+
+    /// Starts emptying the work directory of a finished test in the background.
+    ///
+    /// Removing large trees can take seconds, so doing so in a subprocess
+    /// keeps the caller from stalling the dispatch of other tests while the
+    /// files are deleted.  The removal is skipped, and thus left to the
+    /// synchronous cleanup of the result handle, if the work directory is
+    /// empty, as spawning a subprocess would then cost more than the removal
+    /// itself, or if there are already too many removals in flight.  The latter
+    /// provides backpressure against tests that create large trees faster than
+    /// we can delete them.
+    ///
+    /// \param data The data of the finished test.
+    /// \param handle The exit handle of the finished test.
+    /// \param result The final result of the test.
+    ///
+    /// \return True if the removal was started, in which case wait_any() will
+    /// return the test once the removal completes; false otherwise.
+    bool
+    spawn_removal(const exec_data& data, const executor::exit_handle& handle,
+                  const model::test_result& result)
+    {
+        if (pending_removals >= max_background_jobs())
+            return false;
+
+        try {
+            if (!has_entries(handle.work_directory()))
+                return false;
+        } catch (const fs::error& e) {
+            LW(F("Cannot scan work directory %s: %s") %
+               handle.work_directory() % e.what());
+            return false;
+        }
+
+        generic.check_interrupt();
+
+        LI(F("Spawning %s:%s (work directory removal)") %
+           data.test_program->absolute_path() % data.test_case_name);
+
+        const executor::exec_handle removal_handle = generic.spawn_followup(
+            remove_work_directory(), handle, cleanup_timeout);
+
+        const exec_data_ptr removal_data(new removal_exec_data(
+            data.test_program, data.test_case_name, handle, result));
+        LD(F("Inserting %s into all_exec_data (removal)") %
+           removal_handle.pid());
+        INV_MSG(all_exec_data.find(removal_handle.pid()) ==
+                all_exec_data.end(),
+                F("PID %s already in all_exec_data; not properly cleaned "
+                  "up or reused too fast") % removal_handle.pid());
+        all_exec_data.insert(exec_data_map::value_type(removal_handle.pid(),
+                                                       removal_data));
+        ++pending_removals;
+        return true;
+    }
+
+    /// Starts gathering the stack trace of a crashed process in the background.
+    ///
+    /// GDB can take up to utils::gdb_timeout to complete, so waiting for it
+    /// here would stall the processing of every other test in flight, which is
+    /// particularly bad when many tests crash at once.  If there are already
+    /// too many stack traces being gathered, this falls back to doing so
+    /// synchronously to bound the number of GDB instances.
+    ///
+    /// \param data The data of the terminated process.
+    /// \param handle The exit handle of the terminated process.
+    ///
+    /// \return True if GDB was started, in which case wait_any() will resume
+    /// the processing of the terminated process once GDB finishes; false
+    /// otherwise, including if the process did not dump core.
+    bool
+    spawn_stacktrace(const exec_data& data, const executor::exit_handle& handle)
+    {
+        if (!handle.status() || !handle.status().get().signaled() ||
+            !handle.status().get().coredump())
+            return false;
+
+        const fs::path program = data.test_program->absolute_path();
+        if (pending_stacktraces >= max_background_jobs()) {
+            utils::dump_stacktrace(program, generic, handle);
+            return false;
+        }
+
+        generic.check_interrupt();
+
+        LI(F("Spawning %s:%s (stack trace)") % program % data.test_case_name);
+
+        const optional< executor::exec_handle > gdb_handle =
+            utils::start_stacktrace(program, generic, handle);
+        if (!gdb_handle)
+            return false;
+
+        const exec_data_ptr stacktrace_data(new stacktrace_exec_data(
+            data.test_program, data.test_case_name, handle));
+        LD(F("Inserting %s into all_exec_data (stack trace)") %
+           gdb_handle.get().pid());
+        INV_MSG(all_exec_data.find(gdb_handle.get().pid()) ==
+                all_exec_data.end(),
+                F("PID %s already in all_exec_data; not properly cleaned "
+                  "up or reused too fast") % gdb_handle.get().pid());
+        all_exec_data.insert(exec_data_map::value_type(gdb_handle.get().pid(),
+                                                       stacktrace_data));
+        ++pending_stacktraces;
+        return true;
+    }
+
+    /// Collects the test cases of a list operation started in the background.
+    ///
+    /// \param list_data The data of the list operation.
+    /// \param [in,out] handle The termination data of the list operation.
+    ///
+    /// \return The list of test cases.
+    model::test_cases_map
+    finish_list(const list_exec_data& list_data, executor::exit_handle& handle)
+    {
+        LD(F("Removing %s from all_exec_data (list)") % handle.original_pid());
+        pending_listings.erase(list_data.test_program.get());
+        trace_process("list_tests", list_data.track, list_data, handle);
+        listing_tracks.release(list_data.track);
+        const model::test_cases_map test_cases = collect_test_cases(
+            *list_data.interface, handle);
+        all_exec_data.erase(handle.original_pid());
+        cache_list(*list_data.test_program, *list_data.config, test_cases);
+        return test_cases;
+    }
 };
 
 
@@ -1008,9 +1976,100 @@ scheduler::setup(void)
 }
 
 
+/// Enables the persistent cache of test cases lists.
+///
+/// Once enabled, list operations reuse the test cases recorded for test
+/// programs whose binaries did not change since they were last listed, and
+/// record the test cases of any other test program they list.  Failures to
+/// open the cache are logged and leave the cache disabled.
+///
+/// \param file The database file holding the cache.
+void
+scheduler::scheduler_handle::enable_list_cache(const fs::path& file)
+{
+    try {
+        _pimpl->list_cache = store::list_cache::open_rw(file);
+    } catch (const store::error& e) {
+        LW(F("Cannot open the list cache; listing without it: %s") % e.what());
+    }
+}
+
+
+/// Starts loading the list of test cases of a test program in the background.
+///
+/// This is intended to be called on test programs that will be queried soon via
+/// list_tests() so that their list operations run in parallel with any other
+/// subprocesses.  The list operation is reaped either by list_tests(), which
+/// waits for it if it is still running, or by wait_any(), which records its
+/// results and continues waiting for a test case.
+///
+/// This is a no-op for test programs that do not need to load their test cases
+/// or for which a list operation has already been started.
+///
+/// \param test_program The test program from which to obtain the list of test
+/// cases.
+/// \param user_config User-provided configuration variables.
+void
+scheduler::scheduler_handle::start_list_tests(
+    const model::test_program_ptr test_program,
+    const config::tree& user_config)
+{
+    const lazy_test_program* lazy_program =
+        dynamic_cast< const lazy_test_program* >(test_program.get());
+    if (lazy_program == NULL || lazy_program->_pimpl->_loaded)
+        return;
+    if (_pimpl->pending_listings.find(test_program.get()) !=
+        _pimpl->pending_listings.end() ||
+        _pimpl->ready_listings.find(test_program.get()) !=
+        _pimpl->ready_listings.end())
+        return;
+
+    _pimpl->generic.check_interrupt();
+
+    const config_snapshot_ptr config = _pimpl->freeze_config(user_config);
+    const optional< model::test_cases_map > cached = _pimpl->cached_list(
+        *test_program, *config);
+    if (cached) {
+        _pimpl->ready_listings.insert(ready_listings_map::value_type(
+            test_program.get(), cached.get()));
+        return;
+    }
+
+    const std::shared_ptr< scheduler::interface > interface = find_interface(
+        test_program->interface_name());
+
+    LI(F("Spawning %s (list)") % test_program->absolute_path());
+
+    const int track = _pimpl->listing_tracks.acquire();
+    try {
+        const executor::exec_handle exec_handle = _pimpl->generic.spawn(
+            list_test_cases(interface, test_program.get(), config),
+            list_timeout, none);
+
+        const exec_data_ptr data(new list_exec_data(
+            test_program, interface, exec_handle, config, track));
+        LD(F("Inserting %s into all_exec_data (list)") % exec_handle.pid());
+        INV_MSG(_pimpl->all_exec_data.find(exec_handle.pid()) ==
+                _pimpl->all_exec_data.end(),
+                F("PID %s already in all_exec_data; not properly cleaned "
+                  "up or reused too fast") % exec_handle.pid());
+        _pimpl->all_exec_data.insert(exec_data_map::value_type(
+            exec_handle.pid(), data));
+        _pimpl->pending_listings.insert(pending_listings_map::value_type(
+            test_program.get(), exec_handle.pid()));
+    } catch (const std::runtime_error& e) {
+        _pimpl->listing_tracks.release(track);
+        _pimpl->ready_listings.insert(ready_listings_map::value_type(
+            test_program.get(), broken_test_cases_list(e.what())));
+    }
+}
+
+
 /// Retrieves the list of test cases from a test program.
 ///
-/// This operation is currently synchronous.
+/// If the list operation for the test program was started in the background by
+/// start_list_tests(), this collects its results, waiting for its completion
+/// if necessary.  Otherwise, this operation is synchronous.
 ///
 /// This operation should never throw.  Any errors during the processing of the
 /// test case list are subsumed into a single test case in the return value that
@@ -1028,38 +2087,48 @@ scheduler::scheduler_handle::list_tests(
 {
     _pimpl->generic.check_interrupt();
 
+    const ready_listings_map::iterator ready_iter =
+        _pimpl->ready_listings.find(test_program);
+    if (ready_iter != _pimpl->ready_listings.end()) {
+        const model::test_cases_map test_cases = (*ready_iter).second;
+        _pimpl->ready_listings.erase(ready_iter);
+        return test_cases;
+    }
+
+    const pending_listings_map::const_iterator pending_iter =
+        _pimpl->pending_listings.find(test_program);
+    if (pending_iter != _pimpl->pending_listings.end()) {
+        const exec_data_ptr data =
+            _pimpl->all_exec_data[(*pending_iter).second];
+        const list_exec_data& list_data =
+            dynamic_cast< const list_exec_data& >(*data.get());
+        executor::exit_handle exit_handle = _pimpl->generic.wait(
+            list_data.exec_handle);
+        return _pimpl->finish_list(list_data, exit_handle);
+    }
+
+    const config_snapshot_ptr config = _pimpl->freeze_config(user_config);
+    const optional< model::test_cases_map > cached = _pimpl->cached_list(
+        *test_program, *config);
+    if (cached)
+        return cached.get();
+
     const std::shared_ptr< scheduler::interface > interface = find_interface(
         test_program->interface_name());
 
+    trace::span span("list_tests", trace::main_track,
+                     test_program->relative_path().str());
     try {
         const executor::exec_handle exec_handle = _pimpl->generic.spawn(
-            list_test_cases(interface, test_program, user_config),
+            list_test_cases(interface, test_program, config),
             list_timeout, none);
         executor::exit_handle exit_handle = _pimpl->generic.wait(exec_handle);
-
-        const model::test_cases_map test_cases = interface->parse_list(
-            exit_handle.status(),
-            exit_handle.stdout_file(),
-            exit_handle.stderr_file());
-
-        exit_handle.cleanup();
-
-        if (test_cases.empty())
-            throw std::runtime_error("Empty test cases list");
-
+        const model::test_cases_map test_cases = collect_test_cases(
+            *interface, exit_handle);
+        _pimpl->cache_list(*test_program, *config, test_cases);
         return test_cases;
     } catch (const std::runtime_error& e) {
-        // TODO(jmmv): This is a very ugly workaround for the fact that we
-        // cannot report failures at the test-program level.
-        LW(F("Failed to load test cases list: %s") % e.what());
-        model::test_cases_map fake_test_cases;
-        fake_test_cases.insert(model::test_cases_map::value_type(
-            "__test_cases_list__",
-            model::test_case(
-                "__test_cases_list__",
-                "Represents the correct processing of the test cases list",
-                model::test_result(model::test_result_broken, e.what()))));
-        return fake_test_cases;
+        return broken_test_cases_list(e.what());
     }
 }
 
@@ -1097,14 +2166,53 @@ scheduler::scheduler_handle::spawn_test(
             "unprivileged_user");
     }
 
-    const executor::exec_handle handle = _pimpl->generic.spawn(
-        run_test_program(interface, test_program, test_case_name,
-                         user_config),
-        test_case.get_metadata().timeout(),
-        unprivileged_user);
+    // Everything acquired from here on must be released if spawning fails.
+    const int track = _pimpl->slot_tracks.acquire();
+    process::resource_limits limits;
+    config_snapshot_ptr config;
+    model::test_program_ptr absolute_program;
+    int reservation = -1;
+    optional< executor::exec_handle > spawned;
+    try {
+        trace::span span("spawn_test", track,
+                         F("%s:%s") % test_program->relative_path() %
+                         test_case_name);
+
+        limits = test_limits(test_case.get_metadata(), user_config);
+        config = _pimpl->freeze_config(user_config);
+        absolute_program = _pimpl->acquire_program(test_program);
+
+        // The CPU is part of the limits given to prepare_test(), so it must be
+        // chosen first, but within this block so that it is released if
+        // anything below fails.
+        if (user_config.is_set("cpu_affinity") &&
+            user_config.lookup< config::bool_node >("cpu_affinity")) {
+            const optional< int > cpu = _pimpl->acquire_cpu();
+            if (cpu)
+                limits.cpus.insert(cpu.get());
+        }
+        reservation = interface->prepare_test(
+            *absolute_program, test_case_name,
+            config->test_suite_vars(test_program->test_suite_name()), limits);
+        spawned = _pimpl->generic.spawn_command(
+            run_test_program(interface, absolute_program, test_case_name,
+                             config),
+            test_case.get_metadata().timeout(),
+            limits,
+            unprivileged_user);
+    } catch (...) {
+        interface->finish_test(reservation, none);
+        if (absolute_program)
+            _pimpl->release_program(test_program);
+        _pimpl->release_cpus(limits.cpus);
+        _pimpl->slot_tracks.release(track);
+        throw;
+    }
+    const executor::exec_handle handle = spawned.get();
 
     const exec_data_ptr data(new test_exec_data(
-        test_program, test_case_name, interface, user_config));
+        test_program, test_case_name, interface, config, reservation, limits,
+        track));
     LD(F("Inserting %s into all_exec_data") % handle.pid());
     INV_MSG(
         _pimpl->all_exec_data.find(handle.pid()) == _pimpl->all_exec_data.end(),
@@ -1116,11 +2224,45 @@ scheduler::scheduler_handle::spawn_test(
 }
 
 
+/// Checks if a test case is to be skipped without having to spawn it.
+///
+/// This evaluates the requirements of the test case that are constant during a
+/// run, memoizing them for all tests that share the same requirements, so that
+/// the caller can record the skipped tests without the cost of running them.
+/// Any other requirements are still checked by spawn_test().
+///
+/// \param test_program The container test program.
+/// \param test_case_name The name of the test case to check.
+/// \param user_config User-provided configuration variables.
+///
+/// \return A string describing the reason for skipping the test, or empty if
+/// the test has to be spawned.
+std::string
+scheduler::scheduler_handle::static_skip_reason(
+    const model::test_program_ptr test_program,
+    const std::string& test_case_name,
+    const config::tree& user_config)
+{
+    const model::test_case& test_case = test_program->find(test_case_name);
+    if (test_case.fake_result())
+        return "";
+
+    return _pimpl->freeze_config(user_config)->static_skip_reason(
+        *test_program, test_case_name);
+}
+
+
 /// Waits for completion of any forked test case.
 ///
 /// Note that if the terminated test case has a cleanup routine, this function
 /// is the one in charge of spawning the cleanup routine asynchronously.
 ///
+/// Similarly, if the terminated subprocess is a list operation started by
+/// start_list_tests(), this function records its results for a later call to
+/// list_tests() and continues waiting for a test case.
+///
+/// \pre There must be at least one test case in flight.
+///
 /// \return The result of the execution of a subprocess.  This is a dynamically
 /// allocated object because the scheduler can spawn subprocesses of various
 /// types and, at wait time, we don't know upfront what we are going to get.
@@ -1135,8 +2277,98 @@ scheduler::scheduler_handle::wait_any(void)
         handle.original_pid());
     exec_data_ptr data = (*iter).second;
 
-    utils::dump_stacktrace_if_available(data->test_program->absolute_path(),
-                                        _pimpl->generic, handle);
+    const list_exec_data* list_data = dynamic_cast< const list_exec_data* >(
+        data.get());
+    if (list_data != NULL) {
+        LD(F("Got %s from all_exec_data (list)") % handle.original_pid());
+        const model::test_cases_map test_cases = _pimpl->finish_list(
+            *list_data, handle);
+        _pimpl->ready_listings.insert(ready_listings_map::value_type(
+            data->test_program.get(), test_cases));
+
+        // The caller is not aware of list operations, so keep waiting for the
+        // termination of a test case.
+        return wait_any();
+    }
+
+    const removal_exec_data* removal_data =
+        dynamic_cast< const removal_exec_data* >(data.get());
+    if (removal_data != NULL) {
+        LD(F("Got %s from all_exec_data (removal)") % handle.original_pid());
+        INV(_pimpl->pending_removals > 0);
+        --_pimpl->pending_removals;
+
+        const int track = _pimpl->test_track(removal_data->body_exit_handle);
+        trace_process("rm_r", track, *data, handle);
+
+        // A failed removal is not fatal here: the cleanup of the result handle
+        // takes care of whatever is left and reports any errors to the caller,
+        // and it does so with the privileges of the scheduler, which may be
+        // higher than those of the test.
+        const fs::path cookie = handle.control_directory() /
+            removal_error_cookie;
+        std::ifstream input(cookie.c_str());
+        if (input) {
+            LW(F("Failed to empty work directory %s in the background: %s") %
+               handle.work_directory() % utils::read_stream(input));
+        } else if (!handle.status() || !handle.status().get().exited() ||
+                   handle.status().get().exitstatus() != EXIT_SUCCESS) {
+            LW(F("Background removal of work directory %s did not complete") %
+               handle.work_directory());
+        }
+
+        LD(F("Removing %s from all_exec_data (removal) in favor of %s")
+           % handle.original_pid()
+           % removal_data->body_exit_handle.original_pid());
+        _pimpl->all_exec_data.erase(handle.original_pid());
+        // The removal shares its on-disk state with the test, so this only
+        // releases our reference to it.
+        handle.cleanup();
+        _pimpl->release_program(data->test_program);
+        _pimpl->slot_tracks.release(track);
+
+        std::shared_ptr< result_handle::bimpl > result_handle_bimpl(
+            new result_handle::bimpl(removal_data->body_exit_handle,
+                                     _pimpl->all_exec_data));
+        std::shared_ptr< test_result_handle::impl > test_result_handle_impl(
+            new test_result_handle::impl(
+                data->test_program, data->test_case_name,
+                removal_data->body_result));
+        return result_handle_ptr(new test_result_handle(
+            result_handle_bimpl, test_result_handle_impl));
+    }
+
+    const stacktrace_exec_data* stacktrace_data =
+        dynamic_cast< const stacktrace_exec_data* >(data.get());
+    if (stacktrace_data != NULL) {
+        LD(F("Got %s from all_exec_data (stack trace)") %
+           handle.original_pid());
+        INV(_pimpl->pending_stacktraces > 0);
+        --_pimpl->pending_stacktraces;
+
+        trace_process("stacktrace",
+                      _pimpl->test_track(stacktrace_data->body_exit_handle),
+                      *data, handle);
+        utils::finish_stacktrace(handle);
+
+        const executor::exit_handle body_exit_handle =
+            stacktrace_data->body_exit_handle;
+        LD(F("Removing %s from all_exec_data (stack trace) in favor of %s")
+           % handle.original_pid() % body_exit_handle.original_pid());
+        _pimpl->all_exec_data.erase(handle.original_pid());
+        // GDB shares its on-disk state with the crashed process, so this only
+        // releases our reference to it.
+        handle.cleanup();
+
+        // Resume the processing of the crashed process as if it had just
+        // terminated, now that its stderr contains the stack trace.
+        handle = body_exit_handle;
+        data = (*_pimpl->all_exec_data.find(handle.original_pid())).second;
+    } else if (_pimpl->spawn_stacktrace(*data, handle)) {
+        // The caller is not aware of the stack trace collection, so keep
+        // waiting for the termination of a test case.
+        return wait_any();
+    }
 
     optional< model::test_result > result;
     try {
@@ -1145,6 +2377,10 @@ scheduler::scheduler_handle::wait_any(void)
         LD(F("Got %s from all_exec_data") % handle.original_pid());
 
         test_data->exit_handle = handle;
+        trace_process("test body", test_data->track, *test_data, handle);
+        test_data->interface->finish_test(test_data->reservation,
+                                          handle.status());
+        _pimpl->release_cpus(test_data->limits.cpus);
 
         const model::test_case& test_case = test_data->test_program->find(
             test_data->test_case_name);
@@ -1176,6 +2412,12 @@ scheduler::scheduler_handle::wait_any(void)
                 test_data->needs_cleanup = false;
             }
         }
+        if (!result && exceeded_cpu_time(handle, test_data->limits)) {
+            result = model::test_result(
+                model::test_result_broken,
+                F("Test case body exceeded its CPU time limit of %s seconds") %
+                test_data->limits.cpu_time_seconds());
+        }
         if (!result) {
             result = test_data->interface->compute_result(
                 handle.status(),
@@ -1211,6 +2453,9 @@ scheduler::scheduler_handle::wait_any(void)
         const cleanup_exec_data* cleanup_data =
             &dynamic_cast< const cleanup_exec_data& >(*data.get());
         LD(F("Got %s from all_exec_data (cleanup)") % handle.original_pid());
+        trace_process("cleanup",
+                      _pimpl->test_track(cleanup_data->body_exit_handle),
+                      *data, handle);
 
         // Handle the completion of cleanup subprocesses internally: the caller
         // is not aware that these exist so, when we return, we must return the
@@ -1249,6 +2494,13 @@ scheduler::scheduler_handle::wait_any(void)
     }
     INV(result);
 
+    // The caller is not aware of the removal of the work directory either, so
+    // keep waiting if we started it in the background.
+    if (_pimpl->spawn_removal(*data, handle, result.get()))
+        return wait_any();
+    _pimpl->release_program(data->test_program);
+    _pimpl->slot_tracks.release(_pimpl->test_track(handle));
+
     std::shared_ptr< result_handle::bimpl > result_handle_bimpl(
         new result_handle::bimpl(handle, _pimpl->all_exec_data));
     std::shared_ptr< test_result_handle::impl > test_result_handle_impl(
@@ -71,6 +71,8 @@
 #include "utils/fs/path_fwd.hpp"
 #include "utils/optional.hpp"
 #include "utils/process/executor_fwd.hpp"
+#include "utils/process/isolation_fwd.hpp"
+#include "utils/process/resource_usage_fwd.hpp"
 #include "utils/process/status_fwd.hpp"
 #include "utils/shared_ptr.hpp"
 
@@ -113,6 +115,69 @@ public:
         const utils::fs::path& stdout_path,
         const utils::fs::path& stderr_path) const = 0;
 
+    /// Reserves the resources needed to execute a test case.
+    ///
+    /// This method is invoked in the scheduler process right before spawning
+    /// the subprocess that calls exec_test(), which thus inherits any state set
+    /// up here.
+    ///
+    /// \param test_program The test program to execute.
+    /// \param test_case_name Name of the test case to invoke.
+    /// \param vars User-provided variables to pass to the test program.
+    /// \param limits Resource limits that the scheduler applies to the
+    ///     subprocess that calls exec_test().  Interfaces that run the test
+    ///     case elsewhere cannot enforce these.
+    ///
+    /// \return An identifier of the reserved resources, to be passed to
+    /// finish_test() once the test case terminates, or -1 if none.
+    virtual int prepare_test(const model::test_program& test_program,
+                             const std::string& test_case_name,
+                             const utils::config::properties_map& vars,
+                             const utils::process::resource_limits& limits);
+
+    /// Releases the resources reserved by prepare_test().
+    ///
+    /// \param reservation The value returned by prepare_test().
+    /// \param status The termination status of the subprocess used to execute
+    ///     the exec_test() method or none if the test timed out.
+    virtual void finish_test(
+        const int reservation,
+        const utils::optional< utils::process::status >& status);
+
+    /// Checks whether the subprocess of a test case accounts for its resources.
+    ///
+    /// The scheduler measures the resources consumed by the subprocess that
+    /// calls exec_test().  Interfaces that run the test case elsewhere must
+    /// return false so that this measurement is not mistaken for the usage of
+    /// the test case.
+    ///
+    /// \param reservation The value returned by prepare_test().
+    ///
+    /// \return True if the usage of the subprocess is that of the test case,
+    /// which is the default behavior; false otherwise.
+    virtual bool measures_usage(const int reservation) const;
+
+    /// Describes the program that exec_test() would execute.
+    ///
+    /// This method is invoked in the scheduler process and allows it to start
+    /// the test case without forking a subprocess to run exec_test() in, which
+    /// is costly when the scheduler process is large.  Interfaces that need to
+    /// run any code in the subprocess before executing the test program must
+    /// return none, which is the default behavior.
+    ///
+    /// \param test_program The test program to execute.
+    /// \param test_case_name Name of the test case to invoke.
+    /// \param vars User-provided variables to pass to the test program.
+    /// \param control_directory Directory where the interface may place control
+    ///     files.
+    ///
+    /// \return The program to execute, or none if exec_test() must be used.
+    virtual utils::optional< utils::process::executor::command > test_command(
+        const model::test_program& test_program,
+        const std::string& test_case_name,
+        const utils::config::properties_map& vars,
+        const utils::fs::path& control_directory) const;
+
     /// Executes a test case of the test program.
     ///
     /// This method is intended to be called within a subprocess and is expected
@@ -172,6 +237,8 @@ class lazy_test_program : public model::test_program {
     /// Pointer to the shared internal implementation.
     std::shared_ptr< impl > _pimpl;
 
+    friend class scheduler_handle;
+
 public:
     lazy_test_program(const std::string&, const utils::fs::path&,
                       const utils::fs::path&, const std::string&,
@@ -204,6 +271,9 @@ public:
     int original_pid(void) const;
     const utils::datetime::timestamp& start_time() const;
     const utils::datetime::timestamp& end_time() const;
+    bool has_usage(void) const;
+    const utils::process::resource_usage& usage(void) const;
+    std::set< int > cpus(void) const;
     utils::fs::path work_directory(void) const;
     const utils::fs::path& stdout_file(void) const;
     const utils::fs::path& stderr_file(void) const;
@@ -244,11 +314,17 @@ public:
 
     void cleanup(void);
 
+    void enable_list_cache(const utils::fs::path&);
+    void start_list_tests(const model::test_program_ptr,
+                          const utils::config::tree&);
     model::test_cases_map list_tests(const model::test_program*,
                                      const utils::config::tree&);
     exec_handle spawn_test(const model::test_program_ptr,
                            const std::string&,
                            const utils::config::tree&);
+    std::string static_skip_reason(const model::test_program_ptr,
+                                   const std::string&,
+                                   const utils::config::tree&);
     result_handle_ptr wait_any(void);
 
     result_handle_ptr debug_test(const model::test_program_ptr,
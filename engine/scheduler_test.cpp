@@ -29,16 +29,20 @@
 #include "engine/scheduler.hpp"
 
 extern "C" {
+#include <sys/stat.h>
 #include <sys/types.h>
 
 #include <signal.h>
 #include <unistd.h>
 }
 
+#include <algorithm>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <set>
 #include <string>
+#include <vector>
 
 #include <atf-c++.hpp>
 
@@ -49,16 +53,19 @@ extern "C" {
 #include "model/test_case.hpp"
 #include "model/test_program.hpp"
 #include "model/test_result.hpp"
+#include "store/list_cache.hpp"
 #include "utils/config/tree.ipp"
 #include "utils/datetime.hpp"
 #include "utils/defs.hpp"
 #include "utils/env.hpp"
 #include "utils/format/containers.ipp"
 #include "utils/format/macros.hpp"
+#include "utils/fs/directory.hpp"
 #include "utils/fs/operations.hpp"
 #include "utils/fs/path.hpp"
 #include "utils/optional.ipp"
 #include "utils/passwd.hpp"
+#include "utils/process/isolation.hpp"
 #include "utils/process/status.hpp"
 #include "utils/sanity.hpp"
 #include "utils/stacktrace.hpp"
@@ -146,6 +153,8 @@ class mock_interface : public scheduler::interface {
         atf::utils::create_file("first file", "");
         atf::utils::create_file("second-file", "");
         fs::mkdir_p(fs::path("dir1/dir2"), 0755);
+        if (::symlink("dir1/dir2", "dir-link") == -1)
+            std::abort();
         ::kill(::getpid(), SIGTERM);
         std::abort();
     }
@@ -184,6 +193,15 @@ class mock_interface : public scheduler::interface {
         std::abort();
     }
 
+    /// Executes a test case that burns CPU time forever.
+    void
+    exec_spin(void) const UTILS_NORETURN
+    {
+        volatile unsigned long counter = 0;
+        for (;;)
+            ++counter;
+    }
+
     /// Executes a test case that prints all input parameters to the functor.
     ///
     /// \param test_program The test program to execute.
@@ -345,6 +363,8 @@ public:
             exec_print_params(test_program, test_case_name, vars);
         } else if (starts_with(test_case_name, "skip_body_pass_cleanup")) {
             exec_exit(EXIT_SUCCESS);
+        } else if (starts_with(test_case_name, "spin")) {
+            exec_spin();
         } else {
             std::cerr << "Unknown test case " << test_case_name << '\n';
             std::abort();
@@ -563,6 +583,129 @@ ATF_TEST_CASE_BODY(integration__list_empty)
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(integration__list_background__wait);
+ATF_TEST_CASE_BODY(integration__list_background__wait)
+{
+    config::tree user_config = engine::empty_config();
+    user_config.set_string("test_suites.the-suite.first", "test");
+
+    scheduler::scheduler_handle handle = scheduler::setup();
+
+    const model::test_program_ptr program(new scheduler::lazy_test_program(
+        "mock", fs::path("vars"), fs::path("."), "the-suite",
+        model::metadata_builder().build(), user_config, handle));
+    handle.start_list_tests(program, user_config);
+    handle.start_list_tests(program, user_config);  // Must be a no-op.
+
+    const model::test_cases_map exp_test_cases = model::test_cases_map_builder()
+        .add("first_test").build();
+    ATF_REQUIRE_EQ(exp_test_cases, program->test_cases());
+
+    // Now that the test cases are loaded, this must not spawn anything.
+    handle.start_list_tests(program, user_config);
+
+    handle.cleanup();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(integration__list_background__wait_any);
+ATF_TEST_CASE_BODY(integration__list_background__wait_any)
+{
+    config::tree user_config = engine::empty_config();
+    user_config.set_string("test_suites.the-suite.first", "test");
+
+    scheduler::scheduler_handle handle = scheduler::setup();
+
+    const model::test_program_ptr lazy_program(new scheduler::lazy_test_program(
+        "mock", fs::path("vars"), fs::path("."), "the-suite",
+        model::metadata_builder().build(), user_config, handle));
+    handle.start_list_tests(lazy_program, user_config);
+
+    const model::test_program_ptr program = model::test_program_builder(
+        "mock", fs::path("the-program"), fs::current_path(), "the-suite")
+        .add_test_case("exit 41").build_ptr();
+    const scheduler::exec_handle exec_handle = handle.spawn_test(
+        program, "exit 41", user_config);
+
+    // The list operation may terminate before the test, but wait_any() must
+    // only ever return the test to us.
+    scheduler::result_handle_ptr result_handle = handle.wait_any();
+    ATF_REQUIRE_EQ(exec_handle, result_handle->original_pid());
+    result_handle->cleanup();
+    result_handle.reset();
+
+    const model::test_cases_map exp_test_cases = model::test_cases_map_builder()
+        .add("first_test").build();
+    ATF_REQUIRE_EQ(exp_test_cases, lazy_program->test_cases());
+
+    handle.cleanup();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(integration__list_cache);
+ATF_TEST_CASE_BODY(integration__list_cache)
+{
+    config::tree user_config = engine::empty_config();
+    user_config.set_string("test_suites.the-suite.first", "test");
+
+    // The mock interface does not execute the binary, but the cache needs one
+    // to compute its identity.
+    atf::utils::create_file("vars", "");
+
+    {
+        scheduler::scheduler_handle handle = scheduler::setup();
+        handle.enable_list_cache(fs::path("cache.db"));
+
+        const model::test_program_ptr program(
+            new scheduler::lazy_test_program(
+                "mock", fs::path("vars"), fs::path("."), "the-suite",
+                model::metadata_builder().build(), user_config, handle));
+        const model::test_cases_map exp_test_cases =
+            model::test_cases_map_builder().add("first_test").build();
+        ATF_REQUIRE_EQ(exp_test_cases, program->test_cases());
+
+        handle.cleanup();
+    }
+
+    const model::test_program program(
+        "mock", fs::path("vars"), fs::path("."), "the-suite",
+        model::metadata_builder().build(), model::test_cases_map());
+    config::properties_map vars;
+    vars["first"] = "test";
+    {
+        store::list_cache cache = store::list_cache::open_rw(
+            fs::path("cache.db"));
+        const optional< model::test_cases_map > cached = cache.lookup(
+            program, vars);
+        ATF_REQUIRE(cached);
+        ATF_REQUIRE_EQ(model::test_cases_map_builder().add("first_test")
+                       .build(), cached.get());
+
+        // Replace the recorded list to prove that it is used instead of the
+        // output of the mock interface.
+        cache.put(program, vars,
+                  model::test_cases_map_builder().add("cached").build());
+        cache.close();
+    }
+
+    {
+        scheduler::scheduler_handle handle = scheduler::setup();
+        handle.enable_list_cache(fs::path("cache.db"));
+
+        const model::test_program_ptr lazy_program(
+            new scheduler::lazy_test_program(
+                "mock", fs::path("vars"), fs::path("."), "the-suite",
+                model::metadata_builder().build(), user_config, handle));
+        handle.start_list_tests(lazy_program, user_config);
+        const model::test_cases_map exp_test_cases =
+            model::test_cases_map_builder().add("cached").build();
+        ATF_REQUIRE_EQ(exp_test_cases, lazy_program->test_cases());
+
+        handle.cleanup();
+    }
+}
+
+
 ATF_TEST_CASE_WITHOUT_HEAD(integration__run_one);
 ATF_TEST_CASE_BODY(integration__run_one)
 {
@@ -776,6 +919,45 @@ ATF_TEST_CASE_BODY(integration__parameters_and_output)
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(integration__parameters_per_suite);
+ATF_TEST_CASE_BODY(integration__parameters_per_suite)
+{
+    const model::test_program_ptr program_a = model::test_program_builder(
+        "mock", fs::path("program-a"), fs::current_path(), "suite-a")
+        .add_test_case("print_params").build_ptr();
+    const model::test_program_ptr program_b = model::test_program_builder(
+        "mock", fs::path("program-b"), fs::current_path(), "suite-b")
+        .add_test_case("print_params").build_ptr();
+
+    config::tree user_config = engine::empty_config();
+    user_config.set_string("test_suites.suite-a.var", "value a");
+    user_config.set_string("test_suites.suite-b.var", "value b");
+
+    scheduler::scheduler_handle handle = scheduler::setup();
+
+    // Interleave the programs to ensure that the variables of one test suite
+    // never leak into the subprocesses of the other.
+    const model::test_program_ptr programs[] = {
+        program_a, program_b, program_a, program_b };
+    for (std::size_t i = 0; i < sizeof(programs) / sizeof(programs[0]); ++i) {
+        const model::test_program_ptr program = programs[i];
+        (void)handle.spawn_test(program, "print_params", user_config);
+
+        scheduler::result_handle_ptr result_handle = handle.wait_any();
+        const std::string value = program == program_a ? "a" : "b";
+        ATF_REQUIRE(atf::utils::compare_file(
+            result_handle->stdout_file().str(),
+            F("Test program: program-%s\n"
+              "Test case: print_params\n"
+              "var=value %s\n") % value % value));
+        result_handle->cleanup();
+        result_handle.reset();
+    }
+
+    handle.cleanup();
+}
+
+
 ATF_TEST_CASE_WITHOUT_HEAD(integration__fake_result);
 ATF_TEST_CASE_BODY(integration__fake_result)
 {
@@ -808,6 +990,113 @@ ATF_TEST_CASE_BODY(integration__fake_result)
 }
 
 
+ATF_TEST_CASE(integration__run_many_cases__benchmark);
+ATF_TEST_CASE_HEAD(integration__run_many_cases__benchmark)
+{
+    set_md_var("descr", "Measures the execution of every test case of a "
+               "large test program, which used to be quadratic because every "
+               "spawn copied the whole test program");
+    set_md_var("require.config", "run_benchmarks");
+    set_md_var("timeout", "300");
+}
+ATF_TEST_CASE_BODY(integration__run_many_cases__benchmark)
+{
+    static const std::size_t num_test_cases = 10000;
+    static const std::size_t max_in_flight = 8;
+
+    // Use fake results so that the subprocesses exit right away and the time
+    // of this test is dominated by the work done by the scheduler.
+    const model::test_result fake_result(model::test_result_passed);
+    model::test_cases_map test_cases;
+    for (std::size_t i = 0; i < num_test_cases; ++i) {
+        const std::string name = F("fake %s") % i;
+        test_cases.insert(model::test_cases_map::value_type(
+            name, model::test_case(name, "Fake", fake_result)));
+    }
+
+    const model::test_program_ptr program(new model::test_program(
+        "mock", fs::path("the-program"), fs::current_path(), "the-suite",
+        model::metadata_builder().build(), test_cases));
+
+    const config::tree user_config = engine::empty_config();
+
+    scheduler::scheduler_handle handle = scheduler::setup();
+
+    const datetime::timestamp start = datetime::timestamp::now();
+    std::size_t in_flight = 0;
+    std::size_t done = 0;
+    for (model::test_cases_map::const_iterator iter = test_cases.begin();
+         iter != test_cases.end() || in_flight > 0; ) {
+        if (iter != test_cases.end() && in_flight < max_in_flight) {
+            (void)handle.spawn_test(program, (*iter).first, user_config);
+            ++in_flight;
+            ++iter;
+        } else {
+            scheduler::result_handle_ptr result_handle = handle.wait_any();
+            const scheduler::test_result_handle* test_result_handle =
+                dynamic_cast< const scheduler::test_result_handle* >(
+                    result_handle.get());
+            ATF_REQUIRE_EQ(fake_result, test_result_handle->test_result());
+            result_handle->cleanup();
+            result_handle.reset();
+            --in_flight;
+            ++done;
+        }
+    }
+    ATF_REQUIRE_EQ(num_test_cases, done);
+    const datetime::timestamp end = datetime::timestamp::now();
+    std::cout << F("Ran %s test cases in %s microseconds\n") %
+        num_test_cases % (end - start).to_microseconds();
+
+    handle.cleanup();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(static_skip_reason);
+ATF_TEST_CASE_BODY(static_skip_reason)
+{
+    const model::test_program_ptr program = model::test_program_builder(
+        "mock", fs::path("the-program"), fs::current_path(), "the-suite")
+        .add_test_case("run_me")
+        .add_test_case("skip_me",
+                       model::metadata_builder()
+                       .add_required_config("variable-that-does-not-exist")
+                       .build())
+        .add_test_case("skip_me_too",
+                       model::metadata_builder()
+                       .add_required_file(fs::current_path() / "missing")
+                       .build())
+        .build_ptr();
+
+    const config::tree user_config = engine::empty_config();
+
+    scheduler::scheduler_handle handle = scheduler::setup();
+
+    ATF_REQUIRE(handle.static_skip_reason(program, "run_me",
+                                          user_config).empty());
+    ATF_REQUIRE_EQ("Required configuration property "
+                   "'variable-that-does-not-exist' not defined",
+                   handle.static_skip_reason(program, "skip_me", user_config));
+    // Required files may be created by other tests, so they are only checked
+    // right before running the test.
+    ATF_REQUIRE(handle.static_skip_reason(program, "skip_me_too",
+                                          user_config).empty());
+
+    (void)handle.spawn_test(program, "skip_me_too", user_config);
+
+    scheduler::result_handle_ptr result_handle = handle.wait_any();
+    const scheduler::test_result_handle* test_result_handle =
+        dynamic_cast< const scheduler::test_result_handle* >(
+            result_handle.get());
+    ATF_REQUIRE_EQ(model::test_result_skipped,
+                   test_result_handle->test_result().type());
+    result_handle->cleanup();
+    result_handle.reset();
+
+    handle.cleanup();
+}
+
+
 ATF_TEST_CASE_WITHOUT_HEAD(integration__cleanup__head_skips);
 ATF_TEST_CASE_BODY(integration__cleanup__head_skips)
 {
@@ -927,6 +1216,117 @@ ATF_TEST_CASE_BODY(integration__cleanup__timeout)
 }
 
 
+/// Runs a test that exceeds its CPU time limit and validates its result.
+///
+/// \param metadata The metadata of the test case to run.
+/// \param user_config The user configuration to run the test case with.
+static void
+do_cpu_time_limit_test(const model::metadata& metadata,
+                       const config::tree& user_config)
+{
+    const model::test_program_ptr program = model::test_program_builder(
+        "mock", fs::path("the-program"), fs::current_path(), "the-suite")
+        .add_test_case("spin", metadata)
+        .build_ptr();
+
+    scheduler::scheduler_handle handle = scheduler::setup();
+
+    (void)handle.spawn_test(program, "spin", user_config);
+
+    scheduler::result_handle_ptr result_handle = handle.wait_any();
+    const scheduler::test_result_handle* test_result_handle =
+        dynamic_cast< const scheduler::test_result_handle* >(
+            result_handle.get());
+    ATF_REQUIRE_EQ(model::test_result(
+                       model::test_result_broken,
+                       "Test case body exceeded its CPU time limit of 1 "
+                       "seconds"),
+                   test_result_handle->test_result());
+    result_handle->cleanup();
+    result_handle.reset();
+
+    handle.cleanup();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(integration__cpu_time_limit__metadata);
+ATF_TEST_CASE_BODY(integration__cpu_time_limit__metadata)
+{
+    config::tree user_config = engine::empty_config();
+    user_config.set_string("cpu_time_limit", "100");
+
+    do_cpu_time_limit_test(model::metadata_builder()
+                           .set_cpu_time_limit(datetime::delta(1, 0))
+                           .set_timeout(datetime::delta(60, 0))
+                           .build(),
+                           user_config);
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(integration__cpu_time_limit__config);
+ATF_TEST_CASE_BODY(integration__cpu_time_limit__config)
+{
+    config::tree user_config = engine::empty_config();
+    user_config.set_string("cpu_time_limit", "1");
+
+    do_cpu_time_limit_test(model::metadata_builder()
+                           .set_timeout(datetime::delta(60, 0))
+                           .build(),
+                           user_config);
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(integration__cpu_time_limit__rounded);
+ATF_TEST_CASE_BODY(integration__cpu_time_limit__rounded)
+{
+    config::tree user_config = engine::empty_config();
+
+    do_cpu_time_limit_test(model::metadata_builder()
+                           .set_cpu_time_limit(datetime::delta(0, 500000))
+                           .set_timeout(datetime::delta(60, 0))
+                           .build(),
+                           user_config);
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(integration__cpu_affinity);
+ATF_TEST_CASE_BODY(integration__cpu_affinity)
+{
+    const std::set< int > allowed = process::allowed_cpus();
+    if (allowed.empty())
+        ATF_SKIP("CPU affinity not supported by this platform");
+
+    const model::test_program_ptr program = model::test_program_builder(
+        "mock", fs::path("the-program"), fs::current_path(), "the-suite")
+        .add_test_case("exit 0")
+        .add_test_case("exit 1")
+        .build_ptr();
+
+    config::tree user_config = engine::empty_config();
+    user_config.set_string("cpu_affinity", "true");
+
+    scheduler::scheduler_handle handle = scheduler::setup();
+
+    (void)handle.spawn_test(program, "exit 0", user_config);
+    (void)handle.spawn_test(program, "exit 1", user_config);
+
+    std::set< int > used;
+    for (int i = 0; i < 2; ++i) {
+        scheduler::result_handle_ptr result_handle = handle.wait_any();
+        const std::set< int > cpus = result_handle->cpus();
+        ATF_REQUIRE_EQ(1, cpus.size());
+        ATF_REQUIRE(allowed.find(*cpus.begin()) != allowed.end());
+        used.insert(*cpus.begin());
+        result_handle->cleanup();
+        result_handle.reset();
+    }
+    // Tests in flight at the same time get CPUs of their own if possible.
+    ATF_REQUIRE_EQ(std::min(allowed.size(), std::size_t(2)), used.size());
+
+    handle.cleanup();
+}
+
+
 ATF_TEST_CASE_WITHOUT_HEAD(integration__check_requirements);
 ATF_TEST_CASE_BODY(integration__check_requirements)
 {
@@ -991,6 +1391,68 @@ ATF_TEST_CASE_BODY(integration__stacktrace)
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(integration__stacktrace__background);
+ATF_TEST_CASE_BODY(integration__stacktrace__background)
+{
+    utils::prepare_coredump_test(this);
+
+    atf::utils::create_file("fake-gdb", "#! /bin/sh\n"
+                            "sleep 3; echo 'frame 1'; exit 0\n");
+    ATF_REQUIRE(::chmod("fake-gdb", 0755) != -1);
+    const std::string gdb = (fs::current_path() / "fake-gdb").str();
+    utils::builtin_gdb = gdb.c_str();
+    atf::utils::create_file("the-program.core", "Not read by the fake GDB");
+
+    const model::test_program_ptr program = model::test_program_builder(
+        "mock", fs::path("the-program"), fs::current_path(), "the-suite")
+        .add_test_case("unknown-dumps-core-1")
+        .add_test_case("unknown-dumps-core-2")
+        .add_test_case("exit 0").build_ptr();
+
+    config::tree user_config = engine::empty_config();
+    user_config.set_string("parallelism", "3");
+
+    scheduler::scheduler_handle handle = scheduler::setup();
+
+    (void)handle.spawn_test(program, "unknown-dumps-core-1", user_config);
+    (void)handle.spawn_test(program, "unknown-dumps-core-2", user_config);
+    (void)handle.spawn_test(program, "exit 0", user_config);
+
+    // GDB takes longer than the passing test to complete, so the latter must
+    // be returned first if GDB did not block the scheduler.
+    std::vector< std::string > order;
+    for (int i = 0; i < 3; ++i) {
+        scheduler::result_handle_ptr result_handle = handle.wait_any();
+        const scheduler::test_result_handle* test_result_handle =
+            dynamic_cast< const scheduler::test_result_handle* >(
+                result_handle.get());
+        order.push_back(test_result_handle->test_case_name());
+
+        if (test_result_handle->test_case_name() == "exit 0") {
+            ATF_REQUIRE_EQ(model::test_result(model::test_result_passed),
+                           test_result_handle->test_result());
+        } else {
+            ATF_REQUIRE_EQ(model::test_result(model::test_result_failed,
+                                              F("Signal %s") % SIGABRT),
+                           test_result_handle->test_result());
+            const std::string stderr_file =
+                result_handle->stderr_file().str();
+            ATF_REQUIRE(atf::utils::grep_file(
+                "attempting to gather stack trace", stderr_file));
+            ATF_REQUIRE(atf::utils::grep_file("^frame 1$", stderr_file));
+            ATF_REQUIRE(atf::utils::grep_file("GDB exited successfully",
+                                              stderr_file));
+        }
+
+        result_handle->cleanup();
+        result_handle.reset();
+    }
+    ATF_REQUIRE_EQ("exit 0", order[0]);
+
+    handle.cleanup();
+}
+
+
 /// Runs a test to verify the dumping of the list of existing files on failure.
 ///
 /// \param test_case The name of the test case to invoke.
@@ -1036,7 +1498,52 @@ ATF_TEST_CASE_BODY(integration__list_files_on_failure__some)
         "create_files_and_fail",
         "This should not be clobbered\n"
         "Files left in work directory after failure: "
-        "dir1, first file, second-file\n");
+        "dir-link, dir1, first file, second-file\n");
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(integration__work_directory_removal);
+ATF_TEST_CASE_BODY(integration__work_directory_removal)
+{
+    const model::test_program_ptr program = model::test_program_builder(
+        "mock", fs::path("the-program"), fs::current_path(), "the-suite")
+        .add_test_case("create_files_and_fail").build_ptr();
+
+    const config::tree user_config = engine::empty_config();
+
+    scheduler::scheduler_handle handle = scheduler::setup();
+
+    (void)handle.spawn_test(program, "create_files_and_fail", user_config);
+
+    scheduler::result_handle_ptr result_handle = handle.wait_any();
+    const scheduler::test_result_handle* test_result_handle =
+        dynamic_cast< const scheduler::test_result_handle* >(
+            result_handle.get());
+    ATF_REQUIRE_EQ(model::test_result(model::test_result_failed,
+                                      F("Signal %s") % SIGTERM),
+                   test_result_handle->test_result());
+
+    // The files left behind by the test must have been deleted in the
+    // background by the time the result is returned, without touching the
+    // output of the test.
+    const fs::path work_directory = result_handle->work_directory();
+    ATF_REQUIRE(fs::exists(work_directory));
+    std::set< std::string > names;
+    const fs::directory dir(work_directory);
+    for (fs::directory::const_iterator iter = dir.begin(); iter != dir.end();
+         ++iter) {
+        if (iter->name != "." && iter->name != "..")
+            names.insert(iter->name);
+    }
+    ATF_REQUIRE(names.empty());
+    ATF_REQUIRE(atf::utils::grep_file("^This should not be clobbered$",
+                                      result_handle->stderr_file().str()));
+
+    result_handle->cleanup();
+    ATF_REQUIRE(!fs::exists(work_directory));
+    result_handle.reset();
+
+    handle.cleanup();
 }
 
 
@@ -1213,24 +1720,36 @@ ATF_INIT_TEST_CASES(tcs)
     ATF_ADD_TEST_CASE(tcs, integration__list_timeout);
     ATF_ADD_TEST_CASE(tcs, integration__list_fail);
     ATF_ADD_TEST_CASE(tcs, integration__list_empty);
+    ATF_ADD_TEST_CASE(tcs, integration__list_background__wait);
+    ATF_ADD_TEST_CASE(tcs, integration__list_background__wait_any);
+    ATF_ADD_TEST_CASE(tcs, integration__list_cache);
 
     ATF_ADD_TEST_CASE(tcs, integration__run_one);
     ATF_ADD_TEST_CASE(tcs, integration__run_many);
 
     ATF_ADD_TEST_CASE(tcs, integration__run_check_paths);
     ATF_ADD_TEST_CASE(tcs, integration__parameters_and_output);
+    ATF_ADD_TEST_CASE(tcs, integration__parameters_per_suite);
 
     ATF_ADD_TEST_CASE(tcs, integration__fake_result);
+    ATF_ADD_TEST_CASE(tcs, integration__run_many_cases__benchmark);
     ATF_ADD_TEST_CASE(tcs, integration__cleanup__head_skips);
     ATF_ADD_TEST_CASE(tcs, integration__cleanup__body_skips);
     ATF_ADD_TEST_CASE(tcs, integration__cleanup__body_ok__cleanup_bad);
     ATF_ADD_TEST_CASE(tcs, integration__cleanup__body_bad__cleanup_ok);
     ATF_ADD_TEST_CASE(tcs, integration__cleanup__body_bad__cleanup_bad);
     ATF_ADD_TEST_CASE(tcs, integration__cleanup__timeout);
+    ATF_ADD_TEST_CASE(tcs, integration__cpu_time_limit__metadata);
+    ATF_ADD_TEST_CASE(tcs, integration__cpu_time_limit__config);
+    ATF_ADD_TEST_CASE(tcs, integration__cpu_time_limit__rounded);
+    ATF_ADD_TEST_CASE(tcs, integration__cpu_affinity);
     ATF_ADD_TEST_CASE(tcs, integration__check_requirements);
+    ATF_ADD_TEST_CASE(tcs, static_skip_reason);
     ATF_ADD_TEST_CASE(tcs, integration__stacktrace);
+    ATF_ADD_TEST_CASE(tcs, integration__stacktrace__background);
     ATF_ADD_TEST_CASE(tcs, integration__list_files_on_failure__none);
     ATF_ADD_TEST_CASE(tcs, integration__list_files_on_failure__some);
+    ATF_ADD_TEST_CASE(tcs, integration__work_directory_removal);
     ATF_ADD_TEST_CASE(tcs, integration__prevent_clobbering_control_files);
 
     ATF_ADD_TEST_CASE(tcs, debug_test);
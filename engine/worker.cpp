@@ -0,0 +1,649 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "engine/worker.hpp"
+
+extern "C" {
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+}
+
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "model/metadata.hpp"
+#include "model/test_case.hpp"
+#include "model/test_program.hpp"
+#include "utils/env.hpp"
+#include "utils/format/macros.hpp"
+#include "utils/fs/exceptions.hpp"
+#include "utils/fs/operations.hpp"
+#include "utils/fs/path.hpp"
+#include "utils/logging/macros.hpp"
+#include "utils/noncopyable.hpp"
+#include "utils/optional.ipp"
+#include "utils/passwd.hpp"
+#include "utils/process/exceptions.hpp"
+#include "utils/process/executor.hpp"
+#include "utils/process/fdstream.hpp"
+#include "utils/process/isolation.hpp"
+#include "utils/process/operations.hpp"
+#include "utils/process/status.hpp"
+#include "utils/sanity.hpp"
+#include "utils/text/exceptions.hpp"
+#include "utils/text/operations.ipp"
+
+namespace config = utils::config;
+namespace executor = utils::process::executor;
+namespace fs = utils::fs;
+namespace process = utils::process;
+namespace text = utils::text;
+
+using utils::none;
+using utils::optional;
+
+
+namespace {
+
+
+/// Basename of the file containing the result written by the test case.
+///
+/// This must match the name used by the atf interface, which computes the
+/// results of our test cases.
+static const char* result_name = "result.atf";
+
+
+/// Basename of the file containing the stdout written by the worker.
+static const char* stdout_name = "worker.out";
+
+
+/// Basename of the file containing the stderr written by the worker.
+static const char* stderr_name = "worker.err";
+
+
+/// A test program running in worker mode.
+struct worker {
+    /// Absolute path to the test program.
+    fs::path program;
+
+    /// Private directory of the worker, used as its HOME and TMPDIR.
+    fs::path home;
+
+    /// PID of the worker process, which also leads its own process group.
+    pid_t pid;
+
+    /// Write end of the pipe connected to the stdin of the worker.
+    int request_fd;
+
+    /// Read end of the pipe connected to the stdout of the worker.
+    int reply_fd;
+
+    /// Whether the worker has been reserved for a test case.
+    bool busy;
+
+    /// Constructor.
+    ///
+    /// \param program_ Absolute path to the test program.
+    /// \param home_ Private directory of the worker.
+    /// \param pid_ PID of the worker process.
+    /// \param request_fd_ Pipe connected to the stdin of the worker.
+    /// \param reply_fd_ Pipe connected to the stdout of the worker.
+    worker(const fs::path& program_, const fs::path& home_, const pid_t pid_,
+           const int request_fd_, const int reply_fd_) :
+        program(program_), home(home_), pid(pid_), request_fd(request_fd_),
+        reply_fd(reply_fd_), busy(false)
+    {
+    }
+};
+
+
+/// Collection of workers keyed by their identifier.
+typedef std::map< int, worker > workers_map;
+
+
+/// Marks a file descriptor to be closed on exec.
+///
+/// \param fd The file descriptor to modify.
+///
+/// \throw process::system_error If the call to fcntl(2) fails.
+static void
+set_cloexec(const int fd)
+{
+    if (::fcntl(fd, F_SETFD, FD_CLOEXEC) == -1) {
+        const int original_errno = errno;
+        throw process::system_error(F("Failed to set FD_CLOEXEC on %s") % fd,
+                                    original_errno);
+    }
+}
+
+
+/// Writes a string to a file descriptor, retrying on partial writes.
+///
+/// \param fd The file descriptor to write to.
+/// \param data The string to write.
+///
+/// \return True if all of the string was written; false otherwise.
+static bool
+write_all(const int fd, const std::string& data)
+{
+    std::string::size_type done = 0;
+    while (done < data.length()) {
+        const ssize_t ret = ::write(fd, data.data() + done,
+                                    data.length() - done);
+        if (ret == -1) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        done += ret;
+    }
+    return true;
+}
+
+
+/// Removes the private directory of a worker.
+///
+/// \param home The directory to remove.
+static void
+remove_home(const fs::path& home)
+{
+    try {
+        fs::rm_r(home);
+    } catch (const fs::error& e) {
+        LW(F("Failed to remove worker directory %s: %s") % home % e.what());
+    }
+}
+
+
+/// Starts a test program in worker mode.
+///
+/// The worker is detached from the scheduler process by means of an
+/// intermediate process so that its termination cannot be mistaken for that
+/// of any of the subprocesses tracked by the executor.  The worker terminates
+/// by itself once the scheduler closes its stdin.
+///
+/// The worker is isolated in the same way as the subprocesses of the executor,
+/// except that its HOME and TMPDIR point to a private directory of its own
+/// because the work directory changes with every test case.  It also runs in a
+/// session of its own so that stop_worker() can kill any processes left behind
+/// by the test cases.
+///
+/// \param program Absolute path to the test program.
+/// \param vars User-provided variables to pass to the test program.
+///
+/// \return The new worker.
+///
+/// \throw fs::error If the private directory of the worker cannot be created.
+/// \throw process::system_error If the worker cannot be started.
+static worker
+start_worker(const fs::path& program, const config::properties_map& vars)
+{
+    process::args_vector args;
+    for (config::properties_map::const_iterator iter = vars.begin();
+         iter != vars.end(); ++iter) {
+        args.push_back(F("-v%s=%s") % (*iter).first % (*iter).second);
+    }
+    args.push_back("-w");
+
+    const fs::path home = fs::mkdtemp_public("kyua-worker.XXXXXX");
+
+    int request[2];
+    if (::pipe(request) == -1) {
+        const int original_errno = errno;
+        remove_home(home);
+        throw process::system_error("pipe(2) failed", original_errno);
+    }
+    int reply[2];
+    if (::pipe(reply) == -1) {
+        const int original_errno = errno;
+        ::close(request[0]);
+        ::close(request[1]);
+        remove_home(home);
+        throw process::system_error("pipe(2) failed", original_errno);
+    }
+
+    try {
+        // Prevent other subprocesses from holding the worker's pipes open,
+        // which would delay the worker's termination.
+        set_cloexec(request[0]);
+        set_cloexec(request[1]);
+        set_cloexec(reply[0]);
+        set_cloexec(reply[1]);
+    } catch (const process::system_error& e) {
+        ::close(request[0]);
+        ::close(request[1]);
+        ::close(reply[0]);
+        ::close(reply[1]);
+        remove_home(home);
+        throw;
+    }
+
+    const pid_t pid = ::fork();
+    if (pid == -1) {
+        const int original_errno = errno;
+        ::close(request[0]);
+        ::close(request[1]);
+        ::close(reply[0]);
+        ::close(reply[1]);
+        remove_home(home);
+        throw process::system_error("fork(2) failed", original_errno);
+    } else if (pid == 0) {
+        const pid_t worker_pid = ::fork();
+        if (worker_pid == 0) {
+            (void)::setsid();
+
+            const int null_fd = ::open("/dev/null", O_WRONLY);
+            if (::dup2(request[0], STDIN_FILENO) == -1 ||
+                ::dup2(reply[1], STDOUT_FILENO) == -1 ||
+                null_fd == -1 || ::dup2(null_fd, STDERR_FILENO) == -1)
+                ::_exit(EXIT_FAILURE);
+
+            process::isolate_child(none, home);
+            utils::setenv("__RUNNING_INSIDE_ATF_RUN", "internal-yes-value");
+            process::exec(program, args);
+        }
+
+        // Abruptly terminate the process.  We don't want to run any destructors
+        // inherited from the parent process by mistake.
+        if (worker_pid == -1 ||
+            ::write(reply[1], &worker_pid, sizeof(worker_pid)) !=
+            sizeof(worker_pid))
+            ::_exit(EXIT_FAILURE);
+        ::_exit(EXIT_SUCCESS);
+    }
+
+    ::close(request[0]);
+    ::close(reply[1]);
+
+    int status;
+    while (::waitpid(pid, &status, 0) == -1 && errno == EINTR) {}
+
+    pid_t worker_pid;
+    ssize_t ret;
+    while ((ret = ::read(reply[0], &worker_pid, sizeof(worker_pid))) == -1 &&
+           errno == EINTR) {}
+    if (ret != sizeof(worker_pid)) {
+        ::close(request[1]);
+        ::close(reply[0]);
+        remove_home(home);
+        throw process::system_error(F("Failed to start worker for %s") %
+                                    program, ECHILD);
+    }
+
+    LI(F("Started worker %s for %s") % worker_pid % program);
+    return worker(program, home, worker_pid, request[1], reply[0]);
+}
+
+
+/// Checks if an idle worker can accept requests.
+///
+/// An idle worker has nothing to say, so any pending data or the end of its
+/// output means that it is in an unknown state or that it died.
+///
+/// \param w The worker to check.
+///
+/// \return True if the worker is usable; false otherwise.
+static bool
+is_usable(const worker& w)
+{
+    struct ::pollfd poll_fd;
+    poll_fd.fd = w.reply_fd;
+    poll_fd.events = POLLIN;
+    poll_fd.revents = 0;
+    int ret;
+    while ((ret = ::poll(&poll_fd, 1, 0)) == -1 && errno == EINTR) {}
+    return ret == 0;
+}
+
+
+/// Terminates a worker and releases its resources.
+///
+/// This kills the whole process group of the worker, which includes any
+/// processes spawned by its test cases that did not detach from it.
+///
+/// \param w The worker to terminate.
+static void
+stop_worker(const worker& w)
+{
+    LI(F("Stopping worker %s for %s") % w.pid % w.program);
+    process::terminate_group(w.pid);
+    ::close(w.request_fd);
+    ::close(w.reply_fd);
+    remove_home(w.home);
+}
+
+
+/// Records an error in the result file of a test case and terminates.
+///
+/// \param result_file Path to the result file of the test case.
+/// \param reason Description of the problem.
+static void
+fail_test(const fs::path& result_file, const std::string& reason)
+    UTILS_NORETURN;
+static void
+fail_test(const fs::path& result_file, const std::string& reason)
+{
+    std::ofstream output(result_file.c_str());
+    output << "broken: " << reason << '\n';
+    output.close();
+    ::_exit(EXIT_FAILURE);
+}
+
+
+/// Appends the contents of a file to a stream, if the file exists.
+///
+/// \param path The file to read.
+/// \param output The stream to write to.
+static void
+copy_output(const fs::path& path, std::ostream& output)
+{
+    std::ifstream input(path.c_str());
+    if (input) {
+        output << input.rdbuf();
+        output.flush();
+    }
+}
+
+
+}  // anonymous namespace
+
+
+/// Internal implementation of the worker_interface class.
+struct engine::worker_interface::impl : utils::noncopyable {
+    /// PID of the process that owns the workers.
+    const pid_t owner;
+
+    /// Workers started so far.
+    workers_map workers;
+
+    /// Identifier to assign to the next worker.
+    int next_id;
+
+    /// Worker reserved by the last call to prepare_test(), or -1 if none.
+    ///
+    /// This is inherited by the subprocess spawned right after the call, which
+    /// is the one in charge of sending the request to the worker.
+    int reserved_id;
+
+    /// Test case for which reserved_id was reserved.
+    std::string reserved_test_case;
+
+    /// Constructor.
+    impl(void) : owner(::getpid()), next_id(0), reserved_id(-1)
+    {
+    }
+
+    /// Destructor.
+    ///
+    /// This stops the workers, which should otherwise terminate by themselves
+    /// when their stdin is closed, in case they are still busy.
+    ~impl(void)
+    {
+        if (::getpid() != owner)
+            return;
+        for (workers_map::const_iterator iter = workers.begin();
+             iter != workers.end(); ++iter)
+            stop_worker((*iter).second);
+    }
+
+    /// Finds an idle worker for a test program, starting one if necessary.
+    ///
+    /// \param program Absolute path to the test program.
+    /// \param vars User-provided variables to pass to the test program.
+    ///
+    /// \return The identifier of the worker.
+    ///
+    /// \throw std::runtime_error If a new worker cannot be started.
+    int
+    find_idle(const fs::path& program, const config::properties_map& vars)
+    {
+        workers_map::iterator iter = workers.begin();
+        while (iter != workers.end()) {
+            const worker& w = (*iter).second;
+            if (w.busy || w.program != program) {
+                ++iter;
+            } else if (is_usable(w)) {
+                return (*iter).first;
+            } else {
+                LW(F("Worker %s for %s died or got out of sync") % w.pid %
+                   w.program);
+                stop_worker(w);
+                workers.erase(iter++);
+            }
+        }
+
+        const int id = next_id++;
+        workers.insert(workers_map::value_type(id,
+                                               start_worker(program, vars)));
+        return id;
+    }
+};
+
+
+/// Constructor.
+engine::worker_interface::worker_interface(void) :
+    _pimpl(new impl())
+{
+}
+
+
+/// Destructor.
+engine::worker_interface::~worker_interface(void)
+{
+}
+
+
+/// Reserves a worker to execute a test case.
+///
+/// \param test_program The test program to execute.
+/// \param test_case_name Name of the test case to invoke.
+/// \param vars User-provided variables to pass to the test program.
+/// \param limits Resource limits to apply to the test case.
+///
+/// \return The identifier of the reserved worker, or -1 if the test case has
+/// to be executed in its own process.
+int
+engine::worker_interface::prepare_test(const model::test_program& test_program,
+                                       const std::string& test_case_name,
+                                       const config::properties_map& vars,
+                                       const process::resource_limits& limits)
+{
+    _pimpl->reserved_id = -1;
+
+    // The worker runs with the privileges of the scheduler, so it cannot run
+    // test cases that need to drop them.
+    const model::test_case& test_case = test_program.find(test_case_name);
+    if (test_case.get_metadata().required_user() == "unprivileged")
+        return -1;
+
+    // Resource limits and CPU affinity only apply to the process spawned by the
+    // scheduler and cannot be lifted once set, so they cannot be applied to a
+    // worker shared by many test cases.
+    if (!limits.unlimited())
+        return -1;
+
+    int id;
+    try {
+        id = _pimpl->find_idle(test_program.absolute_path(), vars);
+    } catch (const std::runtime_error& e) {
+        LW(F("Cannot start worker for %s; running test case %s in its own "
+             "process: %s") % test_program.absolute_path() % test_case_name %
+           e.what());
+        return -1;
+    }
+
+    (*_pimpl->workers.find(id)).second.busy = true;
+    _pimpl->reserved_id = id;
+    _pimpl->reserved_test_case = test_case_name;
+    return id;
+}
+
+
+/// Releases a worker once the test case that used it terminates.
+///
+/// \param reservation The identifier of the worker, or -1 if none.
+/// \param status The termination status of the subprocess used to execute
+///     the exec_test() method or none if the test timed out.
+void
+engine::worker_interface::finish_test(const int reservation,
+                                      const optional< process::status >& status)
+{
+    if (reservation == -1)
+        return;
+
+    const workers_map::iterator iter = _pimpl->workers.find(reservation);
+    INV(iter != _pimpl->workers.end());
+    worker& w = (*iter).second;
+    INV(w.busy);
+
+    if (!status || !status.get().exited() || !is_usable(w)) {
+        // The worker may still be running the test case or may have died in
+        // it, so it cannot be trusted with any further requests.  Stopping it
+        // right away also kills any processes that the test case left behind.
+        stop_worker(w);
+        _pimpl->workers.erase(iter);
+    } else {
+        w.busy = false;
+    }
+}
+
+
+/// Checks whether the subprocess of a test case accounts for its resources.
+///
+/// \param reservation The identifier of the worker, or -1 if none.
+///
+/// \return False if the test case ran in a worker, as the scheduler only sees
+/// the subprocess that relays the request to it; true otherwise.
+bool
+engine::worker_interface::measures_usage(const int reservation) const
+{
+    return reservation == -1;
+}
+
+
+/// Describes the program that exec_test() executes.
+///
+/// \param test_program The test program to execute.
+/// \param test_case_name Name of the test case to invoke.
+/// \param vars User-provided variables to pass to the test program.
+/// \param control_directory Directory where the interface may place control
+///     files.
+///
+/// \return None if a worker was reserved for the test case, as the request has
+/// to be sent from a subprocess; otherwise, the program that the atf interface
+/// executes.
+optional< executor::command >
+engine::worker_interface::test_command(const model::test_program& test_program,
+                                       const std::string& test_case_name,
+                                       const config::properties_map& vars,
+                                       const fs::path& control_directory) const
+{
+    if (_pimpl->reserved_id != -1 &&
+        _pimpl->reserved_test_case == test_case_name)
+        return none;
+    return atf_interface::test_command(test_program, test_case_name, vars,
+                                       control_directory);
+}
+
+
+/// Executes a test case of the test program.
+///
+/// If a worker was reserved for the test case, this sends the request to it
+/// and terminates with the exit status reported by the worker once the test
+/// case completes.  Otherwise, this executes the test program as the atf
+/// interface does.
+///
+/// \param test_program The test program to execute.
+/// \param test_case_name Name of the test case to invoke.
+/// \param vars User-provided variables to pass to the test program.
+/// \param control_directory Directory where the interface may place control
+///     files.
+void
+engine::worker_interface::exec_test(const model::test_program& test_program,
+                                    const std::string& test_case_name,
+                                    const config::properties_map& vars,
+                                    const fs::path& control_directory) const
+{
+    if (_pimpl->reserved_id == -1 ||
+        _pimpl->reserved_test_case != test_case_name)
+        atf_interface::exec_test(test_program, test_case_name, vars,
+                                 control_directory);
+
+    const workers_map::const_iterator iter = _pimpl->workers.find(
+        _pimpl->reserved_id);
+    INV(iter != _pimpl->workers.end());
+    const worker& w = (*iter).second;
+
+    const fs::path result_file = control_directory / result_name;
+    const fs::path stdout_file = control_directory / stdout_name;
+    const fs::path stderr_file = control_directory / stderr_name;
+
+    // The control directory is unique among all the tests in flight, so it
+    // serves to match the reply with our request.
+    const std::string token = control_directory.str();
+
+    // Let write(2) report the death of the worker instead of killing us.
+    ::signal(SIGPIPE, SIG_IGN);
+
+    if (!write_all(w.request_fd, F("%s\t%s\t%s\t%s\t%s\t%s\n") % token %
+                   test_case_name % result_file % stdout_file % stderr_file %
+                   fs::current_path()))
+        fail_test(result_file, "Failed to send the test case to the worker");
+
+    process::ifdstream reply(::dup(w.reply_fd));
+    std::string line;
+    while (std::getline(reply, line)) {
+        const std::string::size_type pos = line.find('\t');
+        if (pos == std::string::npos || line.substr(0, pos) != token) {
+            // Stale reply to a request that we abandoned; ignore it.
+            continue;
+        }
+
+        int exit_status;
+        try {
+            exit_status = text::to_type< int >(line.substr(pos + 1));
+        } catch (const text::value_error& e) {
+            fail_test(result_file, F("Invalid exit status in worker reply "
+                                     "'%s'") % line);
+        }
+
+        copy_output(stdout_file, std::cout);
+        copy_output(stderr_file, std::cerr);
+        ::_exit(exit_status);
+    }
+    fail_test(result_file, "Worker died while running the test case");
+}
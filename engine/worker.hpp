@@ -0,0 +1,109 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// \file engine/worker.hpp
+/// Execution engine for test programs that run many test cases per process.
+///
+/// Worker test programs are atf test programs that, in addition, implement a
+/// worker mode in which a single process executes many test cases in sequence.
+/// This amortizes the cost of spawning the test program among all of its test
+/// cases, which dominates the run time of suites with many tiny test cases.
+///
+/// The scheduler keeps one worker per test program and execution slot.  A
+/// worker is started by executing the test program with the -w flag, in
+/// addition to any -v flags for the configuration variables.  The worker reads
+/// requests from its stdin, one per line, each with the following
+/// tab-separated fields:
+///
+/// 1) An opaque token identifying the request.
+/// 2) The name of the test case to execute.
+/// 3) The path to the file in which to store the result of the test case, in
+///    the same format as the atf interface.
+/// 4) The path to the file in which to store the stdout of the test case.
+/// 5) The path to the file in which to store the stderr of the test case.
+/// 6) The work directory in which to execute the test case.
+///
+/// Once the test case finishes, the worker writes a line to its stdout with the
+/// token of the request and the exit status that the test case would have had
+/// if it had been executed on its own, separated by a tab.  The worker must
+/// terminate once its stdin is closed.
+///
+/// Workers that crash are restarted on demand, and workers that run a test case
+/// past its timeout are killed.  Test cases that cannot run within a worker,
+/// such as those that need to drop privileges, and cleanup routines are
+/// executed in their own processes as with the atf interface.
+///
+/// The resources consumed by a test case cannot be told apart from those of
+/// its worker, so they are not reported.
+
+#if !defined(ENGINE_WORKER_HPP)
+#define ENGINE_WORKER_HPP
+
+#include "engine/atf.hpp"
+
+#include "utils/shared_ptr.hpp"
+
+namespace engine {
+
+
+/// Implementation of the scheduler interface for worker test programs.
+class worker_interface : public engine::atf_interface {
+    struct impl;
+
+    /// Pointer to the shared internal implementation.
+    std::shared_ptr< impl > _pimpl;
+
+public:
+    worker_interface(void);
+    ~worker_interface(void);
+
+    int prepare_test(const model::test_program&, const std::string&,
+                     const utils::config::properties_map&,
+                     const utils::process::resource_limits&);
+
+    void finish_test(const int,
+                     const utils::optional< utils::process::status >&);
+
+    bool measures_usage(const int) const;
+
+    utils::optional< utils::process::executor::command > test_command(
+        const model::test_program&, const std::string&,
+        const utils::config::properties_map&,
+        const utils::fs::path&) const;
+
+    void exec_test(const model::test_program&, const std::string&,
+                   const utils::config::properties_map&,
+                   const utils::fs::path&) const
+        UTILS_NORETURN;
+};
+
+
+}  // namespace engine
+
+
+#endif  // !defined(ENGINE_WORKER_HPP)
@@ -0,0 +1,213 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+extern "C" {
+#include <sys/stat.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+}
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "utils/format/macros.hpp"
+#include "utils/test_utils.ipp"
+#include "utils/text/operations.ipp"
+
+namespace text = utils::text;
+
+
+namespace {
+
+
+/// Writes the result of a test case.
+///
+/// \param result_file Path to the file in which to store the result.
+/// \param result The result in the format of the atf interface.
+static void
+write_result(const std::string& result_file, const std::string& result)
+{
+    std::ofstream output(result_file.c_str());
+    if (!output) {
+        std::cerr << "Failed to open " << result_file << '\n';
+        std::exit(EXIT_FAILURE);
+    }
+    output << result << '\n';
+}
+
+
+/// Runs a test case.
+///
+/// \param name The name of the test case.
+/// \param result_file Path to the file in which to store the result.
+///
+/// \return The exit status of the test case.
+static int
+run_test_case(const std::string& name, const std::string& result_file)
+{
+    if (name == "crash") {
+        utils::abort_without_coredump();
+    } else if (name == "fail") {
+        std::cerr << "This is the stderr of fail\n";
+        write_result(result_file, "failed: Failed on purpose");
+        return EXIT_FAILURE;
+    } else if (name == "isolated") {
+        const char* tz = std::getenv("TZ");
+        const ::mode_t mask = ::umask(0);
+        (void)::umask(mask);
+        if (::getpgrp() != ::getpid())
+            write_result(result_file, "failed: Not a process group leader");
+        else if (tz == NULL || std::strcmp(tz, "UTC") != 0)
+            write_result(result_file, "failed: TZ not reset");
+        else if (mask != 0022)
+            write_result(result_file, "failed: umask not reset");
+        else
+            write_result(result_file, "passed");
+        return EXIT_SUCCESS;
+    } else if (name == "hang") {
+        for (;;)
+            ::pause();
+    } else if (name == "pass") {
+        std::cout << "This is the stdout of pass\n";
+        write_result(result_file, "passed");
+        return EXIT_SUCCESS;
+    } else if (name == "pid") {
+        std::cout << ::getpid() << '\n';
+        write_result(result_file, "passed");
+        return EXIT_SUCCESS;
+    } else {
+        std::cerr << "Unknown test case " << name << '\n';
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+
+/// Prints the list of test cases in the format of the atf interface.
+static void
+list_test_cases(void)
+{
+    std::cout << "Content-Type: application/X-atf-tp; version=\"1\"\n\n"
+              << "ident: crash\n\n"
+              << "ident: fail\n\n"
+              << "ident: hang\n"
+              << "timeout: 1\n\n"
+              << "ident: isolated\n\n"
+              << "ident: pass\n\n"
+              << "ident: pid\n";
+}
+
+
+/// Redirects a file descriptor to a file.
+///
+/// \param path The file to open.
+/// \param fd The file descriptor to redirect.
+static void
+redirect(const std::string& path, const int fd)
+{
+    const int new_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+                              0644);
+    if (new_fd == -1 || ::dup2(new_fd, fd) == -1)
+        std::exit(EXIT_FAILURE);
+    ::close(new_fd);
+}
+
+
+/// Serves test case requests from stdin until it is closed.
+static void
+serve_requests(void)
+{
+    // Keep the reply channel away from the stdout of the test cases.
+    const int reply_fd = ::dup(STDOUT_FILENO);
+    const int saved_stderr = ::dup(STDERR_FILENO);
+    if (reply_fd == -1 || saved_stderr == -1)
+        std::exit(EXIT_FAILURE);
+
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        const std::vector< std::string > fields = text::split(line, '\t');
+        if (fields.size() != 6)
+            std::exit(EXIT_FAILURE);
+        const std::string& token = fields[0];
+
+        if (::chdir(fields[5].c_str()) == -1)
+            std::exit(EXIT_FAILURE);
+        redirect(fields[3], STDOUT_FILENO);
+        redirect(fields[4], STDERR_FILENO);
+
+        const int exit_status = run_test_case(fields[1], fields[2]);
+
+        std::cout.flush();
+        std::cerr.flush();
+        if (::dup2(reply_fd, STDOUT_FILENO) == -1 ||
+            ::dup2(saved_stderr, STDERR_FILENO) == -1)
+            std::exit(EXIT_FAILURE);
+
+        std::cout << F("%s\t%s\n") % token % exit_status;
+        std::cout.flush();
+    }
+}
+
+
+}  // anonymous namespace
+
+
+/// Entry point to the test program.
+///
+/// \param argc Number of arguments.
+/// \param argv Values of the arguments.
+///
+/// \return The exit status of the program.
+int
+main(int argc, char** argv)
+{
+    std::string result_file;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-l") {
+            list_test_cases();
+            return EXIT_SUCCESS;
+        } else if (arg == "-w") {
+            serve_requests();
+            return EXIT_SUCCESS;
+        } else if (arg.find("-r") == 0) {
+            result_file = arg.substr(2);
+        } else if (arg.find("-v") == 0) {
+            // Ignore configuration variables.
+        } else {
+            return run_test_case(arg, result_file);
+        }
+    }
+    std::cerr << "No test case specified\n";
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,284 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "engine/worker.hpp"
+
+extern "C" {
+#include <signal.h>
+}
+
+#include <string>
+
+#include <atf-c++.hpp>
+
+#include "engine/config.hpp"
+#include "engine/scheduler.hpp"
+#include "model/metadata.hpp"
+#include "model/test_case.hpp"
+#include "model/test_program_fwd.hpp"
+#include "model/test_result.hpp"
+#include "utils/config/tree.ipp"
+#include "utils/format/macros.hpp"
+#include "utils/fs/path.hpp"
+#include "utils/optional.ipp"
+#include "utils/stream.hpp"
+
+namespace config = utils::config;
+namespace fs = utils::fs;
+namespace scheduler = engine::scheduler;
+
+
+namespace {
+
+
+/// Runs one test case of the helper test program and checks its result.
+///
+/// \param tc Pointer to the calling test case, to obtain srcdir.
+/// \param handle The scheduler in which to run the test case.
+/// \param test_case_name Name of the test case to run.
+/// \param exp_result The expected result.
+/// \param user_config User-provided configuration variables.
+///
+/// \return The stdout of the test case.
+static std::string
+run_one(const atf::tests::tc* tc, scheduler::scheduler_handle& handle,
+        const char* test_case_name, const model::test_result& exp_result,
+        const config::tree& user_config = engine::empty_config())
+{
+
+    const model::test_program_ptr program(new scheduler::lazy_test_program(
+        "worker", fs::path("worker_helpers"),
+        fs::path(tc->get_config_var("srcdir")), "the-suite",
+        model::metadata_builder().build(), user_config, handle));
+
+    (void)handle.spawn_test(program, test_case_name, user_config);
+
+    scheduler::result_handle_ptr result_handle = handle.wait_any();
+    const scheduler::test_result_handle* test_result_handle =
+        dynamic_cast< const scheduler::test_result_handle* >(
+            result_handle.get());
+    atf::utils::cat_file(result_handle->stdout_file().str(), "stdout: ");
+    atf::utils::cat_file(result_handle->stderr_file().str(), "stderr: ");
+    ATF_REQUIRE_EQ(exp_result, test_result_handle->test_result());
+    const std::string stdout_contents = utils::read_file(
+        result_handle->stdout_file());
+    result_handle->cleanup();
+    result_handle.reset();
+
+    return stdout_contents;
+}
+
+
+/// Runs the "pass" test case of the helper test program.
+///
+/// \param tc Pointer to the calling test case, to obtain srcdir.
+/// \param handle The scheduler in which to run the test case.
+/// \param user_config User-provided configuration variables.
+///
+/// \return Whether the scheduler reported the resource usage of the test case.
+static bool
+run_has_usage(const atf::tests::tc* tc, scheduler::scheduler_handle& handle,
+              const config::tree& user_config)
+{
+    const model::test_program_ptr program(new scheduler::lazy_test_program(
+        "worker", fs::path("worker_helpers"),
+        fs::path(tc->get_config_var("srcdir")), "the-suite",
+        model::metadata_builder().build(), user_config, handle));
+
+    (void)handle.spawn_test(program, "pass", user_config);
+
+    scheduler::result_handle_ptr result_handle = handle.wait_any();
+    const bool has_usage = result_handle->has_usage();
+    result_handle->cleanup();
+    result_handle.reset();
+    return has_usage;
+}
+
+
+}  // anonymous namespace
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(list);
+ATF_TEST_CASE_BODY(list)
+{
+    scheduler::scheduler_handle handle = scheduler::setup();
+
+    const config::tree user_config = engine::empty_config();
+    const scheduler::lazy_test_program program(
+        "worker", fs::path("worker_helpers"),
+        fs::path(get_config_var("srcdir")), "the-suite",
+        model::metadata_builder().build(), user_config, handle);
+    const model::test_cases_map test_cases = handle.list_tests(
+        &program, user_config);
+
+    ATF_REQUIRE_EQ(6, test_cases.size());
+    ATF_REQUIRE(test_cases.find("pass") != test_cases.end());
+    ATF_REQUIRE(test_cases.find("hang") != test_cases.end());
+
+    handle.cleanup();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(run__pass);
+ATF_TEST_CASE_BODY(run__pass)
+{
+    scheduler::scheduler_handle handle = scheduler::setup();
+    ATF_REQUIRE_EQ("This is the stdout of pass\n",
+                   run_one(this, handle, "pass",
+                           model::test_result(model::test_result_passed)));
+    handle.cleanup();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(run__fail);
+ATF_TEST_CASE_BODY(run__fail)
+{
+    scheduler::scheduler_handle handle = scheduler::setup();
+    (void)run_one(this, handle, "fail",
+                  model::test_result(model::test_result_failed,
+                                     "Failed on purpose"));
+    handle.cleanup();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(run__reuse_worker);
+ATF_TEST_CASE_BODY(run__reuse_worker)
+{
+    scheduler::scheduler_handle handle = scheduler::setup();
+    const model::test_result passed(model::test_result_passed);
+
+    const std::string pid1 = run_one(this, handle, "pid", passed);
+    (void)run_one(this, handle, "fail",
+                  model::test_result(model::test_result_failed,
+                                     "Failed on purpose"));
+    const std::string pid2 = run_one(this, handle, "pid", passed);
+    ATF_REQUIRE(!pid1.empty());
+    ATF_REQUIRE_EQ(pid1, pid2);
+
+    handle.cleanup();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(run__isolated);
+ATF_TEST_CASE_BODY(run__isolated)
+{
+    scheduler::scheduler_handle handle = scheduler::setup();
+    (void)run_one(this, handle, "isolated",
+                  model::test_result(model::test_result_passed));
+    handle.cleanup();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(run__limits_bypass_worker);
+ATF_TEST_CASE_BODY(run__limits_bypass_worker)
+{
+    scheduler::scheduler_handle handle = scheduler::setup();
+    const model::test_result passed(model::test_result_passed);
+
+    config::tree limited_config = engine::empty_config();
+    limited_config.set_string("cpu_time_limit", "60");
+
+    const std::string pid1 = run_one(this, handle, "pid", passed);
+    const std::string pid2 = run_one(this, handle, "pid", passed,
+                                     limited_config);
+    const std::string pid3 = run_one(this, handle, "pid", passed);
+    ATF_REQUIRE(!pid1.empty());
+    ATF_REQUIRE(pid1 != pid2);
+    ATF_REQUIRE_EQ(pid1, pid3);
+
+    handle.cleanup();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(run__usage_unknown);
+ATF_TEST_CASE_BODY(run__usage_unknown)
+{
+    scheduler::scheduler_handle handle = scheduler::setup();
+
+    config::tree limited_config = engine::empty_config();
+    limited_config.set_string("cpu_time_limit", "60");
+
+    ATF_REQUIRE(!run_has_usage(this, handle, engine::empty_config()));
+    ATF_REQUIRE(run_has_usage(this, handle, limited_config));
+
+    handle.cleanup();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(run__crash_restarts_worker);
+ATF_TEST_CASE_BODY(run__crash_restarts_worker)
+{
+    scheduler::scheduler_handle handle = scheduler::setup();
+    const model::test_result passed(model::test_result_passed);
+
+    const std::string pid1 = run_one(this, handle, "pid", passed);
+    (void)run_one(this, handle, "crash",
+                  model::test_result(model::test_result_broken,
+                                     "Worker died while running the test "
+                                     "case"));
+    const std::string pid2 = run_one(this, handle, "pid", passed);
+    ATF_REQUIRE(pid1 != pid2);
+
+    handle.cleanup();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(run__timeout_restarts_worker);
+ATF_TEST_CASE_BODY(run__timeout_restarts_worker)
+{
+    scheduler::scheduler_handle handle = scheduler::setup();
+    const model::test_result passed(model::test_result_passed);
+
+    const std::string pid1 = run_one(this, handle, "pid", passed);
+    (void)run_one(this, handle, "hang",
+                  model::test_result(model::test_result_broken,
+                                     "Test case body timed out"));
+    const std::string pid2 = run_one(this, handle, "pid", passed);
+    ATF_REQUIRE(pid1 != pid2);
+
+    handle.cleanup();
+}
+
+
+ATF_INIT_TEST_CASES(tcs)
+{
+    scheduler::register_interface(
+        "worker", std::shared_ptr< scheduler::interface >(
+            new engine::worker_interface()));
+
+    ATF_ADD_TEST_CASE(tcs, list);
+
+    ATF_ADD_TEST_CASE(tcs, run__pass);
+    ATF_ADD_TEST_CASE(tcs, run__fail);
+    ATF_ADD_TEST_CASE(tcs, run__reuse_worker);
+    ATF_ADD_TEST_CASE(tcs, run__isolated);
+    ATF_ADD_TEST_CASE(tcs, run__limits_bypass_worker);
+    ATF_ADD_TEST_CASE(tcs, run__usage_unknown);
+    ATF_ADD_TEST_CASE(tcs, run__crash_restarts_worker);
+    ATF_ADD_TEST_CASE(tcs, run__timeout_restarts_worker);
+}
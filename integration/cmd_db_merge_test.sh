@@ -0,0 +1,105 @@
+# Copyright 2026 The Kyua Authors.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met:
+#
+# * Redistributions of source code must retain the above copyright
+#   notice, this list of conditions and the following disclaimer.
+# * Redistributions in binary form must reproduce the above copyright
+#   notice, this list of conditions and the following disclaimer in the
+#   documentation and/or other materials provided with the distribution.
+# * Neither the name of Google Inc. nor the names of its contributors
+#   may be used to endorse or promote products derived from this software
+#   without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Creates a test suite with a few trivial test programs.
+create_test_suite() {
+    echo 'syntax(2)' >Kyuafile
+    echo 'test_suite("integration")' >>Kyuafile
+    for name in first second third fourth; do
+        echo "plain_test_program{name=\"${name}\"}" >>Kyuafile
+        echo '#! /bin/sh' >"${name}"
+        chmod +x "${name}"
+    done
+}
+
+
+utils_test_case shards
+shards_body() {
+    create_test_suite
+
+    for shard in 1 2; do
+        atf_check -s exit:0 -o ignore -e empty \
+            kyua test -r "shard${shard}.db" --shard="${shard}/2"
+    done
+
+    atf_check -s exit:0 -o match:"Results saved to merged.db" -e empty \
+        kyua db-merge -r merged.db shard1.db shard2.db
+
+    atf_check -s exit:0 -o save:stdout -e empty \
+        kyua report -r merged.db --results-filter=passed
+    cat >expout <<EOF2
+first:main
+fourth:main
+second:main
+third:main
+EOF2
+    sed -n 's,  ->.*,,p' stdout | sort >all
+    atf_check -s exit:0 -o file:expout -e empty cat all
+}
+
+
+utils_test_case duplicate_programs
+duplicate_programs_body() {
+    create_test_suite
+
+    atf_check -s exit:0 -o ignore -e empty kyua test -r a.db
+    atf_check -s exit:0 -o ignore -e empty kyua test -r b.db
+
+    atf_check -s exit:0 -o ignore -e empty \
+        kyua db-merge -r merged.db a.db b.db
+    atf_check -s exit:0 -o inline:"COUNT(*)\n4\n" -e empty \
+        kyua db-exec -r merged.db "SELECT COUNT(*) FROM test_programs"
+    atf_check -s exit:0 -o inline:"COUNT(*)\n8\n" -e empty \
+        kyua db-exec -r merged.db "SELECT COUNT(*) FROM test_cases"
+}
+
+
+utils_test_case no_args
+no_args_body() {
+    atf_check -s exit:3 -o empty -e match:"Not enough arguments" kyua db-merge
+}
+
+
+utils_test_case missing_source
+missing_source_body() {
+    create_test_suite
+
+    atf_check -s exit:0 -o ignore -e empty kyua test -r a.db
+
+    atf_check -s exit:1 -o empty -e match:"Merge failed.*no-such" \
+        kyua db-merge -r merged.db a.db no-such.db
+    test ! -f merged.db || atf_fail "Partial results file left behind"
+}
+
+
+atf_init_test_cases() {
+    atf_add_test_case shards
+    atf_add_test_case duplicate_programs
+    atf_add_test_case no_args
+    atf_add_test_case missing_source
+}
@@ -539,6 +539,36 @@ EOF
 }
 
 
+utils_test_case list_cache
+list_cache_body() {
+    cat >Kyuafile <<EOF
+syntax(2)
+test_suite("integration")
+atf_test_program{name="program"}
+EOF
+    cat >program <<EOF
+#! /bin/sh
+echo run >>"$(pwd)/list.log"
+echo 'Content-Type: application/X-atf-tp; version="1"'
+echo
+echo 'ident: first'
+EOF
+    chmod +x program
+
+    atf_check -s exit:0 -o inline:"program:first\n" -e empty kyua list
+    atf_check -s exit:0 -o inline:"program:first\n" -e empty kyua list
+    atf_check -s exit:0 -o inline:"1\n" -e empty grep -c run list.log
+
+    echo '# Modified' >>program
+    atf_check -s exit:0 -o inline:"program:first\n" -e empty kyua list
+    atf_check -s exit:0 -o inline:"2\n" -e empty grep -c run list.log
+
+    atf_check -s exit:0 -o ignore -e empty kyua clear-cache
+    atf_check -s exit:0 -o inline:"program:first\n" -e empty kyua list
+    atf_check -s exit:0 -o inline:"3\n" -e empty grep -c run list.log
+}
+
+
 utils_test_case missing_test_program
 missing_test_program_body() {
     cat >Kyuafile <<EOF
@@ -596,5 +626,6 @@ atf_init_test_cases() {
 
     atf_add_test_case bogus_kyuafile
     atf_add_test_case bogus_test_program
+    atf_add_test_case list_cache
     atf_add_test_case missing_test_program
 }
@@ -96,15 +96,19 @@ CONTENTS STRIPPED BY TEST
 
 allowed_architectures is empty
 allowed_platforms is empty
+cpu_time_limit = 0
 description is empty
 has_cleanup = false
 is_exclusive = false
+memory_limit = 0
 required_configs is empty
 required_disk_space = 0
 required_files is empty
 required_memory = 0
 required_programs is empty
+required_resources is empty
 required_user is empty
+retries = 0
 timeout = 300
 
 Timing information
@@ -114,6 +118,19 @@ Start time: YYYY-MM-DDTHH:MM:SS.ssssssZ
 End time:   YYYY-MM-DDTHH:MM:SS.ssssssZ
 Duration:   S.UUUs
 
+Resource usage
+--------------
+
+block_inputs = N
+block_outputs = N
+involuntary_switches = N
+major_faults = N
+max_rss = N
+minor_faults = N
+system_time = S.UUUs
+user_time = S.UUUs
+voluntary_switches = N
+
 Original stderr
 ---------------
 
@@ -134,15 +151,19 @@ Test case metadata
 
 allowed_architectures is empty
 allowed_platforms is empty
+cpu_time_limit = 0
 description is empty
 has_cleanup = false
 is_exclusive = false
+memory_limit = 0
 required_configs is empty
 required_disk_space = 0
 required_files is empty
 required_memory = 0
 required_programs is empty
+required_resources is empty
 required_user is empty
+retries = 0
 timeout = 300
 
 Timing information
@@ -152,6 +173,19 @@ Start time: YYYY-MM-DDTHH:MM:SS.ssssssZ
 End time:   YYYY-MM-DDTHH:MM:SS.ssssssZ
 Duration:   S.UUUs
 
+Resource usage
+--------------
+
+block_inputs = N
+block_outputs = N
+involuntary_switches = N
+major_faults = N
+max_rss = N
+minor_faults = N
+system_time = S.UUUs
+user_time = S.UUUs
+voluntary_switches = N
+
 Original stderr
 ---------------
 
@@ -210,15 +244,19 @@ CONTENTS STRIPPED BY TEST
 
 allowed_architectures is empty
 allowed_platforms is empty
+cpu_time_limit = 0
 description is empty
 has_cleanup = false
 is_exclusive = false
+memory_limit = 0
 required_configs is empty
 required_disk_space = 0
 required_files is empty
 required_memory = 0
 required_programs is empty
+required_resources is empty
 required_user is empty
+retries = 0
 timeout = 300
 
 Timing information
@@ -228,6 +266,19 @@ Start time: YYYY-MM-DDTHH:MM:SS.ssssssZ
 End time:   YYYY-MM-DDTHH:MM:SS.ssssssZ
 Duration:   S.UUUs
 
+Resource usage
+--------------
+
+block_inputs = N
+block_outputs = N
+involuntary_switches = N
+major_faults = N
+max_rss = N
+minor_faults = N
+system_time = S.UUUs
+user_time = S.UUUs
+voluntary_switches = N
+
 Original stderr
 ---------------
 
@@ -248,15 +299,19 @@ Test case metadata
 
 allowed_architectures is empty
 allowed_platforms is empty
+cpu_time_limit = 0
 description is empty
 has_cleanup = false
 is_exclusive = false
+memory_limit = 0
 required_configs is empty
 required_disk_space = 0
 required_files is empty
 required_memory = 0
 required_programs is empty
+required_resources is empty
 required_user is empty
+retries = 0
 timeout = 300
 
 Timing information
@@ -266,6 +321,19 @@ Start time: YYYY-MM-DDTHH:MM:SS.ssssssZ
 End time:   YYYY-MM-DDTHH:MM:SS.ssssssZ
 Duration:   S.UUUs
 
+Resource usage
+--------------
+
+block_inputs = N
+block_outputs = N
+involuntary_switches = N
+major_faults = N
+max_rss = N
+minor_faults = N
+system_time = S.UUUs
+user_time = S.UUUs
+voluntary_switches = N
+
 Original stderr
 ---------------
 
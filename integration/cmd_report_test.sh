@@ -250,17 +250,32 @@ Duration:   S.UUUs
 Metadata:
     allowed_architectures is empty
     allowed_platforms is empty
+    cpu_time_limit = 0
     description is empty
     has_cleanup = false
     is_exclusive = false
+    memory_limit = 0
     required_configs is empty
     required_disk_space = 0
     required_files is empty
     required_memory = 0
     required_programs is empty
+    required_resources is empty
     required_user is empty
+    retries = 0
     timeout = 300
 
+Resource usage:
+    block_inputs = N
+    block_outputs = N
+    involuntary_switches = N
+    major_faults = N
+    max_rss = N
+    minor_faults = N
+    system_time = S.UUUs
+    user_time = S.UUUs
+    voluntary_switches = N
+
 Standard output:
 This is the stdout of skip
 
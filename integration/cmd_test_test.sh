@@ -680,6 +680,323 @@ EOF
 }
 
 
+utils_test_case history__longest_first
+history__longest_first_body() {
+    cat >Kyuafile <<EOF
+syntax(2)
+test_suite("integration")
+plain_test_program{name="fast"}
+plain_test_program{name="slow"}
+EOF
+    for name in fast slow; do
+        echo '#! /bin/sh' >"${name}"
+        chmod +x "${name}"
+    done
+    echo 'sleep 1' >>slow
+
+    atf_check -s exit:0 -o save:stdout -e empty \
+        kyua -v parallelism=1 test -r first.db
+    cat >expout <<EOF
+fast:main
+slow:main
+EOF
+    atf_check -s exit:0 -o file:expout -e empty sed -n 's,  ->.*,,p' stdout
+
+    atf_check -s exit:0 -o save:stdout -e empty \
+        kyua -v parallelism=1 test -r second.db --history=first.db
+    cat >expout <<EOF
+slow:main
+fast:main
+EOF
+    atf_check -s exit:0 -o file:expout -e empty sed -n 's,  ->.*,,p' stdout
+}
+
+
+utils_test_case history__missing
+history__missing_body() {
+    cat >Kyuafile <<EOF
+syntax(2)
+test_suite("integration")
+plain_test_program{name="fast"}
+EOF
+    echo '#! /bin/sh' >fast
+    chmod +x fast
+
+    atf_check -s exit:2 -o empty -e match:"no-such.db" \
+        kyua test --history=no-such.db
+}
+
+
+utils_test_case shard__disjoint
+shard__disjoint_body() {
+    echo 'syntax(2)' >Kyuafile
+    echo 'test_suite("integration")' >>Kyuafile
+    for name in first second third fourth fifth sixth; do
+        echo "plain_test_program{name=\"${name}\"}" >>Kyuafile
+        echo '#! /bin/sh' >"${name}"
+        chmod +x "${name}"
+    done
+
+    for shard in 1 2 3; do
+        atf_check -s exit:0 -o save:stdout -e empty \
+            kyua test -r "shard${shard}.db" --shard="${shard}/3"
+        sed -n 's,  ->.*,,p' stdout >>all
+    done
+    cat >expout <<EOF
+fifth:main
+first:main
+fourth:main
+second:main
+sixth:main
+third:main
+EOF
+    atf_check -s exit:0 -o file:expout -e empty sort all
+}
+
+
+utils_test_case shard__balanced
+shard__balanced_body() {
+    cat >Kyuafile <<EOF
+syntax(2)
+test_suite("integration")
+plain_test_program{name="fast1"}
+plain_test_program{name="fast2"}
+plain_test_program{name="slow1"}
+plain_test_program{name="slow2"}
+EOF
+    for name in fast1 fast2 slow1 slow2; do
+        echo '#! /bin/sh' >"${name}"
+        chmod +x "${name}"
+    done
+    echo 'sleep 1' >>slow1
+    echo 'sleep 1' >>slow2
+
+    atf_check -s exit:0 -o ignore -e empty kyua test -r history.db
+
+    for shard in 1 2; do
+        atf_check -s exit:0 -o save:stdout -e empty \
+            kyua test -r "shard${shard}.db" --history=history.db \
+            --shard="${shard}/2"
+        atf_check -s exit:0 -o inline:"1\n" -e empty grep -c '^slow' stdout
+    done
+}
+
+
+utils_test_case shard__invalid
+shard__invalid_body() {
+    echo 'syntax(2)' >Kyuafile
+
+    for value in 1 0/3 4/3 a/3 1/b; do
+        atf_check -s exit:3 -o empty -e match:"Invalid.*--shard '${value}'" \
+            kyua test --shard="${value}"
+    done
+}
+
+
+utils_test_case cache__reuse_passed
+cache__reuse_passed_body() {
+    cat >Kyuafile <<EOF
+syntax(2)
+test_suite("integration")
+plain_test_program{name="pass"}
+plain_test_program{name="fail"}
+EOF
+    cat >pass <<EOF
+#! /bin/sh
+echo run >>"$(pwd)/pass.log"
+echo "The pass output"
+EOF
+    cat >fail <<EOF
+#! /bin/sh
+echo run >>"$(pwd)/fail.log"
+exit 1
+EOF
+    chmod +x pass fail
+
+    atf_check -s exit:1 -o save:stdout -e empty kyua test --cache
+    atf_check -s exit:0 -o ignore -e empty grep '^pass:main  ->  passed  ' \
+        stdout
+
+    atf_check -s exit:1 -o save:stdout -e empty kyua test --cache \
+        -r second.db
+    atf_check -s exit:0 -o ignore -e empty \
+        grep '^pass:main  ->  passed: Cached result of a previous run' stdout
+    atf_check -s exit:0 -o ignore -e empty grep '^fail:main  ->  failed' \
+        stdout
+    atf_check -s exit:0 -o inline:"1\n" -e empty grep -c run pass.log
+    atf_check -s exit:0 -o inline:"2\n" -e empty grep -c run fail.log
+
+    atf_check -s exit:0 -o match:"The pass output" -e empty \
+        kyua report -r second.db --verbose --results-filter=passed
+
+    atf_check -s exit:1 -o ignore -e empty kyua test
+    atf_check -s exit:0 -o inline:"2\n" -e empty grep -c run pass.log
+}
+
+
+utils_test_case cache__binary_changed
+cache__binary_changed_body() {
+    cat >Kyuafile <<EOF
+syntax(2)
+test_suite("integration")
+plain_test_program{name="pass"}
+EOF
+    cat >pass <<EOF
+#! /bin/sh
+echo run >>"$(pwd)/pass.log"
+EOF
+    chmod +x pass
+
+    atf_check -s exit:0 -o ignore -e empty kyua test --cache
+    echo '# Modified' >>pass
+    atf_check -s exit:0 -o save:stdout -e empty kyua test --cache
+    atf_check -s exit:1 -o empty -e empty grep Cached stdout
+    atf_check -s exit:0 -o inline:"2\n" -e empty grep -c run pass.log
+}
+
+
+utils_test_case cache__clear
+cache__clear_body() {
+    cat >Kyuafile <<EOF
+syntax(2)
+test_suite("integration")
+plain_test_program{name="pass"}
+EOF
+    cat >pass <<EOF
+#! /bin/sh
+echo run >>"$(pwd)/pass.log"
+EOF
+    chmod +x pass
+
+    cat >expout <<EOF
+Removed 0 cached results
+Removed 0 cached test cases lists
+EOF
+    atf_check -s exit:0 -o file:expout -e empty kyua clear-cache
+
+    atf_check -s exit:0 -o ignore -e empty kyua test --cache
+    cat >expout <<EOF
+Removed 1 cached results
+Removed 1 cached test cases lists
+EOF
+    atf_check -s exit:0 -o file:expout -e empty kyua clear-cache
+    atf_check -s exit:0 -o save:stdout -e empty kyua test --cache
+    atf_check -s exit:1 -o empty -e empty grep Cached stdout
+    atf_check -s exit:0 -o inline:"2\n" -e empty grep -c run pass.log
+}
+
+
+utils_test_case retries__flag
+retries__flag_body() {
+    cat >Kyuafile <<EOF
+syntax(2)
+test_suite("integration")
+plain_test_program{name="flaky"}
+plain_test_program{name="fail"}
+EOF
+    cat >flaky <<EOF
+#! /bin/sh
+echo run >>"$(pwd)/flaky.log"
+echo "Run \$(grep -c run "$(pwd)/flaky.log")"
+[ \$(grep -c run "$(pwd)/flaky.log") -ge 3 ]
+EOF
+    cat >fail <<EOF
+#! /bin/sh
+echo run >>"$(pwd)/fail.log"
+exit 1
+EOF
+    chmod +x flaky fail
+
+    atf_check -s exit:1 -o save:stdout -e empty kyua test --retries=2
+    atf_check -s exit:0 -o ignore -e empty \
+        grep '^flaky:main  ->  passed  .*(passed on retry 2)' stdout
+    atf_check -s exit:0 -o ignore -e empty \
+        grep '^fail:main  ->  failed.*(still failed on retry 2)' stdout
+    atf_check -s exit:0 -o ignore -e empty \
+        grep '^1/2 passed (1 failed)' stdout
+    atf_check -s exit:0 -o ignore -e empty \
+        grep '^1 passed only after being retried' stdout
+    atf_check -s exit:0 -o inline:"3\n" -e empty grep -c run flaky.log
+    atf_check -s exit:0 -o inline:"3\n" -e empty grep -c run fail.log
+
+    atf_check -s exit:1 -o save:stdout -e empty kyua report --verbose
+    atf_check -s exit:0 -o ignore -e empty \
+        grep '^Attempts:   3 (passed on retry 2)' stdout
+    atf_check -s exit:0 -o ignore -e empty grep '^Run 3' stdout
+}
+
+
+utils_test_case retries__metadata
+retries__metadata_body() {
+    cat >Kyuafile <<EOF
+syntax(2)
+test_suite("integration")
+plain_test_program{name="fail", retries=1}
+EOF
+    cat >fail <<EOF
+#! /bin/sh
+echo run >>"$(pwd)/fail.log"
+exit 1
+EOF
+    chmod +x fail
+
+    atf_check -s exit:1 -o ignore -e empty kyua test
+    atf_check -s exit:0 -o inline:"2\n" -e empty grep -c run fail.log
+
+    atf_check -s exit:1 -o ignore -e empty kyua test --retries=3
+    atf_check -s exit:0 -o inline:"6\n" -e empty grep -c run fail.log
+}
+
+
+utils_test_case retries__invalid
+retries__invalid_body() {
+    echo 'syntax(2)' >Kyuafile
+
+    atf_check -s exit:3 -o empty \
+        -e match:"Invalid value passed to --retries '-1'" \
+        kyua test --retries=-1
+    atf_check -s exit:3 -o empty \
+        -e match:"Invalid argument 'a' for option --retries" \
+        kyua test --retries=a
+}
+
+
+utils_test_case trace__ok
+trace__ok_body() {
+    cat >Kyuafile <<EOF
+syntax(2)
+test_suite("integration")
+plain_test_program{name="pass"}
+EOF
+    cat >pass <<EOF
+#! /bin/sh
+exit 0
+EOF
+    chmod +x pass
+
+    atf_check -s exit:0 -o ignore -e empty kyua test --trace=trace.json
+    for name in list_tests spawn_test 'test body' put_result in_flight; do
+        atf_check -s exit:0 -o ignore -e empty \
+            grep "\"name\":\"${name}\"" trace.json
+    done
+    atf_check -s exit:0 -o ignore -e empty \
+        grep '"args":{"name":"slot 1"}' trace.json
+    atf_check -s exit:0 -o ignore -e empty \
+        grep '"args":{"detail":"pass:main"}' trace.json
+    atf_check -s exit:0 -o inline:"]\n" -e empty tail -n 1 trace.json
+}
+
+
+utils_test_case trace__fail
+trace__fail_body() {
+    echo 'syntax(2)' >Kyuafile
+
+    atf_check -s exit:2 -o empty \
+        -e match:"Failed to create trace file missing/trace.json" \
+        kyua test --trace=missing/trace.json
+}
+
+
 utils_test_case build_root_flag
 build_root_flag_body() {
     utils_install_stable_test_wrapper
@@ -854,6 +1171,64 @@ EOF
 }
 
 
+utils_test_case exclusive_tests__interleaved
+exclusive_tests__interleaved_body() {
+    cat >Kyuafile <<EOF
+syntax(2)
+test_suite("integration")
+EOF
+    for i in $(seq 8); do
+        echo 'plain_test_program{name="race", is_exclusive=true}' >>Kyuafile
+        echo 'plain_test_program{name="check"}' >>Kyuafile
+    done
+    utils_cp_helper race .
+
+    # Fails if any exclusive test runs at the same time as this one.
+    cat >check <<EOF
+#! /bin/sh
+test ! -f "\${TEST_ENV_shared_file}" || exit 1
+sleep 1
+test ! -f "\${TEST_ENV_shared_file}" || exit 1
+EOF
+    chmod +x check
+
+    atf_check \
+        -s exit:0 \
+        -o match:"16/16 passed" \
+        -o match:"Slot time lost to exclusive tests" \
+        kyua \
+        -v parallelism=4 \
+        -v test_suites.integration.shared_file="$(pwd)/shared_file" \
+        test
+}
+
+
+utils_test_case required_resources
+required_resources_body() {
+    cat >Kyuafile <<EOF
+syntax(2)
+test_suite("integration")
+EOF
+    for i in $(seq 50); do
+        echo 'plain_test_program{name="race",' \
+            'required_resources="port:8080 shared-file"}' >>Kyuafile
+        echo 'plain_test_program{name="check",' \
+            'required_resources="port:8080=50"}' >>Kyuafile
+    done
+    utils_cp_helper race .
+    echo '#! /bin/sh' >check
+    chmod +x check
+
+    atf_check \
+        -s exit:0 \
+        -o match:"100/100 passed" \
+        kyua \
+        -v parallelism=20 \
+        -v test_suites.integration.shared_file="$(pwd)/shared_file" \
+        test
+}
+
+
 utils_test_case no_test_program_match
 no_test_program_match_body() {
     utils_install_stable_test_wrapper
@@ -1048,6 +1423,24 @@ atf_init_test_cases() {
     atf_add_test_case results_file__fail
     atf_add_test_case results_file__reuse
 
+    atf_add_test_case history__longest_first
+    atf_add_test_case history__missing
+
+    atf_add_test_case shard__disjoint
+    atf_add_test_case shard__balanced
+    atf_add_test_case shard__invalid
+
+    atf_add_test_case cache__reuse_passed
+    atf_add_test_case cache__binary_changed
+    atf_add_test_case cache__clear
+
+    atf_add_test_case retries__flag
+    atf_add_test_case retries__metadata
+    atf_add_test_case retries__invalid
+
+    atf_add_test_case trace__ok
+    atf_add_test_case trace__fail
+
     atf_add_test_case build_root_flag
 
     atf_add_test_case kyuafile_flag__no_args
@@ -1056,6 +1449,8 @@ atf_init_test_cases() {
     atf_add_test_case interrupt
 
     atf_add_test_case exclusive_tests
+    atf_add_test_case exclusive_tests__interleaved
+    atf_add_test_case required_resources
 
     atf_add_test_case no_test_program_match
     atf_add_test_case no_test_case_match
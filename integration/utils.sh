@@ -32,7 +32,8 @@
 # This is to make the reports deterministic and thus easily testable.  The
 # time deltas are replaced by the fixed string S.UUU and the timestamps are
 # replaced by the fixed strings YYYYMMDD.HHMMSS.ssssss and
-# YYYY-MM-DDTHH:MM:SS.ssssssZ depending on their original format.
+# YYYY-MM-DDTHH:MM:SS.ssssssZ depending on their original format.  The
+# resource usage counters are replaced by the fixed string N.
 #
 # This variable should be used as shown here:
 #
@@ -44,6 +45,7 @@
 utils_strip_times='sed -E \
     -e "s,( |\[|\")[0-9][0-9]*.[0-9][0-9][0-9](s]|s|\"),\1S.UUU\2,g" \
     -e "s,[0-9]{8}-[0-9]{6}-[0-9]{6},YYYYMMDD-HHMMSS-ssssss,g" \
+    -e "s,(block_inputs|block_outputs|involuntary_switches|major_faults|max_rss|minor_faults|voluntary_switches) = .*,\1 = N," \
     -e "s,[0-9]{4}-[0-9]{2}-[0-9]{2}T[0-9]{2}:[0-9]{2}:[0-9]{2}\.[0-9]{6}Z,YYYY-MM-DDTHH:MM:SS.ssssssZ,g"'
 # CHECK_STYLE_ENABLE
 
@@ -51,11 +53,13 @@ utils_strip_times='sed -E \
 # Same as utils_strip_times but avoids stripping timestamp-based report IDs.
 #
 # This is to make the reports deterministic and thus easily testable.  The
-# time deltas are replaced by the fixed string S.UUU and the timestamps are
-# replaced by the fixed string YYYY-MM-DDTHH:MM:SS.ssssssZ.
+# time deltas are replaced by the fixed string S.UUU, the timestamps are
+# replaced by the fixed string YYYY-MM-DDTHH:MM:SS.ssssssZ and the resource
+# usage counters are replaced by the fixed string N.
 # CHECK_STYLE_DISABLE
 utils_strip_times_but_not_ids='sed -E \
     -e "s,( |\[|\")[0-9][0-9]*.[0-9][0-9][0-9](s]|s|\"),\1S.UUU\2,g" \
+    -e "s,(block_inputs|block_outputs|involuntary_switches|major_faults|max_rss|minor_faults|voluntary_switches) = .*,\1 = N," \
     -e "s,[0-9]{4}-[0-9]{2}-[0-9]{2}T[0-9]{2}:[0-9]{2}:[0-9]{2}\.[0-9]{6}Z,YYYY-MM-DDTHH:MM:SS.ssssssZ,g"'
 # CHECK_STYLE_ENABLE
 
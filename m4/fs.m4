@@ -118,7 +118,11 @@ dnl
 dnl Performs all checks needed by the utils/fs library.
 AC_DEFUN([KYUA_FS_MODULE], [
     AC_CHECK_HEADERS([sys/mount.h sys/statvfs.h sys/vfs.h])
+    AC_CHECK_FUNCS([fdopendir openat unlinkat])
     AC_CHECK_FUNCS([statfs statvfs])
+    AC_CHECK_MEMBERS([struct dirent.d_type], [], [], [[#include <dirent.h>]])
+    AC_CHECK_MEMBERS([struct stat.st_mtim, struct stat.st_mtimespec], [], [],
+                     [[#include <sys/stat.h>]])
     KYUA_FS_GETCWD_DYN
     KYUA_FS_LCHMOD
     KYUA_FS_UNMOUNT
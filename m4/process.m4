@@ -0,0 +1,61 @@
+dnl Copyright 2026 The Kyua Authors.
+dnl All rights reserved.
+dnl
+dnl Redistribution and use in source and binary forms, with or without
+dnl modification, are permitted provided that the following conditions are
+dnl met:
+dnl
+dnl * Redistributions of source code must retain the above copyright
+dnl   notice, this list of conditions and the following disclaimer.
+dnl * Redistributions in binary form must reproduce the above copyright
+dnl   notice, this list of conditions and the following disclaimer in the
+dnl   documentation and/or other materials provided with the distribution.
+dnl * Neither the name of Google Inc. nor the names of its contributors
+dnl   may be used to endorse or promote products derived from this software
+dnl   without specific prior written permission.
+dnl
+dnl THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+dnl "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+dnl LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+dnl A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+dnl OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+dnl SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+dnl LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+dnl DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+dnl THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+dnl (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+dnl OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+dnl \file m4/process.m4
+dnl
+dnl Macros to configure the utils::process module.
+
+
+dnl Entry point to detect all features needed by utils::process.
+dnl
+dnl This looks for the primitives needed to wait for subprocesses through
+dnl file descriptors: epoll(7) and the pidfd_open(2) system call.  If any is
+dnl missing, the executor falls back to wait(2) and interval timers.
+dnl
+dnl This also looks for posix_spawn(3) and for the ability to change the work
+dnl directory of the spawned process, which are needed to start subprocesses
+dnl without forking.  If any is missing, subprocesses are always forked.
+dnl
+dnl This also looks for wait4(2) to collect the resource usage of the
+dnl subprocesses as they are reaped.  If missing, no usage is reported.
+dnl
+dnl Lastly, this looks for the sched_getaffinity(2) and sched_setaffinity(2)
+dnl system calls to pin subprocesses to CPUs.  If missing, no pinning is
+dnl done.
+AC_DEFUN([KYUA_PROCESS_MODULE], [
+    AC_CHECK_HEADERS([spawn.h sys/epoll.h sys/syscall.h])
+    AC_CHECK_FUNCS([epoll_create1])
+    AC_CHECK_FUNCS([posix_spawn posix_spawn_file_actions_addchdir_np])
+    AC_CHECK_FUNCS([wait4])
+    AC_CHECK_FUNCS([sched_getaffinity sched_setaffinity])
+    AC_CHECK_DECLS([SYS_pidfd_open], [], [], [
+#if defined(HAVE_SYS_SYSCALL_H)
+#   include <sys/syscall.h>
+#endif
+])
+])
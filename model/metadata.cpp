@@ -28,6 +28,7 @@
 
 #include "model/metadata.hpp"
 
+#include <cstddef>
 #include <memory>
 
 #include "model/exceptions.hpp"
@@ -196,6 +197,35 @@ class user_node : public config::string_node {
 };
 
 
+/// A leaf node that holds the number of times to retry a failed test.
+///
+/// This node is just an integer, but it rejects negative values.
+class retries_node : public config::int_node {
+    /// Copies the node.
+    ///
+    /// \return A dynamically-allocated node.
+    virtual base_node*
+    deep_copy(void) const
+    {
+        std::auto_ptr< retries_node > new_node(new retries_node());
+        new_node->_value = _value;
+        return new_node.release();
+    }
+
+    /// Checks a given number of retries for validity.
+    ///
+    /// \param retries The value to validate.
+    ///
+    /// \throw config::value_error If the value is not valid.
+    void
+    validate(const value_type& retries) const
+    {
+        if (retries < 0)
+            throw config::value_error("Must be a non-negative integer");
+    }
+};
+
+
 /// A leaf node that holds a set of paths.
 ///
 /// This node type is used to represent the value of the required files and
@@ -249,6 +279,43 @@ class paths_set_node : public config::base_set_node< fs::path > {
 };
 
 
+/// A leaf node that holds a set of resource tokens.
+///
+/// Each token is a resource name optionally followed by an equal sign and the
+/// number of tests that may hold the resource at once.  Resource names can
+/// contain any character other than whitespace and the equal sign.
+class resources_set_node : public config::strings_set_node {
+    /// Copies the node.
+    ///
+    /// \return A dynamically-allocated node.
+    virtual base_node*
+    deep_copy(void) const
+    {
+        std::auto_ptr< resources_set_node > new_node(new resources_set_node());
+        new_node->_value = _value;
+        return new_node.release();
+    }
+
+    /// Checks a collection of resource tokens for validity.
+    ///
+    /// \param tokens The value to validate.
+    ///
+    /// \throw config::value_error If the value is not valid.
+    void
+    validate(const value_type& tokens) const
+    {
+        for (value_type::const_iterator iter = tokens.begin();
+             iter != tokens.end(); ++iter) {
+            try {
+                (void)model::parse_resource(*iter);
+            } catch (const model::error& e) {
+                throw config::value_error(e.what());
+            }
+        }
+    }
+};
+
+
 /// Initializes a tree to hold test case requirements.
 ///
 /// \param [in,out] tree The tree to initialize.
@@ -257,16 +324,20 @@ init_tree(config::tree& tree)
 {
     tree.define< config::strings_set_node >("allowed_architectures");
     tree.define< config::strings_set_node >("allowed_platforms");
+    tree.define< delta_node >("cpu_time_limit");
     tree.define_dynamic("custom");
     tree.define< config::string_node >("description");
     tree.define< config::bool_node >("has_cleanup");
     tree.define< config::bool_node >("is_exclusive");
+    tree.define< bytes_node >("memory_limit");
     tree.define< config::strings_set_node >("required_configs");
     tree.define< bytes_node >("required_disk_space");
     tree.define< paths_set_node >("required_files");
     tree.define< bytes_node >("required_memory");
     tree.define< paths_set_node >("required_programs");
+    tree.define< resources_set_node >("required_resources");
     tree.define< user_node >("required_user");
+    tree.define< retries_node >("retries");
     tree.define< delta_node >("timeout");
 }
 
@@ -281,16 +352,21 @@ set_defaults(config::tree& tree)
                                          model::strings_set());
     tree.set< config::strings_set_node >("allowed_platforms",
                                          model::strings_set());
+    tree.set< delta_node >("cpu_time_limit", datetime::delta(0, 0));
     tree.set< config::string_node >("description", "");
     tree.set< config::bool_node >("has_cleanup", false);
     tree.set< config::bool_node >("is_exclusive", false);
+    tree.set< bytes_node >("memory_limit", units::bytes(0));
     tree.set< config::strings_set_node >("required_configs",
                                          model::strings_set());
     tree.set< bytes_node >("required_disk_space", units::bytes(0));
     tree.set< paths_set_node >("required_files", model::paths_set());
     tree.set< bytes_node >("required_memory", units::bytes(0));
     tree.set< paths_set_node >("required_programs", model::paths_set());
+    tree.set< resources_set_node >("required_resources",
+                                   model::strings_set());
     tree.set< user_node >("required_user", "");
+    tree.set< retries_node >("retries", 0);
     // TODO(jmmv): We shouldn't be setting a default timeout like this.  See
     // Issue 5 for details.
     tree.set< delta_node >("timeout", datetime::delta(300, 0));
@@ -452,6 +528,20 @@ model::metadata::allowed_platforms(void) const
 }
 
 
+/// Returns the maximum CPU time that the test body can consume.
+///
+/// \return A time delta, or zero if the test does not limit its CPU time.
+const datetime::delta&
+model::metadata::cpu_time_limit(void) const
+{
+    if (_pimpl->props.is_set("cpu_time_limit")) {
+        return _pimpl->props.lookup< delta_node >("cpu_time_limit");
+    } else {
+        return get_defaults().lookup< delta_node >("cpu_time_limit");
+    }
+}
+
+
 /// Returns all the user-defined metadata properties.
 ///
 /// \return A key/value map of properties.
@@ -505,6 +595,20 @@ model::metadata::is_exclusive(void) const
 }
 
 
+/// Returns the maximum amount of memory that the test body can allocate.
+///
+/// \return Number of bytes, or 0 if the test does not limit its memory.
+const units::bytes&
+model::metadata::memory_limit(void) const
+{
+    if (_pimpl->props.is_set("memory_limit")) {
+        return _pimpl->props.lookup< bytes_node >("memory_limit");
+    } else {
+        return get_defaults().lookup< bytes_node >("memory_limit");
+    }
+}
+
+
 /// Returns the list of configuration variables needed by the test.
 ///
 /// \return Set of configuration variables.
@@ -577,6 +681,22 @@ model::metadata::required_programs(void) const
 }
 
 
+/// Returns the list of resources that the test needs exclusive access to.
+///
+/// \return Set of resource tokens; see parse_resource() for their syntax.
+const model::strings_set&
+model::metadata::required_resources(void) const
+{
+    if (_pimpl->props.is_set("required_resources")) {
+        return _pimpl->props.lookup< resources_set_node >(
+            "required_resources");
+    } else {
+        return get_defaults().lookup< resources_set_node >(
+            "required_resources");
+    }
+}
+
+
 /// Returns the user required by the test.
 ///
 /// \return One of unprivileged, root or empty.
@@ -591,6 +711,20 @@ model::metadata::required_user(void) const
 }
 
 
+/// Returns the number of times to retry the test if it fails.
+///
+/// \return A non-negative integer; zero if the test must not be retried.
+int
+model::metadata::retries(void) const
+{
+    if (_pimpl->props.is_set("retries")) {
+        return _pimpl->props.lookup< retries_node >("retries");
+    } else {
+        return get_defaults().lookup< retries_node >("retries");
+    }
+}
+
+
 /// Returns the timeout of the test.
 ///
 /// \return A time delta; should be compared to default_timeout to see if it has
@@ -668,6 +802,45 @@ model::operator<<(std::ostream& output, const metadata& object)
 }
 
 
+/// Splits a resource token into its name and its capacity.
+///
+/// A resource token has the form "name" or "name=count".  The count indicates
+/// how many tests may hold the resource at once and defaults to 1, which means
+/// that the test needs exclusive access to the resource.
+///
+/// \param token The resource token to parse.
+///
+/// \return The name of the resource and its capacity.
+///
+/// \throw model::error If the token is invalid.
+model::resource_token
+model::parse_resource(const std::string& token)
+{
+    const std::string::size_type pos = token.find('=');
+    const std::string name = token.substr(0, pos);
+    if (name.empty())
+        throw model::error(F("Invalid resource token '%s': missing name") %
+                           token);
+    if (pos == std::string::npos)
+        return resource_token(name, 1);
+
+    const std::string raw_count = token.substr(pos + 1);
+    std::size_t count;
+    try {
+        if (raw_count.find_first_not_of("0123456789") != std::string::npos)
+            throw text::value_error("Not a non-negative integer");
+        count = text::to_type< std::size_t >(raw_count);
+    } catch (const text::error& e) {
+        throw model::error(F("Invalid resource token '%s': bad count '%s'") %
+                           token % raw_count);
+    }
+    if (count == 0)
+        throw model::error(F("Invalid resource token '%s': count must be "
+                             "positive") % token);
+    return resource_token(name, count);
+}
+
+
 /// Internal implementation of the metadata_builder class.
 struct model::metadata_builder::impl : utils::noncopyable {
     /// Collection of requirements.
@@ -836,6 +1009,27 @@ model::metadata_builder::add_required_program(const fs::path& path)
 }
 
 
+/// Accumulates an additional required resource.
+///
+/// \param token The resource token; see parse_resource() for its syntax.
+///
+/// \return A reference to this builder.
+///
+/// \throw model::error If the value is invalid.
+model::metadata_builder&
+model::metadata_builder::add_required_resource(const std::string& token)
+{
+    if (!_pimpl->props.is_set("required_resources")) {
+        _pimpl->props.set< resources_set_node >(
+            "required_resources",
+            get_defaults().lookup< resources_set_node >("required_resources"));
+    }
+    lookup_rw< resources_set_node >(_pimpl->props,
+                                    "required_resources").insert(token);
+    return *this;
+}
+
+
 /// Sets the architectures allowed by the test.
 ///
 /// \param as Set of architectures.
@@ -867,6 +1061,21 @@ model::metadata_builder::set_allowed_platforms(const model::strings_set& ps)
 }
 
 
+/// Sets the maximum CPU time that the test body can consume.
+///
+/// \param limit The CPU time limit, or zero to not limit it.
+///
+/// \return A reference to this builder.
+///
+/// \throw model::error If the value is invalid.
+model::metadata_builder&
+model::metadata_builder::set_cpu_time_limit(const datetime::delta& limit)
+{
+    set< delta_node >(_pimpl->props, "cpu_time_limit", limit);
+    return *this;
+}
+
+
 /// Sets the user-defined properties.
 ///
 /// \param props The custom properties to set.
@@ -930,6 +1139,21 @@ model::metadata_builder::set_is_exclusive(const bool exclusive)
 }
 
 
+/// Sets the maximum amount of memory that the test body can allocate.
+///
+/// \param bytes Number of bytes, or zero to not limit the memory.
+///
+/// \return A reference to this builder.
+///
+/// \throw model::error If the value is invalid.
+model::metadata_builder&
+model::metadata_builder::set_memory_limit(const units::bytes& bytes)
+{
+    set< bytes_node >(_pimpl->props, "memory_limit", bytes);
+    return *this;
+}
+
+
 /// Sets the list of configuration variables needed by the test.
 ///
 /// \param vars Set of configuration variables.
@@ -1005,6 +1229,22 @@ model::metadata_builder::set_required_programs(const model::paths_set& progs)
 }
 
 
+/// Sets the resources required by the test.
+///
+/// \param tokens Set of resource tokens; see parse_resource() for their syntax.
+///
+/// \return A reference to this builder.
+///
+/// \throw model::error If the value is invalid.
+model::metadata_builder&
+model::metadata_builder::set_required_resources(
+    const model::strings_set& tokens)
+{
+    set< resources_set_node >(_pimpl->props, "required_resources", tokens);
+    return *this;
+}
+
+
 /// Sets the user required by the test.
 ///
 /// \param user One of unprivileged, root or empty.
@@ -1020,6 +1260,21 @@ model::metadata_builder::set_required_user(const std::string& user)
 }
 
 
+/// Sets the number of times to retry the test if it fails.
+///
+/// \param retries A non-negative integer.
+///
+/// \return A reference to this builder.
+///
+/// \throw model::error If the value is invalid.
+model::metadata_builder&
+model::metadata_builder::set_retries(const int retries)
+{
+    set< retries_node >(_pimpl->props, "retries", retries);
+    return *this;
+}
+
+
 /// Sets a metadata property by name from its textual representation.
 ///
 /// \param key The property to set.
@@ -34,9 +34,11 @@
 
 #include "model/metadata_fwd.hpp"
 
+#include <cstddef>
 #include <memory>
 #include <ostream>
 #include <string>
+#include <utility>
 
 #include "model/types.hpp"
 #include "utils/config/tree_fwd.hpp"
@@ -66,16 +68,20 @@ public:
 
     const strings_set& allowed_architectures(void) const;
     const strings_set& allowed_platforms(void) const;
+    const utils::datetime::delta& cpu_time_limit(void) const;
     model::properties_map custom(void) const;
     const std::string& description(void) const;
     bool has_cleanup(void) const;
     bool is_exclusive(void) const;
+    const utils::units::bytes& memory_limit(void) const;
     const strings_set& required_configs(void) const;
     const utils::units::bytes& required_disk_space(void) const;
     const paths_set& required_files(void) const;
     const utils::units::bytes& required_memory(void) const;
     const paths_set& required_programs(void) const;
+    const strings_set& required_resources(void) const;
     const std::string& required_user(void) const;
+    int retries(void) const;
     const utils::datetime::delta& timeout(void) const;
 
     model::properties_map to_properties(void) const;
@@ -88,6 +94,13 @@ public:
 std::ostream& operator<<(std::ostream&, const metadata&);
 
 
+/// A resource name and the number of tests that may hold it at once.
+typedef std::pair< std::string, std::size_t > resource_token;
+
+
+resource_token parse_resource(const std::string&);
+
+
 /// Builder for a metadata object.
 class metadata_builder : utils::noncopyable {
     struct impl;
@@ -106,19 +119,24 @@ public:
     metadata_builder& add_required_config(const std::string&);
     metadata_builder& add_required_file(const utils::fs::path&);
     metadata_builder& add_required_program(const utils::fs::path&);
+    metadata_builder& add_required_resource(const std::string&);
 
     metadata_builder& set_allowed_architectures(const strings_set&);
     metadata_builder& set_allowed_platforms(const strings_set&);
+    metadata_builder& set_cpu_time_limit(const utils::datetime::delta&);
     metadata_builder& set_custom(const model::properties_map&);
     metadata_builder& set_description(const std::string&);
     metadata_builder& set_has_cleanup(const bool);
     metadata_builder& set_is_exclusive(const bool);
+    metadata_builder& set_memory_limit(const utils::units::bytes&);
     metadata_builder& set_required_configs(const strings_set&);
     metadata_builder& set_required_disk_space(const utils::units::bytes&);
     metadata_builder& set_required_files(const paths_set&);
     metadata_builder& set_required_memory(const utils::units::bytes&);
     metadata_builder& set_required_programs(const paths_set&);
+    metadata_builder& set_required_resources(const strings_set&);
     metadata_builder& set_required_user(const std::string&);
+    metadata_builder& set_retries(const int);
     metadata_builder& set_string(const std::string&, const std::string&);
     metadata_builder& set_timeout(const utils::datetime::delta&);
 
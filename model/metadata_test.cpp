@@ -32,6 +32,7 @@
 
 #include <atf-c++.hpp>
 
+#include "model/exceptions.hpp"
 #include "model/types.hpp"
 #include "utils/datetime.hpp"
 #include "utils/format/containers.ipp"
@@ -50,16 +51,20 @@ ATF_TEST_CASE_BODY(defaults)
     ATF_REQUIRE(md.allowed_architectures().empty());
     ATF_REQUIRE(md.allowed_platforms().empty());
     ATF_REQUIRE(md.allowed_platforms().empty());
+    ATF_REQUIRE(datetime::delta() == md.cpu_time_limit());
     ATF_REQUIRE(md.custom().empty());
     ATF_REQUIRE(md.description().empty());
     ATF_REQUIRE(!md.has_cleanup());
     ATF_REQUIRE(!md.is_exclusive());
+    ATF_REQUIRE_EQ(units::bytes(0), md.memory_limit());
     ATF_REQUIRE(md.required_configs().empty());
     ATF_REQUIRE_EQ(units::bytes(0), md.required_disk_space());
     ATF_REQUIRE(md.required_files().empty());
     ATF_REQUIRE_EQ(units::bytes(0), md.required_memory());
     ATF_REQUIRE(md.required_programs().empty());
+    ATF_REQUIRE(md.required_resources().empty());
     ATF_REQUIRE(md.required_user().empty());
+    ATF_REQUIRE_EQ(0, md.retries());
     ATF_REQUIRE(datetime::delta(300, 0) == md.timeout());
 }
 
@@ -91,6 +96,10 @@ ATF_TEST_CASE_BODY(add)
     programs.insert(fs::path("1-program"));
     programs.insert(fs::path("2-program"));
 
+    model::strings_set resources;
+    resources.insert("1-resource");
+    resources.insert("2-resource=3");
+
     const model::metadata md = model::metadata_builder()
         .add_allowed_architecture("1-architecture")
         .add_allowed_platform("1-platform")
@@ -99,11 +108,13 @@ ATF_TEST_CASE_BODY(add)
         .add_required_config("1-config")
         .add_required_file(fs::path("1-file"))
         .add_required_program(fs::path("1-program"))
+        .add_required_resource("1-resource")
         .add_allowed_architecture("2-architecture")
         .add_allowed_platform("2-platform")
         .add_required_config("2-config")
         .add_required_file(fs::path("2-file"))
         .add_required_program(fs::path("2-program"))
+        .add_required_resource("2-resource=3")
         .build();
 
     ATF_REQUIRE(architectures == md.allowed_architectures());
@@ -112,6 +123,7 @@ ATF_TEST_CASE_BODY(add)
     ATF_REQUIRE(configs == md.required_configs());
     ATF_REQUIRE(files == md.required_files());
     ATF_REQUIRE(programs == md.required_programs());
+    ATF_REQUIRE(resources == md.required_resources());
 }
 
 
@@ -176,12 +188,16 @@ ATF_TEST_CASE_BODY(override_all_with_setters)
     model::strings_set platforms;
     platforms.insert("the-platforms");
 
+    const datetime::delta cpu_time_limit(10, 0);
+
     model::properties_map custom;
     custom["first"] = "hello";
     custom["second"] = "bye";
 
     const std::string description = "Some long text";
 
+    const units::bytes memory_limit(1024 * 1024 * 64);
+
     model::strings_set configs;
     configs.insert("the-configs");
 
@@ -195,6 +211,9 @@ ATF_TEST_CASE_BODY(override_all_with_setters)
     model::paths_set programs;
     programs.insert(fs::path("the-programs"));
 
+    model::strings_set resources;
+    resources.insert("the-resources=2");
+
     const std::string user = "root";
 
     const datetime::delta timeout(123, 0);
@@ -202,31 +221,39 @@ ATF_TEST_CASE_BODY(override_all_with_setters)
     const model::metadata md = model::metadata_builder()
         .set_allowed_architectures(architectures)
         .set_allowed_platforms(platforms)
+        .set_cpu_time_limit(cpu_time_limit)
         .set_custom(custom)
         .set_description(description)
         .set_has_cleanup(true)
         .set_is_exclusive(true)
+        .set_memory_limit(memory_limit)
         .set_required_configs(configs)
         .set_required_disk_space(disk_space)
         .set_required_files(files)
         .set_required_memory(memory)
         .set_required_programs(programs)
+        .set_required_resources(resources)
         .set_required_user(user)
+        .set_retries(2)
         .set_timeout(timeout)
         .build();
 
     ATF_REQUIRE(architectures == md.allowed_architectures());
     ATF_REQUIRE(platforms == md.allowed_platforms());
+    ATF_REQUIRE(cpu_time_limit == md.cpu_time_limit());
     ATF_REQUIRE(custom == md.custom());
     ATF_REQUIRE_EQ(description, md.description());
     ATF_REQUIRE(md.has_cleanup());
     ATF_REQUIRE(md.is_exclusive());
+    ATF_REQUIRE_EQ(memory_limit, md.memory_limit());
     ATF_REQUIRE(configs == md.required_configs());
     ATF_REQUIRE_EQ(disk_space, md.required_disk_space());
     ATF_REQUIRE(files == md.required_files());
     ATF_REQUIRE_EQ(memory, md.required_memory());
     ATF_REQUIRE(programs == md.required_programs());
+    ATF_REQUIRE(resources == md.required_resources());
     ATF_REQUIRE_EQ(user, md.required_user());
+    ATF_REQUIRE_EQ(2, md.retries());
     ATF_REQUIRE(timeout == md.timeout());
 }
 
@@ -242,11 +269,15 @@ ATF_TEST_CASE_BODY(override_all_with_set_string)
     platforms.insert("p1");
     platforms.insert("p2");
 
+    const datetime::delta cpu_time_limit(20, 0);
+
     model::properties_map custom;
     custom["user-defined"] = "the-value";
 
     const std::string description = "Another long text";
 
+    const units::bytes memory_limit(static_cast< uint64_t >(2) * 1024 * 1024);
+
     model::strings_set configs;
     configs.insert("config-var");
 
@@ -263,6 +294,10 @@ ATF_TEST_CASE_BODY(override_all_with_set_string)
     programs.insert(fs::path("program"));
     programs.insert(fs::path("/absolute/prog"));
 
+    model::strings_set resources;
+    resources.insert("port:8080");
+    resources.insert("loopdev=4");
+
     const std::string user = "unprivileged";
 
     const datetime::delta timeout(45, 0);
@@ -270,35 +305,67 @@ ATF_TEST_CASE_BODY(override_all_with_set_string)
     const model::metadata md = model::metadata_builder()
         .set_string("allowed_architectures", "a1 a2")
         .set_string("allowed_platforms", "p1 p2")
+        .set_string("cpu_time_limit", "20")
         .set_string("custom.user-defined", "the-value")
         .set_string("description", "Another long text")
         .set_string("has_cleanup", "true")
         .set_string("is_exclusive", "true")
+        .set_string("memory_limit", "2M")
         .set_string("required_configs", "config-var")
         .set_string("required_disk_space", "16G")
         .set_string("required_files", "plain /absolute/path")
         .set_string("required_memory", "1M")
         .set_string("required_programs", "program /absolute/prog")
+        .set_string("required_resources", "port:8080 loopdev=4")
         .set_string("required_user", "unprivileged")
+        .set_string("retries", "3")
         .set_string("timeout", "45")
         .build();
 
     ATF_REQUIRE(architectures == md.allowed_architectures());
     ATF_REQUIRE(platforms == md.allowed_platforms());
+    ATF_REQUIRE(cpu_time_limit == md.cpu_time_limit());
     ATF_REQUIRE(custom == md.custom());
     ATF_REQUIRE_EQ(description, md.description());
     ATF_REQUIRE(md.has_cleanup());
     ATF_REQUIRE(md.is_exclusive());
+    ATF_REQUIRE_EQ(memory_limit, md.memory_limit());
     ATF_REQUIRE(configs == md.required_configs());
     ATF_REQUIRE_EQ(disk_space, md.required_disk_space());
     ATF_REQUIRE(files == md.required_files());
     ATF_REQUIRE_EQ(memory, md.required_memory());
     ATF_REQUIRE(programs == md.required_programs());
+    ATF_REQUIRE(resources == md.required_resources());
     ATF_REQUIRE_EQ(user, md.required_user());
+    ATF_REQUIRE_EQ(3, md.retries());
     ATF_REQUIRE(timeout == md.timeout());
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(set_string__invalid_resources);
+ATF_TEST_CASE_BODY(set_string__invalid_resources)
+{
+    model::metadata_builder builder;
+    ATF_REQUIRE_THROW_RE(model::error, "required_resources.*missing name",
+                         builder.set_string("required_resources", "a =3"));
+    ATF_REQUIRE_THROW_RE(model::error, "required_resources.*bad count 'x'",
+                         builder.set_string("required_resources", "a=x"));
+    ATF_REQUIRE_THROW_RE(model::error, "required_resources.*positive",
+                         builder.set_string("required_resources", "a=0"));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(set_string__invalid_retries);
+ATF_TEST_CASE_BODY(set_string__invalid_retries)
+{
+    model::metadata_builder builder;
+    ATF_REQUIRE_THROW_RE(model::error, "retries.*non-negative",
+                         builder.set_string("retries", "-1"));
+    ATF_REQUIRE_THROW_RE(model::error, "retries",
+                         builder.set_string("retries", "many"));
+}
+
+
 ATF_TEST_CASE_WITHOUT_HEAD(to_properties);
 ATF_TEST_CASE_BODY(to_properties)
 {
@@ -313,16 +380,20 @@ ATF_TEST_CASE_BODY(to_properties)
     model::properties_map props;
     props["allowed_architectures"] = "abc";
     props["allowed_platforms"] = "";
+    props["cpu_time_limit"] = "0";
     props["custom.foo"] = "bar";
     props["description"] = "";
     props["has_cleanup"] = "false";
     props["is_exclusive"] = "false";
+    props["memory_limit"] = "0";
     props["required_configs"] = "";
     props["required_disk_space"] = "0";
     props["required_files"] = "bar foo";
     props["required_memory"] = "1.00K";
     props["required_programs"] = "";
+    props["required_resources"] = "";
     props["required_user"] = "";
+    props["retries"] = "0";
     props["timeout"] = "300";
     ATF_REQUIRE_EQ(props, md.to_properties());
 }
@@ -406,11 +477,13 @@ ATF_TEST_CASE_BODY(output__defaults)
     std::ostringstream str;
     str << model::metadata_builder().build();
     ATF_REQUIRE_EQ("metadata{allowed_architectures='', allowed_platforms='', "
+                   "cpu_time_limit='0', "
                    "description='', has_cleanup='false', is_exclusive='false', "
-                   "required_configs='', "
+                   "memory_limit='0', required_configs='', "
                    "required_disk_space='0', required_files='', "
                    "required_memory='0', "
-                   "required_programs='', required_user='', timeout='300'}",
+                   "required_programs='', required_resources='', "
+                   "required_user='', retries='0', timeout='300'}",
                    str.str());
 }
 
@@ -428,15 +501,43 @@ ATF_TEST_CASE_BODY(output__some_values)
         .build();
     ATF_REQUIRE_EQ(
         "metadata{allowed_architectures='abc', allowed_platforms='', "
+        "cpu_time_limit='0', "
         "description='', has_cleanup='false', is_exclusive='true', "
-        "required_configs='', "
+        "memory_limit='0', required_configs='', "
         "required_disk_space='0', required_files='bar foo', "
         "required_memory='1.00K', "
-        "required_programs='', required_user='', timeout='300'}",
+        "required_programs='', required_resources='', "
+        "required_user='', retries='0', timeout='300'}",
         str.str());
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(parse_resource__ok);
+ATF_TEST_CASE_BODY(parse_resource__ok)
+{
+    ATF_REQUIRE(model::resource_token("loopdev", 1) ==
+                model::parse_resource("loopdev"));
+    ATF_REQUIRE(model::resource_token("port:8080", 1) ==
+                model::parse_resource("port:8080"));
+    ATF_REQUIRE(model::resource_token("loopdev", 4) ==
+                model::parse_resource("loopdev=4"));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parse_resource__fail);
+ATF_TEST_CASE_BODY(parse_resource__fail)
+{
+    ATF_REQUIRE_THROW_RE(model::error, "missing name",
+                         model::parse_resource("=2"));
+    ATF_REQUIRE_THROW_RE(model::error, "bad count ''",
+                         model::parse_resource("loopdev="));
+    ATF_REQUIRE_THROW_RE(model::error, "bad count '-1'",
+                         model::parse_resource("loopdev=-1"));
+    ATF_REQUIRE_THROW_RE(model::error, "must be positive",
+                         model::parse_resource("loopdev=0"));
+}
+
+
 ATF_INIT_TEST_CASES(tcs)
 {
     ATF_ADD_TEST_CASE(tcs, defaults);
@@ -445,6 +546,8 @@ ATF_INIT_TEST_CASES(tcs)
     ATF_ADD_TEST_CASE(tcs, apply_overrides);
     ATF_ADD_TEST_CASE(tcs, override_all_with_setters);
     ATF_ADD_TEST_CASE(tcs, override_all_with_set_string);
+    ATF_ADD_TEST_CASE(tcs, set_string__invalid_resources);
+    ATF_ADD_TEST_CASE(tcs, set_string__invalid_retries);
     ATF_ADD_TEST_CASE(tcs, to_properties);
 
     ATF_ADD_TEST_CASE(tcs, operators_eq_and_ne__empty);
@@ -456,6 +559,9 @@ ATF_INIT_TEST_CASES(tcs)
     ATF_ADD_TEST_CASE(tcs, output__defaults);
     ATF_ADD_TEST_CASE(tcs, output__some_values);
 
+    ATF_ADD_TEST_CASE(tcs, parse_resource__ok);
+    ATF_ADD_TEST_CASE(tcs, parse_resource__fail);
+
     // TODO(jmmv): Add tests for error conditions (invalid keys and invalid
     // values).
 }
@@ -200,11 +200,14 @@ ATF_TEST_CASE_BODY(test_case__output)
     ATF_REQUIRE_EQ(
         "test_case{name='the-name', "
         "metadata=metadata{allowed_architectures='', allowed_platforms='foo', "
+        "cpu_time_limit='0', "
         "custom.bar='baz', description='', has_cleanup='false', "
         "is_exclusive='false', "
+        "memory_limit='0', "
         "required_configs='', required_disk_space='0', required_files='', "
         "required_memory='0', "
-        "required_programs='', required_user='', timeout='300'}}",
+        "required_programs='', required_resources='', "
+        "required_user='', retries='0', timeout='300'}}",
         str.str());
 }
 
@@ -544,10 +544,13 @@ check_output__no_test_cases(void)
         "test_program{interface='plain', binary='binary/path', "
         "root='/the/root', test_suite='suite-name', "
         "metadata=metadata{allowed_architectures='a', allowed_platforms='', "
+        "cpu_time_limit='0', "
         "description='', has_cleanup='false', is_exclusive='false', "
+        "memory_limit='0', "
         "required_configs='', required_disk_space='0', required_files='', "
         "required_memory='0', "
-        "required_programs='', required_user='', timeout='300'}, "
+        "required_programs='', required_resources='', "
+        "required_user='', retries='0', timeout='300'}, "
         "test_cases=map()}",
         str.str());
 }
@@ -593,24 +596,33 @@ check_output__some_test_cases(void)
         "test_program{interface='plain', binary='binary/path', "
         "root='/the/root', test_suite='suite-name', "
         "metadata=metadata{allowed_architectures='a', allowed_platforms='', "
+        "cpu_time_limit='0', "
         "description='', has_cleanup='false', is_exclusive='false', "
+        "memory_limit='0', "
         "required_configs='', required_disk_space='0', required_files='', "
         "required_memory='0', "
-        "required_programs='', required_user='', timeout='300'}, "
+        "required_programs='', required_resources='', "
+        "required_user='', retries='0', timeout='300'}, "
         "test_cases=map("
         "another-name=test_case{name='another-name', "
         "metadata=metadata{allowed_architectures='a', allowed_platforms='', "
+        "cpu_time_limit='0', "
         "description='', has_cleanup='false', is_exclusive='false', "
+        "memory_limit='0', "
         "required_configs='', required_disk_space='0', required_files='', "
         "required_memory='0', "
-        "required_programs='', required_user='', timeout='300'}}, "
+        "required_programs='', required_resources='', "
+        "required_user='', retries='0', timeout='300'}}, "
         "the-name=test_case{name='the-name', "
         "metadata=metadata{allowed_architectures='a', allowed_platforms='foo', "
+        "cpu_time_limit='0', "
         "custom.bar='baz', description='', has_cleanup='false', "
         "is_exclusive='false', "
+        "memory_limit='0', "
         "required_configs='', required_disk_space='0', required_files='', "
         "required_memory='0', "
-        "required_programs='', required_user='', timeout='300'}})}",
+        "required_programs='', required_resources='', "
+        "required_user='', retries='0', timeout='300'}})}",
         str.str());
 }
 
@@ -219,6 +219,22 @@ layout::new_db_for_migration(const fs::path& root,
 }
 
 
+/// Gets the path to the database holding the caches across runs.
+///
+/// This database holds both the cached test results and the cached test cases
+/// lists.  It lives in the store directory but is not a results file, so its
+/// name does not follow the naming scheme of results files and find_results()
+/// never returns it.  Note that this function does not create the store
+/// directory.
+///
+/// \return Path to the database file holding the caches.
+fs::path
+layout::query_cache_db(void)
+{
+    return query_store_dir() / "cache.db";
+}
+
+
 /// Gets the path to the store directory.
 ///
 /// Note that this function does not create the determined directory.  It is the
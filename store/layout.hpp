@@ -74,6 +74,7 @@ utils::fs::path find_results(const std::string&);
 results_id_file_pair new_db(const std::string&, const utils::fs::path&);
 utils::fs::path new_db_for_migration(const utils::fs::path&,
                                      const utils::datetime::timestamp&);
+utils::fs::path query_cache_db(void);
 utils::fs::path query_store_dir(void);
 std::string test_suite_for_path(const utils::fs::path&);
 
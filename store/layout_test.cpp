@@ -275,6 +275,16 @@ ATF_TEST_CASE_BODY(new_db_for_migration)
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(query_cache_db);
+ATF_TEST_CASE_BODY(query_cache_db)
+{
+    const fs::path home = fs::current_path() / "homedir";
+    utils::setenv("HOME", home.str());
+    ATF_REQUIRE_EQ(home / ".kyua/store/cache.db",
+                   layout::query_cache_db());
+}
+
+
 ATF_TEST_CASE_WITHOUT_HEAD(query_store_dir__home_absolute);
 ATF_TEST_CASE_BODY(query_store_dir__home_absolute)
 {
@@ -341,6 +351,8 @@ ATF_INIT_TEST_CASES(tcs)
 
     ATF_ADD_TEST_CASE(tcs, new_db_for_migration);
 
+    ATF_ADD_TEST_CASE(tcs, query_cache_db);
+
     ATF_ADD_TEST_CASE(tcs, query_store_dir__home_absolute);
     ATF_ADD_TEST_CASE(tcs, query_store_dir__home_relative);
     ATF_ADD_TEST_CASE(tcs, query_store_dir__no_home);
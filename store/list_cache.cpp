@@ -0,0 +1,439 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "store/list_cache.hpp"
+
+#if defined(HAVE_CONFIG_H)
+#   include "config.h"
+#endif
+
+extern "C" {
+#include <sys/stat.h>
+}
+
+#include <cstdlib>
+
+#include "model/exceptions.hpp"
+#include "model/metadata.hpp"
+#include "model/test_case.hpp"
+#include "model/test_program.hpp"
+#include "model/test_result.hpp"
+#include "store/exceptions.hpp"
+#include "store/result_cache.hpp"
+#include "utils/format/macros.hpp"
+#include "utils/fs/path.hpp"
+#include "utils/logging/macros.hpp"
+#include "utils/noncopyable.hpp"
+#include "utils/optional.ipp"
+#include "utils/sqlite/database.hpp"
+#include "utils/sqlite/exceptions.hpp"
+#include "utils/sqlite/statement.ipp"
+#include "utils/sqlite/transaction.hpp"
+
+namespace config = utils::config;
+namespace fs = utils::fs;
+namespace sqlite = utils::sqlite;
+
+using utils::none;
+using utils::optional;
+
+
+namespace {
+
+
+/// Identity of a file, which changes whenever the file is modified.
+struct file_identity {
+    /// Device containing the file.
+    int64_t device;
+
+    /// Inode number of the file within its device.
+    int64_t inode;
+
+    /// Size of the file in bytes.
+    int64_t size;
+
+    /// Modification time of the file in nanoseconds since the epoch.
+    int64_t mtime_nsecs;
+};
+
+
+/// Queries the identity of a test program binary.
+///
+/// \param path Path to the binary.
+///
+/// \return The identity of the binary, or none if it cannot be queried.
+static optional< file_identity >
+identify_binary(const fs::path& path)
+{
+    struct ::stat sb;
+    if (::stat(path.c_str(), &sb) == -1)
+        return none;
+
+    file_identity identity;
+    identity.device = static_cast< int64_t >(sb.st_dev);
+    identity.inode = static_cast< int64_t >(sb.st_ino);
+    identity.size = static_cast< int64_t >(sb.st_size);
+    identity.mtime_nsecs = static_cast< int64_t >(sb.st_mtime) * 1000000000;
+#if defined(HAVE_STRUCT_STAT_ST_MTIM)
+    identity.mtime_nsecs += sb.st_mtim.tv_nsec;
+#elif defined(HAVE_STRUCT_STAT_ST_MTIMESPEC)
+    identity.mtime_nsecs += sb.st_mtimespec.tv_nsec;
+#endif
+    return utils::make_optional(identity);
+}
+
+
+/// Serializes a collection of properties into a string.
+///
+/// Every name and value is prefixed by its length so that the result can be
+/// parsed back unambiguously, regardless of the characters in the properties.
+///
+/// \param properties The properties to serialize.
+///
+/// \return The textual representation of the properties.
+static std::string
+serialize_properties(const config::properties_map& properties)
+{
+    std::string text;
+    for (config::properties_map::const_iterator iter = properties.begin();
+         iter != properties.end(); ++iter) {
+        text += F("%s:%s%s:%s") % (*iter).first.length() % (*iter).first %
+            (*iter).second.length() % (*iter).second;
+    }
+    return text;
+}
+
+
+/// Extracts a length-prefixed field from a serialized collection of properties.
+///
+/// \param text The serialized properties.
+/// \param [in,out] pos Position of the field; updated to point past it.
+///
+/// \return The value of the field.
+///
+/// \throw store::integrity_error If the field is malformed.
+static std::string
+parse_field(const std::string& text, std::string::size_type& pos)
+{
+    const std::string::size_type colon = text.find(':', pos);
+    if (colon == std::string::npos || colon == pos)
+        throw store::integrity_error("Missing length in cached metadata");
+
+    char* endptr;
+    const unsigned long length = std::strtoul(text.c_str() + pos, &endptr, 10);
+    if (endptr != text.c_str() + colon || length > text.length() - colon - 1)
+        throw store::integrity_error("Invalid length in cached metadata");
+
+    pos = colon + 1 + length;
+    return text.substr(colon + 1, length);
+}
+
+
+/// Parses a serialized collection of properties.
+///
+/// \param text The result of a previous call to serialize_properties().
+///
+/// \return The collection of properties.
+///
+/// \throw store::integrity_error If the text is malformed.
+static config::properties_map
+parse_properties(const std::string& text)
+{
+    config::properties_map properties;
+    std::string::size_type pos = 0;
+    while (pos < text.length()) {
+        const std::string name = parse_field(text, pos);
+        const std::string value = parse_field(text, pos);
+        properties[name] = value;
+    }
+    return properties;
+}
+
+
+/// Builds a test case out of its cached representation.
+///
+/// \param name The name of the test case.
+/// \param metadata The serialized metadata of the test case.
+///
+/// \return The test case.
+///
+/// \throw store::integrity_error If the metadata is invalid.
+static model::test_case
+parse_test_case(const std::string& name, const std::string& metadata)
+{
+    const config::properties_map properties = parse_properties(metadata);
+
+    model::metadata_builder builder;
+    try {
+        for (config::properties_map::const_iterator iter = properties.begin();
+             iter != properties.end(); ++iter) {
+            builder.set_string((*iter).first, (*iter).second);
+        }
+    } catch (const model::error& e) {
+        throw store::integrity_error(F("Invalid cached metadata: %s") %
+                                     e.what());
+    }
+    return model::test_case(name, builder.build());
+}
+
+
+}  // anonymous namespace
+
+
+/// Internal implementation for the list cache.
+struct store::list_cache::impl : utils::noncopyable {
+    /// The SQLite database holding the cache.
+    sqlite::database database;
+
+    /// Constructor.
+    ///
+    /// \param database_ The SQLite database instance.
+    impl(sqlite::database& database_) : database(database_)
+    {
+    }
+};
+
+
+/// Constructs a new list cache.
+///
+/// \param pimpl_ The internal data.
+store::list_cache::list_cache(impl* pimpl_) :
+    _pimpl(pimpl_)
+{
+}
+
+
+/// Destructor.
+store::list_cache::~list_cache(void)
+{
+}
+
+
+/// Opens the list cache and creates it if necessary.
+///
+/// \param file The database file holding the cache.
+///
+/// \return The cache representation.
+///
+/// \throw store::error If there is any problem opening or creating the cache.
+store::list_cache
+store::list_cache::open_rw(const fs::path& file)
+{
+    sqlite::database db = detail::open_cache(file);
+    try {
+        db.exec("CREATE TABLE IF NOT EXISTS listed_programs ("
+                "    program_id INTEGER PRIMARY KEY AUTOINCREMENT,"
+                "    absolute_path TEXT NOT NULL,"
+                "    interface TEXT NOT NULL,"
+                "    device INTEGER NOT NULL,"
+                "    inode INTEGER NOT NULL,"
+                "    size INTEGER NOT NULL,"
+                "    mtime_nsecs INTEGER NOT NULL,"
+                "    vars TEXT NOT NULL,"
+                "    UNIQUE (absolute_path, interface)"
+                ")");
+        db.exec("CREATE TABLE IF NOT EXISTS listed_test_cases ("
+                "    program_id INTEGER NOT NULL"
+                "        REFERENCES listed_programs ON DELETE CASCADE,"
+                "    name TEXT NOT NULL,"
+                "    metadata TEXT NOT NULL"
+                ")");
+        db.exec("CREATE INDEX IF NOT EXISTS index_listed_test_cases "
+                "    ON listed_test_cases (program_id)");
+    } catch (const sqlite::error& e) {
+        db.close();
+        throw error(F("Cannot initialize list cache %s: %s") % file %
+                    e.what());
+    }
+    return list_cache(new impl(db));
+}
+
+
+/// Closes the SQLite database.
+void
+store::list_cache::close(void)
+{
+    _pimpl->database.close();
+}
+
+
+/// Looks up the test cases of a test program.
+///
+/// \param test_program The test program to query.
+/// \param vars The configuration variables given to the list operation.
+///
+/// \return The test cases of the test program, or none if they are not cached
+/// or if the binary of the test program changed since they were cached.
+///
+/// \throw store::error If there is any problem reading the cache.
+optional< model::test_cases_map >
+store::list_cache::lookup(const model::test_program& test_program,
+                          const config::properties_map& vars)
+{
+    const optional< file_identity > identity = identify_binary(
+        test_program.absolute_path());
+    if (!identity)
+        return none;
+
+    try {
+        sqlite::statement stmt = _pimpl->database.create_statement(
+            "SELECT name, metadata FROM listed_programs "
+            "    NATURAL JOIN listed_test_cases "
+            "WHERE absolute_path == :absolute_path "
+            "    AND interface == :interface AND device == :device "
+            "    AND inode == :inode AND size == :size "
+            "    AND mtime_nsecs == :mtime_nsecs AND vars == :vars");
+        stmt.bind(":absolute_path", test_program.absolute_path().str());
+        stmt.bind(":interface", test_program.interface_name());
+        stmt.bind(":device", identity.get().device);
+        stmt.bind(":inode", identity.get().inode);
+        stmt.bind(":size", identity.get().size);
+        stmt.bind(":mtime_nsecs", identity.get().mtime_nsecs);
+        stmt.bind(":vars", serialize_properties(vars));
+
+        model::test_cases_map_builder builder;
+        bool found = false;
+        while (stmt.step()) {
+            builder.add(parse_test_case(stmt.safe_column_text("name"),
+                                        stmt.safe_column_text("metadata")));
+            found = true;
+        }
+        if (!found)
+            return none;
+        return utils::make_optional(builder.build());
+    } catch (const sqlite::error& e) {
+        throw error(e.what());
+    } catch (const integrity_error& e) {
+        LW(F("Ignoring corrupt cached list of %s: %s") %
+           test_program.absolute_path() % e.what());
+        return none;
+    }
+}
+
+
+/// Records the test cases of a test program.
+///
+/// Lists that contain test cases with recorded results, such as the fake test
+/// case that represents a failed list operation, are not cached because they
+/// are the result of an execution and not just of the binary.
+///
+/// \param test_program The test program that was listed.
+/// \param vars The configuration variables given to the list operation.
+/// \param test_cases The test cases of the test program.
+///
+/// \throw store::error If there is any problem writing to the cache.
+void
+store::list_cache::put(const model::test_program& test_program,
+                       const config::properties_map& vars,
+                       const model::test_cases_map& test_cases)
+{
+    for (model::test_cases_map::const_iterator iter = test_cases.begin();
+         iter != test_cases.end(); ++iter) {
+        if ((*iter).second.fake_result())
+            return;
+    }
+
+    const optional< file_identity > identity = identify_binary(
+        test_program.absolute_path());
+    if (!identity)
+        return;
+
+    LD(F("Caching test cases list of %s") % test_program.absolute_path());
+    try {
+        sqlite::transaction tx = _pimpl->database.begin_transaction();
+
+        {
+            sqlite::statement stmt = _pimpl->database.create_statement(
+                "DELETE FROM listed_programs "
+                "WHERE absolute_path == :absolute_path "
+                "    AND interface == :interface");
+            stmt.bind(":absolute_path", test_program.absolute_path().str());
+            stmt.bind(":interface", test_program.interface_name());
+            stmt.step_without_results();
+        }
+
+        sqlite::statement stmt = _pimpl->database.create_statement(
+            "INSERT INTO listed_programs (absolute_path, interface, device, "
+            "    inode, size, mtime_nsecs, vars) "
+            "VALUES (:absolute_path, :interface, :device, :inode, :size, "
+            "    :mtime_nsecs, :vars)");
+        stmt.bind(":absolute_path", test_program.absolute_path().str());
+        stmt.bind(":interface", test_program.interface_name());
+        stmt.bind(":device", identity.get().device);
+        stmt.bind(":inode", identity.get().inode);
+        stmt.bind(":size", identity.get().size);
+        stmt.bind(":mtime_nsecs", identity.get().mtime_nsecs);
+        stmt.bind(":vars", serialize_properties(vars));
+        stmt.step_without_results();
+        const int64_t program_id = _pimpl->database.last_insert_rowid();
+
+        sqlite::statement tc_stmt = _pimpl->database.create_statement(
+            "INSERT INTO listed_test_cases (program_id, name, metadata) "
+            "VALUES (:program_id, :name, :metadata)");
+        tc_stmt.bind(":program_id", program_id);
+        for (model::test_cases_map::const_iterator iter = test_cases.begin();
+             iter != test_cases.end(); ++iter) {
+            tc_stmt.bind(":name", (*iter).first);
+            tc_stmt.bind(":metadata", serialize_properties(
+                (*iter).second.get_raw_metadata().to_properties()));
+            tc_stmt.step_without_results();
+            tc_stmt.reset();
+        }
+
+        tx.commit();
+    } catch (const sqlite::error& e) {
+        throw error(e.what());
+    }
+}
+
+
+/// Removes all entries from the cache.
+///
+/// \return The number of test programs whose lists were removed.
+///
+/// \throw store::error If there is any problem writing to the cache.
+int64_t
+store::list_cache::clear(void)
+{
+    try {
+        int64_t count;
+        {
+            // The statement must be gone by the time we vacuum the database.
+            sqlite::statement stmt = _pimpl->database.create_statement(
+                "SELECT COUNT(*) AS count FROM listed_programs");
+            (void)stmt.step();
+            count = stmt.safe_column_int64("count");
+        }
+
+        _pimpl->database.exec("DELETE FROM listed_programs");
+        _pimpl->database.exec("VACUUM");
+        return count;
+    } catch (const sqlite::error& e) {
+        throw error(e.what());
+    }
+}
@@ -0,0 +1,79 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// \file store/list_cache.hpp
+/// Cache of the test cases lists of test programs.
+///
+/// Listing the test cases of a test program requires running it, which adds up
+/// to a significant cost for test suites with many test programs.  This cache
+/// records the test cases of every test program along with the identity of its
+/// binary so that the list can be reused until the binary changes.
+
+#if !defined(STORE_LIST_CACHE_HPP)
+#define STORE_LIST_CACHE_HPP
+
+extern "C" {
+#include <stdint.h>
+}
+
+#include "model/test_case_fwd.hpp"
+#include "model/test_program_fwd.hpp"
+#include "utils/config/tree_fwd.hpp"
+#include "utils/fs/path_fwd.hpp"
+#include "utils/optional_fwd.hpp"
+#include "utils/shared_ptr.hpp"
+
+namespace store {
+
+
+/// Persistent cache of the test cases lists of test programs.
+class list_cache {
+    struct impl;
+
+    /// Pointer to the shared internal implementation.
+    std::shared_ptr< impl > _pimpl;
+
+    list_cache(impl*);
+
+public:
+    ~list_cache(void);
+
+    static list_cache open_rw(const utils::fs::path&);
+    void close(void);
+
+    utils::optional< model::test_cases_map > lookup(
+        const model::test_program&, const utils::config::properties_map&);
+    void put(const model::test_program&, const utils::config::properties_map&,
+             const model::test_cases_map&);
+    int64_t clear(void);
+};
+
+
+}  // namespace store
+
+#endif  // !defined(STORE_LIST_CACHE_HPP)
@@ -0,0 +1,265 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "store/list_cache.hpp"
+
+#include <atf-c++.hpp>
+
+#include "model/metadata.hpp"
+#include "model/test_case.hpp"
+#include "model/test_program.hpp"
+#include "model/test_result.hpp"
+#include "utils/config/tree.ipp"
+#include "utils/fs/operations.hpp"
+#include "utils/fs/path.hpp"
+#include "utils/logging/operations.hpp"
+#include "utils/optional.ipp"
+
+namespace config = utils::config;
+namespace fs = utils::fs;
+namespace logging = utils::logging;
+
+using utils::optional;
+
+
+namespace {
+
+
+/// Creates a test program backed by a binary in the current directory.
+///
+/// \param name The name of the binary, which is created if it does not exist.
+///
+/// \return A test program without test cases.
+static model::test_program
+make_test_program(const char* name)
+{
+    if (!fs::exists(fs::path(name)))
+        atf::utils::create_file(name, "binary contents");
+    return model::test_program("atf", fs::path(name), fs::current_path(),
+                               "the-suite", model::metadata_builder().build(),
+                               model::test_cases_map());
+}
+
+
+}  // anonymous namespace
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(lookup__miss);
+ATF_TEST_CASE_BODY(lookup__miss)
+{
+    logging::set_inmemory();
+
+    store::list_cache cache = store::list_cache::open_rw(fs::path("cache.db"));
+    ATF_REQUIRE(!cache.lookup(make_test_program("program"),
+                              config::properties_map()));
+    cache.close();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(put_and_lookup);
+ATF_TEST_CASE_BODY(put_and_lookup)
+{
+    logging::set_inmemory();
+
+    const model::test_program program1 = make_test_program("program1");
+    const model::test_program program2 = make_test_program("program2");
+
+    const model::test_cases_map test_cases1 = model::test_cases_map_builder()
+        .add("first")
+        .add("second", model::metadata_builder()
+             .set_description("Some text: with\nnewlines")
+             .add_custom("X-foo", "bar")
+             .set_is_exclusive(true)
+             .build())
+        .build();
+    const model::test_cases_map test_cases2 = model::test_cases_map_builder()
+        .add("main")
+        .build();
+
+    config::properties_map vars;
+    vars["the-variable"] = "the-value";
+
+    {
+        store::list_cache cache = store::list_cache::open_rw(
+            fs::path("cache.db"));
+        cache.put(program1, vars, test_cases1);
+        cache.put(program2, vars, test_cases2);
+        cache.close();
+    }
+
+    store::list_cache cache = store::list_cache::open_rw(fs::path("cache.db"));
+
+    const optional< model::test_cases_map > cached1 = cache.lookup(
+        program1, vars);
+    ATF_REQUIRE(cached1);
+    ATF_REQUIRE(test_cases1 == cached1.get());
+
+    const optional< model::test_cases_map > cached2 = cache.lookup(
+        program2, vars);
+    ATF_REQUIRE(cached2);
+    ATF_REQUIRE(test_cases2 == cached2.get());
+
+    cache.close();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(lookup__binary_changed);
+ATF_TEST_CASE_BODY(lookup__binary_changed)
+{
+    logging::set_inmemory();
+
+    const model::test_program program = make_test_program("program");
+    const model::test_cases_map test_cases = model::test_cases_map_builder()
+        .add("main").build();
+
+    store::list_cache cache = store::list_cache::open_rw(fs::path("cache.db"));
+    cache.put(program, config::properties_map(), test_cases);
+    ATF_REQUIRE(cache.lookup(program, config::properties_map()));
+
+    atf::utils::create_file("program", "new binary contents");
+    ATF_REQUIRE(!cache.lookup(program, config::properties_map()));
+    cache.close();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(lookup__vars_changed);
+ATF_TEST_CASE_BODY(lookup__vars_changed)
+{
+    logging::set_inmemory();
+
+    const model::test_program program = make_test_program("program");
+    const model::test_cases_map test_cases = model::test_cases_map_builder()
+        .add("main").build();
+
+    config::properties_map vars;
+    vars["a"] = "b";
+
+    store::list_cache cache = store::list_cache::open_rw(fs::path("cache.db"));
+    cache.put(program, vars, test_cases);
+    ATF_REQUIRE(cache.lookup(program, vars));
+
+    vars["a"] = "c";
+    ATF_REQUIRE(!cache.lookup(program, vars));
+    ATF_REQUIRE(!cache.lookup(program, config::properties_map()));
+    cache.close();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(put__replace);
+ATF_TEST_CASE_BODY(put__replace)
+{
+    logging::set_inmemory();
+
+    const model::test_program program = make_test_program("program");
+    const model::test_cases_map test_cases = model::test_cases_map_builder()
+        .add("second").build();
+
+    store::list_cache cache = store::list_cache::open_rw(fs::path("cache.db"));
+    cache.put(program, config::properties_map(),
+              model::test_cases_map_builder().add("first").build());
+    cache.put(program, config::properties_map(), test_cases);
+
+    const optional< model::test_cases_map > cached = cache.lookup(
+        program, config::properties_map());
+    ATF_REQUIRE(cached);
+    ATF_REQUIRE(test_cases == cached.get());
+    ATF_REQUIRE_EQ(1, cache.clear());
+    cache.close();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(put__fake_results_not_cached);
+ATF_TEST_CASE_BODY(put__fake_results_not_cached)
+{
+    logging::set_inmemory();
+
+    const model::test_program program = make_test_program("program");
+    const model::test_cases_map test_cases = model::test_cases_map_builder()
+        .add(model::test_case(
+                 "__test_cases_list__", "Represents the failed list",
+                 model::test_result(model::test_result_broken, "Crashed")))
+        .build();
+
+    store::list_cache cache = store::list_cache::open_rw(fs::path("cache.db"));
+    cache.put(program, config::properties_map(), test_cases);
+    ATF_REQUIRE(!cache.lookup(program, config::properties_map()));
+    cache.close();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(put__missing_binary);
+ATF_TEST_CASE_BODY(put__missing_binary)
+{
+    logging::set_inmemory();
+
+    const model::test_program program("atf", fs::path("missing"),
+                                      fs::current_path(), "the-suite",
+                                      model::metadata_builder().build(),
+                                      model::test_cases_map());
+
+    store::list_cache cache = store::list_cache::open_rw(fs::path("cache.db"));
+    cache.put(program, config::properties_map(),
+              model::test_cases_map_builder().add("main").build());
+    ATF_REQUIRE(!cache.lookup(program, config::properties_map()));
+    ATF_REQUIRE_EQ(0, cache.clear());
+    cache.close();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(clear);
+ATF_TEST_CASE_BODY(clear)
+{
+    logging::set_inmemory();
+
+    const model::test_program program1 = make_test_program("program1");
+    const model::test_program program2 = make_test_program("program2");
+    const model::test_cases_map test_cases = model::test_cases_map_builder()
+        .add("main").build();
+
+    store::list_cache cache = store::list_cache::open_rw(fs::path("cache.db"));
+    ATF_REQUIRE_EQ(0, cache.clear());
+    cache.put(program1, config::properties_map(), test_cases);
+    cache.put(program2, config::properties_map(), test_cases);
+    ATF_REQUIRE_EQ(2, cache.clear());
+    ATF_REQUIRE(!cache.lookup(program1, config::properties_map()));
+    ATF_REQUIRE(!cache.lookup(program2, config::properties_map()));
+    cache.close();
+}
+
+
+ATF_INIT_TEST_CASES(tcs)
+{
+    ATF_ADD_TEST_CASE(tcs, lookup__miss);
+    ATF_ADD_TEST_CASE(tcs, put_and_lookup);
+    ATF_ADD_TEST_CASE(tcs, lookup__binary_changed);
+    ATF_ADD_TEST_CASE(tcs, lookup__vars_changed);
+    ATF_ADD_TEST_CASE(tcs, put__replace);
+    ATF_ADD_TEST_CASE(tcs, put__fake_results_not_cached);
+    ATF_ADD_TEST_CASE(tcs, put__missing_binary);
+    ATF_ADD_TEST_CASE(tcs, clear);
+}
@@ -0,0 +1,440 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "store/merge.hpp"
+
+extern "C" {
+#include <stdint.h>
+}
+
+#include <cstring>
+
+#include "store/exceptions.hpp"
+#include "store/read_backend.hpp"
+#include "store/write_backend.hpp"
+#include "utils/format/macros.hpp"
+#include "utils/fs/operations.hpp"
+#include "utils/fs/path.hpp"
+#include "utils/hash.hpp"
+#include "utils/logging/macros.hpp"
+#include "utils/sanity.hpp"
+#include "utils/sqlite/database.hpp"
+#include "utils/sqlite/exceptions.hpp"
+#include "utils/sqlite/statement.ipp"
+#include "utils/sqlite/transaction.hpp"
+
+namespace fs = utils::fs;
+namespace sqlite = utils::sqlite;
+
+
+namespace {
+
+
+/// Name under which the source results files are attached to the target.
+static const char* source_schema = "merge_source";
+
+
+/// Computes a hash of the contents of a file.
+///
+/// The hash is only used to locate candidate duplicates, so collisions are
+/// harmless: the contents of the candidates are compared before reusing them.
+///
+/// \param contents The contents to hash.
+///
+/// \return The 64-bit FNV-1a hash of the contents, as a signed integer so that
+/// it can be stored in the database.
+static int64_t
+hash_contents(const sqlite::blob& contents)
+{
+    return static_cast< int64_t >(utils::fnv1a_64(
+        utils::fnv1a_64_basis, contents.memory, contents.size));
+}
+
+
+/// Queries an integer computed by a statement returning a single value.
+///
+/// \param db The database to query.
+/// \param sql The statement to run.
+///
+/// \return The value, or 0 if it is NULL.
+static int64_t
+query_int64(sqlite::database& db, const std::string& sql)
+{
+    sqlite::statement stmt = db.create_statement(sql);
+    if (!stmt.step() || stmt.column_type(0) == sqlite::type_null)
+        return 0;
+    return stmt.column_int64(0);
+}
+
+
+/// Creates the temporary tables that map identifiers across databases.
+///
+/// \param db The database being merged into.
+static void
+create_mapping_tables(sqlite::database& db)
+{
+    db.exec("CREATE TEMP TABLE merge_program_ids ("
+            "    old_id INTEGER PRIMARY KEY,"
+            "    new_id INTEGER NOT NULL)");
+    db.exec("CREATE TEMP TABLE merge_file_ids ("
+            "    old_id INTEGER PRIMARY KEY,"
+            "    new_id INTEGER NOT NULL)");
+    db.exec("CREATE TEMP TABLE merge_file_hashes ("
+            "    hash INTEGER NOT NULL,"
+            "    file_id INTEGER NOT NULL)");
+    db.exec("CREATE INDEX temp.index_merge_file_hashes "
+            "    ON merge_file_hashes (hash)");
+}
+
+
+/// Copies the context of the source database if the target has none yet.
+///
+/// Results files only hold one context, so the context of the first source
+/// wins.  We warn if any other source was run in a different context.
+///
+/// \param db The database being merged into, with the source attached.
+/// \param source Path to the source database, for logging purposes.
+static void
+merge_context(sqlite::database& db, const fs::path& source)
+{
+    if (query_int64(db, "SELECT COUNT(*) FROM main.contexts") == 0) {
+        db.exec(F("INSERT INTO main.contexts (cwd) "
+                  "SELECT cwd FROM %s.contexts") % source_schema);
+        db.exec(F("INSERT INTO main.env_vars (var_name, var_value) "
+                  "SELECT var_name, var_value FROM %s.env_vars") %
+                source_schema);
+        return;
+    }
+
+    const int64_t differences = query_int64(db, F(
+        "SELECT (SELECT COUNT(*) FROM ("
+        "            SELECT cwd FROM main.contexts EXCEPT "
+        "            SELECT cwd FROM %s.contexts)) + "
+        "       (SELECT COUNT(*) FROM ("
+        "            SELECT * FROM main.env_vars EXCEPT "
+        "            SELECT * FROM %s.env_vars)) + "
+        "       (SELECT COUNT(*) FROM ("
+        "            SELECT * FROM %s.env_vars EXCEPT "
+        "            SELECT * FROM main.env_vars))") %
+        source_schema % source_schema % source_schema);
+    if (differences > 0)
+        LW(F("The context of %s differs from the one of the first results "
+             "file; keeping the latter") % source);
+}
+
+
+/// Copies the test programs of the source database.
+///
+/// Test programs already present in the target, as happens when merging the
+/// shards of a single run, are reused.  The mapping of the identifiers of the
+/// source to the identifiers of the target is recorded in merge_program_ids.
+///
+/// \param db The database being merged into, with the source attached.
+/// \param metadata_offset Offset to apply to the source metadata identifiers.
+static void
+merge_test_programs(sqlite::database& db, const int64_t metadata_offset)
+{
+    sqlite::statement select_stmt = db.create_statement(F(
+        "SELECT test_program_id, absolute_path, root, relative_path, "
+        "    test_suite_name, metadata_id, interface "
+        "FROM %s.test_programs") % source_schema);
+    sqlite::statement find_stmt = db.create_statement(
+        "SELECT test_program_id FROM main.test_programs "
+        "WHERE absolute_path == :absolute_path AND root == :root "
+        "    AND relative_path == :relative_path "
+        "    AND test_suite_name == :test_suite_name "
+        "    AND interface == :interface");
+    sqlite::statement insert_stmt = db.create_statement(
+        "INSERT INTO main.test_programs (absolute_path, root, relative_path, "
+        "    test_suite_name, metadata_id, interface) "
+        "VALUES (:absolute_path, :root, :relative_path, :test_suite_name, "
+        "    :metadata_id, :interface)");
+    sqlite::statement map_stmt = db.create_statement(
+        "INSERT INTO temp.merge_program_ids (old_id, new_id) "
+        "VALUES (:old_id, :new_id)");
+
+    while (select_stmt.step()) {
+        const std::string absolute_path = select_stmt.safe_column_text(
+            "absolute_path");
+        const std::string root = select_stmt.safe_column_text("root");
+        const std::string relative_path = select_stmt.safe_column_text(
+            "relative_path");
+        const std::string test_suite_name = select_stmt.safe_column_text(
+            "test_suite_name");
+        const std::string interface = select_stmt.safe_column_text(
+            "interface");
+
+        find_stmt.reset();
+        find_stmt.bind(":absolute_path", absolute_path);
+        find_stmt.bind(":root", root);
+        find_stmt.bind(":relative_path", relative_path);
+        find_stmt.bind(":test_suite_name", test_suite_name);
+        find_stmt.bind(":interface", interface);
+        int64_t new_id;
+        if (find_stmt.step()) {
+            new_id = find_stmt.safe_column_int64("test_program_id");
+        } else {
+            insert_stmt.reset();
+            insert_stmt.bind(":absolute_path", absolute_path);
+            insert_stmt.bind(":root", root);
+            insert_stmt.bind(":relative_path", relative_path);
+            insert_stmt.bind(":test_suite_name", test_suite_name);
+            insert_stmt.bind(":metadata_id",
+                             select_stmt.safe_column_int64("metadata_id") +
+                             metadata_offset);
+            insert_stmt.bind(":interface", interface);
+            insert_stmt.step_without_results();
+            new_id = db.last_insert_rowid();
+        }
+
+        map_stmt.reset();
+        map_stmt.bind(":old_id", select_stmt.safe_column_int64(
+                          "test_program_id"));
+        map_stmt.bind(":new_id", new_id);
+        map_stmt.step_without_results();
+    }
+}
+
+
+/// Copies the files of the source database, reusing identical ones.
+///
+/// Many test cases produce identical output, and the shards of a run often
+/// share it too, so we only store each distinct file once.  The mapping of the
+/// identifiers of the source to the identifiers of the target is recorded in
+/// merge_file_ids.
+///
+/// \param db The database being merged into, with the source attached.
+///
+/// \return The number of files that were not copied because they were already
+/// present in the target.
+static int64_t
+merge_files(sqlite::database& db)
+{
+    sqlite::statement select_stmt = db.create_statement(F(
+        "SELECT file_id, contents FROM %s.files") % source_schema);
+    sqlite::statement find_stmt = db.create_statement(
+        "SELECT main.files.file_id AS file_id, contents "
+        "FROM temp.merge_file_hashes "
+        "    JOIN main.files "
+        "        ON temp.merge_file_hashes.file_id == main.files.file_id "
+        "WHERE hash == :hash");
+    sqlite::statement insert_stmt = db.create_statement(
+        "INSERT INTO main.files (contents) VALUES (:contents)");
+    sqlite::statement hash_stmt = db.create_statement(
+        "INSERT INTO temp.merge_file_hashes (hash, file_id) "
+        "VALUES (:hash, :file_id)");
+    sqlite::statement map_stmt = db.create_statement(
+        "INSERT INTO temp.merge_file_ids (old_id, new_id) "
+        "VALUES (:old_id, :new_id)");
+
+    int64_t reused = 0;
+    while (select_stmt.step()) {
+        const sqlite::blob contents = select_stmt.safe_column_blob("contents");
+        const int64_t hash = hash_contents(contents);
+
+        int64_t new_id = -1;
+        find_stmt.reset();
+        find_stmt.bind(":hash", hash);
+        while (new_id == -1 && find_stmt.step()) {
+            const sqlite::blob candidate = find_stmt.safe_column_blob(
+                "contents");
+            if (candidate.size == contents.size && (contents.size == 0 ||
+                std::memcmp(candidate.memory, contents.memory,
+                            contents.size) == 0))
+                new_id = find_stmt.safe_column_int64("file_id");
+        }
+
+        if (new_id == -1) {
+            insert_stmt.reset();
+            insert_stmt.bind(":contents", contents);
+            insert_stmt.step_without_results();
+            new_id = db.last_insert_rowid();
+
+            hash_stmt.reset();
+            hash_stmt.bind(":hash", hash);
+            hash_stmt.bind(":file_id", new_id);
+            hash_stmt.step_without_results();
+        } else {
+            ++reused;
+        }
+
+        map_stmt.reset();
+        map_stmt.bind(":old_id", select_stmt.safe_column_int64("file_id"));
+        map_stmt.bind(":new_id", new_id);
+        map_stmt.step_without_results();
+    }
+    return reused;
+}
+
+
+/// Merges one results file into the target database.
+///
+/// Other than test programs and files, which are looked up one at a time to
+/// remove duplicates, all rows are copied with one INSERT ... SELECT statement
+/// per table that shifts the identifiers past those already in the target.
+///
+/// \param db The database being merged into.
+/// \param source Path to the results file to merge.
+///
+/// \throw sqlite::error If there is a problem accessing the databases.
+static void
+merge_one(sqlite::database& db, const fs::path& source)
+{
+    LI(F("Merging results file %s") % source);
+
+    // SQLite cannot detach a database while a transaction is open, so every
+    // source gets its own transaction.  The caller deletes the target on
+    // failure, so partial merges are never observable.
+    {
+        sqlite::statement stmt = db.create_statement(
+            F("ATTACH DATABASE :path AS %s") % source_schema);
+        stmt.bind(":path", source.str());
+        stmt.step_without_results();
+    }
+
+    {
+        sqlite::transaction tx = db.begin_transaction();
+
+        merge_context(db, source);
+
+        const int64_t metadata_offset = query_int64(
+            db, "SELECT MAX(metadata_id) + 1 FROM main.metadatas");
+        db.exec(F("INSERT INTO main.metadatas "
+                  "    (metadata_id, property_name, property_value) "
+                  "SELECT metadata_id + %s, property_name, property_value "
+                  "FROM %s.metadatas") % metadata_offset % source_schema);
+
+        merge_test_programs(db, metadata_offset);
+
+        const int64_t test_case_offset = query_int64(
+            db, "SELECT MAX(test_case_id) FROM main.test_cases");
+        db.exec(F("INSERT INTO main.test_cases "
+                  "    (test_case_id, test_program_id, name, metadata_id) "
+                  "SELECT test_case_id + %s, new_id, name, metadata_id + %s "
+                  "FROM %s.test_cases "
+                  "    JOIN temp.merge_program_ids "
+                  "        ON test_program_id == old_id") %
+                test_case_offset % metadata_offset % source_schema);
+        db.exec(F("INSERT INTO main.test_results "
+                  "    (test_case_id, result_type, result_reason, "
+                  "     start_time, end_time) "
+                  "SELECT test_case_id + %s, result_type, result_reason, "
+                  "    start_time, end_time "
+                  "FROM %s.test_results") % test_case_offset % source_schema);
+
+        const int64_t reused_files = merge_files(db);
+        db.exec(F("INSERT INTO main.test_case_files "
+                  "    (test_case_id, file_name, file_id) "
+                  "SELECT test_case_id + %s, file_name, new_id "
+                  "FROM %s.test_case_files "
+                  "    JOIN temp.merge_file_ids ON file_id == old_id") %
+                test_case_offset % source_schema);
+        db.exec(F("INSERT INTO main.test_attempts "
+                  "    (test_case_id, attempt, result_type, result_reason, "
+                  "     start_time, end_time, stdout_file_id, "
+                  "     stderr_file_id) "
+                  "SELECT test_case_id + %s, attempt, result_type, "
+                  "    result_reason, start_time, end_time, "
+                  "    (SELECT new_id FROM temp.merge_file_ids "
+                  "     WHERE old_id == stdout_file_id), "
+                  "    (SELECT new_id FROM temp.merge_file_ids "
+                  "     WHERE old_id == stderr_file_id) "
+                  "FROM %s.test_attempts") %
+                test_case_offset % source_schema);
+        db.exec(F("INSERT INTO main.test_resource_usage "
+                  "SELECT test_case_id + %s, user_time, system_time, "
+                  "    max_rss, minor_faults, major_faults, block_inputs, "
+                  "    block_outputs, voluntary_switches, "
+                  "    involuntary_switches "
+                  "FROM %s.test_resource_usage") %
+                test_case_offset % source_schema);
+        db.exec(F("INSERT INTO main.test_cpu_affinity "
+                  "SELECT test_case_id + %s, cpus "
+                  "FROM %s.test_cpu_affinity") %
+                test_case_offset % source_schema);
+
+        db.exec("DELETE FROM temp.merge_program_ids");
+        db.exec("DELETE FROM temp.merge_file_ids");
+
+        tx.commit();
+        LI(F("Reused %s files already present in the merged results") %
+           reused_files);
+    }
+
+    db.exec(F("DETACH DATABASE %s") % source_schema);
+}
+
+
+}  // anonymous namespace
+
+
+/// Combines several results files into a new one.
+///
+/// The identifiers of all the objects in the sources are remapped so that
+/// they do not collide.  Test programs that appear in more than one source are
+/// stored only once, as are identical files.  Test cases, however, are copied
+/// verbatim: if the sources ran the same test case more than once, the merged
+/// results file records all of its executions.
+///
+/// \param sources Paths to the results files to merge.
+/// \param target Path to the results file to create.  Must not exist.
+///
+/// \throw error If there is a problem reading any of the sources or writing
+///     the target, in which case the target is deleted.
+void
+store::merge_results(const std::vector< fs::path >& sources,
+                     const fs::path& target)
+{
+    PRE(!sources.empty());
+
+    // Validate the schema of all the sources before doing any work so that we
+    // do not spend time merging files only to fail later on.
+    for (std::vector< fs::path >::const_iterator iter = sources.begin();
+         iter != sources.end(); ++iter) {
+        read_backend::open_ro(*iter).close();
+    }
+
+    write_backend backend = write_backend::open_rw(target);
+    try {
+        sqlite::database& db = backend.database();
+        create_mapping_tables(db);
+        for (std::vector< fs::path >::const_iterator iter = sources.begin();
+             iter != sources.end(); ++iter) {
+            merge_one(db, *iter);
+        }
+        backend.close();
+    } catch (const sqlite::error& e) {
+        backend.close();
+        fs::unlink(target);
+        throw error(F("Cannot merge results into %s: %s") % target % e.what());
+    } catch (...) {
+        backend.close();
+        fs::unlink(target);
+        throw;
+    }
+}
@@ -0,0 +1,288 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "store/merge.hpp"
+
+#include <map>
+#include <set>
+#include <string>
+
+#include <atf-c++.hpp>
+
+#include "model/context.hpp"
+#include "model/test_program.hpp"
+#include "model/test_result.hpp"
+#include "store/exceptions.hpp"
+#include "store/read_backend.hpp"
+#include "store/read_transaction.hpp"
+#include "store/write_backend.hpp"
+#include "store/write_transaction.hpp"
+#include "utils/datetime.hpp"
+#include "utils/fs/path.hpp"
+#include "utils/logging/operations.hpp"
+#include "utils/optional.ipp"
+#include "utils/process/resource_usage.hpp"
+#include "utils/sqlite/database.hpp"
+#include "utils/sqlite/statement.ipp"
+
+namespace datetime = utils::datetime;
+namespace fs = utils::fs;
+namespace logging = utils::logging;
+namespace process = utils::process;
+namespace sqlite = utils::sqlite;
+namespace units = utils::units;
+
+
+namespace {
+
+
+/// Creates a results file with a single test program.
+///
+/// Every test case is recorded as having been retried once, with the same
+/// output in both attempts, and as having used one second of user time.
+///
+/// \param file Path to the results file to create.
+/// \param test_program The test program to store.
+/// \param results The results of the test cases of the test program.
+/// \param output Contents of the stdout of every test case.
+static void
+create_results_file(const char* file, const model::test_program& test_program,
+                    const std::map< std::string, model::test_result >& results,
+                    const char* output)
+{
+    store::write_backend backend = store::write_backend::open_rw(
+        fs::path(file));
+    store::write_transaction tx = backend.start_write();
+
+    tx.put_context(model::context(fs::path("/the/root"),
+                                  std::map< std::string, std::string >()));
+
+    atf::utils::create_file("output.txt", output);
+    const datetime::timestamp start_time = datetime::timestamp::from_values(
+        2026, 10, 17, 10, 0, 0, 0);
+    const datetime::timestamp end_time = datetime::timestamp::from_values(
+        2026, 10, 17, 10, 0, 5, 0);
+
+    std::set< int > cpus;
+    cpus.insert(2);
+
+    const int64_t tp_id = tx.put_test_program(test_program);
+    for (std::map< std::string, model::test_result >::const_iterator iter =
+             results.begin(); iter != results.end(); ++iter) {
+        const int64_t tc_id = tx.put_test_case(test_program, (*iter).first,
+                                               tp_id);
+        tx.put_attempt(model::test_result(model::test_result_failed, "Flaky"),
+                       tc_id, 1, start_time, start_time,
+                       fs::path("output.txt"), fs::path("output.txt"));
+        tx.put_test_case_file("__STDOUT__", fs::path("output.txt"), tc_id);
+        tx.put_result((*iter).second, tc_id, start_time, end_time);
+        tx.put_resource_usage(tc_id, process::resource_usage(
+            datetime::delta(1, 0), datetime::delta(), units::bytes(units::MB),
+            0, 0, 0, 0, 0, 0));
+        tx.put_cpu_affinity(tc_id, cpus);
+    }
+
+    tx.commit();
+    backend.close();
+}
+
+
+/// Counts the rows of a table in a database.
+///
+/// \param file Path to the database.
+/// \param table Name of the table to query.
+///
+/// \return The number of rows in the table.
+static int64_t
+count_rows(const char* file, const char* table)
+{
+    sqlite::database db = sqlite::database::open(fs::path(file),
+                                                 sqlite::open_readonly);
+    sqlite::statement stmt = db.create_statement(
+        std::string("SELECT COUNT(*) FROM ") + table);
+    ATF_REQUIRE(stmt.step());
+    const int64_t count = stmt.column_int64(0);
+    db.close();
+    return count;
+}
+
+
+}  // anonymous namespace
+
+
+ATF_TEST_CASE(merge_results__ok);
+ATF_TEST_CASE_HEAD(merge_results__ok)
+{
+    logging::set_inmemory();
+    set_md_var("require.files", store::detail::schema_file().c_str());
+}
+ATF_TEST_CASE_BODY(merge_results__ok)
+{
+    const model::test_program program1 = model::test_program_builder(
+        "atf", fs::path("dir/prog1"), fs::path("/the/root"), "suite")
+        .add_test_case("first").add_test_case("second").add_test_case("third")
+        .build();
+    const model::test_program program2 = model::test_program_builder(
+        "plain", fs::path("prog2"), fs::path("/the/root"), "suite")
+        .add_test_case("main")
+        .build();
+
+    std::map< std::string, model::test_result > results1;
+    results1.insert(std::make_pair(
+        "first", model::test_result(model::test_result_passed)));
+    results1.insert(std::make_pair(
+        "second", model::test_result(model::test_result_failed, "Oops")));
+    create_results_file("shard1.db", program1, results1, "Same output\n");
+
+    std::map< std::string, model::test_result > results2;
+    results2.insert(std::make_pair(
+        "third", model::test_result(model::test_result_passed)));
+    create_results_file("shard2.db", program1, results2, "Same output\n");
+
+    std::map< std::string, model::test_result > results3;
+    results3.insert(std::make_pair(
+        "main", model::test_result(model::test_result_skipped, "No")));
+    create_results_file("shard3.db", program2, results3, "Other output\n");
+
+    std::vector< fs::path > sources;
+    sources.push_back(fs::path("shard1.db"));
+    sources.push_back(fs::path("shard2.db"));
+    sources.push_back(fs::path("shard3.db"));
+    store::merge_results(sources, fs::path("merged.db"));
+
+    store::read_backend backend = store::read_backend::open_ro(
+        fs::path("merged.db"));
+    store::read_transaction tx = backend.start_read();
+    ATF_REQUIRE_EQ(fs::path("/the/root"), tx.get_context().cwd());
+
+    store::results_iterator iter = tx.get_results();
+    ATF_REQUIRE(iter);
+    ATF_REQUIRE_EQ(fs::path("dir/prog1"), iter.test_program()->relative_path());
+    ATF_REQUIRE_EQ("first", iter.test_case_name());
+    ATF_REQUIRE_EQ(results1.find("first")->second, iter.result());
+    ATF_REQUIRE_EQ("Same output\n", iter.stdout_contents());
+    ATF_REQUIRE_EQ(2, iter.attempts());
+    ATF_REQUIRE_EQ(datetime::delta(1, 0), iter.usage().get().user_time);
+    ++iter;
+    ATF_REQUIRE(iter);
+    ATF_REQUIRE_EQ("second", iter.test_case_name());
+    ATF_REQUIRE_EQ(results1.find("second")->second, iter.result());
+    ++iter;
+    ATF_REQUIRE(iter);
+    ATF_REQUIRE_EQ("third", iter.test_case_name());
+    ATF_REQUIRE_EQ(results2.find("third")->second, iter.result());
+    ATF_REQUIRE_EQ("Same output\n", iter.stdout_contents());
+    ++iter;
+    ATF_REQUIRE(iter);
+    ATF_REQUIRE_EQ(fs::path("prog2"), iter.test_program()->relative_path());
+    ATF_REQUIRE_EQ("main", iter.test_case_name());
+    ATF_REQUIRE_EQ(results3.find("main")->second, iter.result());
+    ATF_REQUIRE_EQ("Other output\n", iter.stdout_contents());
+    ATF_REQUIRE_EQ(2, iter.attempts());
+    ATF_REQUIRE_EQ(datetime::delta(1, 0), iter.usage().get().user_time);
+    ++iter;
+    ATF_REQUIRE(!iter);
+    tx.finish();
+    backend.close();
+
+    ATF_REQUIRE_EQ(2, count_rows("merged.db", "test_programs"));
+    ATF_REQUIRE_EQ(4, count_rows("merged.db", "test_cases"));
+    ATF_REQUIRE_EQ(4, count_rows("merged.db", "test_attempts"));
+    ATF_REQUIRE_EQ(4, count_rows("merged.db", "test_resource_usage"));
+    ATF_REQUIRE_EQ(4, count_rows("merged.db", "test_cpu_affinity"));
+    ATF_REQUIRE_EQ(2, count_rows("merged.db", "files"));
+
+    sqlite::database db = sqlite::database::open(fs::path("merged.db"),
+                                                 sqlite::open_readonly);
+    sqlite::statement stmt = db.create_statement(
+        "SELECT COUNT(*) FROM test_attempts "
+        "    JOIN test_cases USING (test_case_id) "
+        "    JOIN files ON stdout_file_id == file_id");
+    ATF_REQUIRE(stmt.step());
+    ATF_REQUIRE_EQ(4, stmt.column_int64(0));
+}
+
+
+ATF_TEST_CASE(merge_results__missing_source);
+ATF_TEST_CASE_HEAD(merge_results__missing_source)
+{
+    logging::set_inmemory();
+    set_md_var("require.files", store::detail::schema_file().c_str());
+}
+ATF_TEST_CASE_BODY(merge_results__missing_source)
+{
+    const model::test_program program = model::test_program_builder(
+        "plain", fs::path("prog"), fs::path("/the/root"), "suite")
+        .add_test_case("main")
+        .build();
+    std::map< std::string, model::test_result > results;
+    results.insert(std::make_pair(
+        "main", model::test_result(model::test_result_passed)));
+    create_results_file("shard1.db", program, results, "");
+
+    std::vector< fs::path > sources;
+    sources.push_back(fs::path("shard1.db"));
+    sources.push_back(fs::path("missing.db"));
+    ATF_REQUIRE_THROW_RE(store::error, "missing.db",
+                         store::merge_results(sources, fs::path("merged.db")));
+    ATF_REQUIRE(!atf::utils::file_exists("merged.db"));
+}
+
+
+ATF_TEST_CASE(merge_results__target_exists);
+ATF_TEST_CASE_HEAD(merge_results__target_exists)
+{
+    logging::set_inmemory();
+    set_md_var("require.files", store::detail::schema_file().c_str());
+}
+ATF_TEST_CASE_BODY(merge_results__target_exists)
+{
+    const model::test_program program = model::test_program_builder(
+        "plain", fs::path("prog"), fs::path("/the/root"), "suite")
+        .add_test_case("main")
+        .build();
+    std::map< std::string, model::test_result > results;
+    results.insert(std::make_pair(
+        "main", model::test_result(model::test_result_passed)));
+    create_results_file("shard1.db", program, results, "");
+    create_results_file("merged.db", program, results, "");
+
+    std::vector< fs::path > sources;
+    sources.push_back(fs::path("shard1.db"));
+    ATF_REQUIRE_THROW_RE(store::error, "already exists",
+                         store::merge_results(sources, fs::path("merged.db")));
+    ATF_REQUIRE_EQ(1, count_rows("merged.db", "test_cases"));
+}
+
+
+ATF_INIT_TEST_CASES(tcs)
+{
+    ATF_ADD_TEST_CASE(tcs, merge_results__ok);
+    ATF_ADD_TEST_CASE(tcs, merge_results__missing_source);
+    ATF_ADD_TEST_CASE(tcs, merge_results__target_exists);
+}
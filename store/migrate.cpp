@@ -260,6 +260,10 @@ store::detail::backup_database(const fs::path& source, const int old_version)
 /// version implemented in this file.  This should permit upgrades from
 /// arbitrary old databases.
 ///
+/// Historical databases, which predate results files, are split into results
+/// files that are created with the current schema, so no further steps are
+/// needed for them once they have been chunked.
+///
 /// \param file The database whose schema to upgrade.
 ///
 /// \throw error If there is a problem with the migration.
@@ -282,6 +286,11 @@ store::migrate_schema(const utils::fs::path& file)
     for (i = version_from; i < first_chunked_schema_version - 1; ++i) {
         migrate_schema_step(file, i, i + 1);
     }
-    chunk_database(file);
-    INV(version_to == first_chunked_schema_version);
+    if (i < first_chunked_schema_version) {
+        chunk_database(file);
+        return;
+    }
+    for (; i < version_to; ++i) {
+        migrate_schema_step(file, i, i + 1);
+    }
 }
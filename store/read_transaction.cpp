@@ -34,6 +34,7 @@ extern "C" {
 
 #include <map>
 #include <utility>
+#include <vector>
 
 #include "model/context.hpp"
 #include "model/metadata.hpp"
@@ -49,16 +50,22 @@ extern "C" {
 #include "utils/logging/macros.hpp"
 #include "utils/noncopyable.hpp"
 #include "utils/optional.ipp"
+#include "utils/process/resource_usage.hpp"
 #include "utils/sanity.hpp"
 #include "utils/sqlite/database.hpp"
 #include "utils/sqlite/exceptions.hpp"
 #include "utils/sqlite/statement.ipp"
 #include "utils/sqlite/transaction.hpp"
+#include "utils/text/exceptions.hpp"
+#include "utils/text/operations.ipp"
 
 namespace datetime = utils::datetime;
 namespace fs = utils::fs;
 namespace sqlite = utils::sqlite;
+namespace text = utils::text;
+namespace units = utils::units;
 
+using utils::none;
 using utils::optional;
 
 
@@ -273,12 +280,30 @@ struct store::results_iterator::impl : utils::noncopyable {
             "    test_programs.interface, "
             "    test_cases.test_case_id, test_cases.name, "
             "    test_results.result_type, test_results.result_reason, "
-            "    test_results.start_time, test_results.end_time "
+            "    test_results.start_time, test_results.end_time, "
+            "    (SELECT COUNT(*) FROM test_attempts "
+            "     WHERE test_attempts.test_case_id = test_cases.test_case_id) "
+            "        + 1 AS attempts, "
+            "    test_resource_usage.user_time, "
+            "    test_resource_usage.system_time, "
+            "    test_resource_usage.max_rss, "
+            "    test_resource_usage.minor_faults, "
+            "    test_resource_usage.major_faults, "
+            "    test_resource_usage.block_inputs, "
+            "    test_resource_usage.block_outputs, "
+            "    test_resource_usage.voluntary_switches, "
+            "    test_resource_usage.involuntary_switches, "
+            "    test_cpu_affinity.cpus "
             "FROM test_programs "
             "    JOIN test_cases "
             "    ON test_programs.test_program_id = test_cases.test_program_id "
             "    JOIN test_results "
             "    ON test_cases.test_case_id = test_results.test_case_id "
+            "    LEFT OUTER JOIN test_resource_usage "
+            "    ON test_cases.test_case_id = "
+            "        test_resource_usage.test_case_id "
+            "    LEFT OUTER JOIN test_cpu_affinity "
+            "    ON test_cases.test_case_id = test_cpu_affinity.test_case_id "
             "ORDER BY test_programs.absolute_path, test_cases.name"))
     {
         _valid = _stmt.step();
@@ -383,6 +408,75 @@ store::results_iterator::end_time(void) const
 }
 
 
+/// Gets the number of times the test case was run.
+///
+/// \return 1 if the test case was run only once, or a higher number if it was
+/// retried after failing.  Only the result of the last attempt is reported by
+/// the other methods of this iterator.
+int
+store::results_iterator::attempts(void) const
+{
+    return static_cast< int >(_pimpl->_stmt.safe_column_int64("attempts"));
+}
+
+
+/// Gets the resources consumed by the last execution of the test case.
+///
+/// \return The resource usage, or none if it was not recorded; e.g. because
+/// the result of the test case was not obtained by running it.
+optional< utils::process::resource_usage >
+store::results_iterator::usage(void) const
+{
+    sqlite::statement& stmt = _pimpl->_stmt;
+    if (stmt.column_type(stmt.column_id("user_time")) == sqlite::type_null)
+        return none;
+
+    return utils::make_optional(utils::process::resource_usage(
+        store::column_delta(stmt, "user_time"),
+        store::column_delta(stmt, "system_time"),
+        units::bytes(static_cast< uint64_t >(
+            stmt.safe_column_int64("max_rss"))),
+        static_cast< uint64_t >(stmt.safe_column_int64("minor_faults")),
+        static_cast< uint64_t >(stmt.safe_column_int64("major_faults")),
+        static_cast< uint64_t >(stmt.safe_column_int64("block_inputs")),
+        static_cast< uint64_t >(stmt.safe_column_int64("block_outputs")),
+        static_cast< uint64_t >(stmt.safe_column_int64(
+            "voluntary_switches")),
+        static_cast< uint64_t >(stmt.safe_column_int64(
+            "involuntary_switches"))));
+}
+
+
+/// Gets the CPUs to which the last execution of the test case was pinned.
+///
+/// \return The identifiers of the CPUs, or an empty set if the test case was
+/// not pinned.
+///
+/// \throw integrity_error If the recorded CPUs are invalid.
+std::set< int >
+store::results_iterator::cpus(void) const
+{
+    std::set< int > cpus;
+
+    sqlite::statement& stmt = _pimpl->_stmt;
+    if (stmt.column_type(stmt.column_id("cpus")) == sqlite::type_null)
+        return cpus;
+
+    const std::vector< std::string > words = text::split(
+        stmt.safe_column_text("cpus"), ',');
+    for (std::vector< std::string >::const_iterator iter = words.begin();
+         iter != words.end(); ++iter) {
+        try {
+            cpus.insert(text::to_type< int >(*iter));
+        } catch (const text::value_error& e) {
+            throw store::integrity_error(F("Invalid CPU identifier '%s'") %
+                                         *iter);
+        }
+    }
+    return cpus;
+}
+
+
 /// Gets a file from a test case.
 ///
 /// \param db The database to query the file from.
@@ -38,6 +38,7 @@ extern "C" {
 #include <stdint.h>
 }
 
+#include <set>
 #include <string>
 
 #include "model/context_fwd.hpp"
@@ -46,6 +47,8 @@ extern "C" {
 #include "store/read_backend_fwd.hpp"
 #include "store/read_transaction_fwd.hpp"
 #include "utils/datetime_fwd.hpp"
+#include "utils/optional_fwd.hpp"
+#include "utils/process/resource_usage_fwd.hpp"
 #include "utils/shared_ptr.hpp"
 
 namespace store {
@@ -86,6 +89,9 @@ public:
     model::test_result result(void) const;
     utils::datetime::timestamp start_time(void) const;
     utils::datetime::timestamp end_time(void) const;
+    int attempts(void) const;
+    utils::optional< utils::process::resource_usage > usage(void) const;
+    std::set< int > cpus(void) const;
 
     std::string stdout_contents(void) const;
     std::string stderr_contents(void) const;
@@ -29,6 +29,7 @@
 #include "store/read_transaction.hpp"
 
 #include <map>
+#include <set>
 #include <string>
 
 #include <atf-c++.hpp>
@@ -45,13 +46,16 @@
 #include "utils/fs/path.hpp"
 #include "utils/logging/operations.hpp"
 #include "utils/optional.ipp"
+#include "utils/process/resource_usage.hpp"
 #include "utils/sqlite/database.hpp"
 #include "utils/sqlite/statement.ipp"
 
 namespace datetime = utils::datetime;
 namespace fs = utils::fs;
 namespace logging = utils::logging;
+namespace process = utils::process;
 namespace sqlite = utils::sqlite;
+namespace units = utils::units;
 
 
 ATF_TEST_CASE(get_context__missing);
@@ -200,13 +204,25 @@ ATF_TEST_CASE_BODY(get_results__many)
         .add_test_case("main")
         .build();
     const model::test_result result_1(model::test_result_passed);
+    const process::resource_usage usage_1(
+        datetime::delta(1, 500), datetime::delta(0, 250),
+        units::bytes(4 * units::MB), 10, 2, 30, 40, 5, 6);
+    std::set< int > cpus_1;
+    cpus_1.insert(5);
     {
         const int64_t tp_id = tx.put_test_program(test_program_1);
         const int64_t tc_id = tx.put_test_case(test_program_1, "main", tp_id);
         atf::utils::create_file("prog1.out", "stdout of prog1\n");
         tx.put_test_case_file("__STDOUT__", fs::path("prog1.out"), tc_id);
         tx.put_test_case_file("unused.txt", fs::path("unused.txt"), tc_id);
+        for (int i = 1; i <= 2; ++i)
+            tx.put_attempt(model::test_result(model::test_result_failed,
+                                              "Flaky"),
+                           tc_id, i, start_time1, start_time1,
+                           fs::path("unused.txt"), fs::path("unused.txt"));
         tx.put_result(result_1, tc_id, start_time1, end_time1);
+        tx.put_resource_usage(tc_id, usage_1);
+        tx.put_cpu_affinity(tc_id, cpus_1);
     }
 
     const model::test_program test_program_2 = model::test_program_builder(
@@ -239,6 +255,10 @@ ATF_TEST_CASE_BODY(get_results__many)
     ATF_REQUIRE_EQ(result_1, iter.result());
     ATF_REQUIRE_EQ(start_time1, iter.start_time());
     ATF_REQUIRE_EQ(end_time1, iter.end_time());
+    ATF_REQUIRE_EQ(3, iter.attempts());
+    ATF_REQUIRE(iter.usage());
+    ATF_REQUIRE_EQ(usage_1, iter.usage().get());
+    ATF_REQUIRE(cpus_1 == iter.cpus());
     ATF_REQUIRE(++iter);
     ATF_REQUIRE_EQ(test_program_2, *iter.test_program());
     ATF_REQUIRE_EQ("main", iter.test_case_name());
@@ -247,6 +267,9 @@ ATF_TEST_CASE_BODY(get_results__many)
     ATF_REQUIRE_EQ(result_2, iter.result());
     ATF_REQUIRE_EQ(start_time2, iter.start_time());
     ATF_REQUIRE_EQ(end_time2, iter.end_time());
+    ATF_REQUIRE_EQ(1, iter.attempts());
+    ATF_REQUIRE(!iter.usage());
+    ATF_REQUIRE(iter.cpus().empty());
     ATF_REQUIRE(!++iter);
 }
 
@@ -0,0 +1,261 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "store/result_cache.hpp"
+
+#include <stdexcept>
+
+#include "store/exceptions.hpp"
+#include "store/read_backend.hpp"
+#include "utils/format/macros.hpp"
+#include "utils/fs/path.hpp"
+#include "utils/logging/macros.hpp"
+#include "utils/noncopyable.hpp"
+#include "utils/optional.ipp"
+#include "utils/sqlite/database.hpp"
+#include "utils/sqlite/exceptions.hpp"
+#include "utils/sqlite/statement.ipp"
+#include "utils/stream.hpp"
+
+namespace fs = utils::fs;
+namespace sqlite = utils::sqlite;
+
+using utils::none;
+using utils::optional;
+
+
+namespace {
+
+
+/// Converts a BLOB column into a string.
+///
+/// \param blob The BLOB to convert.
+///
+/// \return The contents of the BLOB.
+static std::string
+blob_to_string(const sqlite::blob& blob)
+{
+    if (blob.size == 0)
+        return "";
+    return std::string(static_cast< const char* >(blob.memory), blob.size);
+}
+
+
+}  // anonymous namespace
+
+
+/// Opens a cache database and creates it if necessary.
+///
+/// Caches can be shared by concurrent invocations of Kyua.  They only hold data
+/// that can be regenerated, so we trade their durability on system crashes for
+/// not having to sync them to disk on every update.
+///
+/// \param file The database file holding the cache.
+///
+/// \return The opened database.
+///
+/// \throw store::error If there is a problem opening or creating the database.
+sqlite::database
+store::detail::open_cache(const fs::path& file)
+{
+    sqlite::database db = detail::open_and_setup(
+        file, sqlite::open_readwrite | sqlite::open_create);
+    try {
+        db.exec("PRAGMA busy_timeout = 60000");
+        db.exec("PRAGMA synchronous = OFF");
+        return db;
+    } catch (const sqlite::error& e) {
+        db.close();
+        throw error(F("Cannot set up cache %s: %s") % file % e.what());
+    }
+}
+
+
+/// Internal implementation for the result cache.
+struct store::result_cache::impl : utils::noncopyable {
+    /// The SQLite database holding the cache.
+    sqlite::database database;
+
+    /// Constructor.
+    ///
+    /// \param database_ The SQLite database instance.
+    impl(sqlite::database& database_) : database(database_)
+    {
+    }
+};
+
+
+/// Constructs a new result cache.
+///
+/// \param pimpl_ The internal data.
+store::result_cache::result_cache(impl* pimpl_) :
+    _pimpl(pimpl_)
+{
+}
+
+
+/// Destructor.
+store::result_cache::~result_cache(void)
+{
+}
+
+
+/// Opens the result cache and creates it if necessary.
+///
+/// \param file The database file holding the cache.
+///
+/// \return The cache representation.
+///
+/// \throw store::error If there is any problem opening or creating the cache.
+store::result_cache
+store::result_cache::open_rw(const fs::path& file)
+{
+    sqlite::database db = detail::open_cache(file);
+    try {
+        db.exec("CREATE TABLE IF NOT EXISTS cached_outputs ("
+                "    key TEXT PRIMARY KEY,"
+                "    stdout BLOB NOT NULL,"
+                "    stderr BLOB NOT NULL"
+                ")");
+    } catch (const sqlite::error& e) {
+        db.close();
+        throw error(F("Cannot initialize result cache %s: %s") % file %
+                    e.what());
+    }
+    return result_cache(new impl(db));
+}
+
+
+/// Closes the SQLite database.
+void
+store::result_cache::close(void)
+{
+    _pimpl->database.close();
+}
+
+
+/// Looks up the outputs of a passing execution of a test case.
+///
+/// \param key The key of the test case.
+///
+/// \return The cached outputs of the test case, or none if the test case has
+/// not passed with the given key before.
+///
+/// \throw store::error If there is any problem reading the cache.
+optional< store::cached_output >
+store::result_cache::lookup(const std::string& key)
+{
+    try {
+        sqlite::statement stmt = _pimpl->database.create_statement(
+            "SELECT stdout, stderr FROM cached_outputs WHERE key == :key");
+        stmt.bind(":key", key);
+        if (!stmt.step())
+            return none;
+        return utils::make_optional(cached_output(
+            blob_to_string(stmt.safe_column_blob("stdout")),
+            blob_to_string(stmt.safe_column_blob("stderr"))));
+    } catch (const sqlite::error& e) {
+        throw error(e.what());
+    }
+}
+
+
+/// Records the outputs of a passing execution of a test case.
+///
+/// \param key The key of the test case.
+/// \param output The outputs of the test.
+///
+/// \throw store::error If there is any problem writing to the cache.
+void
+store::result_cache::put(const std::string& key, const cached_output& output)
+{
+    LD(F("Caching outputs of test with key %s") % key);
+    try {
+        sqlite::statement stmt = _pimpl->database.create_statement(
+            "INSERT OR REPLACE INTO cached_outputs (key, stdout, stderr) "
+            "VALUES (:key, :stdout, :stderr)");
+        stmt.bind(":key", key);
+        stmt.bind(":stdout", sqlite::blob(output.stdout_contents.c_str(),
+                                          output.stdout_contents.length()));
+        stmt.bind(":stderr", sqlite::blob(output.stderr_contents.c_str(),
+                                          output.stderr_contents.length()));
+        stmt.step_without_results();
+    } catch (const sqlite::error& e) {
+        throw error(e.what());
+    }
+}
+
+
+/// Records the outputs of a passing execution of a test case.
+///
+/// \param key The key of the test case.
+/// \param stdout_path Path to the file containing the stdout of the test.
+/// \param stderr_path Path to the file containing the stderr of the test.
+///
+/// \throw store::error If there is any problem reading the outputs or writing
+///     to the cache.
+void
+store::result_cache::put(const std::string& key, const fs::path& stdout_path,
+                         const fs::path& stderr_path)
+{
+    std::string stdout_contents, stderr_contents;
+    try {
+        stdout_contents = utils::read_file(stdout_path);
+        stderr_contents = utils::read_file(stderr_path);
+    } catch (const std::runtime_error& e) {
+        throw error(F("Cannot cache outputs of test: %s") % e.what());
+    }
+    put(key, cached_output(stdout_contents, stderr_contents));
+}
+
+
+/// Removes all entries from the cache.
+///
+/// \return The number of removed entries.
+///
+/// \throw store::error If there is any problem writing to the cache.
+int64_t
+store::result_cache::clear(void)
+{
+    try {
+        int64_t count;
+        {
+            // The statement must be gone by the time we vacuum the database.
+            sqlite::statement stmt = _pimpl->database.create_statement(
+                "SELECT COUNT(*) AS count FROM cached_outputs");
+            (void)stmt.step();
+            count = stmt.safe_column_int64("count");
+        }
+
+        _pimpl->database.exec("DELETE FROM cached_outputs");
+        _pimpl->database.exec("VACUUM");
+        return count;
+    } catch (const sqlite::error& e) {
+        throw error(e.what());
+    }
+}
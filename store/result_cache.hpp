@@ -0,0 +1,109 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// \file store/result_cache.hpp
+/// Cache of the outputs of passing test cases.
+///
+/// The cache maps an opaque key that identifies a test case and everything
+/// its execution depends on to the outputs of a passing execution of it.  The
+/// computation of the keys is up to the caller.
+
+#if !defined(STORE_RESULT_CACHE_HPP)
+#define STORE_RESULT_CACHE_HPP
+
+extern "C" {
+#include <stdint.h>
+}
+
+#include <string>
+
+#include "utils/fs/path_fwd.hpp"
+#include "utils/optional_fwd.hpp"
+#include "utils/shared_ptr.hpp"
+#include "utils/sqlite/database_fwd.hpp"
+
+namespace store {
+
+
+namespace detail {
+
+
+utils::sqlite::database open_cache(const utils::fs::path&);
+
+
+}  // namespace detail
+
+
+/// Outputs of a test case recorded in the result cache.
+class cached_output {
+public:
+    /// Contents of the stdout of the test case.
+    std::string stdout_contents;
+
+    /// Contents of the stderr of the test case.
+    std::string stderr_contents;
+
+    /// Initializer for the tuple's fields.
+    ///
+    /// \param stdout_contents_ Contents of the stdout of the test case.
+    /// \param stderr_contents_ Contents of the stderr of the test case.
+    cached_output(const std::string& stdout_contents_,
+                  const std::string& stderr_contents_) :
+        stdout_contents(stdout_contents_),
+        stderr_contents(stderr_contents_)
+    {
+    }
+};
+
+
+/// Persistent cache of the outputs of passing test cases.
+class result_cache {
+    struct impl;
+
+    /// Pointer to the shared internal implementation.
+    std::shared_ptr< impl > _pimpl;
+
+    result_cache(impl*);
+
+public:
+    ~result_cache(void);
+
+    static result_cache open_rw(const utils::fs::path&);
+    void close(void);
+
+    utils::optional< cached_output > lookup(const std::string&);
+    void put(const std::string&, const cached_output&);
+    void put(const std::string&, const utils::fs::path&,
+             const utils::fs::path&);
+    int64_t clear(void);
+};
+
+
+}  // namespace store
+
+#endif  // !defined(STORE_RESULT_CACHE_HPP)
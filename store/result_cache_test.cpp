@@ -0,0 +1,173 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "store/result_cache.hpp"
+
+#include <string>
+
+#include <atf-c++.hpp>
+
+#include "store/exceptions.hpp"
+#include "utils/fs/path.hpp"
+#include "utils/logging/operations.hpp"
+#include "utils/optional.ipp"
+
+namespace fs = utils::fs;
+namespace logging = utils::logging;
+
+using utils::optional;
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(lookup__miss);
+ATF_TEST_CASE_BODY(lookup__miss)
+{
+    logging::set_inmemory();
+
+    store::result_cache cache = store::result_cache::open_rw(
+        fs::path("cache.db"));
+    ATF_REQUIRE(!cache.lookup("some-key"));
+    cache.close();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(put_and_lookup);
+ATF_TEST_CASE_BODY(put_and_lookup)
+{
+    logging::set_inmemory();
+
+    atf::utils::create_file("stdout.txt", "Some output\n");
+    atf::utils::create_file("stderr.txt", "");
+
+    {
+        store::result_cache cache = store::result_cache::open_rw(
+            fs::path("cache.db"));
+        cache.put("key1", fs::path("stdout.txt"), fs::path("stderr.txt"));
+        cache.put("key2", fs::path("stderr.txt"), fs::path("stdout.txt"));
+        cache.close();
+    }
+
+    store::result_cache cache = store::result_cache::open_rw(
+        fs::path("cache.db"));
+
+    const optional< store::cached_output > output1 = cache.lookup("key1");
+    ATF_REQUIRE(output1);
+    ATF_REQUIRE_EQ("Some output\n", output1.get().stdout_contents);
+    ATF_REQUIRE_EQ("", output1.get().stderr_contents);
+
+    const optional< store::cached_output > output2 = cache.lookup("key2");
+    ATF_REQUIRE(output2);
+    ATF_REQUIRE_EQ("", output2.get().stdout_contents);
+    ATF_REQUIRE_EQ("Some output\n", output2.get().stderr_contents);
+
+    ATF_REQUIRE(!cache.lookup("key3"));
+    cache.close();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(put__replace);
+ATF_TEST_CASE_BODY(put__replace)
+{
+    logging::set_inmemory();
+
+    atf::utils::create_file("first.txt", "first");
+    atf::utils::create_file("second.txt", "second");
+
+    store::result_cache cache = store::result_cache::open_rw(
+        fs::path("cache.db"));
+    cache.put("key", fs::path("first.txt"), fs::path("first.txt"));
+    cache.put("key", fs::path("second.txt"), fs::path("second.txt"));
+
+    const optional< store::cached_output > output = cache.lookup("key");
+    ATF_REQUIRE(output);
+    ATF_REQUIRE_EQ("second", output.get().stdout_contents);
+    cache.close();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(put__contents);
+ATF_TEST_CASE_BODY(put__contents)
+{
+    logging::set_inmemory();
+
+    store::result_cache cache = store::result_cache::open_rw(
+        fs::path("cache.db"));
+    cache.put("key", store::cached_output("the stdout", "the stderr"));
+
+    const optional< store::cached_output > output = cache.lookup("key");
+    ATF_REQUIRE(output);
+    ATF_REQUIRE_EQ("the stdout", output.get().stdout_contents);
+    ATF_REQUIRE_EQ("the stderr", output.get().stderr_contents);
+    cache.close();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(put__missing_file);
+ATF_TEST_CASE_BODY(put__missing_file)
+{
+    logging::set_inmemory();
+
+    atf::utils::create_file("stdout.txt", "");
+
+    store::result_cache cache = store::result_cache::open_rw(
+        fs::path("cache.db"));
+    ATF_REQUIRE_THROW_RE(store::error, "Cannot cache",
+                         cache.put("key", fs::path("stdout.txt"),
+                                   fs::path("missing.txt")));
+    ATF_REQUIRE(!cache.lookup("key"));
+    cache.close();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(clear);
+ATF_TEST_CASE_BODY(clear)
+{
+    logging::set_inmemory();
+
+    atf::utils::create_file("output.txt", "");
+
+    store::result_cache cache = store::result_cache::open_rw(
+        fs::path("cache.db"));
+    ATF_REQUIRE_EQ(0, cache.clear());
+    cache.put("key1", fs::path("output.txt"), fs::path("output.txt"));
+    cache.put("key2", fs::path("output.txt"), fs::path("output.txt"));
+    ATF_REQUIRE_EQ(2, cache.clear());
+    ATF_REQUIRE(!cache.lookup("key1"));
+    ATF_REQUIRE(!cache.lookup("key2"));
+    cache.close();
+}
+
+
+ATF_INIT_TEST_CASES(tcs)
+{
+    ATF_ADD_TEST_CASE(tcs, lookup__miss);
+    ATF_ADD_TEST_CASE(tcs, put_and_lookup);
+    ATF_ADD_TEST_CASE(tcs, put__replace);
+    ATF_ADD_TEST_CASE(tcs, put__contents);
+    ATF_ADD_TEST_CASE(tcs, put__missing_file);
+    ATF_ADD_TEST_CASE(tcs, clear);
+}
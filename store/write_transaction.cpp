@@ -50,16 +50,19 @@ extern "C" {
 #include "utils/logging/macros.hpp"
 #include "utils/noncopyable.hpp"
 #include "utils/optional.ipp"
+#include "utils/process/resource_usage.hpp"
 #include "utils/sanity.hpp"
 #include "utils/stream.hpp"
 #include "utils/sqlite/database.hpp"
 #include "utils/sqlite/exceptions.hpp"
 #include "utils/sqlite/statement.ipp"
 #include "utils/sqlite/transaction.hpp"
+#include "utils/text/operations.ipp"
 
 namespace datetime = utils::datetime;
 namespace fs = utils::fs;
 namespace sqlite = utils::sqlite;
+namespace text = utils::text;
 
 using utils::none;
 using utils::optional;
@@ -142,6 +145,29 @@ put_metadata(sqlite::database& db, const model::metadata& md)
 }
 
 
+/// Stores arbitrary contents into the database as a BLOB.
+///
+/// \param db The database into which to store the contents.
+/// \param contents The contents to be stored.
+///
+/// \return The identifier of the stored contents, or none if they were empty.
+///
+/// \throw sqlite::error If there are problems writing to the database.
+static optional< int64_t >
+put_contents(sqlite::database& db, const std::string& contents)
+{
+    if (contents.empty())
+        return none;
+
+    sqlite::statement stmt = db.create_statement(
+        "INSERT INTO files (contents) VALUES (:contents)");
+    stmt.bind(":contents", sqlite::blob(contents.c_str(), contents.length()));
+    stmt.step_without_results();
+
+    return optional< int64_t >(db.last_insert_rowid());
+}
+
+
 /// Stores an arbitrary file into the database as a BLOB.
 ///
 /// \param db The database into which to store the file.
@@ -171,14 +197,32 @@ put_file(sqlite::database& db, const fs::path& path)
     // consumption if we decide to store arbitrary files in the database (other
     // than stdout or stderr).  Should this happen, we need to investigate a
     // better way to feel blobs into SQLite.
-    const std::string contents = utils::read_stream(input);
+    return put_contents(db, utils::read_stream(input));
+}
 
+
+/// Links a stored file to a test case.
+///
+/// \param db The database into which to store the link.
+/// \param name The name of the file within the test case.
+/// \param file_id The identifier of the stored file.
+/// \param test_case_id The identifier of the test case.
+///
+/// \return The identifier of the link.
+///
+/// \throw sqlite::error If there are problems writing to the database.
+static int64_t
+put_test_case_file_id(sqlite::database& db, const std::string& name,
+                      const int64_t file_id, const int64_t test_case_id)
+{
     sqlite::statement stmt = db.create_statement(
-        "INSERT INTO files (contents) VALUES (:contents)");
-    stmt.bind(":contents", sqlite::blob(contents.c_str(), contents.length()));
+        "INSERT INTO test_case_files (test_case_id, file_name, file_id) "
+        "VALUES (:test_case_id, :file_name, :file_id)");
+    stmt.bind(":test_case_id", test_case_id);
+    stmt.bind(":file_name", name);
+    stmt.bind(":file_id", file_id);
     stmt.step_without_results();
-
-    return optional< int64_t >(db.last_insert_rowid());
+    return db.last_insert_rowid();
 }
 
 
@@ -378,15 +422,43 @@ store::write_transaction::put_test_case_file(const std::string& name,
             return none;
         }
 
-        sqlite::statement stmt = _pimpl->_db.create_statement(
-            "INSERT INTO test_case_files (test_case_id, file_name, file_id) "
-            "VALUES (:test_case_id, :file_name, :file_id)");
-        stmt.bind(":test_case_id", test_case_id);
-        stmt.bind(":file_name", name);
-        stmt.bind(":file_id", file_id.get());
-        stmt.step_without_results();
+        return optional< int64_t >(put_test_case_file_id(
+            _pimpl->_db, name, file_id.get(), test_case_id));
+    } catch (const sqlite::error& e) {
+        throw error(e.what());
+    }
+}
+
 
-        return optional< int64_t >(_pimpl->_db.last_insert_rowid());
+/// Stores the contents of a file generated by a test case as a BLOB.
+///
+/// This is the same as put_test_case_file() but for contents that are already
+/// in memory, such as those of a previous run of the test case.
+///
+/// \param name The name of the file to store in the database.  This needs to be
+///     unique per test case.
+/// \param contents The contents of the file.
+/// \param test_case_id The identifier of the test case this file belongs to.
+///
+/// \return The identifier of the stored file, or none if the file was empty.
+///
+/// \throw store::error If there are problems writing to the database.
+optional< int64_t >
+store::write_transaction::put_test_case_contents(const std::string& name,
+                                                 const std::string& contents,
+                                                 const int64_t test_case_id)
+{
+    LD(F("Storing %s of test case %s") % name % test_case_id);
+    try {
+        const optional< int64_t > file_id = put_contents(_pimpl->_db,
+                                                         contents);
+        if (!file_id) {
+            LD("Not storing empty file");
+            return none;
+        }
+
+        return optional< int64_t >(put_test_case_file_id(
+            _pimpl->_db, name, file_id.get(), test_case_id));
     } catch (const sqlite::error& e) {
         throw error(e.what());
     }
@@ -438,3 +510,146 @@ store::write_transaction::put_result(const model::test_result& result,
         throw error(e.what());
     }
 }
+
+
+/// Puts a superseded attempt at running a test case into the database.
+///
+/// Test cases that are retried after a failure only get one result in
+/// test_results, which belongs to their last attempt.  The previous attempts
+/// are recorded with this method, together with their output, so that they
+/// can be inspected later on.
+///
+/// \pre The test case has been put already.
+///
+/// \param result The result of the attempt.
+/// \param test_case_id The test case this attempt corresponds to.
+/// \param attempt The number of the attempt, starting at 1.
+/// \param start_time The time when the attempt started to run.
+/// \param end_time The time when the attempt finished running.
+/// \param stdout_path Path to the file with the stdout of the attempt.
+/// \param stderr_path Path to the file with the stderr of the attempt.
+///
+/// \throw error If there is any problem when talking to the database.
+void
+store::write_transaction::put_attempt(const model::test_result& result,
+                                      const int64_t test_case_id,
+                                      const int attempt,
+                                      const datetime::timestamp& start_time,
+                                      const datetime::timestamp& end_time,
+                                      const fs::path& stdout_path,
+                                      const fs::path& stderr_path)
+{
+    PRE(attempt >= 1);
+
+    try {
+        const optional< int64_t > stdout_id = put_file(_pimpl->_db,
+                                                       stdout_path);
+        const optional< int64_t > stderr_id = put_file(_pimpl->_db,
+                                                       stderr_path);
+
+        sqlite::statement stmt = _pimpl->_db.create_statement(
+            "INSERT INTO test_attempts (test_case_id, attempt, result_type, "
+            "                           result_reason, start_time, "
+            "                           end_time, stdout_file_id, "
+            "                           stderr_file_id) "
+            "VALUES (:test_case_id, :attempt, :result_type, :result_reason, "
+            "        :start_time, :end_time, :stdout_file_id, "
+            "        :stderr_file_id)");
+        stmt.bind(":test_case_id", test_case_id);
+        stmt.bind(":attempt", attempt);
+
+        store::bind_test_result_type(stmt, ":result_type", result.type());
+        if (result.reason().empty())
+            stmt.bind(":result_reason", sqlite::null());
+        else
+            stmt.bind(":result_reason", result.reason());
+
+        store::bind_timestamp(stmt, ":start_time", start_time);
+        store::bind_timestamp(stmt, ":end_time", end_time);
+
+        if (stdout_id)
+            stmt.bind(":stdout_file_id", stdout_id.get());
+        else
+            stmt.bind(":stdout_file_id", sqlite::null());
+        if (stderr_id)
+            stmt.bind(":stderr_file_id", stderr_id.get());
+        else
+            stmt.bind(":stderr_file_id", sqlite::null());
+
+        stmt.step_without_results();
+    } catch (const sqlite::error& e) {
+        throw error(e.what());
+    }
+}
+
+
+/// Puts the resources consumed by a test case into the database.
+///
+/// \pre The test case has been put already.
+///
+/// \param test_case_id The test case the resource usage belongs to.
+/// \param usage The resources consumed by the last execution of the test case.
+///
+/// \throw error If there is any problem when talking to the database.
+void
+store::write_transaction::put_resource_usage(
+    const int64_t test_case_id, const utils::process::resource_usage& usage)
+{
+    try {
+        sqlite::statement stmt = _pimpl->_db.create_statement(
+            "INSERT INTO test_resource_usage (test_case_id, user_time, "
+            "                                 system_time, max_rss, "
+            "                                 minor_faults, major_faults, "
+            "                                 block_inputs, block_outputs, "
+            "                                 voluntary_switches, "
+            "                                 involuntary_switches) "
+            "VALUES (:test_case_id, :user_time, :system_time, :max_rss, "
+            "        :minor_faults, :major_faults, :block_inputs, "
+            "        :block_outputs, :voluntary_switches, "
+            "        :involuntary_switches)");
+        stmt.bind(":test_case_id", test_case_id);
+        store::bind_delta(stmt, ":user_time", usage.user_time);
+        store::bind_delta(stmt, ":system_time", usage.system_time);
+        stmt.bind(":max_rss", static_cast< int64_t >(usage.max_rss));
+        stmt.bind(":minor_faults", static_cast< int64_t >(usage.minor_faults));
+        stmt.bind(":major_faults", static_cast< int64_t >(usage.major_faults));
+        stmt.bind(":block_inputs", static_cast< int64_t >(usage.block_inputs));
+        stmt.bind(":block_outputs",
+                  static_cast< int64_t >(usage.block_outputs));
+        stmt.bind(":voluntary_switches",
+                  static_cast< int64_t >(usage.voluntary_switches));
+        stmt.bind(":involuntary_switches",
+                  static_cast< int64_t >(usage.involuntary_switches));
+        stmt.step_without_results();
+    } catch (const sqlite::error& e) {
+        throw error(e.what());
+    }
+}
+
+
+/// Puts the CPUs to which a test case was pinned into the database.
+///
+/// \pre The test case has been put already.
+/// \pre The set of CPUs is not empty.
+///
+/// \param test_case_id The test case the CPUs belong to.
+/// \param cpus The identifiers of the CPUs.
+///
+/// \throw error If there is any problem when talking to the database.
+void
+store::write_transaction::put_cpu_affinity(const int64_t test_case_id,
+                                           const std::set< int >& cpus)
+{
+    PRE(!cpus.empty());
+
+    try {
+        sqlite::statement stmt = _pimpl->_db.create_statement(
+            "INSERT INTO test_cpu_affinity (test_case_id, cpus) "
+            "VALUES (:test_case_id, :cpus)");
+        stmt.bind(":test_case_id", test_case_id);
+        stmt.bind(":cpus", text::join(cpus, ","));
+        stmt.step_without_results();
+    } catch (const sqlite::error& e) {
+        throw error(e.what());
+    }
+}
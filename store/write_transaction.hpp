@@ -38,6 +38,7 @@ extern "C" {
 #include <stdint.h>
 }
 
+#include <set>
 #include <string>
 
 #include "model/context_fwd.hpp"
@@ -47,6 +48,7 @@ extern "C" {
 #include "utils/datetime_fwd.hpp"
 #include "utils/fs/path_fwd.hpp"
 #include "utils/optional_fwd.hpp"
+#include "utils/process/resource_usage_fwd.hpp"
 #include "utils/shared_ptr.hpp"
 
 namespace store {
@@ -78,9 +80,19 @@ public:
     utils::optional< int64_t > put_test_case_file(const std::string&,
                                                   const utils::fs::path&,
                                                   const int64_t);
+    utils::optional< int64_t > put_test_case_contents(const std::string&,
+                                                      const std::string&,
+                                                      const int64_t);
     int64_t put_result(const model::test_result&, const int64_t,
                        const utils::datetime::timestamp&,
                        const utils::datetime::timestamp&);
+    void put_attempt(const model::test_result&, const int64_t, const int,
+                     const utils::datetime::timestamp&,
+                     const utils::datetime::timestamp&,
+                     const utils::fs::path&, const utils::fs::path&);
+    void put_resource_usage(const int64_t,
+                            const utils::process::resource_usage&);
+    void put_cpu_affinity(const int64_t, const std::set< int >&);
 };
 
 
@@ -30,6 +30,7 @@
 
 #include <cstring>
 #include <map>
+#include <set>
 #include <string>
 
 #include <atf-c++.hpp>
@@ -45,6 +46,7 @@
 #include "utils/fs/path.hpp"
 #include "utils/logging/operations.hpp"
 #include "utils/optional.ipp"
+#include "utils/process/resource_usage.hpp"
 #include "utils/sqlite/database.hpp"
 #include "utils/sqlite/exceptions.hpp"
 #include "utils/sqlite/statement.ipp"
@@ -52,7 +54,9 @@
 namespace datetime = utils::datetime;
 namespace fs = utils::fs;
 namespace logging = utils::logging;
+namespace process = utils::process;
 namespace sqlite = utils::sqlite;
+namespace units = utils::units;
 
 using utils::optional;
 
@@ -310,6 +314,61 @@ ATF_TEST_CASE_BODY(put_test_case_file__fail)
 }
 
 
+ATF_TEST_CASE(put_test_case_contents__empty);
+ATF_TEST_CASE_HEAD(put_test_case_contents__empty)
+{
+    logging::set_inmemory();
+    set_md_var("require.files", store::detail::schema_file().c_str());
+}
+ATF_TEST_CASE_BODY(put_test_case_contents__empty)
+{
+    store::write_backend backend = store::write_backend::open_rw(
+        fs::path("test.db"));
+    backend.database().exec("PRAGMA foreign_keys = OFF");
+    store::write_transaction tx = backend.start_write();
+    const optional< int64_t > file_id = tx.put_test_case_contents(
+        "my-file", "", 123L);
+    tx.commit();
+    ATF_REQUIRE(!file_id);
+
+    sqlite::statement stmt = backend.database().create_statement(
+        "SELECT * FROM test_case_files NATURAL JOIN files");
+    ATF_REQUIRE(!stmt.step());
+}
+
+
+ATF_TEST_CASE(put_test_case_contents__some);
+ATF_TEST_CASE_HEAD(put_test_case_contents__some)
+{
+    logging::set_inmemory();
+    set_md_var("require.files", store::detail::schema_file().c_str());
+}
+ATF_TEST_CASE_BODY(put_test_case_contents__some)
+{
+    const std::string contents("Binary\0contents", 15);
+
+    store::write_backend backend = store::write_backend::open_rw(
+        fs::path("test.db"));
+    backend.database().exec("PRAGMA foreign_keys = OFF");
+    store::write_transaction tx = backend.start_write();
+    const optional< int64_t > file_id = tx.put_test_case_contents(
+        "my-file", contents, 123L);
+    tx.commit();
+    ATF_REQUIRE(file_id);
+
+    sqlite::statement stmt = backend.database().create_statement(
+        "SELECT * FROM test_case_files NATURAL JOIN files");
+
+    ATF_REQUIRE(stmt.step());
+    ATF_REQUIRE_EQ(123L, stmt.safe_column_int64("test_case_id"));
+    ATF_REQUIRE_EQ("my-file", stmt.safe_column_text("file_name"));
+    const sqlite::blob blob = stmt.safe_column_blob("contents");
+    ATF_REQUIRE(contents.length() == static_cast< std::size_t >(blob.size));
+    ATF_REQUIRE(std::memcmp(contents.c_str(), blob.memory, blob.size) == 0);
+    ATF_REQUIRE(!stmt.step());
+}
+
+
 ATF_TEST_CASE(put_result__ok__broken);
 ATF_TEST_CASE_HEAD(put_result__ok__broken)
 {
@@ -395,6 +454,185 @@ ATF_TEST_CASE_BODY(put_result__fail)
 }
 
 
+ATF_TEST_CASE(put_attempt__ok);
+ATF_TEST_CASE_HEAD(put_attempt__ok)
+{
+    logging::set_inmemory();
+    set_md_var("require.files", store::detail::schema_file().c_str());
+}
+ATF_TEST_CASE_BODY(put_attempt__ok)
+{
+    atf::utils::create_file("stdout.txt", "The output");
+    atf::utils::create_file("stderr.txt", "");
+
+    store::write_backend backend = store::write_backend::open_rw(
+        fs::path("test.db"));
+    backend.database().exec("PRAGMA foreign_keys = OFF");
+    store::write_transaction tx = backend.start_write();
+    const datetime::timestamp start_time = datetime::timestamp::from_values(
+        2012, 01, 30, 22, 10, 00, 0);
+    const datetime::timestamp end_time = datetime::timestamp::from_values(
+        2012, 01, 30, 22, 15, 30, 123456);
+    tx.put_attempt(model::test_result(model::test_result_failed, "Oops"),
+                   312, 1, start_time, end_time,
+                   fs::path("stdout.txt"), fs::path("stderr.txt"));
+    tx.put_attempt(model::test_result(model::test_result_broken, "Crash"),
+                   312, 2, start_time, end_time,
+                   fs::path("stderr.txt"), fs::path("stderr.txt"));
+    tx.commit();
+
+    sqlite::statement stmt = backend.database().create_statement(
+        "SELECT test_case_id, attempt, result_type, result_reason, "
+        "    contents, stderr_file_id "
+        "FROM test_attempts "
+        "    LEFT OUTER JOIN files ON stdout_file_id == file_id "
+        "ORDER BY attempt");
+
+    ATF_REQUIRE(stmt.step());
+    ATF_REQUIRE_EQ(312, stmt.column_int64(0));
+    ATF_REQUIRE_EQ(1, stmt.column_int(1));
+    ATF_REQUIRE_EQ("failed", stmt.column_text(2));
+    ATF_REQUIRE_EQ("Oops", stmt.column_text(3));
+    const sqlite::blob blob = stmt.column_blob(4);
+    ATF_REQUIRE(std::strlen("The output") ==
+                static_cast< std::size_t >(blob.size));
+    ATF_REQUIRE(std::memcmp("The output", blob.memory, blob.size) == 0);
+    ATF_REQUIRE(stmt.column_type(5) == sqlite::type_null);
+
+    ATF_REQUIRE(stmt.step());
+    ATF_REQUIRE_EQ(312, stmt.column_int64(0));
+    ATF_REQUIRE_EQ(2, stmt.column_int(1));
+    ATF_REQUIRE_EQ("broken", stmt.column_text(2));
+    ATF_REQUIRE_EQ("Crash", stmt.column_text(3));
+    ATF_REQUIRE(stmt.column_type(4) == sqlite::type_null);
+    ATF_REQUIRE(stmt.column_type(5) == sqlite::type_null);
+
+    ATF_REQUIRE(!stmt.step());
+}
+
+
+ATF_TEST_CASE(put_attempt__fail);
+ATF_TEST_CASE_HEAD(put_attempt__fail)
+{
+    logging::set_inmemory();
+    set_md_var("require.files", store::detail::schema_file().c_str());
+}
+ATF_TEST_CASE_BODY(put_attempt__fail)
+{
+    const model::test_result result(model::test_result_broken, "foo");
+
+    store::write_backend backend = store::write_backend::open_rw(
+        fs::path("test.db"));
+    store::write_transaction tx = backend.start_write();
+    const datetime::timestamp zero = datetime::timestamp::from_microseconds(0);
+    ATF_REQUIRE_THROW(store::error,
+                      tx.put_attempt(result, -1, 1, zero, zero,
+                                     fs::path("missing"), fs::path("missing")));
+    tx.commit();
+}
+
+
+ATF_TEST_CASE(put_resource_usage__ok);
+ATF_TEST_CASE_HEAD(put_resource_usage__ok)
+{
+    logging::set_inmemory();
+    set_md_var("require.files", store::detail::schema_file().c_str());
+}
+ATF_TEST_CASE_BODY(put_resource_usage__ok)
+{
+    store::write_backend backend = store::write_backend::open_rw(
+        fs::path("test.db"));
+    backend.database().exec("PRAGMA foreign_keys = OFF");
+    store::write_transaction tx = backend.start_write();
+    tx.put_resource_usage(312, process::resource_usage(
+        datetime::delta(3, 5), datetime::delta(1, 20),
+        units::bytes(2 * units::MB), 100, 1, 8, 16, 42, 7));
+    tx.commit();
+
+    sqlite::statement stmt = backend.database().create_statement(
+        "SELECT test_case_id, user_time, system_time, max_rss, "
+        "    minor_faults, major_faults, block_inputs, block_outputs, "
+        "    voluntary_switches, involuntary_switches "
+        "FROM test_resource_usage");
+
+    ATF_REQUIRE(stmt.step());
+    ATF_REQUIRE_EQ(312, stmt.column_int64(0));
+    ATF_REQUIRE_EQ(3000005, stmt.column_int64(1));
+    ATF_REQUIRE_EQ(1000020, stmt.column_int64(2));
+    ATF_REQUIRE_EQ(2 * 1024 * 1024, stmt.column_int64(3));
+    ATF_REQUIRE_EQ(100, stmt.column_int64(4));
+    ATF_REQUIRE_EQ(1, stmt.column_int64(5));
+    ATF_REQUIRE_EQ(8, stmt.column_int64(6));
+    ATF_REQUIRE_EQ(16, stmt.column_int64(7));
+    ATF_REQUIRE_EQ(42, stmt.column_int64(8));
+    ATF_REQUIRE_EQ(7, stmt.column_int64(9));
+    ATF_REQUIRE(!stmt.step());
+}
+
+
+ATF_TEST_CASE(put_resource_usage__fail);
+ATF_TEST_CASE_HEAD(put_resource_usage__fail)
+{
+    logging::set_inmemory();
+    set_md_var("require.files", store::detail::schema_file().c_str());
+}
+ATF_TEST_CASE_BODY(put_resource_usage__fail)
+{
+    store::write_backend backend = store::write_backend::open_rw(
+        fs::path("test.db"));
+    store::write_transaction tx = backend.start_write();
+    ATF_REQUIRE_THROW(store::error,
+                      tx.put_resource_usage(-1, process::resource_usage()));
+    tx.commit();
+}
+
+
+ATF_TEST_CASE(put_cpu_affinity__ok);
+ATF_TEST_CASE_HEAD(put_cpu_affinity__ok)
+{
+    logging::set_inmemory();
+    set_md_var("require.files", store::detail::schema_file().c_str());
+}
+ATF_TEST_CASE_BODY(put_cpu_affinity__ok)
+{
+    store::write_backend backend = store::write_backend::open_rw(
+        fs::path("test.db"));
+    backend.database().exec("PRAGMA foreign_keys = OFF");
+    store::write_transaction tx = backend.start_write();
+    std::set< int > cpus;
+    cpus.insert(12);
+    cpus.insert(3);
+    tx.put_cpu_affinity(312, cpus);
+    tx.commit();
+
+    sqlite::statement stmt = backend.database().create_statement(
+        "SELECT test_case_id, cpus FROM test_cpu_affinity");
+
+    ATF_REQUIRE(stmt.step());
+    ATF_REQUIRE_EQ(312, stmt.column_int64(0));
+    ATF_REQUIRE_EQ("3,12", stmt.column_text(1));
+    ATF_REQUIRE(!stmt.step());
+}
+
+
+ATF_TEST_CASE(put_cpu_affinity__fail);
+ATF_TEST_CASE_HEAD(put_cpu_affinity__fail)
+{
+    logging::set_inmemory();
+    set_md_var("require.files", store::detail::schema_file().c_str());
+}
+ATF_TEST_CASE_BODY(put_cpu_affinity__fail)
+{
+    store::write_backend backend = store::write_backend::open_rw(
+        fs::path("test.db"));
+    store::write_transaction tx = backend.start_write();
+    std::set< int > cpus;
+    cpus.insert(0);
+    ATF_REQUIRE_THROW(store::error, tx.put_cpu_affinity(-1, cpus));
+    tx.commit();
+}
+
+
 ATF_INIT_TEST_CASES(tcs)
 {
     ATF_ADD_TEST_CASE(tcs, commit__ok);
@@ -406,6 +644,8 @@ ATF_INIT_TEST_CASES(tcs)
     ATF_ADD_TEST_CASE(tcs, put_test_case_file__empty);
     ATF_ADD_TEST_CASE(tcs, put_test_case_file__some);
     ATF_ADD_TEST_CASE(tcs, put_test_case_file__fail);
+    ATF_ADD_TEST_CASE(tcs, put_test_case_contents__empty);
+    ATF_ADD_TEST_CASE(tcs, put_test_case_contents__some);
 
     ATF_ADD_TEST_CASE(tcs, put_result__ok__broken);
     ATF_ADD_TEST_CASE(tcs, put_result__ok__expected_failure);
@@ -413,4 +653,12 @@ ATF_INIT_TEST_CASES(tcs)
     ATF_ADD_TEST_CASE(tcs, put_result__ok__passed);
     ATF_ADD_TEST_CASE(tcs, put_result__ok__skipped);
     ATF_ADD_TEST_CASE(tcs, put_result__fail);
+
+    ATF_ADD_TEST_CASE(tcs, put_attempt__ok);
+    ATF_ADD_TEST_CASE(tcs, put_attempt__fail);
+
+    ATF_ADD_TEST_CASE(tcs, put_resource_usage__ok);
+    ATF_ADD_TEST_CASE(tcs, put_resource_usage__fail);
+    ATF_ADD_TEST_CASE(tcs, put_cpu_affinity__ok);
+    ATF_ADD_TEST_CASE(tcs, put_cpu_affinity__fail);
 }
@@ -48,6 +48,7 @@ extern "C" {
 
 #include <atf-c++.hpp>
 
+#include "utils/datetime.hpp"
 #include "utils/env.hpp"
 #include "utils/format/containers.ipp"
 #include "utils/format/macros.hpp"
@@ -59,6 +60,7 @@ extern "C" {
 #include "utils/stream.hpp"
 #include "utils/units.hpp"
 
+namespace datetime = utils::datetime;
 namespace fs = utils::fs;
 namespace passwd = utils::passwd;
 namespace units = utils::units;
@@ -664,6 +666,59 @@ ATF_TEST_CASE_BODY(rm_r__files_and_directories)
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(rm_r__symlinks);
+ATF_TEST_CASE_BODY(rm_r__symlinks)
+{
+    fs::mkdir(fs::path("target"), 0755);
+    atf::utils::create_file("target/keep", "");
+    fs::mkdir(fs::path("root"), 0755);
+    ATF_REQUIRE(::symlink("../target", "root/dir-link") != -1);
+    ATF_REQUIRE(::symlink("../target/keep", "root/file-link") != -1);
+    ATF_REQUIRE(::symlink("missing", "root/dangling-link") != -1);
+    fs::rm_r(fs::path("root"));
+    ATF_REQUIRE(!lookup(".", "root", S_IFDIR));
+    ATF_REQUIRE(lookup("target", "keep", S_IFREG));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(rm_r__fail);
+ATF_TEST_CASE_BODY(rm_r__fail)
+{
+    ATF_REQUIRE_THROW_RE(fs::system_error, "Failed to open directory missing",
+                         fs::rm_r(fs::path("missing")));
+}
+
+
+ATF_TEST_CASE(rm_r__benchmark);
+ATF_TEST_CASE_HEAD(rm_r__benchmark)
+{
+    set_md_var("descr", "Measures the removal of a tree with 100k files");
+    set_md_var("require.config", "run_benchmarks");
+    set_md_var("timeout", "600");
+}
+ATF_TEST_CASE_BODY(rm_r__benchmark)
+{
+    const int ndirs = 100;
+    const int nfiles = 1000;
+
+    fs::mkdir(fs::path("root"), 0755);
+    for (int i = 0; i < ndirs; ++i) {
+        const fs::path dir = fs::path("root") / (F("dir%s") % i);
+        fs::mkdir(dir, 0755);
+        for (int j = 0; j < nfiles; ++j)
+            atf::utils::create_file((dir / (F("file%s") % j)).str(), "");
+    }
+
+    const datetime::timestamp start = datetime::timestamp::now();
+    fs::rm_r(fs::path("root"));
+    const datetime::timestamp end = datetime::timestamp::now();
+
+    ATF_REQUIRE(!lookup(".", "root", S_IFDIR));
+    std::cout << F("Removed %s files in %s microseconds\n") %
+        (ndirs * nfiles) % (end - start).to_microseconds();
+}
+
+
 ATF_TEST_CASE_WITHOUT_HEAD(rmdir__ok)
 ATF_TEST_CASE_BODY(rmdir__ok)
 {
@@ -811,6 +866,9 @@ ATF_INIT_TEST_CASES(tcs)
 
     ATF_ADD_TEST_CASE(tcs, rm_r__empty);
     ATF_ADD_TEST_CASE(tcs, rm_r__files_and_directories);
+    ATF_ADD_TEST_CASE(tcs, rm_r__symlinks);
+    ATF_ADD_TEST_CASE(tcs, rm_r__fail);
+    ATF_ADD_TEST_CASE(tcs, rm_r__benchmark);
 
     ATF_ADD_TEST_CASE(tcs, rmdir__ok);
     ATF_ADD_TEST_CASE(tcs, rmdir__fail);
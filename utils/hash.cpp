@@ -0,0 +1,81 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include "utils/hash.hpp"
+
+
+/// Computes the 32-bit FNV-1a hash of a string.
+///
+/// \param str The string to hash.
+///
+/// \return The hash of the string.
+uint32_t
+utils::fnv1a_32(const std::string& str)
+{
+    uint32_t hash = fnv1a_32_basis;
+    for (std::string::const_iterator iter = str.begin(); iter != str.end();
+         ++iter) {
+        hash ^= static_cast< unsigned char >(*iter);
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+
+/// Feeds data into a 64-bit FNV-1a hash.
+///
+/// This allows hashing data that is not available all at once, such as the
+/// contents of a file read in chunks: start with fnv1a_64_basis and pass the
+/// result of every call to the next one.
+///
+/// \param hash The hash of the preceding data.
+/// \param data The data to hash.
+/// \param length The length of the data.
+///
+/// \return The hash of the preceding data followed by the new data.
+uint64_t
+utils::fnv1a_64(uint64_t hash, const void* data, const std::size_t length)
+{
+    const unsigned char* bytes = static_cast< const unsigned char* >(data);
+    for (std::size_t i = 0; i < length; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+
+/// Computes the 64-bit FNV-1a hash of a string.
+///
+/// \param str The string to hash.
+///
+/// \return The hash of the string.
+uint64_t
+utils::fnv1a_64(const std::string& str)
+{
+    return fnv1a_64(fnv1a_64_basis, str.c_str(), str.length());
+}
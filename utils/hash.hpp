@@ -0,0 +1,62 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/// \file utils/hash.hpp
+/// Non-cryptographic hash functions with a stable definition.
+///
+/// Unlike the hashes provided by the standard library, the results of these
+/// functions do not vary across platforms nor builds, so they can be stored
+/// persistently or compared across machines.
+
+#if !defined(UTILS_HASH_HPP)
+#define UTILS_HASH_HPP
+
+extern "C" {
+#include <stdint.h>
+}
+
+#include <cstddef>
+#include <string>
+
+namespace utils {
+
+
+/// Offset basis of the 32-bit FNV-1a hash; the hash of no data.
+const uint32_t fnv1a_32_basis = 2166136261U;
+
+/// Offset basis of the 64-bit FNV-1a hash; the hash of no data.
+const uint64_t fnv1a_64_basis = 14695981039346656037ULL;
+
+
+uint32_t fnv1a_32(const std::string&);
+uint64_t fnv1a_64(const uint64_t, const void*, const std::size_t);
+uint64_t fnv1a_64(const std::string&);
+
+
+}  // namespace utils
+
+#endif  // !defined(UTILS_HASH_HPP)
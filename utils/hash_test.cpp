@@ -0,0 +1,79 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include "utils/hash.hpp"
+
+#include <atf-c++.hpp>
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(fnv1a_32__known_values);
+ATF_TEST_CASE_BODY(fnv1a_32__known_values)
+{
+    ATF_REQUIRE_EQ(0x811c9dc5U, utils::fnv1a_32(""));
+    ATF_REQUIRE_EQ(0xe40c292cU, utils::fnv1a_32("a"));
+    ATF_REQUIRE_EQ(0xbf9cf968U, utils::fnv1a_32("foobar"));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(fnv1a_64__known_values);
+ATF_TEST_CASE_BODY(fnv1a_64__known_values)
+{
+    ATF_REQUIRE_EQ(0xcbf29ce484222325ULL, utils::fnv1a_64(""));
+    ATF_REQUIRE_EQ(0xaf63dc4c8601ec8cULL, utils::fnv1a_64("a"));
+    ATF_REQUIRE_EQ(0x85944171f73967e8ULL, utils::fnv1a_64("foobar"));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(fnv1a_64__incremental);
+ATF_TEST_CASE_BODY(fnv1a_64__incremental)
+{
+    uint64_t hash = utils::fnv1a_64_basis;
+    hash = utils::fnv1a_64(hash, "foo", 3);
+    hash = utils::fnv1a_64(hash, "", 0);
+    hash = utils::fnv1a_64(hash, "bar", 3);
+    ATF_REQUIRE_EQ(utils::fnv1a_64("foobar"), hash);
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(fnv1a_64__binary);
+ATF_TEST_CASE_BODY(fnv1a_64__binary)
+{
+    const char data[] = { 'a', '\0', '\xff' };
+    ATF_REQUIRE(utils::fnv1a_64(utils::fnv1a_64_basis, data, 1) !=
+                utils::fnv1a_64(utils::fnv1a_64_basis, data, 2));
+    ATF_REQUIRE_EQ(utils::fnv1a_64(std::string(data, 3)),
+                   utils::fnv1a_64(utils::fnv1a_64_basis, data, 3));
+}
+
+
+ATF_INIT_TEST_CASES(tcs)
+{
+    ATF_ADD_TEST_CASE(tcs, fnv1a_32__known_values);
+    ATF_ADD_TEST_CASE(tcs, fnv1a_64__known_values);
+    ATF_ADD_TEST_CASE(tcs, fnv1a_64__incremental);
+    ATF_ADD_TEST_CASE(tcs, fnv1a_64__binary);
+}
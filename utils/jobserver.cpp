@@ -0,0 +1,352 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "utils/jobserver.hpp"
+
+extern "C" {
+#include <fcntl.h>
+#include <unistd.h>
+}
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include "utils/env.hpp"
+#include "utils/format/macros.hpp"
+#include "utils/logging/macros.hpp"
+#include "utils/noncopyable.hpp"
+#include "utils/optional.ipp"
+#include "utils/sanity.hpp"
+#include "utils/text/exceptions.hpp"
+#include "utils/text/operations.ipp"
+
+namespace text = utils::text;
+
+using utils::none;
+using utils::optional;
+
+
+namespace {
+
+
+/// Marks a file descriptor to be closed when executing subprocesses.
+///
+/// The tests we spawn have no business with our connection to the jobserver.
+/// Note that this does not affect the descriptors inherited from make, which
+/// we only duplicate.
+///
+/// \param fd The file descriptor to mark.
+static void
+set_cloexec(const int fd)
+{
+    const int flags = ::fcntl(fd, F_GETFD);
+    if (flags != -1)
+        (void)::fcntl(fd, F_SETFD, flags | FD_CLOEXEC);
+}
+
+
+/// Opens the reading end of a jobserver given as inherited descriptors.
+///
+/// Reading tokens must not block us while tests are running, but the
+/// descriptor is shared with make and with any other clients that may not
+/// cope with non-blocking reads.  We therefore try to reopen the pipe to get a
+/// file description of our own and only fall back to changing the flags of
+/// the shared one if that fails.
+///
+/// \param fd The inherited reading end of the pipe.
+///
+/// \return A non-blocking descriptor to read tokens from, or -1 on error.
+static int
+open_read_fd(const int fd)
+{
+    const std::string proc_path = F("/proc/self/fd/%s") % fd;
+    int read_fd = ::open(proc_path.c_str(), O_RDONLY | O_NONBLOCK);
+    if (read_fd == -1) {
+        read_fd = ::dup(fd);
+        if (read_fd == -1)
+            return -1;
+        const int flags = ::fcntl(read_fd, F_GETFL);
+        if (flags == -1 ||
+            ::fcntl(read_fd, F_SETFL, flags | O_NONBLOCK) == -1) {
+            ::close(read_fd);
+            return -1;
+        }
+    }
+    return read_fd;
+}
+
+
+/// Extracts the location of the jobserver from the flags of make.
+///
+/// \param makeflags The contents of the MAKEFLAGS variable.
+///
+/// \return The value of the last --jobserver-auth flag, or of its older
+/// --jobserver-fds name, or none if make did not pass a jobserver.
+static optional< std::string >
+find_auth(const std::string& makeflags)
+{
+    static const char* const prefixes[] = {
+        "--jobserver-auth=",
+        "--jobserver-fds=",
+        NULL,
+    };
+
+    optional< std::string > auth;
+    const std::vector< std::string > words = text::split(makeflags, ' ');
+    for (std::vector< std::string >::const_iterator iter = words.begin();
+         iter != words.end(); ++iter) {
+        for (const char* const* prefix = prefixes; *prefix != NULL; ++prefix) {
+            const std::size_t length = std::strlen(*prefix);
+            if ((*iter).compare(0, length, *prefix) == 0)
+                auth = (*iter).substr(length);
+        }
+    }
+    return auth;
+}
+
+
+}  // anonymous namespace
+
+
+/// Shared implementation of the jobserver.
+struct utils::jobserver::impl : utils::noncopyable {
+    /// Non-blocking descriptor to read tokens from.
+    int _read_fd;
+
+    /// Descriptor to write tokens back to.
+    int _write_fd;
+
+    /// Tokens currently held, in the order in which they were acquired.
+    ///
+    /// make may use the value of the tokens to carry state, so we hand back
+    /// exactly what we got.
+    std::vector< char > _tokens;
+
+    /// Constructor.
+    ///
+    /// \param read_fd_ Non-blocking descriptor to read tokens from.  Grabs
+    ///     ownership.
+    /// \param write_fd_ Descriptor to write tokens back to.  Grabs ownership.
+    impl(const int read_fd_, const int write_fd_) :
+        _read_fd(read_fd_),
+        _write_fd(write_fd_)
+    {
+    }
+
+    /// Destructor.
+    ///
+    /// Tokens that are not returned are lost to the whole build, so this
+    /// hands back any that the caller did not release.
+    ~impl(void)
+    {
+        while (!_tokens.empty())
+            release();
+        ::close(_read_fd);
+        ::close(_write_fd);
+    }
+
+    /// Returns the most recently acquired token to the jobserver.
+    void
+    release(void)
+    {
+        PRE(!_tokens.empty());
+        const char token = _tokens.back();
+        _tokens.pop_back();
+
+        ssize_t ret;
+        do {
+            ret = ::write(_write_fd, &token, 1);
+        } while (ret == -1 && errno == EINTR);
+        if (ret != 1) {
+            const int original_errno = errno;
+            LW(F("Failed to return a token to the jobserver: %s") %
+               std::strerror(original_errno));
+        }
+    }
+};
+
+
+/// Constructor.
+///
+/// \param pimpl The shared implementation.
+utils::jobserver::jobserver(std::shared_ptr< impl > pimpl) :
+    _pimpl(pimpl)
+{
+}
+
+
+/// Destructor.
+utils::jobserver::~jobserver(void)
+{
+}
+
+
+/// Connects to the jobserver described by the flags of make.
+///
+/// Both the descriptor-based jobserver ("--jobserver-auth=R,W") and the
+/// named pipe one of newer versions of make ("--jobserver-auth=fifo:PATH")
+/// are supported.  Failures to connect are not fatal: they are logged and the
+/// caller is expected to proceed as if there was no jobserver at all.
+///
+/// \param makeflags The contents of the MAKEFLAGS variable.
+///
+/// \return The connection to the jobserver, or none if there is no usable
+/// jobserver.
+optional< utils::jobserver >
+utils::jobserver::from_makeflags(const std::string& makeflags)
+{
+    const optional< std::string > auth = find_auth(makeflags);
+    if (!auth)
+        return none;
+
+    int read_fd, write_fd;
+    if (auth.get().compare(0, 5, "fifo:") == 0) {
+        const std::string fifo = auth.get().substr(5);
+        read_fd = ::open(fifo.c_str(), O_RDONLY | O_NONBLOCK);
+        if (read_fd == -1) {
+            const int original_errno = errno;
+            LW(F("Cannot open jobserver fifo %s: %s") % fifo %
+               std::strerror(original_errno));
+            return none;
+        }
+        write_fd = ::open(fifo.c_str(), O_WRONLY);
+        if (write_fd == -1) {
+            const int original_errno = errno;
+            ::close(read_fd);
+            LW(F("Cannot open jobserver fifo %s: %s") % fifo %
+               std::strerror(original_errno));
+            return none;
+        }
+    } else {
+        const std::vector< std::string > fds = text::split(auth.get(), ',');
+        int inherited_read_fd, inherited_write_fd;
+        try {
+            if (fds.size() != 2)
+                throw text::value_error("Expected two descriptors");
+            inherited_read_fd = text::to_type< int >(fds[0]);
+            inherited_write_fd = text::to_type< int >(fds[1]);
+        } catch (const text::value_error& e) {
+            LW(F("Invalid jobserver '%s': %s") % auth.get() % e.what());
+            return none;
+        }
+        if (inherited_read_fd < 0 || inherited_write_fd < 0)
+            return none;
+
+        // make only passes the descriptors down to the recipes it knows to
+        // be recursive, so they may well be closed or reused here.
+        if (::fcntl(inherited_read_fd, F_GETFD) == -1 ||
+            ::fcntl(inherited_write_fd, F_GETFD) == -1) {
+            LW(F("Jobserver descriptors %s are not open; ignoring the "
+                 "jobserver (mark the make rule with '+'?)") % auth.get());
+            return none;
+        }
+
+        read_fd = open_read_fd(inherited_read_fd);
+        if (read_fd == -1) {
+            const int original_errno = errno;
+            LW(F("Cannot open jobserver descriptor %s: %s") %
+               inherited_read_fd % std::strerror(original_errno));
+            return none;
+        }
+        write_fd = ::dup(inherited_write_fd);
+        if (write_fd == -1) {
+            const int original_errno = errno;
+            ::close(read_fd);
+            LW(F("Cannot open jobserver descriptor %s: %s") %
+               inherited_write_fd % std::strerror(original_errno));
+            return none;
+        }
+    }
+    set_cloexec(read_fd);
+    set_cloexec(write_fd);
+
+    LI(F("Using the jobserver at %s") % auth.get());
+    return utils::make_optional(jobserver(
+        std::shared_ptr< impl >(new impl(read_fd, write_fd))));
+}
+
+
+/// Connects to the jobserver of the make process that started us, if any.
+///
+/// \return The connection to the jobserver, or none if there is no usable
+/// jobserver.
+optional< utils::jobserver >
+utils::jobserver::from_environment(void)
+{
+    const optional< std::string > makeflags = utils::getenv("MAKEFLAGS");
+    if (!makeflags)
+        return none;
+    return from_makeflags(makeflags.get());
+}
+
+
+/// Takes a token from the jobserver without blocking.
+///
+/// \return True if a token was acquired, in which case the caller may start one
+/// more job and must later call release(); false if no tokens are available
+/// at the moment.
+bool
+utils::jobserver::try_acquire(void)
+{
+    char token;
+    ssize_t ret;
+    do {
+        ret = ::read(_pimpl->_read_fd, &token, 1);
+    } while (ret == -1 && errno == EINTR);
+
+    if (ret == 1) {
+        _pimpl->_tokens.push_back(token);
+        return true;
+    }
+    if (ret == -1 && errno != EAGAIN && errno != EWOULDBLOCK) {
+        const int original_errno = errno;
+        LW(F("Failed to read a token from the jobserver: %s") %
+           std::strerror(original_errno));
+    }
+    return false;
+}
+
+
+/// Returns a token previously obtained with try_acquire() to the jobserver.
+void
+utils::jobserver::release(void)
+{
+    _pimpl->release();
+}
+
+
+/// Gets the number of tokens currently held.
+///
+/// \return The number of tokens acquired and not yet released.  This does not
+/// account for the implicit token that make grants to every recipe.
+std::size_t
+utils::jobserver::held(void) const
+{
+    return _pimpl->_tokens.size();
+}
@@ -0,0 +1,77 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// \file utils/jobserver.hpp
+/// Client of the jobserver of GNU make.
+///
+/// When make runs with -jN, it hands its recipes a pipe that holds N-1
+/// tokens.  A recipe that wants to run several jobs at once owns one implicit
+/// token and must read an additional token from the pipe before starting each
+/// job beyond the first, writing it back once the job finishes.  Honoring this
+/// protocol keeps the total concurrency of the build at N.
+
+#if !defined(UTILS_JOBSERVER_HPP)
+#define UTILS_JOBSERVER_HPP
+
+#include "utils/jobserver_fwd.hpp"
+
+#include <cstddef>
+#include <string>
+
+#include "utils/optional_fwd.hpp"
+#include "utils/shared_ptr.hpp"
+
+namespace utils {
+
+
+/// Connection to the jobserver of a parent make process.
+///
+/// This class is reference-counted and therefore only the destruction of the
+/// last instance returns the tokens still held to the jobserver.
+class jobserver {
+    struct impl;
+    /// Reference-counted, shared implementation.
+    std::shared_ptr< impl > _pimpl;
+
+    explicit jobserver(std::shared_ptr< impl >);
+
+public:
+    ~jobserver(void);
+
+    static optional< jobserver > from_makeflags(const std::string&);
+    static optional< jobserver > from_environment(void);
+
+    bool try_acquire(void);
+    void release(void);
+    std::size_t held(void) const;
+};
+
+
+}  // namespace utils
+
+#endif  // !defined(UTILS_JOBSERVER_HPP)
@@ -0,0 +1,212 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "utils/jobserver.hpp"
+
+extern "C" {
+#include <sys/stat.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+}
+
+#include <string>
+
+#include <atf-c++.hpp>
+
+#include "utils/env.hpp"
+#include "utils/format/macros.hpp"
+#include "utils/optional.ipp"
+
+using utils::optional;
+
+
+namespace {
+
+
+/// Creates a jobserver pipe loaded with some tokens.
+///
+/// \param fds Output array to store the reading and writing ends of the pipe.
+/// \param tokens The tokens to preload in the pipe, one per character.
+static void
+make_jobserver(int fds[2], const std::string& tokens)
+{
+    ATF_REQUIRE(::pipe(fds) != -1);
+    ATF_REQUIRE_EQ(static_cast< ssize_t >(tokens.length()),
+                   ::write(fds[1], tokens.c_str(), tokens.length()));
+}
+
+
+/// Reads all the tokens available in a jobserver pipe without blocking.
+///
+/// \param fd The reading end of the pipe.
+///
+/// \return The tokens, one per character.
+static std::string
+drain_jobserver(const int fd)
+{
+    ATF_REQUIRE(::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK) != -1);
+    std::string tokens;
+    char token;
+    while (::read(fd, &token, 1) == 1)
+        tokens += token;
+    return tokens;
+}
+
+
+}  // anonymous namespace
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(from_makeflags__none);
+ATF_TEST_CASE_BODY(from_makeflags__none)
+{
+    ATF_REQUIRE(!utils::jobserver::from_makeflags(""));
+    ATF_REQUIRE(!utils::jobserver::from_makeflags("-j4 -k"));
+    ATF_REQUIRE(!utils::jobserver::from_makeflags("--jobserver-auth=-2,-2"));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(from_makeflags__invalid);
+ATF_TEST_CASE_BODY(from_makeflags__invalid)
+{
+    ATF_REQUIRE(!utils::jobserver::from_makeflags("--jobserver-auth=3"));
+    ATF_REQUIRE(!utils::jobserver::from_makeflags("--jobserver-auth=a,b"));
+    ATF_REQUIRE(!utils::jobserver::from_makeflags(
+        "--jobserver-auth=fifo:non-existent"));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(from_makeflags__closed_fds);
+ATF_TEST_CASE_BODY(from_makeflags__closed_fds)
+{
+    int fds[2];
+    make_jobserver(fds, "");
+    ::close(fds[0]);
+    ::close(fds[1]);
+    ATF_REQUIRE(!utils::jobserver::from_makeflags(
+        F("-j4 --jobserver-auth=%s,%s") % fds[0] % fds[1]));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(try_acquire__fds);
+ATF_TEST_CASE_BODY(try_acquire__fds)
+{
+    int fds[2];
+    make_jobserver(fds, "+-");
+
+    optional< utils::jobserver > jobserver = utils::jobserver::from_makeflags(
+        F("kw -j3 --jobserver-auth=%s,%s") % fds[0] % fds[1]);
+    ATF_REQUIRE(jobserver);
+    ATF_REQUIRE_EQ(0, jobserver.get().held());
+    ATF_REQUIRE(jobserver.get().try_acquire());
+    ATF_REQUIRE(jobserver.get().try_acquire());
+    ATF_REQUIRE_EQ(2, jobserver.get().held());
+    ATF_REQUIRE(!jobserver.get().try_acquire());
+    ATF_REQUIRE_EQ(2, jobserver.get().held());
+
+    jobserver.get().release();
+    ATF_REQUIRE_EQ(1, jobserver.get().held());
+    ATF_REQUIRE_EQ("-", drain_jobserver(fds[0]));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(try_acquire__fds_old_flag);
+ATF_TEST_CASE_BODY(try_acquire__fds_old_flag)
+{
+    int fds[2];
+    make_jobserver(fds, "+");
+
+    optional< utils::jobserver > jobserver = utils::jobserver::from_makeflags(
+        F("-j2 --jobserver-fds=%s,%s") % fds[0] % fds[1]);
+    ATF_REQUIRE(jobserver);
+    ATF_REQUIRE(jobserver.get().try_acquire());
+    ATF_REQUIRE(!jobserver.get().try_acquire());
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(try_acquire__fifo);
+ATF_TEST_CASE_BODY(try_acquire__fifo)
+{
+    ATF_REQUIRE(::mkfifo("fifo", 0600) != -1);
+    const int fd = ::open("fifo", O_RDWR);
+    ATF_REQUIRE(fd != -1);
+    ATF_REQUIRE_EQ(1, ::write(fd, "+", 1));
+
+    optional< utils::jobserver > jobserver = utils::jobserver::from_makeflags(
+        "-j2 --jobserver-auth=fifo:fifo");
+    ATF_REQUIRE(jobserver);
+    ATF_REQUIRE(jobserver.get().try_acquire());
+    ATF_REQUIRE(!jobserver.get().try_acquire());
+    jobserver.get().release();
+    ATF_REQUIRE_EQ("+", drain_jobserver(fd));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(destructor__returns_tokens);
+ATF_TEST_CASE_BODY(destructor__returns_tokens)
+{
+    int fds[2];
+    make_jobserver(fds, "abc");
+
+    {
+        optional< utils::jobserver > jobserver =
+            utils::jobserver::from_makeflags(
+                F("--jobserver-auth=%s,%s") % fds[0] % fds[1]);
+        ATF_REQUIRE(jobserver);
+        ATF_REQUIRE(jobserver.get().try_acquire());
+        ATF_REQUIRE(jobserver.get().try_acquire());
+    }
+    ATF_REQUIRE_EQ("cba", drain_jobserver(fds[0]));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(from_environment);
+ATF_TEST_CASE_BODY(from_environment)
+{
+    utils::unsetenv("MAKEFLAGS");
+    ATF_REQUIRE(!utils::jobserver::from_environment());
+
+    int fds[2];
+    make_jobserver(fds, "+");
+    utils::setenv("MAKEFLAGS",
+                  F("-j2 --jobserver-auth=%s,%s") % fds[0] % fds[1]);
+    ATF_REQUIRE(utils::jobserver::from_environment());
+}
+
+
+ATF_INIT_TEST_CASES(tcs)
+{
+    ATF_ADD_TEST_CASE(tcs, from_makeflags__none);
+    ATF_ADD_TEST_CASE(tcs, from_makeflags__invalid);
+    ATF_ADD_TEST_CASE(tcs, from_makeflags__closed_fds);
+    ATF_ADD_TEST_CASE(tcs, try_acquire__fds);
+    ATF_ADD_TEST_CASE(tcs, try_acquire__fds_old_flag);
+    ATF_ADD_TEST_CASE(tcs, try_acquire__fifo);
+    ATF_ADD_TEST_CASE(tcs, destructor__returns_tokens);
+    ATF_ADD_TEST_CASE(tcs, from_environment);
+}
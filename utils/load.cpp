@@ -0,0 +1,162 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "utils/load.hpp"
+
+#if defined(HAVE_CONFIG_H)
+#   include "config.h"
+#endif
+
+extern "C" {
+#include <stdlib.h>
+#include <unistd.h>
+}
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "utils/format/macros.hpp"
+#include "utils/logging/macros.hpp"
+#include "utils/optional.ipp"
+#include "utils/text/exceptions.hpp"
+#include "utils/text/operations.ipp"
+
+namespace text = utils::text;
+
+using utils::none;
+using utils::optional;
+
+
+namespace {
+
+
+/// Files that report the pressure stall information of the system resources.
+static const char* const pressure_files[] = {
+    "/proc/pressure/cpu",
+    "/proc/pressure/memory",
+    "/proc/pressure/io",
+    NULL,
+};
+
+
+/// Computes a pressure figure out of the load average of the system.
+///
+/// The load average is scaled by the number of online CPUs so that only the
+/// demand that exceeds the capacity of the machine counts as pressure, which
+/// makes the result comparable to the stall percentages of PSI.
+///
+/// \return The excess of the 1-minute load average over the number of CPUs as
+/// a percentage of the latter, or none if this cannot be computed.
+static optional< double >
+loadavg_pressure(void)
+{
+#if defined(HAVE_GETLOADAVG) && defined(_SC_NPROCESSORS_ONLN)
+    double load;
+    if (::getloadavg(&load, 1) != 1)
+        return none;
+
+    const long ncpus = ::sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpus <= 0)
+        return none;
+
+    return utils::make_optional(
+        std::max(0.0, load / ncpus - 1.0) * 100.0);
+#else
+    return none;
+#endif
+}
+
+
+}  // anonymous namespace
+
+
+/// Extracts the short-term stall percentage from a PSI report.
+///
+/// The input follows the format of the /proc/pressure/* files of Linux, in
+/// which the "some" line tells the share of time in which at least one task
+/// was stalled waiting for the resource.
+///
+/// \param input The stream to read the report from.
+///
+/// \return The 10-second average of the "some" line, or none if the input is
+/// malformed.
+optional< double >
+utils::parse_pressure(std::istream& input)
+{
+    std::string line;
+    while (std::getline(input, line)) {
+        const std::vector< std::string > words = text::split(line, ' ');
+        if (words.empty() || words[0] != "some")
+            continue;
+
+        for (std::vector< std::string >::const_iterator iter =
+                 words.begin() + 1; iter != words.end(); ++iter) {
+            if ((*iter).find("avg10=") != 0)
+                continue;
+            try {
+                return utils::make_optional(
+                    text::to_type< double >((*iter).substr(6)));
+            } catch (const text::value_error& e) {
+                LW(F("Invalid pressure value '%s'") % *iter);
+                return none;
+            }
+        }
+        return none;
+    }
+    return none;
+}
+
+
+/// Queries the pressure that the system is currently under.
+///
+/// This prefers the pressure stall information of Linux and reports the
+/// highest stall percentage among the CPU, memory and I/O resources.  Where
+/// that is not available, this falls back to the load average.
+///
+/// \return A percentage where 0 means that no work is waiting for resources,
+/// or none if the system provides no way to measure this.
+optional< double >
+utils::system_pressure(void)
+{
+    optional< double > pressure;
+    for (const char* const* file = pressure_files; *file != NULL; ++file) {
+        std::ifstream input(*file);
+        if (!input)
+            continue;
+
+        const optional< double > value = parse_pressure(input);
+        if (value && (!pressure || value.get() > pressure.get()))
+            pressure = value;
+    }
+    if (pressure)
+        return pressure;
+
+    return loadavg_pressure();
+}
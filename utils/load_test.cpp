@@ -0,0 +1,103 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "utils/load.hpp"
+
+#include <sstream>
+
+#include <atf-c++.hpp>
+
+#include "utils/optional.ipp"
+
+using utils::optional;
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parse_pressure__ok);
+ATF_TEST_CASE_BODY(parse_pressure__ok)
+{
+    std::istringstream input(
+        "some avg10=12.50 avg60=3.00 avg300=1.00 total=12345\n"
+        "full avg10=80.00 avg60=70.00 avg300=60.00 total=67890\n");
+    const optional< double > pressure = utils::parse_pressure(input);
+    ATF_REQUIRE(pressure);
+    ATF_REQUIRE_EQ(12.5, pressure.get());
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parse_pressure__some_not_first);
+ATF_TEST_CASE_BODY(parse_pressure__some_not_first)
+{
+    std::istringstream input(
+        "full avg10=80.00 avg60=70.00 avg300=60.00 total=67890\n"
+        "some avg10=0.75 avg60=3.00 avg300=1.00 total=12345\n");
+    const optional< double > pressure = utils::parse_pressure(input);
+    ATF_REQUIRE(pressure);
+    ATF_REQUIRE_EQ(0.75, pressure.get());
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parse_pressure__empty);
+ATF_TEST_CASE_BODY(parse_pressure__empty)
+{
+    std::istringstream input("");
+    ATF_REQUIRE(!utils::parse_pressure(input));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(parse_pressure__malformed);
+ATF_TEST_CASE_BODY(parse_pressure__malformed)
+{
+    {
+        std::istringstream input("some avg60=3.00 total=12345\n");
+        ATF_REQUIRE(!utils::parse_pressure(input));
+    }
+    {
+        std::istringstream input("some avg10=abc avg60=3.00\n");
+        ATF_REQUIRE(!utils::parse_pressure(input));
+    }
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(system_pressure);
+ATF_TEST_CASE_BODY(system_pressure)
+{
+    const optional< double > pressure = utils::system_pressure();
+    if (pressure)
+        ATF_REQUIRE(pressure.get() >= 0.0);
+}
+
+
+ATF_INIT_TEST_CASES(tcs)
+{
+    ATF_ADD_TEST_CASE(tcs, parse_pressure__ok);
+    ATF_ADD_TEST_CASE(tcs, parse_pressure__some_not_first);
+    ATF_ADD_TEST_CASE(tcs, parse_pressure__empty);
+    ATF_ADD_TEST_CASE(tcs, parse_pressure__malformed);
+
+    ATF_ADD_TEST_CASE(tcs, system_pressure);
+}
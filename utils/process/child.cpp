@@ -28,18 +28,28 @@
 
 #include "utils/process/child.ipp"
 
+#if defined(HAVE_CONFIG_H)
+#   include "config.h"
+#endif
+
 extern "C" {
+#include <sys/resource.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
 
 #include <fcntl.h>
 #include <signal.h>
+#if defined(HAVE_SPAWN_H)
+#   include <spawn.h>
+#endif
 #include <unistd.h>
 }
 
 #include <cerrno>
+#include <cstring>
 #include <iostream>
 #include <memory>
+#include <vector>
 
 #include "utils/defs.hpp"
 #include "utils/format/macros.hpp"
@@ -143,6 +153,31 @@ log_exec(const fs::path& program, const process::args_vector& args)
 }
 
 
+#if defined(HAVE_POSIX_SPAWN) && \
+    defined(HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCHDIR_NP)
+/// Raises the soft core size limit of the current process to its hard limit.
+///
+/// This is the same as utils::unlimit_core_size() but remembers the previous
+/// value so that the caller can restore it.
+///
+/// \param [out] old_limit The limit before the change.
+///
+/// \return True if the limit was modified; false otherwise.
+static bool
+raise_core_limit(struct ::rlimit* old_limit)
+{
+    if (::getrlimit(RLIMIT_CORE, old_limit) == -1)
+        return false;
+    if (old_limit->rlim_cur == old_limit->rlim_max)
+        return false;
+
+    struct ::rlimit new_limit = *old_limit;
+    new_limit.rlim_cur = new_limit.rlim_max;
+    return ::setrlimit(RLIMIT_CORE, &new_limit) != -1;
+}
+#endif
+
+
 }  // anonymous namespace
 
 
@@ -349,6 +384,161 @@ process::child::spawn_files(const fs::path& program,
 }
 
 
+/// Spawns a new binary in an isolated environment without forking.
+///
+/// This is equivalent to forking a subprocess with fork_files() and to calling
+/// process::isolate_child() and exec() in it, except that the subprocess does
+/// not run any code of ours: the whole setup is prepared in this process and
+/// performed by posix_spawn(3).  Not having to copy the address space of the
+/// caller, which can be large, makes this much cheaper than forking.
+///
+/// The process is not switched to any other user.  Callers that need to do so
+/// must resort to fork_files().
+///
+/// \param program The binary to execute.
+/// \param args The arguments to pass to the binary, without the program name.
+/// \param environment The complete environment of the new process, as computed
+///     by process::isolated_environment() plus any additions.
+/// \param work_directory Directory to enter when running the new process.
+/// \param stdout_file The name of the file in which to store the stdout.
+///     If this has the magic value /dev/stdout, then the parent's stdout is
+///     reused without applying any redirection.
+/// \param stderr_file The name of the file in which to store the stderr.
+///     If this has the magic value /dev/stderr, then the parent's stderr is
+///     reused without applying any redirection.
+///
+/// \return A new child object, returned as a dynamically-allocated object
+/// because children classes are unique and thus noncopyable; or NULL if the
+/// process cannot be spawned this way, in which case the caller should fall
+/// back to fork_files() to get the details of the failure.
+std::auto_ptr< process::child >
+process::child::spawn_isolated(
+    const fs::path& program,
+    const args_vector& args,
+    const std::map< std::string, std::string >& environment,
+    const fs::path& work_directory,
+    const fs::path& stdout_file,
+    const fs::path& stderr_file)
+{
+#if defined(HAVE_POSIX_SPAWN) && \
+    defined(HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCHDIR_NP)
+    std::vector< const char* > argv;
+    argv.push_back(program.c_str());
+    for (args_vector::const_iterator iter = args.begin(); iter != args.end();
+         ++iter)
+        argv.push_back((*iter).c_str());
+    argv.push_back(NULL);
+
+    std::vector< std::string > envp_storage;
+    for (std::map< std::string, std::string >::const_iterator iter =
+             environment.begin(); iter != environment.end(); ++iter)
+        envp_storage.push_back((*iter).first + "=" + (*iter).second);
+    std::vector< const char* > envp;
+    for (std::vector< std::string >::const_iterator iter =
+             envp_storage.begin(); iter != envp_storage.end(); ++iter)
+        envp.push_back((*iter).c_str());
+    envp.push_back(NULL);
+
+    ::posix_spawnattr_t attr;
+    if (::posix_spawnattr_init(&attr) != 0)
+        return std::auto_ptr< process::child >(NULL);
+    ::posix_spawn_file_actions_t actions;
+    if (::posix_spawn_file_actions_init(&actions) != 0) {
+        ::posix_spawnattr_destroy(&attr);
+        return std::auto_ptr< process::child >(NULL);
+    }
+
+    // The equivalent of the signals::reset_all() call done by isolate_child().
+    // The signals blocked by the interrupts_inhibiter below must also be
+    // unblocked in the new process, just as fork_files_aux() does.
+    ::sigset_t default_signals;
+    sigfillset(&default_signals);
+    sigdelset(&default_signals, SIGKILL);
+    sigdelset(&default_signals, SIGSTOP);
+#if defined(SIGTHR)
+    sigdelset(&default_signals, SIGTHR);
+#endif
+    ::sigset_t no_signals;
+    sigemptyset(&no_signals);
+
+    short flags = POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK;
+#if defined(POSIX_SPAWN_SETSID)
+    flags |= POSIX_SPAWN_SETSID;
+#else
+    // Without setsid(2), at least put the process in its own process group so
+    // that we can terminate all of its children at once.
+    flags |= POSIX_SPAWN_SETPGROUP;
+#endif
+
+    const int open_flags = O_CREAT | O_WRONLY | O_APPEND;
+    const mode_t open_mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
+    bool ok =
+        ::posix_spawnattr_setflags(&attr, flags) == 0 &&
+        ::posix_spawnattr_setpgroup(&attr, 0) == 0 &&
+        ::posix_spawnattr_setsigdefault(&attr, &default_signals) == 0 &&
+        ::posix_spawnattr_setsigmask(&attr, &no_signals) == 0;
+    if (ok && stdout_file != fs::path("/dev/stdout"))
+        ok = ::posix_spawn_file_actions_addopen(
+            &actions, STDOUT_FILENO, stdout_file.c_str(), open_flags,
+            open_mode) == 0;
+    if (ok && stderr_file != fs::path("/dev/stderr"))
+        ok = ::posix_spawn_file_actions_addopen(
+            &actions, STDERR_FILENO, stderr_file.c_str(), open_flags,
+            open_mode) == 0;
+    if (ok)
+        ok = ::posix_spawn_file_actions_addchdir_np(
+            &actions, work_directory.c_str()) == 0;
+    if (!ok) {
+        ::posix_spawn_file_actions_destroy(&actions);
+        ::posix_spawnattr_destroy(&attr);
+        return std::auto_ptr< process::child >(NULL);
+    }
+
+    std::cout.flush();
+    std::cerr.flush();
+
+    // posix_spawn(3) cannot set the file creation mask nor the resource limits
+    // of the new process, so temporarily apply the settings of isolate_child()
+    // to ourselves for the new process to inherit them.  This is safe because
+    // we are single-threaded and these settings do not affect our own
+    // behavior in the meantime.
+    const ::mode_t old_umask = ::umask(0022);
+    struct ::rlimit old_core_limit;
+    const bool core_limit_changed = raise_core_limit(&old_core_limit);
+
+    std::auto_ptr< signals::interrupts_inhibiter > inhibiter(
+        new signals::interrupts_inhibiter);
+    ::pid_t pid;
+    const int error = ::posix_spawn(
+        &pid, program.c_str(), &actions, &attr,
+        (char* const*)(unsigned long)(const void*)&argv[0],
+        (char* const*)(unsigned long)(const void*)&envp[0]);
+    if (error == 0)
+        signals::add_pid_to_kill(pid);
+    inhibiter.reset(NULL);  // Unblock signals.
+
+    if (core_limit_changed)
+        (void)::setrlimit(RLIMIT_CORE, &old_core_limit);
+    (void)::umask(old_umask);
+
+    ::posix_spawn_file_actions_destroy(&actions);
+    ::posix_spawnattr_destroy(&attr);
+
+    if (error != 0) {
+        LD(F("posix_spawn(%s) failed: %s") % program % std::strerror(error));
+        return std::auto_ptr< process::child >(NULL);
+    }
+    LD(F("Spawned process %s without forking: stdout=%s, stderr=%s") % pid %
+       stdout_file % stderr_file);
+    log_exec(program, args);
+    return std::auto_ptr< process::child >(
+        new process::child(new impl(pid, NULL)));
+#else
+    return std::auto_ptr< process::child >(NULL);
+#endif
+}
+
+
 /// Returns the process identifier of this child.
 ///
 /// \return A process identifier.
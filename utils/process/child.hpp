@@ -49,8 +49,10 @@
 #include "utils/process/child_fwd.hpp"
 
 #include <istream>
+#include <map>
 #include <memory>
 #include <stdexcept>
+#include <string>
 
 #include "utils/defs.hpp"
 #include "utils/fs/path_fwd.hpp"
@@ -100,6 +102,10 @@ public:
         const fs::path&, const args_vector&);
     static std::auto_ptr< child > spawn_files(
         const fs::path&, const args_vector&, const fs::path&, const fs::path&);
+    static std::auto_ptr< child > spawn_isolated(
+        const fs::path&, const args_vector&,
+        const std::map< std::string, std::string >&, const fs::path&,
+        const fs::path&, const fs::path&);
 
     int pid(void) const;
 
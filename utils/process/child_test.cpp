@@ -43,7 +43,10 @@ extern "C" {
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <sstream>
 #include <stdexcept>
+#include <vector>
 
 #include <atf-c++.hpp>
 
@@ -788,6 +791,93 @@ ATF_TEST_CASE_BODY(child__spawn__missing_program)
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(child__spawn_isolated__ok);
+ATF_TEST_CASE_BODY(child__spawn_isolated__ok)
+{
+    std::vector< std::string > args;
+    args.push_back("print-state");
+
+    std::map< std::string, std::string > environment;
+    environment["FOO"] = "bar";
+
+    ATF_REQUIRE(::mkdir("work", 0755) != -1);
+    const fs::path work_directory = fs::path("work").to_absolute();
+
+    // Mess up the state of the parent to ensure that the child does not
+    // inherit any of it.
+    const mode_t old_umask = ::umask(0077);
+    ATF_REQUIRE(::signal(SIGTERM, SIG_IGN) != SIG_ERR);
+
+    std::auto_ptr< process::child > child = process::child::spawn_isolated(
+        get_helpers(this), args, environment, work_directory,
+        fs::path("out").to_absolute(), fs::path("err").to_absolute());
+    ATF_REQUIRE_EQ(0077, ::umask(old_umask));
+    if (child.get() == NULL)
+        skip("Cannot spawn processes without forking on this platform");
+
+    const process::status status = child->wait();
+    ATF_REQUIRE(status.exited());
+    ATF_REQUIRE_EQ(EXIT_SUCCESS, status.exitstatus());
+
+    std::ostringstream exp_output;
+    exp_output << "cwd = " << work_directory << "\n"
+               << "umask = 22\n"
+               << "session = own\n"
+               << "sigterm = default\n"
+               << "sigterm blocked = no\n"
+               << "env = FOO=bar\n";
+    ATF_REQUIRE(atf::utils::compare_file("out", exp_output.str()));
+    ATF_REQUIRE(atf::utils::compare_file("err", ""));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(child__spawn_isolated__append);
+ATF_TEST_CASE_BODY(child__spawn_isolated__append)
+{
+    atf::utils::create_file("out", "Previous output\n");
+
+    std::vector< std::string > args;
+    args.push_back("print-args");
+    args.push_back("foo");
+
+    std::auto_ptr< process::child > child = process::child::spawn_isolated(
+        get_helpers(this), args, std::map< std::string, std::string >(),
+        fs::current_path(), fs::path("out").to_absolute(),
+        fs::path("err").to_absolute());
+    if (child.get() == NULL)
+        skip("Cannot spawn processes without forking on this platform");
+
+    const process::status status = child->wait();
+    ATF_REQUIRE(status.exited());
+    ATF_REQUIRE_EQ(EXIT_SUCCESS, status.exitstatus());
+
+    ATF_REQUIRE(atf::utils::compare_file(
+        "out",
+        "Previous output\n"
+        "argv[0] = " + get_helpers(this).str() + "\n"
+        "argv[1] = print-args\n"
+        "argv[2] = foo\n"
+        "argv[3] = NULL"));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(child__spawn_isolated__missing_program);
+ATF_TEST_CASE_BODY(child__spawn_isolated__missing_program)
+{
+    std::auto_ptr< process::child > child = process::child::spawn_isolated(
+        fs::path("/a/b/c"), std::vector< std::string >(),
+        std::map< std::string, std::string >(), fs::current_path(),
+        fs::path("out").to_absolute(), fs::path("err").to_absolute());
+    if (child.get() != NULL) {
+        // Some implementations of posix_spawn(3) only report the failure of
+        // the exec(2) through the exit status of the child.
+        const process::status status = child->wait();
+        ATF_REQUIRE(status.exited());
+        ATF_REQUIRE_EQ(127, status.exitstatus());
+    }
+}
+
+
 ATF_TEST_CASE_WITHOUT_HEAD(child__pid);
 ATF_TEST_CASE_BODY(child__pid)
 {
@@ -843,5 +933,9 @@ ATF_INIT_TEST_CASES(tcs)
     ATF_ADD_TEST_CASE(tcs, child__spawn__some_args);
     ATF_ADD_TEST_CASE(tcs, child__spawn__missing_program);
 
+    ATF_ADD_TEST_CASE(tcs, child__spawn_isolated__ok);
+    ATF_ADD_TEST_CASE(tcs, child__spawn_isolated__append);
+    ATF_ADD_TEST_CASE(tcs, child__spawn_isolated__missing_program);
+
     ATF_ADD_TEST_CASE(tcs, child__pid);
 }
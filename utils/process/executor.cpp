@@ -45,6 +45,7 @@ extern "C" {
 #include <stdexcept>
 
 #include "utils/datetime.hpp"
+#include "utils/env.hpp"
 #include "utils/format/macros.hpp"
 #include "utils/fs/auto_cleaners.hpp"
 #include "utils/fs/exceptions.hpp"
@@ -57,12 +58,16 @@ extern "C" {
 #include "utils/passwd.hpp"
 #include "utils/process/child.ipp"
 #include "utils/process/deadline_killer.hpp"
+#include "utils/process/exceptions.hpp"
 #include "utils/process/isolation.hpp"
 #include "utils/process/operations.hpp"
+#include "utils/process/resource_usage.hpp"
 #include "utils/process/status.hpp"
+#include "utils/process/wait_set.hpp"
 #include "utils/sanity.hpp"
 #include "utils/signals/interrupts.hpp"
 #include "utils/signals/timer.hpp"
+#include "utils/trace.hpp"
 
 namespace datetime = utils::datetime;
 namespace executor = utils::process::executor;
@@ -71,6 +76,7 @@ namespace logging = utils::logging;
 namespace passwd = utils::passwd;
 namespace process = utils::process;
 namespace signals = utils::signals;
+namespace trace = utils::trace;
 
 using utils::none;
 using utils::optional;
@@ -111,15 +117,17 @@ const char* utils::process::executor::detail::work_subdir = "work";
 /// \param unprivileged_user User to switch to if not none.
 /// \param control_directory Path to the subprocess-specific control directory.
 /// \param work_directory Path to the subprocess-specific work directory.
+/// \param limits Resource limits to apply to the subprocess.
 void
 utils::process::executor::detail::setup_child(
     const optional< passwd::user > unprivileged_user,
     const fs::path& control_directory,
-    const fs::path& work_directory)
+    const fs::path& work_directory,
+    const process::resource_limits& limits)
 {
     logging::set_inmemory();
     process::isolate_path(unprivileged_user, control_directory);
-    process::isolate_child(unprivileged_user, work_directory);
+    process::isolate_child(unprivileged_user, work_directory, limits);
 }
 
 
@@ -144,7 +152,10 @@ struct utils::process::executor::exec_handle::impl : utils::noncopyable {
     const optional< passwd::user > unprivileged_user;
 
     /// Timer to kill the subprocess on activation.
-    process::deadline_killer timer;
+    ///
+    /// This is NULL if the deadline of the subprocess is enforced by the
+    /// wait_set of the executor instead.
+    std::auto_ptr< process::deadline_killer > timer;
 
     /// Number of owners of the on-disk state.
     executor::detail::refcnt_t state_owners;
@@ -157,7 +168,7 @@ struct utils::process::executor::exec_handle::impl : utils::noncopyable {
     /// \param stdout_file_ Path to the subprocess's stdout file.
     /// \param stderr_file_ Path to the subprocess's stderr file.
     /// \param start_time_ Timestamp of when this object was constructed.
-    /// \param timeout Maximum amount of time the subprocess can run for.
+    /// \param timer_ Timer to kill the subprocess on activation, or NULL.
     /// \param unprivileged_user_ User the subprocess is running as if
     ///     different than the current one.
     /// \param [in,out] state_owners_ Number of owners of the on-disk state.
@@ -169,7 +180,7 @@ struct utils::process::executor::exec_handle::impl : utils::noncopyable {
          const fs::path& stdout_file_,
          const fs::path& stderr_file_,
          const datetime::timestamp& start_time_,
-         const datetime::delta& timeout,
+         std::auto_ptr< process::deadline_killer > timer_,
          const optional< passwd::user > unprivileged_user_,
          executor::detail::refcnt_t state_owners_) :
         pid(pid_),
@@ -178,7 +189,7 @@ struct utils::process::executor::exec_handle::impl : utils::noncopyable {
         stderr_file(stderr_file_),
         start_time(start_time_),
         unprivileged_user(unprivileged_user_),
-        timer(timeout, pid_),
+        timer(timer_),
         state_owners(state_owners_)
     {
         (*state_owners)++;
@@ -267,6 +278,9 @@ struct utils::process::executor::exit_handle::impl : utils::noncopyable {
     /// Termination status of the subprocess, or none if it timed out.
     const optional< process::status > status;
 
+    /// Resources consumed by the subprocess, even if it timed out.
+    const process::resource_usage usage;
+
     /// The user the process ran as, if different than the current one.
     const optional< passwd::user > unprivileged_user;
 
@@ -309,6 +323,7 @@ struct utils::process::executor::exit_handle::impl : utils::noncopyable {
     /// \param original_pid_ Original PID of the terminated subprocess.
     /// \param status_ Termination status of the subprocess, or none if
     ///     timed out.
+    /// \param usage_ Resources consumed by the subprocess.
     /// \param unprivileged_user_ The user the process ran as, if different than
     ///     the current one.
     /// \param start_time_ Timestamp of when the subprocess was spawned.
@@ -324,6 +339,7 @@ struct utils::process::executor::exit_handle::impl : utils::noncopyable {
     ///     the executor_handle object.
     impl(const int original_pid_,
          const optional< process::status > status_,
+         const process::resource_usage& usage_,
          const optional< passwd::user > unprivileged_user_,
          const datetime::timestamp& start_time_,
          const datetime::timestamp& end_time_,
@@ -332,7 +348,7 @@ struct utils::process::executor::exit_handle::impl : utils::noncopyable {
          const fs::path& stderr_file_,
          detail::refcnt_t state_owners_,
          exec_handles_map& all_exec_handles_) :
-        original_pid(original_pid_), status(status_),
+        original_pid(original_pid_), status(status_), usage(usage_),
         unprivileged_user(unprivileged_user_),
         start_time(start_time_), end_time(end_time_),
         control_directory(control_directory_),
@@ -366,6 +382,8 @@ struct utils::process::executor::exit_handle::impl : utils::noncopyable {
         PRE(*state_owners > 0);
         if (*state_owners == 1) {
             LI(F("Cleaning up exit_handle for exec_handle %s") % original_pid);
+            trace::span span("rm_r", trace::main_track,
+                             control_directory.str());
             fs::rm_r(control_directory);
         } else {
             LI(F("Not cleaning up exit_handle for exec_handle %s; "
@@ -452,6 +470,20 @@ executor::exit_handle::status(void) const
 }
 
 
+/// Returns the resources consumed by the subprocess.
+///
+/// Unlike status(), this is available for subprocesses that timed out, which
+/// accounts for the time they spent running until they were killed.
+///
+/// \return The resource usage of the subprocess, or all zeros if the platform
+/// cannot report it.
+const process::resource_usage&
+executor::exit_handle::usage(void) const
+{
+    return _pimpl->usage;
+}
+
+
 /// Returns the user the process ran as if different than the current one.
 ///
 /// \return None if the credentials of the process were the same as the current
@@ -547,6 +579,12 @@ struct utils::process::executor::executor_handle::impl : utils::noncopyable {
     /// Mapping of PIDs to the data required at run time.
     exec_handles_map all_exec_handles;
 
+    /// Multiplexer of subprocess terminations and deadlines.
+    ///
+    /// This is NULL if the running system does not support it, in which case
+    /// we fall back to wait(2) and to one deadline_killer per subprocess.
+    std::auto_ptr< process::wait_set > wait_set;
+
     /// Whether the executor state has been cleaned yet or not.
     ///
     /// Used to keep track of explicit calls to the public cleanup().
@@ -558,6 +596,8 @@ struct utils::process::executor::executor_handle::impl : utils::noncopyable {
         interrupts_handler(new signals::interrupts_handler()),
         root_work_directory(new fs::auto_directory(
             fs::auto_directory::mkdtemp_public(work_directory_template))),
+        wait_set(process::wait_set::is_supported() ?
+                 new process::wait_set() : NULL),
         cleaned(false)
     {
     }
@@ -602,6 +642,7 @@ struct utils::process::executor::executor_handle::impl : utils::noncopyable {
             }
         }
         all_exec_handles.clear();
+        wait_set.reset(NULL);
 
         try {
             // The following only causes the work directory to be deleted, not
@@ -621,6 +662,34 @@ struct utils::process::executor::executor_handle::impl : utils::noncopyable {
         interrupts_handler.reset(NULL);
     }
 
+    /// Starts enforcing the deadline of a new subprocess.
+    ///
+    /// \param pid The PID of the new subprocess.
+    /// \param timeout Maximum amount of time the subprocess can run for.
+    ///
+    /// \return The timer that kills the subprocess on activation, or NULL if
+    /// the deadline is enforced by the wait_set.
+    ///
+    /// \throw process::system_error If the subprocess cannot be tracked.  In
+    ///     this case, the subprocess is terminated and reaped before returning.
+    std::auto_ptr< process::deadline_killer >
+    track_deadline(const int pid, const datetime::delta& timeout)
+    {
+        std::auto_ptr< process::deadline_killer > timer;
+        if (wait_set.get() == NULL) {
+            timer.reset(new process::deadline_killer(timeout, pid));
+        } else {
+            try {
+                wait_set->add(pid, timeout);
+            } catch (...) {
+                process::terminate_group(pid);
+                (void)process::wait(pid);
+                throw;
+            }
+        }
+        return timer;
+    }
+
     /// Common code to run after any of the wait calls.
     ///
     /// \param original_pid The PID of the terminated subprocess.
@@ -638,7 +707,14 @@ struct utils::process::executor::executor_handle::impl : utils::noncopyable {
         const exec_handles_map::iterator iter = all_exec_handles.find(
             original_pid);
         exec_handle& data = (*iter).second;
-        data._pimpl->timer.unprogram();
+        bool timed_out;
+        if (data._pimpl->timer.get() != NULL) {
+            data._pimpl->timer->unprogram();
+            timed_out = data._pimpl->timer->fired();
+        } else {
+            timed_out = wait_set->timed_out(original_pid);
+            wait_set->remove(original_pid);
+        }
 
         // It is tempting to assert here (and old code did) that, if the timer
         // has fired, the process has been forcibly killed by us.  This is not
@@ -661,8 +737,8 @@ struct utils::process::executor::executor_handle::impl : utils::noncopyable {
         return exit_handle(std::shared_ptr< exit_handle::impl >(
             new exit_handle::impl(
                 data.pid(),
-                data._pimpl->timer.fired() ?
-                    none : utils::make_optional(status),
+                timed_out ? none : utils::make_optional(status),
+                status.usage(),
                 data._pimpl->unprivileged_user,
                 data._pimpl->start_time, datetime::timestamp::now(),
                 data.control_directory(),
@@ -744,6 +820,65 @@ executor::executor_handle::spawn_pre(void)
 }
 
 
+/// Helper for the spawn_command() method to start a process without forking.
+///
+/// \param cmd The program to execute.
+/// \param limits Resource limits to apply to the subprocess.
+/// \param unprivileged_user If not none, user to switch to before execution.
+/// \param work_directory Directory to enter when running the subprocess.
+/// \param stdout_file Path to the subprocess' stdout.
+/// \param stderr_file Path to the subprocess' stderr.
+///
+/// \return The new process or NULL if the caller has to fork a subprocess to
+/// run the hook instead.
+std::auto_ptr< process::child >
+executor::executor_handle::spawn_isolated(
+    const command& cmd,
+    const process::resource_limits& limits,
+    const optional< passwd::user > unprivileged_user,
+    const fs::path& work_directory,
+    const fs::path& stdout_file,
+    const fs::path& stderr_file)
+{
+    // Switching users requires running code in the subprocess.
+    if (unprivileged_user && passwd::current_user().is_root())
+        return std::auto_ptr< process::child >(NULL);
+
+    // So does lowering the resource limits: posix_spawn(3) cannot do it and,
+    // unlike with the core size, we cannot temporarily lower our own limits
+    // for the new process to inherit them without risking our own execution.
+    if (!limits.unlimited())
+        return std::auto_ptr< process::child >(NULL);
+
+    std::map< std::string, std::string > environment =
+        process::isolated_environment(work_directory);
+    for (std::map< std::string, std::string >::const_iterator iter =
+             cmd.environment.begin(); iter != cmd.environment.end(); ++iter)
+        environment[(*iter).first] = (*iter).second;
+
+    return process::child::spawn_isolated(cmd.program, cmd.args, environment,
+                                          work_directory, stdout_file,
+                                          stderr_file);
+}
+
+
+/// Executes a command from within a subprocess started by the executor.
+///
+/// This is the counterpart of the spawn_isolated() path for hooks that have to
+/// run in a forked subprocess: it applies the environment of the command on
+/// top of the isolated environment that the subprocess already has.
+///
+/// \param cmd The command to execute.
+void
+executor::exec(const command& cmd) throw()
+{
+    for (std::map< std::string, std::string >::const_iterator iter =
+             cmd.environment.begin(); iter != cmd.environment.end(); ++iter)
+        utils::setenv((*iter).first, (*iter).second);
+    process::exec(cmd.program, cmd.args);
+}
+
+
 /// Post-helper for the spawn() method.
 ///
 /// \param control_directory Control directory as returned by spawn_pre().
@@ -763,6 +898,8 @@ executor::executor_handle::spawn_post(
     const optional< passwd::user > unprivileged_user,
     std::auto_ptr< process::child > child)
 {
+    std::auto_ptr< process::deadline_killer > timer =
+        _pimpl->track_deadline(child->pid(), timeout);
     const exec_handle handle(std::shared_ptr< exec_handle::impl >(
         new exec_handle::impl(
             child->pid(),
@@ -770,7 +907,7 @@ executor::executor_handle::spawn_post(
             stdout_file,
             stderr_file,
             datetime::timestamp::now(),
-            timeout,
+            timer,
             unprivileged_user,
             detail::refcnt_t(new detail::refcnt_t::element_type(0)))));
     INV_MSG(_pimpl->all_exec_handles.find(handle.pid()) ==
@@ -806,6 +943,8 @@ executor::executor_handle::spawn_followup_post(
     std::auto_ptr< process::child > child)
 {
     INV(*base.state_owners() > 0);
+    std::auto_ptr< process::deadline_killer > timer =
+        _pimpl->track_deadline(child->pid(), timeout);
     const exec_handle handle(std::shared_ptr< exec_handle::impl >(
         new exec_handle::impl(
             child->pid(),
@@ -813,7 +952,7 @@ executor::executor_handle::spawn_followup_post(
             base.stdout_file(),
             base.stderr_file(),
             datetime::timestamp::now(),
-            timeout,
+            timer,
             base.unprivileged_user(),
             base.state_owners())));
     INV_MSG(_pimpl->all_exec_handles.find(handle.pid()) ==
@@ -836,6 +975,8 @@ executor::exit_handle
 executor::executor_handle::wait(const exec_handle exec_handle)
 {
     signals::check_interrupt();
+    if (_pimpl->wait_set.get() != NULL)
+        _pimpl->wait_set->wait(exec_handle.pid());
     const process::status status = process::wait(exec_handle.pid());
     return _pimpl->post_wait(exec_handle.pid(), status);
 }
@@ -848,7 +989,8 @@ executor::exit_handle
 executor::executor_handle::wait_any(void)
 {
     signals::check_interrupt();
-    const process::status status = process::wait_any();
+    const process::status status = _pimpl->wait_set.get() != NULL ?
+        process::wait(_pimpl->wait_set->wait_any()) : process::wait_any();
     return _pimpl->post_wait(status.dead_pid(), status);
 }
 
@@ -65,12 +65,18 @@
 #include "utils/process/executor_fwd.hpp"
 
 #include <cstddef>
+#include <map>
+#include <string>
 
 #include "utils/datetime_fwd.hpp"
-#include "utils/fs/path_fwd.hpp"
+#include "utils/defs.hpp"
+#include "utils/fs/path.hpp"
 #include "utils/optional.hpp"
 #include "utils/passwd_fwd.hpp"
 #include "utils/process/child_fwd.hpp"
+#include "utils/process/isolation_fwd.hpp"
+#include "utils/process/operations_fwd.hpp"
+#include "utils/process/resource_usage_fwd.hpp"
 #include "utils/process/status_fwd.hpp"
 #include "utils/shared_ptr.hpp"
 
@@ -92,12 +98,38 @@ typedef std::shared_ptr< std::size_t > refcnt_t;
 
 
 void setup_child(const utils::optional< utils::passwd::user >,
-                 const utils::fs::path&, const utils::fs::path&);
+                 const utils::fs::path&, const utils::fs::path&,
+                 const utils::process::resource_limits&);
 
 
 }   // namespace detail
 
 
+/// Description of a program to execute as is in an isolated subprocess.
+///
+/// Hooks passed to executor_handle::spawn_command() return one of these when
+/// all they would do in the subprocess is to execute another program.  This
+/// allows the executor to start the program without forking.
+struct command {
+    /// The binary to execute.
+    utils::fs::path program;
+
+    /// The arguments to pass to the binary, without the program name.
+    args_vector args;
+
+    /// Environment variables to set on top of the isolated environment.
+    std::map< std::string, std::string > environment;
+
+    /// Constructor.
+    ///
+    /// \param program_ The binary to execute.
+    command(const utils::fs::path& program_) : program(program_) {}
+};
+
+
+void exec(const command&) throw() UTILS_NORETURN;
+
+
 /// Maintenance data held while a subprocess is being executed.
 ///
 /// This data structure exists from the moment a subprocess is executed via
@@ -158,6 +190,7 @@ public:
 
     int original_pid(void) const;
     const utils::optional< utils::process::status >& status(void) const;
+    const utils::process::resource_usage& usage(void) const;
     const utils::optional< utils::passwd::user >& unprivileged_user(void) const;
     const utils::datetime::timestamp& start_time() const;
     const utils::datetime::timestamp& end_time() const;
@@ -182,6 +215,13 @@ class executor_handle {
     executor_handle(void) throw();
 
     utils::fs::path spawn_pre(void);
+    std::auto_ptr< utils::process::child > spawn_isolated(
+        const command&,
+        const utils::process::resource_limits&,
+        const utils::optional< utils::passwd::user >,
+        const utils::fs::path&,
+        const utils::fs::path&,
+        const utils::fs::path&);
     exec_handle spawn_post(const utils::fs::path&,
                            const utils::fs::path&,
                            const utils::fs::path&,
@@ -208,6 +248,16 @@ public:
                       const utils::optional< utils::fs::path > = utils::none,
                       const utils::optional< utils::fs::path > = utils::none);
 
+    template< class Hook >
+    exec_handle spawn_command(Hook,
+                              const datetime::delta&,
+                              const utils::process::resource_limits&,
+                              const utils::optional< utils::passwd::user >,
+                              const utils::optional< utils::fs::path > =
+                                  utils::none,
+                              const utils::optional< utils::fs::path > =
+                                  utils::none);
+
     template< class Hook >
     exec_handle spawn_followup(Hook,
                                const exit_handle&,
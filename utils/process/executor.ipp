@@ -35,6 +35,7 @@
 #include "utils/optional.ipp"
 #include "utils/passwd.hpp"
 #include "utils/process/child.ipp"
+#include "utils/process/isolation.hpp"
 
 namespace utils {
 namespace process {
@@ -68,6 +69,9 @@ class run_child {
     /// the control and work directories will be writable by this user.
     const optional< passwd::user > _unprivileged_user;
 
+    /// Resource limits to apply to the subprocess.
+    const process::resource_limits _limits;
+
 public:
     /// Constructor.
     ///
@@ -75,14 +79,17 @@ public:
     /// \param control_directory Directory where control files can be placed.
     /// \param work_directory Directory to enter when running the subprocess.
     /// \param unprivileged_user If set, user to switch to before execution.
+    /// \param limits Resource limits to apply to the subprocess.
     run_child(Hook hook,
               const fs::path& control_directory,
               const fs::path& work_directory,
-              const optional< passwd::user > unprivileged_user) :
+              const optional< passwd::user > unprivileged_user,
+              const process::resource_limits& limits) :
         _hook(hook),
         _control_directory(control_directory),
         _work_directory(work_directory),
-        _unprivileged_user(unprivileged_user)
+        _unprivileged_user(unprivileged_user),
+        _limits(limits)
     {
     }
 
@@ -91,7 +98,8 @@ public:
     operator()(void)
     {
         executor::detail::setup_child(_unprivileged_user,
-                                      _control_directory, _work_directory);
+                                      _control_directory, _work_directory,
+                                      _limits);
         _hook(_control_directory);
     }
 };
@@ -133,7 +141,8 @@ executor::executor_handle::spawn(
         detail::run_child< Hook >(hook,
                                   unique_work_directory,
                                   unique_work_directory / detail::work_subdir,
-                                  unprivileged_user),
+                                  unprivileged_user,
+                                  process::resource_limits()),
         stdout_path, stderr_path);
 
     return spawn_post(unique_work_directory, stdout_path, stderr_path,
@@ -141,6 +150,65 @@ executor::executor_handle::spawn(
 }
 
 
+/// Executes a subprocess asynchronously, avoiding a fork if possible.
+///
+/// This is like spawn() but the hook is first asked for the program it would
+/// execute.  If it provides one, and the program can be started without
+/// running any code in the subprocess, the subprocess is started without
+/// forking the current process.  Otherwise, this falls back to running the
+/// hook in a forked subprocess.
+///
+/// \tparam Hook Type of the hook.  In addition to the requirements of spawn(),
+///     it must provide an "optional< command > command(const fs::path&)"
+///     method that receives the control directory of the subprocess.
+/// \param hook Function or functor to run in the subprocess.
+/// \param timeout Maximum amount of time the subprocess can run for.
+/// \param limits Resource limits to apply to the subprocess.
+/// \param unprivileged_user If not none, user to switch to before execution.
+/// \param stdout_target If not none, file to which to write the stdout of the
+///     test case.
+/// \param stderr_target If not none, file to which to write the stderr of the
+///     test case.
+///
+/// \return A handle for the background operation.  Used to match the result of
+/// the execution returned by wait_any() with this invocation.
+template< class Hook >
+executor::exec_handle
+executor::executor_handle::spawn_command(
+    Hook hook,
+    const datetime::delta& timeout,
+    const process::resource_limits& limits,
+    const optional< passwd::user > unprivileged_user,
+    const optional< fs::path > stdout_target,
+    const optional< fs::path > stderr_target)
+{
+    const fs::path unique_work_directory = spawn_pre();
+
+    const fs::path stdout_path = stdout_target ?
+        stdout_target.get() : (unique_work_directory / detail::stdout_name);
+    const fs::path stderr_path = stderr_target ?
+        stderr_target.get() : (unique_work_directory / detail::stderr_name);
+    const fs::path work_directory = unique_work_directory / detail::work_subdir;
+
+    std::auto_ptr< process::child > child;
+    const optional< command > cmd = hook.command(unique_work_directory);
+    if (cmd)
+        child = spawn_isolated(cmd.get(), limits, unprivileged_user,
+                               work_directory, stdout_path, stderr_path);
+    if (child.get() == NULL)
+        child = process::child::fork_files(
+            detail::run_child< Hook >(hook,
+                                      unique_work_directory,
+                                      work_directory,
+                                      unprivileged_user,
+                                      limits),
+            stdout_path, stderr_path);
+
+    return spawn_post(unique_work_directory, stdout_path, stderr_path,
+                      timeout, unprivileged_user, child);
+}
+
+
 /// Forks and executes a subprocess asynchronously in the context of another.
 ///
 /// By context we understand the on-disk state of a previously-executed process,
@@ -169,7 +237,8 @@ executor::executor_handle::spawn_followup(Hook hook,
         detail::run_child< Hook >(hook,
                                   base.control_directory(),
                                   base.work_directory(),
-                                  base.unprivileged_user()),
+                                  base.unprivileged_user(),
+                                  process::resource_limits()),
         base.stdout_file(), base.stderr_file());
 
     return spawn_followup_post(base, timeout, child);
@@ -37,6 +37,7 @@ namespace process {
 namespace executor {
 
 
+struct command;
 class exec_handle;
 class executor_handle;
 class exit_handle;
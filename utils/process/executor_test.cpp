@@ -28,6 +28,10 @@
 
 #include "utils/process/executor.ipp"
 
+#if defined(HAVE_CONFIG_H)
+#   include "config.h"
+#endif
+
 extern "C" {
 #include <sys/types.h>
 #include <sys/time.h>
@@ -54,12 +58,15 @@ extern "C" {
 #include "utils/fs/path.hpp"
 #include "utils/optional.ipp"
 #include "utils/passwd.hpp"
+#include "utils/process/isolation.hpp"
+#include "utils/process/resource_usage.hpp"
 #include "utils/process/status.hpp"
 #include "utils/sanity.hpp"
 #include "utils/signals/exceptions.hpp"
 #include "utils/stacktrace.hpp"
 #include "utils/text/exceptions.hpp"
 #include "utils/text/operations.ipp"
+#include "utils/units.hpp"
 
 namespace datetime = utils::datetime;
 namespace executor = utils::process::executor;
@@ -68,6 +75,7 @@ namespace passwd = utils::passwd;
 namespace process = utils::process;
 namespace signals = utils::signals;
 namespace text = utils::text;
+namespace units = utils::units;
 
 using utils::none;
 using utils::optional;
@@ -201,6 +209,98 @@ public:
 };
 
 
+/// Subprocess that can be started without forking by spawn_command().
+class child_command {
+    /// Whether to provide a command or to let the hook run.
+    bool _provide_command;
+
+public:
+    /// Constructor.
+    ///
+    /// \param provide_command Whether command() returns a command or none.
+    child_command(const bool provide_command) :
+        _provide_command(provide_command)
+    {
+    }
+
+    /// Describes the program to execute instead of running operator().
+    ///
+    /// \param unused_control_directory Directory where control files separate
+    ///     from the work directory can be placed.
+    ///
+    /// \return A shell command that prints its environment and exits with 42,
+    /// or none if the hook has to run.
+    optional< executor::command >
+    command(const fs::path& UTILS_UNUSED_PARAM(control_directory)) const
+    {
+        if (!_provide_command)
+            return none;
+
+        executor::command cmd(fs::path("/bin/sh"));
+        cmd.args.push_back("-c");
+        cmd.args.push_back("echo \"${FOO}:${HOME}:${LANG-unset}\"; exit 42");
+        cmd.environment["FOO"] = "bar";
+        return utils::make_optional(cmd);
+    }
+
+    /// Runs the subprocess.
+    ///
+    /// \param unused_control_directory Directory where control files separate
+    ///     from the work directory can be placed.
+    void
+    operator()(const fs::path& UTILS_UNUSED_PARAM(control_directory))
+        UTILS_NORETURN
+    {
+        do_exit(43);
+    }
+};
+
+
+/// Subprocess that runs the command of child_command through exec().
+class child_exec_command {
+public:
+    /// Runs the subprocess.
+    ///
+    /// \param control_directory Directory where control files separate from
+    ///     the work directory can be placed.
+    void
+    operator()(const fs::path& control_directory) UTILS_NORETURN
+    {
+        executor::exec(child_command(true).command(control_directory).get());
+    }
+};
+
+
+/// Subprocess that burns CPU time forever.
+class child_spin {
+public:
+    /// Describes the program to execute instead of running operator().
+    ///
+    /// \param unused_control_directory Directory where control files separate
+    ///     from the work directory can be placed.
+    ///
+    /// \return Always none, as the hook has to run.
+    optional< executor::command >
+    command(const fs::path& UTILS_UNUSED_PARAM(control_directory)) const
+    {
+        return none;
+    }
+
+    /// Runs the subprocess.
+    ///
+    /// \param unused_control_directory Directory where control files separate
+    ///     from the work directory can be placed.
+    void
+    operator()(const fs::path& UTILS_UNUSED_PARAM(control_directory))
+        UTILS_NORETURN
+    {
+        volatile unsigned long counter = 0;
+        for (;;)
+            ++counter;
+    }
+};
+
+
 static void child_pause(const fs::path&) UTILS_NORETURN;
 
 
@@ -559,6 +659,27 @@ ATF_TEST_CASE_BODY(integration__timestamps)
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(integration__usage);
+ATF_TEST_CASE_BODY(integration__usage)
+{
+#if !defined(HAVE_WAIT4)
+    ATF_SKIP("wait4(2) not supported by this platform");
+#endif
+
+    executor::executor_handle handle = executor::setup();
+
+    do_spawn(handle, child_exit(0));
+    executor::exit_handle exit_handle = handle.wait_any();
+
+    require_exit(0, exit_handle.status());
+    ATF_REQUIRE(static_cast< uint64_t >(exit_handle.usage().max_rss) > 0);
+    ATF_REQUIRE_EQ(exit_handle.status().get().usage(), exit_handle.usage());
+    exit_handle.cleanup();
+
+    handle.cleanup();
+}
+
+
 ATF_TEST_CASE_WITHOUT_HEAD(integration__files);
 ATF_TEST_CASE_BODY(integration__files)
 {
@@ -581,6 +702,83 @@ ATF_TEST_CASE_BODY(integration__files)
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(integration__spawn_command__command);
+ATF_TEST_CASE_BODY(integration__spawn_command__command)
+{
+    utils::setenv("LANG", "C");
+
+    executor::executor_handle handle = executor::setup();
+
+    (void)handle.spawn_command(child_command(true), infinite_timeout,
+                               process::resource_limits(), none);
+
+    executor::exit_handle exit_handle = handle.wait_any();
+    require_exit(42, exit_handle.status());
+    ATF_REQUIRE(atf::utils::compare_file(
+        exit_handle.stdout_file().str(),
+        F("bar:%s:unset\n") % exit_handle.work_directory()));
+    exit_handle.cleanup();
+
+    handle.cleanup();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(integration__spawn_command__hook);
+ATF_TEST_CASE_BODY(integration__spawn_command__hook)
+{
+    executor::executor_handle handle = executor::setup();
+
+    (void)handle.spawn_command(child_command(false), infinite_timeout,
+                               process::resource_limits(), none);
+
+    executor::exit_handle exit_handle = handle.wait_any();
+    require_exit(43, exit_handle.status());
+    exit_handle.cleanup();
+
+    handle.cleanup();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(integration__exec_command);
+ATF_TEST_CASE_BODY(integration__exec_command)
+{
+    utils::setenv("LANG", "C");
+
+    executor::executor_handle handle = executor::setup();
+
+    (void)handle.spawn(child_exec_command(), infinite_timeout, none);
+
+    executor::exit_handle exit_handle = handle.wait_any();
+    require_exit(42, exit_handle.status());
+    ATF_REQUIRE(atf::utils::compare_file(
+        exit_handle.stdout_file().str(),
+        F("bar:%s:unset\n") % exit_handle.work_directory()));
+    exit_handle.cleanup();
+
+    handle.cleanup();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(integration__spawn_command__cpu_limit);
+ATF_TEST_CASE_BODY(integration__spawn_command__cpu_limit)
+{
+    executor::executor_handle handle = executor::setup();
+
+    const process::resource_limits limits(datetime::delta(1, 0),
+                                          units::bytes());
+    (void)handle.spawn_command(child_spin(), datetime::delta(60, 0),
+                               limits, none);
+
+    executor::exit_handle exit_handle = handle.wait_any();
+    ATF_REQUIRE(exit_handle.status());
+    ATF_REQUIRE(exit_handle.status().get().signaled());
+    ATF_REQUIRE_EQ(SIGXCPU, exit_handle.status().get().termsig());
+    exit_handle.cleanup();
+
+    handle.cleanup();
+}
+
+
 ATF_TEST_CASE_WITHOUT_HEAD(integration__followup);
 ATF_TEST_CASE_BODY(integration__followup)
 {
@@ -950,8 +1148,14 @@ ATF_INIT_TEST_CASES(tcs)
     ATF_ADD_TEST_CASE(tcs, integration__parameters_and_output);
     ATF_ADD_TEST_CASE(tcs, integration__custom_output_files);
     ATF_ADD_TEST_CASE(tcs, integration__timestamps);
+    ATF_ADD_TEST_CASE(tcs, integration__usage);
     ATF_ADD_TEST_CASE(tcs, integration__files);
 
+    ATF_ADD_TEST_CASE(tcs, integration__spawn_command__command);
+    ATF_ADD_TEST_CASE(tcs, integration__spawn_command__hook);
+    ATF_ADD_TEST_CASE(tcs, integration__exec_command);
+    ATF_ADD_TEST_CASE(tcs, integration__spawn_command__cpu_limit);
+
     ATF_ADD_TEST_CASE(tcs, integration__followup);
 
     ATF_ADD_TEST_CASE(tcs, integration__output_files_always_exist);
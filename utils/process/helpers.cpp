@@ -26,6 +26,15 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+extern "C" {
+#include <sys/stat.h>
+
+#include <signal.h>
+#include <unistd.h>
+
+extern char** environ;
+}
+
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
@@ -55,6 +64,38 @@ return_code(int argc, char* argv[])
 }
 
 
+static int
+print_state(void)
+{
+    char cwd[1024];
+    if (::getcwd(cwd, sizeof(cwd)) == NULL)
+        std::abort();
+    std::cout << "cwd = " << cwd << "\n";
+
+    const mode_t mask = ::umask(0);
+    std::cout << "umask = " << std::oct << mask << std::dec << "\n";
+
+    std::cout << "session = " << (::getsid(0) == ::getpid() ? "own" : "other")
+              << "\n";
+
+    struct ::sigaction sa;
+    if (::sigaction(SIGTERM, NULL, &sa) == -1)
+        std::abort();
+    std::cout << "sigterm = " << (sa.sa_handler == SIG_DFL ? "default" :
+                                  "other") << "\n";
+
+    ::sigset_t mask_set;
+    if (::sigprocmask(SIG_BLOCK, NULL, &mask_set) == -1)
+        std::abort();
+    std::cout << "sigterm blocked = "
+              << (sigismember(&mask_set, SIGTERM) ? "yes" : "no") << "\n";
+
+    for (char** iter = environ; *iter != NULL; ++iter)
+        std::cout << "env = " << *iter << "\n";
+    return EXIT_SUCCESS;
+}
+
+
 int
 main(int argc, char* argv[])
 {
@@ -65,6 +106,8 @@ main(int argc, char* argv[])
 
     if (std::strcmp(argv[1], "print-args") == 0) {
         return print_args(argc, argv);
+    } else if (std::strcmp(argv[1], "print-state") == 0) {
+        return print_state();
     } else if (std::strcmp(argv[1], "return-code") == 0) {
         return return_code(argc, argv);
     } else {
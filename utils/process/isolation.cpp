@@ -28,14 +28,24 @@
 
 #include "utils/process/isolation.hpp"
 
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
 extern "C" {
+#include <sys/types.h>
+#include <sys/resource.h>
 #include <sys/stat.h>
 
 #include <grp.h>
+#if defined(HAVE_SCHED_GETAFFINITY) || defined(HAVE_SCHED_SETAFFINITY)
+#   include <sched.h>
+#endif
 #include <signal.h>
 #include <unistd.h>
 }
 
+#include <algorithm>
 #include <cerrno>
 #include <cstdlib>
 #include <cstring>
@@ -51,11 +61,15 @@ extern "C" {
 #include "utils/sanity.hpp"
 #include "utils/signals/misc.hpp"
 #include "utils/stacktrace.hpp"
+#include "utils/text/operations.ipp"
 
+namespace datetime = utils::datetime;
 namespace fs = utils::fs;
 namespace passwd = utils::passwd;
 namespace process = utils::process;
 namespace signals = utils::signals;
+namespace text = utils::text;
+namespace units = utils::units;
 
 using utils::optional;
 
@@ -83,6 +97,40 @@ fail(const std::string& message, const int original_errno)
 }
 
 
+/// Lowers a resource limit of the current process.
+///
+/// This function is intended to be called from a subprocess getting ready to
+/// invoke an external binary.  Therefore, if there is any error during the
+/// setup, the new process is terminated with an error code.
+///
+/// \param resource The name of the resource, for error reporting purposes.
+/// \param id The identifier of the resource as given to setrlimit(2).
+/// \param soft The new soft limit.
+/// \param hard The new hard limit.  Must be greater or equal than soft.
+static void
+lower_limit(const char* resource, const int id, ::rlim_t soft, ::rlim_t hard)
+{
+    PRE(soft <= hard);
+
+    struct ::rlimit rl;
+    if (::getrlimit(id, &rl) == -1)
+        fail(F("getrlimit(%s) failed") % resource, errno);
+
+    // Unprivileged processes cannot raise their hard limit, so respect any
+    // stricter limit that is already in place.
+    if (rl.rlim_max != RLIM_INFINITY) {
+        hard = std::min(hard, rl.rlim_max);
+        soft = std::min(soft, hard);
+    }
+
+    rl.rlim_cur = soft;
+    rl.rlim_max = hard;
+    if (::setrlimit(id, &rl) == -1)
+        fail(F("setrlimit(%s, %s, %s) failed") % resource % soft % hard,
+             errno);
+}
+
+
 /// Changes the owner of a path.
 ///
 /// This function is intended to be called from a subprocess getting ready to
@@ -101,18 +149,23 @@ do_chown(const fs::path& file, const uid_t uid, const gid_t gid)
 }
 
 
+/// Environment variables removed from the environment of isolated processes.
+static const char* const to_unset[] = {
+    "LANG", "LC_ALL", "LC_COLLATE", "LC_CTYPE", "LC_MESSAGES", "LC_MONETARY",
+    "LC_NUMERIC", "LC_TIME", NULL };
+
+
 /// Resets the environment of the process to a known state.
 ///
+/// Keep in sync with isolated_environment().
+///
 /// \param work_directory Path to the work directory being used.
 ///
 /// \throw std::runtime_error If there is a problem setting up the environment.
 static void
 prepare_environment(const fs::path& work_directory)
 {
-    const char* to_unset[] = { "LANG", "LC_ALL", "LC_COLLATE", "LC_CTYPE",
-                               "LC_MESSAGES", "LC_MONETARY", "LC_NUMERIC",
-                               "LC_TIME", NULL };
-    const char** iter;
+    const char* const* iter;
     for (iter = to_unset; *iter != NULL; ++iter) {
         utils::unsetenv(*iter);
     }
@@ -126,6 +179,46 @@ prepare_environment(const fs::path& work_directory)
 }  // anonymous namespace
 
 
+/// Constructs a set of limits that leaves all resources unlimited.
+process::resource_limits::resource_limits(void)
+{
+}
+
+
+/// Constructs a set of limits.
+///
+/// \param cpu_time_ Maximum CPU time that the process can use, or zero.
+/// \param memory_ Maximum size of the address space of the process, or zero.
+process::resource_limits::resource_limits(const datetime::delta& cpu_time_,
+                                          const units::bytes& memory_) :
+    cpu_time(cpu_time_),
+    memory(memory_)
+{
+}
+
+
+/// Checks whether no resource is limited at all.
+///
+/// \return True if all the limits are zero and the process is not pinned to
+/// any CPUs; false otherwise.
+bool
+process::resource_limits::unlimited(void) const
+{
+    return cpu_time == datetime::delta() && memory == 0 && cpus.empty();
+}
+
+
+/// Gets the CPU time limit that is actually enforced on the process.
+///
+/// \return The CPU time limit rounded up to whole seconds, which is the
+/// granularity of RLIMIT_CPU, or zero if the CPU time is not limited.
+int64_t
+process::resource_limits::cpu_time_seconds(void) const
+{
+    return cpu_time.seconds + (cpu_time.useconds > 0 ? 1 : 0);
+}
+
+
 /// Cleans up the container process to run a new child.
 ///
 /// If there is any error during the setup, the new process is terminated
@@ -133,15 +226,18 @@ prepare_environment(const fs::path& work_directory)
 ///
 /// \param unprivileged_user Unprivileged user to run the test case as.
 /// \param work_directory Path to the test case-specific work directory.
+/// \param limits Resource limits to apply to the process.
 void
 process::isolate_child(const optional< passwd::user >& unprivileged_user,
-                       const fs::path& work_directory)
+                       const fs::path& work_directory,
+                       const resource_limits& limits)
 {
     isolate_path(unprivileged_user, work_directory);
     if (::chdir(work_directory.c_str()) == -1)
         fail(F("chdir(%s) failed") % work_directory, errno);
 
     utils::unlimit_core_size();
+    limit_resources(limits);
     if (!signals::reset_all()) {
         LW("Failed to reset one or more signals to their default behavior");
     }
@@ -172,6 +268,30 @@ process::isolate_child(const optional< passwd::user >& unprivileged_user,
 }
 
 
+/// Computes the environment that isolate_child() would leave in place.
+///
+/// This is for the callers that start a process without running any code in
+/// it before the exec(2), as they must pass it its whole environment.
+///
+/// \param work_directory Path to the test case-specific work directory.
+///
+/// \return The environment variables of the isolated process.
+std::map< std::string, std::string >
+process::isolated_environment(const fs::path& work_directory)
+{
+    std::map< std::string, std::string > environment = utils::getallenv();
+    const char* const* iter;
+    for (iter = to_unset; *iter != NULL; ++iter) {
+        environment.erase(*iter);
+    }
+
+    environment["HOME"] = work_directory.str();
+    environment["TMPDIR"] = work_directory.str();
+    environment["TZ"] = "UTC";
+    return environment;
+}
+
+
 /// Sets up a path to be writable by a child isolated with isolate_child.
 ///
 /// If there is any error during the setup, the new process is terminated
@@ -205,3 +325,85 @@ process::isolate_path(const optional< passwd::user >& unprivileged_user,
         do_chown(file, user.uid, ::getgid());
     }
 }
+
+
+/// Applies resource limits to the current process.
+///
+/// The CPU time limit is rounded up to whole seconds, which is the granularity
+/// of RLIMIT_CPU.  The process receives SIGXCPU when it reaches the limit so
+/// that callers can tell this termination cause apart from others, and is
+/// killed one second later if it handles the signal and keeps running.
+///
+/// The memory limit is applied to the address space of the process where the
+/// system supports it and to its data segment otherwise.
+///
+/// The CPUs are applied as the affinity mask of the process where the system
+/// supports it and are ignored otherwise.
+///
+/// This function is intended to be called from a subprocess getting ready to
+/// invoke an external binary.  Therefore, if there is any error during the
+/// setup, the new process is terminated with an error code.
+///
+/// \param limits The limits to apply.  Zero values are ignored.
+void
+process::limit_resources(const resource_limits& limits)
+{
+    if (limits.cpu_time != datetime::delta()) {
+        const ::rlim_t seconds = static_cast< ::rlim_t >(
+            limits.cpu_time_seconds());
+        lower_limit("RLIMIT_CPU", RLIMIT_CPU, seconds, seconds + 1);
+    }
+
+    if (limits.memory != 0) {
+        const ::rlim_t bytes = static_cast< ::rlim_t >(
+            static_cast< uint64_t >(limits.memory));
+#if defined(RLIMIT_AS)
+        lower_limit("RLIMIT_AS", RLIMIT_AS, bytes, bytes);
+#else
+        lower_limit("RLIMIT_DATA", RLIMIT_DATA, bytes, bytes);
+#endif
+    }
+
+    if (!limits.cpus.empty()) {
+#if defined(HAVE_SCHED_SETAFFINITY)
+        ::cpu_set_t mask;
+        CPU_ZERO(&mask);
+        for (std::set< int >::const_iterator iter = limits.cpus.begin();
+             iter != limits.cpus.end(); ++iter) {
+            PRE(*iter >= 0 && *iter < CPU_SETSIZE);
+            CPU_SET(*iter, &mask);
+        }
+        if (::sched_setaffinity(0, sizeof(mask), &mask) == -1)
+            fail(F("sched_setaffinity(%s) failed") %
+                 text::join(limits.cpus, ","), errno);
+#endif
+    }
+}
+
+
+/// Queries the CPUs on which the current process can run.
+///
+/// This honors any restrictions placed on the process, such as the cpuset of
+/// its control group or an affinity mask inherited from its parent.
+///
+/// \return The identifiers of the CPUs, or an empty set if the system cannot
+/// report them.
+std::set< int >
+process::allowed_cpus(void)
+{
+    std::set< int > cpus;
+#if defined(HAVE_SCHED_GETAFFINITY)
+    ::cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (::sched_getaffinity(0, sizeof(mask), &mask) == -1) {
+        const int original_errno = errno;
+        LW(F("sched_getaffinity failed: %s") % std::strerror(original_errno));
+        return cpus;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &mask))
+            cpus.insert(cpu);
+    }
+#endif
+    return cpus;
+}
@@ -35,9 +35,17 @@
 #if !defined(UTILS_PROCESS_ISOLATION_HPP)
 #define UTILS_PROCESS_ISOLATION_HPP
 
+#include "utils/process/isolation_fwd.hpp"
+
+#include <map>
+#include <set>
+#include <string>
+
+#include "utils/datetime.hpp"
 #include "utils/fs/path_fwd.hpp"
 #include "utils/optional_fwd.hpp"
 #include "utils/passwd_fwd.hpp"
+#include "utils/units.hpp"
 
 namespace utils {
 namespace process {
@@ -46,12 +54,43 @@ namespace process {
 extern const int exit_isolation_failure;
 
 
+/// Limits on the resources that an isolated process can consume.
+///
+/// A zero value in any of the fields means that the corresponding resource
+/// is not limited.
+class resource_limits {
+public:
+    /// Maximum CPU time, user and system combined, that the process can use.
+    datetime::delta cpu_time;
+
+    /// Maximum size of the address space of the process.
+    units::bytes memory;
+
+    /// CPUs on which the process can run; if empty, the process is not pinned.
+    std::set< int > cpus;
+
+    resource_limits(void);
+    resource_limits(const datetime::delta&, const units::bytes&);
+
+    bool unlimited(void) const;
+    int64_t cpu_time_seconds(void) const;
+};
+
+
 void isolate_child(const utils::optional< utils::passwd::user >&,
-                   const utils::fs::path&);
+                   const utils::fs::path&,
+                   const resource_limits& = resource_limits());
 
 void isolate_path(const utils::optional< utils::passwd::user >&,
                   const utils::fs::path&);
 
+std::map< std::string, std::string > isolated_environment(
+    const utils::fs::path&);
+
+void limit_resources(const resource_limits&);
+
+std::set< int > allowed_cpus(void);
+
 
 }  // namespace process
 }  // namespace utils
@@ -40,9 +40,11 @@ extern "C" {
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <set>
 
 #include <atf-c++.hpp>
 
+#include "utils/datetime.hpp"
 #include "utils/defs.hpp"
 #include "utils/env.hpp"
 #include "utils/format/macros.hpp"
@@ -54,10 +56,13 @@ extern "C" {
 #include "utils/process/status.hpp"
 #include "utils/sanity.hpp"
 #include "utils/test_utils.ipp"
+#include "utils/units.hpp"
 
+namespace datetime = utils::datetime;
 namespace fs = utils::fs;
 namespace passwd = utils::passwd;
 namespace process = utils::process;
+namespace units = utils::units;
 
 using utils::none;
 using utils::optional;
@@ -234,6 +239,70 @@ public:
 };
 
 
+/// Subprocess that validates that resource limits are applied.
+///
+/// \post Exits with success if the CPU time and address space limits are at
+/// most the requested values; failure otherwise.
+static void
+check_resource_limits(void)
+{
+    const process::resource_limits limits(datetime::delta(2, 500000),
+                                          units::bytes(units::GB));
+    process::isolate_child(none, fs::path("."), limits);
+
+    bool failed = false;
+
+    struct ::rlimit rl;
+    if (::getrlimit(RLIMIT_CPU, &rl) == -1) {
+        failed = true;
+        std::cout << "Failed to query the CPU time limit\n";
+    } else if (rl.rlim_cur == RLIM_INFINITY || rl.rlim_cur > 3) {
+        failed = true;
+        std::cout << F("Unexpected CPU time limit %s\n") % rl.rlim_cur;
+    }
+
+#if defined(RLIMIT_AS)
+    const int memory_resource = RLIMIT_AS;
+#else
+    const int memory_resource = RLIMIT_DATA;
+#endif
+    if (::getrlimit(memory_resource, &rl) == -1) {
+        failed = true;
+        std::cout << "Failed to query the memory limit\n";
+    } else if (rl.rlim_cur == RLIM_INFINITY || rl.rlim_cur > units::GB) {
+        failed = true;
+        std::cout << F("Unexpected memory limit %s\n") % rl.rlim_cur;
+    }
+
+    std::exit(failed ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+
+/// Subprocess that validates that CPU affinity is applied.
+///
+/// \post Exits with success if the process ends up pinned to the last of the
+/// CPUs it was allowed to run on; failure otherwise.
+static void
+check_cpu_affinity(void)
+{
+    const std::set< int > allowed = process::allowed_cpus();
+    if (allowed.empty()) {
+        std::cout << "Cannot query the CPU affinity\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    process::resource_limits limits;
+    limits.cpus.insert(*allowed.rbegin());
+    process::isolate_child(none, fs::path("."), limits);
+
+    if (process::allowed_cpus() != limits.cpus) {
+        std::cout << "CPU affinity not applied\n";
+        std::exit(EXIT_FAILURE);
+    }
+    std::exit(EXIT_SUCCESS);
+}
+
+
 /// Subprocess that validates that it owns a session.
 ///
 /// \post Exits with success if the process lives in its own session;
@@ -477,6 +546,27 @@ ATF_TEST_CASE_BODY(isolate_child__process_group)
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(isolate_child__resource_limits);
+ATF_TEST_CASE_BODY(isolate_child__resource_limits)
+{
+    const process::status status = fork_and_run(check_resource_limits);
+    ATF_REQUIRE(status.exited());
+    ATF_REQUIRE_EQ(EXIT_SUCCESS, status.exitstatus());
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(isolate_child__cpu_affinity);
+ATF_TEST_CASE_BODY(isolate_child__cpu_affinity)
+{
+    if (process::allowed_cpus().empty())
+        ATF_SKIP("CPU affinity not supported by this platform");
+
+    const process::status status = fork_and_run(check_cpu_affinity);
+    ATF_REQUIRE(status.exited());
+    ATF_REQUIRE_EQ(EXIT_SUCCESS, status.exitstatus());
+}
+
+
 ATF_TEST_CASE_WITHOUT_HEAD(isolate_child__reset_umask);
 ATF_TEST_CASE_BODY(isolate_child__reset_umask)
 {
@@ -486,6 +576,46 @@ ATF_TEST_CASE_BODY(isolate_child__reset_umask)
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(resource_limits__unlimited);
+ATF_TEST_CASE_BODY(resource_limits__unlimited)
+{
+    ATF_REQUIRE(process::resource_limits().unlimited());
+    ATF_REQUIRE(process::resource_limits(datetime::delta(),
+                                         units::bytes()).unlimited());
+    ATF_REQUIRE(!process::resource_limits(datetime::delta(0, 1),
+                                          units::bytes()).unlimited());
+    ATF_REQUIRE(!process::resource_limits(datetime::delta(),
+                                          units::bytes(1)).unlimited());
+
+    process::resource_limits pinned;
+    pinned.cpus.insert(0);
+    ATF_REQUIRE(!pinned.unlimited());
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(resource_limits__cpu_time_seconds);
+ATF_TEST_CASE_BODY(resource_limits__cpu_time_seconds)
+{
+    ATF_REQUIRE_EQ(0, process::resource_limits().cpu_time_seconds());
+    ATF_REQUIRE_EQ(1, process::resource_limits(
+        datetime::delta(1, 0), units::bytes()).cpu_time_seconds());
+    ATF_REQUIRE_EQ(2, process::resource_limits(
+        datetime::delta(1, 500000), units::bytes()).cpu_time_seconds());
+    ATF_REQUIRE_EQ(1, process::resource_limits(
+        datetime::delta(0, 1), units::bytes()).cpu_time_seconds());
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(allowed_cpus);
+ATF_TEST_CASE_BODY(allowed_cpus)
+{
+    const std::set< int > cpus = process::allowed_cpus();
+    if (cpus.empty())
+        ATF_SKIP("CPU affinity not supported by this platform");
+    ATF_REQUIRE(*cpus.begin() >= 0);
+}
+
+
 /// Executes isolate_path() and compares the on-disk changes to expected values.
 ///
 /// \param unprivileged_user The user to pass to isolate_path; may be none.
@@ -611,8 +741,15 @@ ATF_INIT_TEST_CASES(tcs)
     ATF_ADD_TEST_CASE(tcs, isolate_child__new_session);
     ATF_ADD_TEST_CASE(tcs, isolate_child__no_terminal);
     ATF_ADD_TEST_CASE(tcs, isolate_child__process_group);
+    ATF_ADD_TEST_CASE(tcs, isolate_child__resource_limits);
+    ATF_ADD_TEST_CASE(tcs, isolate_child__cpu_affinity);
     ATF_ADD_TEST_CASE(tcs, isolate_child__reset_umask);
 
+    ATF_ADD_TEST_CASE(tcs, resource_limits__unlimited);
+    ATF_ADD_TEST_CASE(tcs, resource_limits__cpu_time_seconds);
+
+    ATF_ADD_TEST_CASE(tcs, allowed_cpus);
+
     ATF_ADD_TEST_CASE(tcs, isolate_path__no_user);
     ATF_ADD_TEST_CASE(tcs, isolate_path__same_user);
     ATF_ADD_TEST_CASE(tcs, isolate_path__other_user_when_unprivileged);
@@ -28,8 +28,14 @@
 
 #include "utils/process/operations.hpp"
 
+#if defined(HAVE_CONFIG_H)
+#   include "config.h"
+#endif
+
 extern "C" {
 #include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
 #include <sys/wait.h>
 
 #include <signal.h>
@@ -45,6 +51,7 @@ extern "C" {
 #include "utils/fs/path.hpp"
 #include "utils/logging/macros.hpp"
 #include "utils/process/exceptions.hpp"
+#include "utils/process/resource_usage.hpp"
 #include "utils/process/system.hpp"
 #include "utils/process/status.hpp"
 #include "utils/sanity.hpp"
@@ -68,6 +75,9 @@ namespace {
 
 /// Exception-based, type-improved version of wait(2).
 ///
+/// Uses wait4(2) when available to also collect the resource usage of the
+/// terminated process.
+///
 /// \return The PID of the terminated process and its termination status.
 ///
 /// \throw process::system_error If the call to wait(2) fails.
@@ -76,18 +86,31 @@ safe_wait(void)
 {
     LD("Waiting for any child process");
     int stat_loc;
+#if defined(HAVE_WAIT4)
+    struct ::rusage usage;
+    const pid_t pid = ::wait4(-1, &stat_loc, 0, &usage);
+#else
     const pid_t pid = ::wait(&stat_loc);
+#endif
     if (pid == -1) {
         const int original_errno = errno;
         throw process::system_error("Failed to wait for any child process",
                                     original_errno);
     }
+#if defined(HAVE_WAIT4)
+    return process::status(pid, stat_loc,
+                           process::resource_usage::from_rusage(usage));
+#else
     return process::status(pid, stat_loc);
+#endif
 }
 
 
 /// Exception-based, type-improved version of waitpid(2).
 ///
+/// Uses wait4(2) when available to also collect the resource usage of the
+/// terminated process.
+///
 /// \param pid The identifier of the process to wait for.
 ///
 /// \return The termination status of the process.
@@ -98,12 +121,22 @@ safe_waitpid(const pid_t pid)
 {
     LD(F("Waiting for pid=%s") % pid);
     int stat_loc;
+#if defined(HAVE_WAIT4)
+    struct ::rusage usage;
+    if (::wait4(pid, &stat_loc, 0, &usage) == -1) {
+#else
     if (process::detail::syscall_waitpid(pid, &stat_loc, 0) == -1) {
+#endif
         const int original_errno = errno;
         throw process::system_error(F("Failed to wait for PID %s") % pid,
                                     original_errno);
     }
+#if defined(HAVE_WAIT4)
+    return process::status(pid, stat_loc,
+                           process::resource_usage::from_rusage(usage));
+#else
     return process::status(pid, stat_loc);
+#endif
 }
 
 
@@ -28,6 +28,10 @@
 
 #include "utils/process/operations.hpp"
 
+#if defined(HAVE_CONFIG_H)
+#   include "config.h"
+#endif
+
 extern "C" {
 #include <sys/types.h>
 #include <sys/wait.h>
@@ -37,6 +41,8 @@ extern "C" {
 }
 
 #include <cerrno>
+#include <cstdlib>
+#include <ctime>
 #include <iostream>
 
 #include <atf-c++.hpp>
@@ -46,6 +52,7 @@ extern "C" {
 #include "utils/fs/path.hpp"
 #include "utils/process/child.ipp"
 #include "utils/process/exceptions.hpp"
+#include "utils/process/resource_usage.hpp"
 #include "utils/process/status.hpp"
 #include "utils/stacktrace.hpp"
 #include "utils/test_utils.ipp"
@@ -117,6 +124,18 @@ child_exit(void)
 }
 
 
+/// Body of a subprocess that burns some CPU time before exiting.
+static void
+child_spin(void)
+{
+    const std::clock_t start = std::clock();
+    while (std::clock() - start < CLOCKS_PER_SEC / 5) {
+        // Busy loop.
+    }
+    std::exit(EXIT_SUCCESS);
+}
+
+
 static void suspend(void) UTILS_NORETURN;
 
 
@@ -392,6 +411,26 @@ ATF_TEST_CASE_BODY(wait__ok)
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(wait__resource_usage);
+ATF_TEST_CASE_BODY(wait__resource_usage)
+{
+#if !defined(HAVE_WAIT4)
+    ATF_SKIP("wait4(2) not supported by this platform");
+#endif
+
+    std::auto_ptr< process::child > child = process::child::fork_capture(
+        child_spin);
+    const pid_t pid = child->pid();
+    child.reset();  // Ensure there is no conflict between destructor and wait.
+
+    const process::status status = process::wait(pid);
+    ATF_REQUIRE(status.exited());
+    ATF_REQUIRE(status.usage().user_time + status.usage().system_time >=
+                utils::datetime::delta(0, 100000));
+    ATF_REQUIRE(static_cast< uint64_t >(status.usage().max_rss) > 0);
+}
+
+
 ATF_TEST_CASE_WITHOUT_HEAD(wait__fail);
 ATF_TEST_CASE_BODY(wait__fail)
 {
@@ -463,6 +502,7 @@ ATF_INIT_TEST_CASES(tcs)
     ATF_ADD_TEST_CASE(tcs, terminate_self_with__termsig_and_core);
 
     ATF_ADD_TEST_CASE(tcs, wait__ok);
+    ATF_ADD_TEST_CASE(tcs, wait__resource_usage);
     ATF_ADD_TEST_CASE(tcs, wait__fail);
 
     ATF_ADD_TEST_CASE(tcs, wait_any__one);
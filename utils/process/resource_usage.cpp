@@ -0,0 +1,197 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "utils/process/resource_usage.hpp"
+
+extern "C" {
+#include <sys/time.h>
+#include <sys/resource.h>
+}
+
+#include "utils/format/macros.hpp"
+
+namespace datetime = utils::datetime;
+namespace process = utils::process;
+namespace units = utils::units;
+
+
+namespace {
+
+
+/// Converts a time value reported by getrusage(2) to a delta.
+///
+/// \param tv The time value to convert.
+///
+/// \return The converted time value.
+static datetime::delta
+to_delta(const struct ::timeval& tv)
+{
+    return datetime::delta(tv.tv_sec, tv.tv_usec);
+}
+
+
+/// Converts a counter reported by getrusage(2) to an unsigned quantity.
+///
+/// \param value The counter to convert.  Should never be negative but, as the
+///     type is signed, we clamp it just in case.
+///
+/// \return The converted counter.
+static uint64_t
+to_count(const long value)
+{
+    return value < 0 ? 0 : static_cast< uint64_t >(value);
+}
+
+
+}  // anonymous namespace
+
+
+/// Constructs an object with all usage figures set to zero.
+process::resource_usage::resource_usage(void) :
+    minor_faults(0),
+    major_faults(0),
+    block_inputs(0),
+    block_outputs(0),
+    voluntary_switches(0),
+    involuntary_switches(0)
+{
+}
+
+
+/// Constructs an object with explicit usage figures.
+///
+/// \param user_time_ Time spent executing in user mode.
+/// \param system_time_ Time spent executing in kernel mode.
+/// \param max_rss_ Largest resident set size of the process.
+/// \param minor_faults_ Page faults serviced without any I/O.
+/// \param major_faults_ Page faults that required I/O.
+/// \param block_inputs_ Number of times the file system had to perform input.
+/// \param block_outputs_ Number of times the file system had to perform
+///     output.
+/// \param voluntary_switches_ Number of times the process gave up the CPU.
+/// \param involuntary_switches_ Number of times the process was preempted.
+process::resource_usage::resource_usage(const datetime::delta& user_time_,
+                                        const datetime::delta& system_time_,
+                                        const units::bytes& max_rss_,
+                                        const uint64_t minor_faults_,
+                                        const uint64_t major_faults_,
+                                        const uint64_t block_inputs_,
+                                        const uint64_t block_outputs_,
+                                        const uint64_t voluntary_switches_,
+                                        const uint64_t involuntary_switches_) :
+    user_time(user_time_),
+    system_time(system_time_),
+    max_rss(max_rss_),
+    minor_faults(minor_faults_),
+    major_faults(major_faults_),
+    block_inputs(block_inputs_),
+    block_outputs(block_outputs_),
+    voluntary_switches(voluntary_switches_),
+    involuntary_switches(involuntary_switches_)
+{
+}
+
+
+/// Constructs an object from the data returned by wait4(2) or getrusage(2).
+///
+/// \param usage The structure to convert.
+///
+/// \return The converted usage figures.
+process::resource_usage
+process::resource_usage::from_rusage(const struct ::rusage& usage)
+{
+#if defined(__APPLE__)
+    // macOS reports the resident set size in bytes...
+    const units::bytes max_rss(to_count(usage.ru_maxrss));
+#else
+    // ... whereas the BSDs and Linux report it in kilobytes.
+    const units::bytes max_rss(to_count(usage.ru_maxrss) * units::KB);
+#endif
+
+    return resource_usage(to_delta(usage.ru_utime), to_delta(usage.ru_stime),
+                          max_rss,
+                          to_count(usage.ru_minflt), to_count(usage.ru_majflt),
+                          to_count(usage.ru_inblock),
+                          to_count(usage.ru_oublock),
+                          to_count(usage.ru_nvcsw), to_count(usage.ru_nivcsw));
+}
+
+
+/// Checks if two usage objects are equal.
+///
+/// \param other The object to compare to.
+///
+/// \return True if the two objects are equal; false otherwise.
+bool
+process::resource_usage::operator==(const resource_usage& other) const
+{
+    return (user_time == other.user_time &&
+            system_time == other.system_time &&
+            static_cast< uint64_t >(max_rss) ==
+            static_cast< uint64_t >(other.max_rss) &&
+            minor_faults == other.minor_faults &&
+            major_faults == other.major_faults &&
+            block_inputs == other.block_inputs &&
+            block_outputs == other.block_outputs &&
+            voluntary_switches == other.voluntary_switches &&
+            involuntary_switches == other.involuntary_switches);
+}
+
+
+/// Checks if two usage objects are different.
+///
+/// \param other The object to compare to.
+///
+/// \return True if the two objects are different; false otherwise.
+bool
+process::resource_usage::operator!=(const resource_usage& other) const
+{
+    return !(*this == other);
+}
+
+
+/// Injects the object into a stream.
+///
+/// \param output The stream into which to inject the object.
+/// \param usage The object to format.
+///
+/// \return The output stream.
+std::ostream&
+process::operator<<(std::ostream& output, const resource_usage& usage)
+{
+    output << F("resource_usage{user_time=%s, system_time=%s, max_rss=%s, "
+                "minor_faults=%s, major_faults=%s, block_inputs=%s, "
+                "block_outputs=%s, voluntary_switches=%s, "
+                "involuntary_switches=%s}") %
+        usage.user_time % usage.system_time %
+        static_cast< uint64_t >(usage.max_rss) %
+        usage.minor_faults % usage.major_faults %
+        usage.block_inputs % usage.block_outputs %
+        usage.voluntary_switches % usage.involuntary_switches;
+    return output;
+}
@@ -0,0 +1,101 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// \file utils/process/resource_usage.hpp
+/// Provides the utils::process::resource_usage class.
+
+#if !defined(UTILS_PROCESS_RESOURCE_USAGE_HPP)
+#define UTILS_PROCESS_RESOURCE_USAGE_HPP
+
+#include "utils/process/resource_usage_fwd.hpp"
+
+#include <stdint.h>
+
+#include <ostream>
+
+#include "utils/datetime.hpp"
+#include "utils/units.hpp"
+
+struct rusage;
+
+namespace utils {
+namespace process {
+
+
+/// Resources consumed by a terminated process.
+///
+/// The figures include those of all the descendants of the process that it
+/// waited for, which is what getrusage(2) reports for RUSAGE_CHILDREN.
+class resource_usage {
+public:
+    /// Time spent executing in user mode.
+    datetime::delta user_time;
+
+    /// Time spent executing in kernel mode.
+    datetime::delta system_time;
+
+    /// Largest resident set size of the process.
+    units::bytes max_rss;
+
+    /// Page faults serviced without any I/O.
+    uint64_t minor_faults;
+
+    /// Page faults that required I/O.
+    uint64_t major_faults;
+
+    /// Number of times the file system had to perform input.
+    uint64_t block_inputs;
+
+    /// Number of times the file system had to perform output.
+    uint64_t block_outputs;
+
+    /// Number of times the process gave up the CPU, usually to wait for I/O.
+    uint64_t voluntary_switches;
+
+    /// Number of times the process was preempted.
+    uint64_t involuntary_switches;
+
+    resource_usage(void);
+    resource_usage(const datetime::delta&, const datetime::delta&,
+                   const units::bytes&, const uint64_t, const uint64_t,
+                   const uint64_t, const uint64_t, const uint64_t,
+                   const uint64_t);
+    static resource_usage from_rusage(const struct ::rusage&);
+
+    bool operator==(const resource_usage&) const;
+    bool operator!=(const resource_usage&) const;
+};
+
+
+std::ostream& operator<<(std::ostream&, const resource_usage&);
+
+
+}  // namespace process
+}  // namespace utils
+
+#endif  // !defined(UTILS_PROCESS_RESOURCE_USAGE_HPP)
@@ -0,0 +1,144 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "utils/process/resource_usage.hpp"
+
+extern "C" {
+#include <sys/time.h>
+#include <sys/resource.h>
+}
+
+#include <cstring>
+#include <sstream>
+
+#include <atf-c++.hpp>
+
+#include "utils/datetime.hpp"
+#include "utils/units.hpp"
+
+namespace datetime = utils::datetime;
+namespace process = utils::process;
+namespace units = utils::units;
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(default_construct);
+ATF_TEST_CASE_BODY(default_construct)
+{
+    const process::resource_usage usage;
+    ATF_REQUIRE_EQ(datetime::delta(), usage.user_time);
+    ATF_REQUIRE_EQ(datetime::delta(), usage.system_time);
+    ATF_REQUIRE_EQ(0, static_cast< uint64_t >(usage.max_rss));
+    ATF_REQUIRE_EQ(0, usage.minor_faults);
+    ATF_REQUIRE_EQ(0, usage.major_faults);
+    ATF_REQUIRE_EQ(0, usage.block_inputs);
+    ATF_REQUIRE_EQ(0, usage.block_outputs);
+    ATF_REQUIRE_EQ(0, usage.voluntary_switches);
+    ATF_REQUIRE_EQ(0, usage.involuntary_switches);
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(from_rusage);
+ATF_TEST_CASE_BODY(from_rusage)
+{
+    struct ::rusage raw;
+    std::memset(&raw, 0, sizeof(raw));
+    raw.ru_utime.tv_sec = 1;
+    raw.ru_utime.tv_usec = 2;
+    raw.ru_stime.tv_sec = 3;
+    raw.ru_stime.tv_usec = 4;
+    raw.ru_maxrss = 1024;
+    raw.ru_minflt = 5;
+    raw.ru_majflt = 6;
+    raw.ru_inblock = 7;
+    raw.ru_oublock = 8;
+    raw.ru_nvcsw = 9;
+    raw.ru_nivcsw = -1;
+
+    const process::resource_usage usage =
+        process::resource_usage::from_rusage(raw);
+    ATF_REQUIRE_EQ(datetime::delta(1, 2), usage.user_time);
+    ATF_REQUIRE_EQ(datetime::delta(3, 4), usage.system_time);
+#if defined(__APPLE__)
+    ATF_REQUIRE_EQ(1024, static_cast< uint64_t >(usage.max_rss));
+#else
+    ATF_REQUIRE_EQ(units::MB, static_cast< uint64_t >(usage.max_rss));
+#endif
+    ATF_REQUIRE_EQ(5, usage.minor_faults);
+    ATF_REQUIRE_EQ(6, usage.major_faults);
+    ATF_REQUIRE_EQ(7, usage.block_inputs);
+    ATF_REQUIRE_EQ(8, usage.block_outputs);
+    ATF_REQUIRE_EQ(9, usage.voluntary_switches);
+    ATF_REQUIRE_EQ(0, usage.involuntary_switches);
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(operators_eq_and_ne);
+ATF_TEST_CASE_BODY(operators_eq_and_ne)
+{
+    const process::resource_usage usage1(
+        datetime::delta(1, 0), datetime::delta(2, 0), units::bytes(3),
+        4, 5, 6, 7, 8, 9);
+    const process::resource_usage usage2(
+        datetime::delta(1, 0), datetime::delta(2, 0), units::bytes(3),
+        4, 5, 6, 7, 8, 9);
+    const process::resource_usage usage3(
+        datetime::delta(1, 0), datetime::delta(2, 0), units::bytes(3),
+        4, 5, 6, 7, 8, 10);
+
+    ATF_REQUIRE(  usage1 == usage2);
+    ATF_REQUIRE(!(usage1 != usage2));
+    ATF_REQUIRE(!(usage1 == usage3));
+    ATF_REQUIRE(  usage1 != usage3);
+    ATF_REQUIRE(  usage1 != process::resource_usage());
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(output);
+ATF_TEST_CASE_BODY(output)
+{
+    const process::resource_usage usage(
+        datetime::delta(1, 5), datetime::delta(2, 0), units::bytes(3),
+        4, 5, 6, 7, 8, 9);
+
+    std::ostringstream str;
+    str << usage;
+    ATF_REQUIRE_EQ("resource_usage{user_time=1000005us, "
+                   "system_time=2000000us, max_rss=3, minor_faults=4, "
+                   "major_faults=5, block_inputs=6, block_outputs=7, "
+                   "voluntary_switches=8, involuntary_switches=9}",
+                   str.str());
+}
+
+
+ATF_INIT_TEST_CASES(tcs)
+{
+    ATF_ADD_TEST_CASE(tcs, default_construct);
+    ATF_ADD_TEST_CASE(tcs, from_rusage);
+    ATF_ADD_TEST_CASE(tcs, operators_eq_and_ne);
+    ATF_ADD_TEST_CASE(tcs, output);
+}
@@ -0,0 +1,254 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// \file utils/process/spawn_benchmark.cpp
+/// Benchmark of the mechanisms to start subprocesses.
+///
+/// This program measures how many subprocesses per second can be started with
+/// process::child::fork_files() and with process::child::spawn_isolated() as
+/// the resident set size of the calling process grows.  Every subprocess
+/// executes this same program, which exits immediately, so the difference
+/// between the two columns is the cost of forking the caller.
+///
+/// Usage: spawn_benchmark [-n spawns] [ballast_mb ...]
+///
+/// Build it with "make utils/process/spawn_benchmark".
+
+extern "C" {
+#include <sys/resource.h>
+
+#include <unistd.h>
+}
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "utils/datetime.hpp"
+#include "utils/defs.hpp"
+#include "utils/format/macros.hpp"
+#include "utils/fs/operations.hpp"
+#include "utils/fs/path.hpp"
+#include "utils/process/child.ipp"
+#include "utils/process/operations.hpp"
+#include "utils/process/status.hpp"
+#include "utils/text/exceptions.hpp"
+#include "utils/text/operations.ipp"
+
+namespace datetime = utils::datetime;
+namespace fs = utils::fs;
+namespace process = utils::process;
+namespace text = utils::text;
+
+
+namespace {
+
+
+/// Argument that makes this program exit immediately.
+static const char* exit_arg = "exit";
+
+
+/// Subprocess body that executes this program with exit_arg.
+class exec_self {
+    /// Absolute path to this program.
+    const fs::path& _self;
+
+public:
+    /// Constructor.
+    ///
+    /// \param self Absolute path to this program.
+    exec_self(const fs::path& self) : _self(self)
+    {
+    }
+
+    /// Runs the subprocess.
+    void
+    operator()(void) UTILS_NORETURN
+    {
+        process::args_vector args;
+        args.push_back(exit_arg);
+        process::exec(_self, args);
+    }
+};
+
+
+/// Starts a subprocess and waits for its termination.
+///
+/// \param self Absolute path to this program.
+/// \param isolated Whether to use spawn_isolated() instead of fork_files().
+///
+/// \return False if the subprocess cannot be started with the requested
+/// mechanism; true otherwise.
+static bool
+run_one(const fs::path& self, const bool isolated)
+{
+    const fs::path dev_null("/dev/null");
+
+    std::auto_ptr< process::child > child;
+    if (isolated) {
+        process::args_vector args;
+        args.push_back(exit_arg);
+        child = process::child::spawn_isolated(
+            self, args, std::map< std::string, std::string >(),
+            fs::current_path(), dev_null, dev_null);
+        if (child.get() == NULL)
+            return false;
+    } else {
+        child = process::child::fork_files(exec_self(self), dev_null,
+                                           dev_null);
+    }
+
+    const process::status status = child->wait();
+    if (!status.exited() || status.exitstatus() != EXIT_SUCCESS) {
+        std::cerr << "Subprocess did not exit cleanly\n";
+        std::exit(EXIT_FAILURE);
+    }
+    return true;
+}
+
+
+/// Measures the rate at which subprocesses can be started.
+///
+/// \param self Absolute path to this program.
+/// \param isolated Whether to use spawn_isolated() instead of fork_files().
+/// \param spawns Number of subprocesses to start.
+///
+/// \return The number of subprocesses per second, or a negative number if the
+/// requested mechanism is not supported.
+static double
+measure(const fs::path& self, const bool isolated, const int spawns)
+{
+    const datetime::timestamp start = datetime::timestamp::now();
+    for (int i = 0; i < spawns; ++i) {
+        if (!run_one(self, isolated))
+            return -1.0;
+    }
+    const datetime::delta elapsed = datetime::timestamp::now() - start;
+    return spawns * 1000000.0 / elapsed.to_microseconds();
+}
+
+
+/// Returns the maximum resident set size of this process.
+///
+/// As the ballast only grows, this is also the current resident set size.
+///
+/// \return The size in the units of getrusage(2), which are kilobytes on most
+/// systems.
+static long
+max_rss(void)
+{
+    struct ::rusage usage;
+    if (::getrusage(RUSAGE_SELF, &usage) == -1)
+        return -1;
+    return usage.ru_maxrss;
+}
+
+
+}  // anonymous namespace
+
+
+/// Program entry point.
+///
+/// \param argc Number of arguments.
+/// \param argv Arguments.
+///
+/// \return An exit code.
+int
+main(const int argc, char* const* argv)
+{
+    if (argc == 2 && std::strcmp(argv[1], exit_arg) == 0)
+        return EXIT_SUCCESS;
+
+    int spawns = 200;
+    int ch;
+    while ((ch = ::getopt(argc, argv, "n:")) != -1) {
+        switch (ch) {
+        case 'n':
+            try {
+                spawns = text::to_type< int >(optarg);
+            } catch (const text::value_error& e) {
+                std::cerr << "Invalid number of spawns " << optarg << '\n';
+                return EXIT_FAILURE;
+            }
+            break;
+        default:
+            std::cerr << "Usage: spawn_benchmark [-n spawns] "
+                "[ballast_mb ...]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector< int > ballasts;
+    for (int i = optind; i < argc; ++i) {
+        try {
+            ballasts.push_back(text::to_type< int >(argv[i]));
+        } catch (const text::value_error& e) {
+            std::cerr << "Invalid ballast size " << argv[i] << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+    if (ballasts.empty()) {
+        ballasts.push_back(0);
+        ballasts.push_back(64);
+        ballasts.push_back(256);
+        ballasts.push_back(1024);
+    }
+
+    const fs::path self = fs::path(argv[0]).to_absolute();
+
+    std::cout << "ballast_mb\tmax_rss\tfork_per_sec\tspawn_per_sec\n";
+    std::vector< char* > chunks;
+    int allocated = 0;
+    for (std::vector< int >::const_iterator iter = ballasts.begin();
+         iter != ballasts.end(); ++iter) {
+        // Grow the ballast and touch every page of it so that it is resident.
+        while (allocated < *iter) {
+            char* chunk = new char[1024 * 1024];
+            std::memset(chunk, allocated, 1024 * 1024);
+            chunks.push_back(chunk);
+            ++allocated;
+        }
+
+        const double fork_rate = measure(self, false, spawns);
+        const double spawn_rate = measure(self, true, spawns);
+        std::cout << F("%s\t%s\t%.1s\t") % allocated % max_rss() % fork_rate;
+        if (spawn_rate < 0)
+            std::cout << "unsupported\n";
+        else
+            std::cout << F("%.1s\n") % spawn_rate;
+    }
+
+    for (std::vector< char* >::const_iterator iter = chunks.begin();
+         iter != chunks.end(); ++iter)
+        delete [] *iter;
+    return EXIT_SUCCESS;
+}
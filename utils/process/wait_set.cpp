@@ -0,0 +1,412 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "utils/process/wait_set.hpp"
+
+#if defined(HAVE_CONFIG_H)
+#   include "config.h"
+#endif
+
+extern "C" {
+#if defined(HAVE_SYS_EPOLL_H)
+#   include <sys/epoll.h>
+#endif
+#if defined(HAVE_SYS_SYSCALL_H)
+#   include <sys/syscall.h>
+#endif
+
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+}
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <map>
+
+#include "utils/datetime.hpp"
+#include "utils/format/macros.hpp"
+#include "utils/logging/macros.hpp"
+#include "utils/optional.ipp"
+#include "utils/process/exceptions.hpp"
+#include "utils/process/operations.hpp"
+#include "utils/sanity.hpp"
+
+namespace datetime = utils::datetime;
+namespace process = utils::process;
+
+using utils::optional;
+
+
+#if defined(HAVE_SYS_EPOLL_H) && defined(HAVE_EPOLL_CREATE1) && \
+    defined(HAVE_DECL_SYS_PIDFD_OPEN) && HAVE_DECL_SYS_PIDFD_OPEN
+/// Whether the primitives required by the wait_set are available or not.
+#   define WAIT_SET_SUPPORTED 1
+#endif
+
+
+namespace {
+
+
+/// Data held for every subprocess tracked by a wait_set.
+struct process_data {
+    /// File descriptor referring to the subprocess.
+    int pidfd;
+
+    /// Time at which the subprocess is forcibly terminated, in microseconds
+    /// of the monotonic clock.
+    int64_t deadline;
+
+    /// Whether the subprocess has been terminated due to its deadline.
+    bool timed_out;
+
+    /// Constructor.
+    ///
+    /// \param pidfd_ File descriptor referring to the subprocess.
+    /// \param deadline_ Time at which the subprocess is forcibly terminated,
+    ///     in microseconds of the monotonic clock.
+    process_data(const int pidfd_, const int64_t deadline_) :
+        pidfd(pidfd_), deadline(deadline_), timed_out(false)
+    {
+    }
+};
+
+
+/// Mapping of PIDs to their tracking data.
+typedef std::map< int, process_data > process_data_map;
+
+
+/// Opens a file descriptor referring to a process.
+///
+/// \param pid The process to open.
+///
+/// \return The new file descriptor, which has the close-on-exec flag set, or -1
+/// on error, in which case errno is set accordingly.
+static int
+open_pidfd(const int pid)
+{
+#if defined(WAIT_SET_SUPPORTED)
+    return static_cast< int >(::syscall(SYS_pidfd_open, pid, 0));
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+
+/// Queries the current time of the monotonic clock.
+///
+/// Unlike datetime::timestamp::now(), the monotonic clock is not affected by
+/// changes to the system time, which would otherwise make deadlines expire
+/// early or never.
+///
+/// \return The current time in microseconds since an unspecified origin.
+static int64_t
+monotonic_now(void)
+{
+    struct ::timespec ts;
+    const int ret = ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    INV(ret != -1);
+    return static_cast< int64_t >(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+
+/// Converts a time interval to a timeout for poll(2) and friends.
+///
+/// \param usecs The interval to convert, in microseconds.
+///
+/// \return The interval in milliseconds, rounded up so that we never wake up
+/// before the deadline, and clamped to the maximum representable value.
+static int
+to_timeout_ms(const int64_t usecs)
+{
+    const int64_t ms = (usecs + 999) / 1000;
+    return ms > INT_MAX ? INT_MAX : static_cast< int >(ms);
+}
+
+
+}  // anonymous namespace
+
+
+/// Internal implementation for the wait_set class.
+struct utils::process::wait_set::impl : utils::noncopyable {
+    /// Descriptor of the epoll set holding the pidfds of all subprocesses.
+    int epoll_fd;
+
+    /// Collection of tracked subprocesses.
+    process_data_map processes;
+
+    /// Constructor.
+    ///
+    /// \throw process::system_error If the epoll set cannot be created.
+    impl(void) : epoll_fd(-1)
+    {
+#if defined(WAIT_SET_SUPPORTED)
+        epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd == -1) {
+            const int original_errno = errno;
+            throw process::system_error("Failed to create epoll set",
+                                        original_errno);
+        }
+#else
+        throw process::system_error("wait_set is not supported in this "
+                                    "platform", ENOSYS);
+#endif
+    }
+
+    /// Destructor.
+    ~impl(void)
+    {
+        for (process_data_map::const_iterator iter = processes.begin();
+             iter != processes.end(); ++iter) {
+            (void)::close((*iter).second.pidfd);
+        }
+        if (epoll_fd != -1)
+            (void)::close(epoll_fd);
+    }
+
+    /// Terminates any subprocesses that have exceeded their deadline.
+    ///
+    /// Terminated subprocesses remain in the set until the caller removes them,
+    /// which should happen once they are reported as ready for reaping.
+    ///
+    /// \return The time in milliseconds until the next deadline, or -1 if there
+    /// is none.  Suitable for passing to poll(2) and friends.
+    int
+    enforce_deadlines(void)
+    {
+        const int64_t now = monotonic_now();
+
+        optional< int64_t > next;
+        for (process_data_map::iterator iter = processes.begin();
+             iter != processes.end(); ++iter) {
+            process_data& data = (*iter).second;
+            if (data.timed_out)
+                continue;
+
+            if (data.deadline <= now) {
+                LD(F("Deadline for pid=%s exceeded; terminating") %
+                   (*iter).first);
+                process::terminate_group((*iter).first);
+                data.timed_out = true;
+            } else {
+                const int64_t remaining = data.deadline - now;
+                if (!next || remaining < next.get())
+                    next = remaining;
+            }
+        }
+        return next ? to_timeout_ms(next.get()) : -1;
+    }
+};
+
+
+/// Constructor.
+///
+/// \throw process::system_error If the wait_set cannot be initialized, which
+///     happens if is_supported() returns false.
+process::wait_set::wait_set(void) :
+    _pimpl(new impl())
+{
+}
+
+
+/// Destructor.
+///
+/// Any subprocesses still in the set are left untouched.
+process::wait_set::~wait_set(void)
+{
+}
+
+
+/// Checks whether wait_set objects can be used in the running system.
+///
+/// This probes the kernel for the required system calls because the binary
+/// may have been built on a newer system than the one it runs on.
+///
+/// \return True if the wait_set can be used; false otherwise.
+bool
+process::wait_set::is_supported(void)
+{
+    const int pidfd = open_pidfd(::getpid());
+    if (pidfd == -1)
+        return false;
+    (void)::close(pidfd);
+    return true;
+}
+
+
+/// Starts tracking a subprocess.
+///
+/// \param pid The subprocess to track.  Must be a child of the current process
+///     that has not been reaped yet.
+/// \param timeout Maximum amount of time the subprocess can run for, counting
+///     from now, before it is forcibly terminated.
+///
+/// \throw process::system_error If the subprocess cannot be tracked.
+void
+process::wait_set::add(const int pid, const datetime::delta& timeout)
+{
+    PRE(_pimpl->processes.find(pid) == _pimpl->processes.end());
+
+    const int pidfd = open_pidfd(pid);
+    if (pidfd == -1) {
+        const int original_errno = errno;
+        throw process::system_error(F("Failed to open descriptor for PID %s")
+                                    % pid, original_errno);
+    }
+
+#if defined(WAIT_SET_SUPPORTED)
+    struct ::epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u64 = static_cast< uint64_t >(pid);
+    if (::epoll_ctl(_pimpl->epoll_fd, EPOLL_CTL_ADD, pidfd, &event) == -1) {
+        const int original_errno = errno;
+        (void)::close(pidfd);
+        throw process::system_error(F("Failed to add PID %s to epoll set")
+                                    % pid, original_errno);
+    }
+#endif
+
+    const int64_t deadline = monotonic_now() + timeout.to_microseconds();
+    _pimpl->processes.insert(process_data_map::value_type(
+        pid, process_data(pidfd, deadline)));
+}
+
+
+/// Stops tracking a subprocess.
+///
+/// \param pid The subprocess to stop tracking.  Must have been added before.
+void
+process::wait_set::remove(const int pid)
+{
+    const process_data_map::iterator iter = _pimpl->processes.find(pid);
+    PRE(iter != _pimpl->processes.end());
+
+    // The pidfd may have been inherited by a child that has not yet called
+    // exec(2), in which case closing it would not remove it from the epoll set.
+#if defined(WAIT_SET_SUPPORTED)
+    (void)::epoll_ctl(_pimpl->epoll_fd, EPOLL_CTL_DEL, (*iter).second.pidfd,
+                      NULL);
+#endif
+    (void)::close((*iter).second.pidfd);
+    _pimpl->processes.erase(iter);
+}
+
+
+/// Checks whether a subprocess was terminated due to its deadline.
+///
+/// \param pid The subprocess to query.  Must have been added before.
+///
+/// \return True if the subprocess exceeded its deadline.
+bool
+process::wait_set::timed_out(const int pid) const
+{
+    const process_data_map::const_iterator iter = _pimpl->processes.find(pid);
+    PRE(iter != _pimpl->processes.end());
+    return (*iter).second.timed_out;
+}
+
+
+/// Blocks until any subprocess in the set terminates.
+///
+/// Deadlines are enforced while waiting.  Interrupted system calls are retried:
+/// the interrupts handler kills all of our children on the reception of a
+/// signal, so this returns soon afterwards.
+///
+/// \return The PID of a terminated subprocess.  The subprocess is not reaped.
+///
+/// \throw process::system_error If there are no subprocesses to wait for or if
+///     waiting fails.
+int
+process::wait_set::wait_any(void)
+{
+    if (_pimpl->processes.empty())
+        throw process::system_error("No subprocesses to wait for", ECHILD);
+
+#if defined(WAIT_SET_SUPPORTED)
+    for (;;) {
+        const int timeout = _pimpl->enforce_deadlines();
+
+        struct ::epoll_event event;
+        const int ret = ::epoll_wait(_pimpl->epoll_fd, &event, 1, timeout);
+        if (ret == -1) {
+            if (errno == EINTR)
+                continue;
+            const int original_errno = errno;
+            throw process::system_error("Failed to wait for any child process",
+                                        original_errno);
+        } else if (ret == 1) {
+            const int pid = static_cast< int >(event.data.u64);
+            LD(F("Subprocess with pid=%s is ready to be reaped") % pid);
+            return pid;
+        }
+        // Otherwise, we timed out waiting; loop to enforce the deadlines.
+    }
+#else
+    UNREACHABLE;
+#endif
+}
+
+
+/// Blocks until a specific subprocess in the set terminates.
+///
+/// The deadlines of all subprocesses are enforced while waiting, not just the
+/// deadline of the one we are waiting for.
+///
+/// \param pid The subprocess to wait for.  Must have been added before.
+///
+/// \throw process::system_error If waiting fails.
+void
+process::wait_set::wait(const int pid)
+{
+    const process_data_map::const_iterator iter = _pimpl->processes.find(pid);
+    PRE(iter != _pimpl->processes.end());
+
+    struct ::pollfd pfd;
+    pfd.fd = (*iter).second.pidfd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    for (;;) {
+        const int timeout = _pimpl->enforce_deadlines();
+
+        const int ret = ::poll(&pfd, 1, timeout);
+        if (ret == -1) {
+            if (errno == EINTR)
+                continue;
+            const int original_errno = errno;
+            throw process::system_error(F("Failed to wait for PID %s") % pid,
+                                        original_errno);
+        } else if (ret == 1) {
+            LD(F("Subprocess with pid=%s is ready to be reaped") % pid);
+            return;
+        }
+        // Otherwise, we timed out waiting; loop to enforce the deadlines.
+    }
+}
@@ -0,0 +1,93 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// \file utils/process/wait_set.hpp
+/// Event-driven tracking of subprocess terminations and deadlines.
+///
+/// A wait_set multiplexes the termination of a collection of subprocesses and
+/// the expiration of their deadlines on a single blocking system call.  This
+/// avoids having to program one utils::signals::timer per subprocess, which
+/// requires reprogramming the global SIGALRM-based system timer every time a
+/// subprocess is spawned or reaped and interrupts any blocking system call
+/// whenever a deadline expires.
+///
+/// Deadlines are tracked on the monotonic clock so that adjustments to the
+/// wall clock do not cause subprocesses to be killed early or too late.
+///
+/// This is only available on systems that support epoll(7) and pidfd_open(2).
+/// Use is_supported() to check for its availability at run time.
+
+#if !defined(UTILS_PROCESS_WAIT_SET_HPP)
+#define UTILS_PROCESS_WAIT_SET_HPP
+
+#include "utils/process/wait_set_fwd.hpp"
+
+#include <memory>
+
+#include "utils/datetime_fwd.hpp"
+#include "utils/noncopyable.hpp"
+
+namespace utils {
+namespace process {
+
+
+/// Collection of subprocesses to wait for, each with its own deadline.
+///
+/// The subprocesses tracked by this class must be children of the current
+/// process.  This class never reaps them: it only tells the caller when they
+/// are ready to be reaped, at which point the caller must use process::wait()
+/// to collect their termination status.
+///
+/// Subprocesses that exceed their deadline are forcibly terminated along with
+/// their process group, just like deadline_killer does.
+class wait_set : noncopyable {
+    struct impl;
+
+    /// Pointer to the internal implementation.
+    std::auto_ptr< impl > _pimpl;
+
+public:
+    wait_set(void);
+    ~wait_set(void);
+
+    static bool is_supported(void);
+
+    void add(const int, const utils::datetime::delta&);
+    void remove(const int);
+
+    bool timed_out(const int) const;
+
+    int wait_any(void);
+    void wait(const int);
+};
+
+
+}  // namespace process
+}  // namespace utils
+
+#endif  // !defined(UTILS_PROCESS_WAIT_SET_HPP)
@@ -0,0 +1,228 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "utils/process/wait_set.hpp"
+
+extern "C" {
+#include <signal.h>
+#include <unistd.h>
+}
+
+#include <cstdlib>
+
+#include <atf-c++.hpp>
+
+#include "utils/datetime.hpp"
+#include "utils/process/child.ipp"
+#include "utils/process/exceptions.hpp"
+#include "utils/process/operations.hpp"
+#include "utils/process/status.hpp"
+
+namespace datetime = utils::datetime;
+namespace process = utils::process;
+
+
+namespace {
+
+
+/// Body of a child process that sleeps and then exits.
+///
+/// \tparam Seconds The delay the subprocess has to sleep for.
+template< int Seconds >
+static void
+child_sleep(void)
+{
+    ::sleep(Seconds);
+    std::exit(EXIT_SUCCESS);
+}
+
+
+/// Skips the calling test case if the wait_set is not supported.
+static void
+require_supported(void)
+{
+    if (!process::wait_set::is_supported())
+        ATF_SKIP("wait_set is not supported in this system");
+}
+
+
+/// Computes a timeout long enough to never be hit by tests.
+///
+/// \return A time interval.
+static datetime::delta
+far_timeout(void)
+{
+    return datetime::delta(60, 0);
+}
+
+
+}  // anonymous namespace
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(wait_any__one);
+ATF_TEST_CASE_BODY(wait_any__one)
+{
+    require_supported();
+
+    std::auto_ptr< process::child > child = process::child::fork_capture(
+        child_sleep< 0 >);
+
+    process::wait_set set;
+    set.add(child->pid(), far_timeout());
+    ATF_REQUIRE_EQ(child->pid(), set.wait_any());
+    ATF_REQUIRE(!set.timed_out(child->pid()));
+    set.remove(child->pid());
+
+    const process::status status = child->wait();
+    ATF_REQUIRE(status.exited());
+    ATF_REQUIRE_EQ(EXIT_SUCCESS, status.exitstatus());
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(wait_any__many);
+ATF_TEST_CASE_BODY(wait_any__many)
+{
+    require_supported();
+
+    std::auto_ptr< process::child > slow = process::child::fork_capture(
+        child_sleep< 60 >);
+    std::auto_ptr< process::child > fast = process::child::fork_capture(
+        child_sleep< 0 >);
+
+    process::wait_set set;
+    set.add(slow->pid(), far_timeout());
+    set.add(fast->pid(), far_timeout());
+    ATF_REQUIRE_EQ(fast->pid(), set.wait_any());
+    set.remove(fast->pid());
+    (void)fast->wait();
+
+    process::terminate_group(slow->pid());
+    ATF_REQUIRE_EQ(slow->pid(), set.wait_any());
+    ATF_REQUIRE(!set.timed_out(slow->pid()));
+    set.remove(slow->pid());
+
+    const process::status status = slow->wait();
+    ATF_REQUIRE(status.signaled());
+    ATF_REQUIRE_EQ(SIGKILL, status.termsig());
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(wait_any__empty);
+ATF_TEST_CASE_BODY(wait_any__empty)
+{
+    require_supported();
+
+    process::wait_set set;
+    ATF_REQUIRE_THROW(process::system_error, set.wait_any());
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(wait_any__deadline);
+ATF_TEST_CASE_BODY(wait_any__deadline)
+{
+    require_supported();
+
+    std::auto_ptr< process::child > child = process::child::fork_capture(
+        child_sleep< 60 >);
+
+    const datetime::timestamp start = datetime::timestamp::now();
+    process::wait_set set;
+    set.add(child->pid(), datetime::delta(1, 0));
+    ATF_REQUIRE_EQ(child->pid(), set.wait_any());
+    const datetime::timestamp end = datetime::timestamp::now();
+    ATF_REQUIRE(set.timed_out(child->pid()));
+    set.remove(child->pid());
+
+    ATF_REQUIRE(end - start <= datetime::delta(10, 0));
+    const process::status status = child->wait();
+    ATF_REQUIRE(status.signaled());
+    ATF_REQUIRE_EQ(SIGKILL, status.termsig());
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(wait_any__wall_clock_jump);
+ATF_TEST_CASE_BODY(wait_any__wall_clock_jump)
+{
+    require_supported();
+
+    std::auto_ptr< process::child > child = process::child::fork_capture(
+        child_sleep< 1 >);
+
+    process::wait_set set;
+    set.add(child->pid(), far_timeout());
+    // Moving the wall clock past the deadline must not expire it.
+    datetime::set_mock_now(datetime::timestamp::now() +
+                           datetime::delta(3600, 0));
+    ATF_REQUIRE_EQ(child->pid(), set.wait_any());
+    ATF_REQUIRE(!set.timed_out(child->pid()));
+    set.remove(child->pid());
+
+    const process::status status = child->wait();
+    ATF_REQUIRE(status.exited());
+    ATF_REQUIRE_EQ(EXIT_SUCCESS, status.exitstatus());
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(wait__other_deadlines);
+ATF_TEST_CASE_BODY(wait__other_deadlines)
+{
+    require_supported();
+
+    std::auto_ptr< process::child > expired = process::child::fork_capture(
+        child_sleep< 60 >);
+    std::auto_ptr< process::child > target = process::child::fork_capture(
+        child_sleep< 2 >);
+
+    process::wait_set set;
+    set.add(expired->pid(), datetime::delta());
+    set.add(target->pid(), far_timeout());
+    set.wait(target->pid());
+    ATF_REQUIRE(!set.timed_out(target->pid()));
+    ATF_REQUIRE(set.timed_out(expired->pid()));
+    set.remove(target->pid());
+    set.remove(expired->pid());
+
+    const process::status target_status = target->wait();
+    ATF_REQUIRE(target_status.exited());
+    ATF_REQUIRE_EQ(EXIT_SUCCESS, target_status.exitstatus());
+
+    const process::status expired_status = expired->wait();
+    ATF_REQUIRE(expired_status.signaled());
+    ATF_REQUIRE_EQ(SIGKILL, expired_status.termsig());
+}
+
+
+ATF_INIT_TEST_CASES(tcs)
+{
+    ATF_ADD_TEST_CASE(tcs, wait_any__one);
+    ATF_ADD_TEST_CASE(tcs, wait_any__many);
+    ATF_ADD_TEST_CASE(tcs, wait_any__empty);
+    ATF_ADD_TEST_CASE(tcs, wait_any__deadline);
+    ATF_ADD_TEST_CASE(tcs, wait_any__wall_clock_jump);
+    ATF_ADD_TEST_CASE(tcs, wait__other_deadlines);
+}
@@ -271,21 +271,23 @@ utils::unlimit_core_size(void)
 }
 
 
-/// Gathers a stacktrace of a crashed program.
+/// Starts gathering a stacktrace of a crashed program in the background.
 ///
 /// \param program The name of the binary that crashed and dumped a core file.
 ///     Can be either absolute or relative.
-/// \param status The exit status of the program.
-/// \param work_directory The directory from which the program was run.
-/// \param output Stream into which to dump the stack trace and any additional
-///     information.
+/// \param executor_handle The executor in which to spawn GDB.
+/// \param exit_handle The termination data of the crashed program.
+///
+/// \return The handle of the GDB subprocess, which the caller must wait for
+/// and then pass to finish_stacktrace(), or none if there is nothing to wait
+/// for because GDB or the core file could not be found.
 ///
 /// \post If anything goes wrong, the diagnostic messages are written to the
-/// output.  This function should not throw.
-void
-utils::dump_stacktrace(const fs::path& program,
-                       executor::executor_handle& executor_handle,
-                       const executor::exit_handle& exit_handle)
+/// stderr file of the program.  This function should not throw.
+optional< executor::exec_handle >
+utils::start_stacktrace(const fs::path& program,
+                        executor::executor_handle& executor_handle,
+                        const executor::exit_handle& exit_handle)
 {
     PRE(exit_handle.status());
     const process::status& status = exit_handle.status().get();
@@ -295,7 +297,7 @@ utils::dump_stacktrace(const fs::path& program,
     if (!gdb_err) {
         LW(F("Failed to open %s to append GDB's output") %
            exit_handle.stderr_file());
-        return;
+        return none;
     }
 
     gdb_err << F("Process with PID %s exited with signal %s and dumped core; "
@@ -306,23 +308,39 @@ utils::dump_stacktrace(const fs::path& program,
     if (!gdb) {
         gdb_err << F("Cannot find GDB binary; builtin was '%s'\n") %
             builtin_gdb;
-        return;
+        return none;
     }
 
     const optional< fs::path > core_file = find_core(
         program, status, exit_handle.work_directory());
     if (!core_file) {
         gdb_err << F("Cannot find any core file\n");
-        return;
+        return none;
     }
 
     gdb_err.flush();
-    const executor::exec_handle exec_handle =
-        executor_handle.spawn_followup(
-            run_gdb(gdb.get(), program, core_file.get()),
-            exit_handle, gdb_timeout);
-    const executor::exit_handle gdb_exit_handle =
-        executor_handle.wait(exec_handle);
+    return utils::make_optional(executor_handle.spawn_followup(
+        run_gdb(gdb.get(), program, core_file.get()),
+        exit_handle, gdb_timeout));
+}
+
+
+/// Completes the gathering of a stacktrace started by start_stacktrace().
+///
+/// \param gdb_exit_handle The termination data of the GDB subprocess.
+///
+/// \post If anything goes wrong, the diagnostic messages are written to the
+/// stderr file of the program.  This function should not throw.
+void
+utils::finish_stacktrace(const executor::exit_handle& gdb_exit_handle)
+{
+    std::ofstream gdb_err(gdb_exit_handle.stderr_file().c_str(),
+                          std::ios::app);
+    if (!gdb_err) {
+        LW(F("Failed to open %s to append GDB's output") %
+           gdb_exit_handle.stderr_file());
+        return;
+    }
 
     const optional< process::status >& gdb_status = gdb_exit_handle.status();
     if (!gdb_status) {
@@ -338,6 +356,31 @@ utils::dump_stacktrace(const fs::path& program,
 }
 
 
+/// Gathers a stacktrace of a crashed program.
+///
+/// \param program The name of the binary that crashed and dumped a core file.
+///     Can be either absolute or relative.
+/// \param executor_handle The executor in which to spawn GDB.
+/// \param exit_handle The termination data of the crashed program.
+///
+/// \post If anything goes wrong, the diagnostic messages are written to the
+/// output.  This function should not throw.
+void
+utils::dump_stacktrace(const fs::path& program,
+                       executor::executor_handle& executor_handle,
+                       const executor::exit_handle& exit_handle)
+{
+    const optional< executor::exec_handle > exec_handle = start_stacktrace(
+        program, executor_handle, exit_handle);
+    if (!exec_handle)
+        return;
+
+    const executor::exit_handle gdb_exit_handle =
+        executor_handle.wait(exec_handle.get());
+    finish_stacktrace(gdb_exit_handle);
+}
+
+
 /// Gathers a stacktrace of a program if it crashed.
 ///
 /// This is just a convenience function to allow appending the stacktrace to an
@@ -54,6 +54,13 @@ utils::optional< utils::fs::path > find_core(const utils::fs::path&,
 
 bool unlimit_core_size(void);
 
+utils::optional< utils::process::executor::exec_handle > start_stacktrace(
+    const utils::fs::path&,
+    utils::process::executor::executor_handle&,
+    const utils::process::executor::exit_handle&);
+
+void finish_stacktrace(const utils::process::executor::exit_handle&);
+
 void dump_stacktrace(const utils::fs::path&,
                      utils::process::executor::executor_handle&,
                      const utils::process::executor::exit_handle&);
@@ -537,6 +537,57 @@ ATF_TEST_CASE_BODY(dump_stacktrace__gdb_timeout)
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(start_stacktrace__background);
+ATF_TEST_CASE_BODY(start_stacktrace__background)
+{
+    utils::setenv("PATH", ".");
+    create_script("fake-gdb", "echo 'frame 1'; exit 0");
+    utils::builtin_gdb = "fake-gdb";
+
+    executor::executor_handle handle = executor::setup();
+    executor::exit_handle exit_handle = generate_core(this, "short", handle);
+
+    const optional< executor::exec_handle > exec_handle =
+        utils::start_stacktrace(fs::path("short"), handle, exit_handle);
+    ATF_REQUIRE(exec_handle);
+    ATF_REQUIRE(atf::utils::grep_file("exited with signal [0-9]* and dumped",
+                                      exit_handle.stderr_file().str()));
+
+    executor::exit_handle gdb_exit_handle = handle.wait(exec_handle.get());
+    ATF_REQUIRE(!atf::utils::grep_file("GDB exited successfully",
+                                       exit_handle.stderr_file().str()));
+    utils::finish_stacktrace(gdb_exit_handle);
+    ATF_REQUIRE(atf::utils::grep_file("^frame 1$",
+                                      exit_handle.stderr_file().str()));
+    ATF_REQUIRE(atf::utils::grep_file("GDB exited successfully",
+                                      exit_handle.stderr_file().str()));
+
+    gdb_exit_handle.cleanup();
+    exit_handle.cleanup();
+    handle.cleanup();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(start_stacktrace__cannot_find_gdb);
+ATF_TEST_CASE_BODY(start_stacktrace__cannot_find_gdb)
+{
+    utils::setenv("PATH", ".");
+    utils::builtin_gdb = "missing-gdb";
+
+    executor::executor_handle handle = executor::setup();
+    executor::exit_handle exit_handle = generate_core(this, "short", handle);
+
+    ATF_REQUIRE(!utils::start_stacktrace(fs::path("short"), handle,
+                                         exit_handle));
+    ATF_REQUIRE(atf::utils::grep_file("Cannot find GDB binary; builtin was "
+                                      "'missing-gdb'",
+                                      exit_handle.stderr_file().str()));
+
+    exit_handle.cleanup();
+    handle.cleanup();
+}
+
+
 ATF_TEST_CASE_WITHOUT_HEAD(dump_stacktrace_if_available__append);
 ATF_TEST_CASE_BODY(dump_stacktrace_if_available__append)
 {
@@ -623,6 +674,9 @@ ATF_INIT_TEST_CASES(tcs)
     ATF_ADD_TEST_CASE(tcs, dump_stacktrace__gdb_fail);
     ATF_ADD_TEST_CASE(tcs, dump_stacktrace__gdb_timeout);
 
+    ATF_ADD_TEST_CASE(tcs, start_stacktrace__background);
+    ATF_ADD_TEST_CASE(tcs, start_stacktrace__cannot_find_gdb);
+
     ATF_ADD_TEST_CASE(tcs, dump_stacktrace_if_available__append);
     ATF_ADD_TEST_CASE(tcs, dump_stacktrace_if_available__no_status);
     ATF_ADD_TEST_CASE(tcs, dump_stacktrace_if_available__no_coredump);
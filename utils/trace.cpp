@@ -0,0 +1,333 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "utils/trace.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "utils/format/macros.hpp"
+#include "utils/fs/path.hpp"
+#include "utils/optional.ipp"
+#include "utils/sanity.hpp"
+#include "utils/stream.hpp"
+
+namespace datetime = utils::datetime;
+namespace fs = utils::fs;
+namespace trace = utils::trace;
+
+using utils::none;
+using utils::optional;
+
+
+/// Track for the events of the main thread of control.
+const int trace::main_track = 0;
+
+
+namespace {
+
+
+/// State of an active trace.
+struct trace_state {
+    /// Path to the output file.
+    fs::path path;
+
+    /// Stream to the output file, opened when the trace started.
+    std::auto_ptr< std::ostream > output;
+
+    /// Time at which the trace started; all event times are relative to this.
+    datetime::timestamp origin;
+
+    /// Events recorded so far, already serialized and separated by commas.
+    std::ostringstream events;
+
+    /// Whether any event has been recorded yet.
+    bool empty;
+
+    /// Constructor.
+    ///
+    /// \param path_ Path to the output file.
+    /// \param output_ Stream to the output file.
+    trace_state(const fs::path& path_, std::auto_ptr< std::ostream > output_) :
+        path(path_), output(output_), origin(datetime::timestamp::now()),
+        empty(true)
+    {
+    }
+};
+
+
+/// The active trace, if any.
+///
+/// This is a raw pointer because the trace must be explicitly finished to
+/// produce any output; abandoning it at program exit is harmless.
+static trace_state* active = NULL;
+
+
+/// Escapes a string to be embedded within a JSON string literal.
+///
+/// \param in The string to escape.
+///
+/// \return The escaped string, without the surrounding quotes.
+static std::string
+json_escape(const std::string& in)
+{
+    std::string out;
+    out.reserve(in.length());
+    for (std::string::const_iterator iter = in.begin(); iter != in.end();
+         ++iter) {
+        const unsigned char ch = *iter;
+        if (ch == '"' || ch == '\\') {
+            out += '\\';
+            out += ch;
+        } else if (ch < 0x20) {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", ch);
+            out += buffer;
+        } else {
+            out += ch;
+        }
+    }
+    return out;
+}
+
+
+/// Computes the offset of a point in time within the active trace.
+///
+/// \param when The point in time to convert.
+///
+/// \return The number of microseconds since the trace started, or 0 if the
+/// point in time predates the trace.
+static int64_t
+offset(const datetime::timestamp& when)
+{
+    PRE(active != NULL);
+    const int64_t usec = when.to_microseconds() -
+        active->origin.to_microseconds();
+    return usec < 0 ? 0 : usec;
+}
+
+
+/// Appends a serialized event to the active trace.
+///
+/// \param event The JSON object describing the event.
+static void
+append(const std::string& event)
+{
+    PRE(active != NULL);
+    if (active->empty)
+        active->empty = false;
+    else
+        active->events << ",\n";
+    active->events << event;
+}
+
+
+}  // anonymous namespace
+
+
+/// Starts recording a trace.
+///
+/// The output file is created right away so that an invalid path is reported
+/// before any work happens, but nothing is written to it until finish() is
+/// called.
+///
+/// \param path The file into which to write the trace.
+///
+/// \throw std::runtime_error If the output file cannot be created.
+void
+trace::start(const fs::path& path)
+{
+    PRE_MSG(active == NULL, "Trace already started");
+    std::auto_ptr< std::ostream > output;
+    try {
+        output = utils::open_ostream(path);
+    } catch (const std::runtime_error& unused_error) {
+        throw std::runtime_error(F("Failed to create trace file %s") % path);
+    }
+    active = new trace_state(path, output);
+
+    append("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+           "\"args\":{\"name\":\"kyua\"}}");
+    name_track(main_track, "main");
+}
+
+
+/// Writes the recorded trace to its output file and stops recording.
+///
+/// \throw std::runtime_error If the trace cannot be written.
+void
+trace::finish(void)
+{
+    PRE_MSG(active != NULL, "Trace not started");
+    std::auto_ptr< trace_state > state(active);
+    active = NULL;
+
+    std::ostream& output = *state->output;
+    output << "[\n" << state->events.str() << "\n]\n";
+    output.flush();
+    if (!output)
+        throw std::runtime_error(F("Failed to write trace file %s") %
+                                 state->path);
+}
+
+
+/// Checks whether a trace is being recorded.
+///
+/// \return True if start() has been called and finish() has not.
+bool
+trace::enabled(void)
+{
+    return active != NULL;
+}
+
+
+/// Assigns a human-readable name to a track.
+///
+/// \param track The track to name.
+/// \param name The name to display for the track.
+void
+trace::name_track(const int track, const std::string& name)
+{
+    if (active == NULL)
+        return;
+    append(F("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%s,"
+             "\"args\":{\"name\":\"%s\"}}") % track % json_escape(name));
+}
+
+
+/// Records an activity that spanned a period of time.
+///
+/// \param name The name of the activity.
+/// \param track The track on which to display the activity.
+/// \param start_time The time at which the activity started.
+/// \param end_time The time at which the activity ended.
+/// \param detail Free-form detail about the activity; omitted if empty.
+void
+trace::complete(const std::string& name, const int track,
+                const datetime::timestamp& start_time,
+                const datetime::timestamp& end_time,
+                const std::string& detail)
+{
+    if (active == NULL)
+        return;
+    const int64_t start_usec = offset(start_time);
+    const int64_t end_usec = offset(end_time);
+    const int64_t duration = end_usec < start_usec ? 0 : end_usec - start_usec;
+    const std::string args = detail.empty() ? std::string() :
+        std::string(F(",\"args\":{\"detail\":\"%s\"}") %
+                    json_escape(detail));
+    append(F("{\"name\":\"%s\",\"cat\":\"kyua\",\"ph\":\"X\",\"pid\":1,"
+             "\"tid\":%s,\"ts\":%s,\"dur\":%s%s}") % json_escape(name) %
+           track % start_usec % duration % args);
+}
+
+
+/// Records the value of a counter at a point in time.
+///
+/// \param name The name of the counter.
+/// \param when The time at which the counter took the value.
+/// \param value The value of the counter.
+void
+trace::counter(const std::string& name, const datetime::timestamp& when,
+               const long value)
+{
+    if (active == NULL)
+        return;
+    append(F("{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"ts\":%s,"
+             "\"args\":{\"value\":%s}}") % json_escape(name) % offset(when) %
+           value);
+}
+
+
+/// Enters a scope to be recorded in the trace.
+///
+/// \param name The name of the activity represented by the scope.
+/// \param track The track on which to display the activity.
+/// \param detail Free-form detail about the activity; omitted if empty.
+trace::span::span(const std::string& name, const int track,
+                  const std::string& detail) :
+    _name(name), _track(track), _detail(detail)
+{
+    if (enabled())
+        _start = datetime::timestamp::now();
+}
+
+
+/// Leaves the scope and records it in the trace.
+trace::span::~span(void)
+{
+    if (_start && enabled())
+        complete(_name, _track, _start.get(), datetime::timestamp::now(),
+                 _detail);
+}
+
+
+/// Constructor.
+///
+/// \param first Identifier of the first track in the pool.  Must not overlap
+///     with the tracks of any other pool.
+/// \param label Prefix of the names of the tracks in the pool, which are
+///     suffixed by their one-based index within the pool.
+trace::track_pool::track_pool(const int first, const std::string& label) :
+    _first(first), _label(label)
+{
+}
+
+
+/// Borrows a track from the pool.
+///
+/// \return The identifier of the lowest track not currently in use.
+int
+trace::track_pool::acquire(void)
+{
+    std::vector< bool >::size_type index = 0;
+    while (index < _used.size() && _used[index])
+        ++index;
+    if (index == _used.size()) {
+        _used.push_back(false);
+        name_track(_first + index, F("%s %s") % _label % (index + 1));
+    }
+    _used[index] = true;
+    return _first + index;
+}
+
+
+/// Returns a track to the pool.
+///
+/// \param track The identifier of the track, as returned by acquire().
+void
+trace::track_pool::release(const int track)
+{
+    PRE(track >= _first);
+    const std::vector< bool >::size_type index = track - _first;
+    PRE(index < _used.size() && _used[index]);
+    _used[index] = false;
+}
@@ -0,0 +1,117 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// \file utils/trace.hpp
+/// Recording of a timeline of events in the trace-event format.
+///
+/// The output file is a JSON array of events as understood by the Chrome
+/// tracing viewer (chrome://tracing) and by Perfetto.  Events are grouped in
+/// tracks, which these viewers render as separate rows, and are accumulated in
+/// memory until the trace is finished: this keeps the cost of recording an
+/// event low and ensures that subprocesses forked while the trace is active do
+/// not write partial events to the output file on exit.
+
+#if !defined(UTILS_TRACE_HPP)
+#define UTILS_TRACE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "utils/datetime.hpp"
+#include "utils/fs/path_fwd.hpp"
+#include "utils/noncopyable.hpp"
+#include "utils/optional.hpp"
+
+namespace utils {
+namespace trace {
+
+
+extern const int main_track;
+
+
+void start(const fs::path&);
+void finish(void);
+bool enabled(void);
+
+void name_track(const int, const std::string&);
+void complete(const std::string&, const int, const datetime::timestamp&,
+              const datetime::timestamp&, const std::string& = "");
+void counter(const std::string&, const datetime::timestamp&, const long);
+
+
+/// Records the lifetime of a scope as an event on a track.
+///
+/// Nothing is recorded if tracing is not enabled at construction time.
+class span : noncopyable {
+    /// Name of the event.
+    const std::string _name;
+
+    /// Track on which to record the event.
+    const int _track;
+
+    /// Free-form detail to attach to the event.
+    const std::string _detail;
+
+    /// Time at which the scope was entered, if tracing was enabled.
+    optional< datetime::timestamp > _start;
+
+public:
+    span(const std::string&, const int, const std::string& = "");
+    ~span(void);
+};
+
+
+/// Allocator of track identifiers for concurrent activities.
+///
+/// Each activity (e.g. a running test) borrows a track for its duration so that
+/// activities that overlap in time are rendered in different rows.  Released
+/// tracks are reused lowest-first, so the number of rows in the timeline
+/// matches the maximum concurrency reached.
+class track_pool : noncopyable {
+    /// Identifier of the first track in the pool.
+    const int _first;
+
+    /// Label used to name the tracks in the pool.
+    const std::string _label;
+
+    /// Whether each track in the pool is currently in use.
+    std::vector< bool > _used;
+
+public:
+    track_pool(const int, const std::string&);
+
+    int acquire(void);
+    void release(const int);
+};
+
+
+}  // namespace trace
+}  // namespace utils
+
+#endif  // !defined(UTILS_TRACE_HPP)
@@ -0,0 +1,205 @@
+// Copyright 2026 The Kyua Authors.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// * Redistributions of source code must retain the above copyright
+//   notice, this list of conditions and the following disclaimer.
+// * Redistributions in binary form must reproduce the above copyright
+//   notice, this list of conditions and the following disclaimer in the
+//   documentation and/or other materials provided with the distribution.
+// * Neither the name of Google Inc. nor the names of its contributors
+//   may be used to endorse or promote products derived from this software
+//   without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "utils/trace.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include <atf-c++.hpp>
+
+#include "utils/datetime.hpp"
+#include "utils/fs/path.hpp"
+#include "utils/stream.hpp"
+
+namespace datetime = utils::datetime;
+namespace fs = utils::fs;
+namespace trace = utils::trace;
+
+
+namespace {
+
+
+/// Gets a timestamp relative to a fixed origin.
+///
+/// \param usec Number of microseconds past the origin.
+///
+/// \return A new timestamp.
+static datetime::timestamp
+at(const int64_t usec)
+{
+    return datetime::timestamp::from_microseconds(1000000000000LL + usec);
+}
+
+
+/// Starts a trace whose origin is the time returned by at(0).
+///
+/// \param path The file into which to write the trace.
+static void
+start_at_origin(const fs::path& path)
+{
+    datetime::set_mock_now(at(0));
+    trace::start(path);
+}
+
+
+}  // anonymous namespace
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(disabled);
+ATF_TEST_CASE_BODY(disabled)
+{
+    ATF_REQUIRE(!trace::enabled());
+    trace::name_track(1, "foo");
+    trace::complete("foo", 1, at(0), at(10));
+    trace::counter("foo", at(0), 5);
+    {
+        trace::span span("foo", trace::main_track);
+    }
+    ATF_REQUIRE(!trace::enabled());
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(start__fail);
+ATF_TEST_CASE_BODY(start__fail)
+{
+    ATF_REQUIRE_THROW_RE(std::runtime_error, "Failed to create trace file",
+                         trace::start(fs::path("missing/trace.json")));
+    ATF_REQUIRE(!trace::enabled());
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(empty);
+ATF_TEST_CASE_BODY(empty)
+{
+    start_at_origin(fs::path("trace.json"));
+    ATF_REQUIRE(trace::enabled());
+    trace::finish();
+    ATF_REQUIRE(!trace::enabled());
+
+    ATF_REQUIRE_EQ(
+        "[\n"
+        "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+        "\"args\":{\"name\":\"kyua\"}},\n"
+        "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+        "\"args\":{\"name\":\"main\"}}\n"
+        "]\n",
+        utils::read_file(fs::path("trace.json")));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(events);
+ATF_TEST_CASE_BODY(events)
+{
+    start_at_origin(fs::path("trace.json"));
+    trace::complete("first", 3, at(100), at(350));
+    trace::complete("second", 4, at(200), at(250), "a:b");
+    trace::counter("in_flight", at(300), 2);
+    trace::finish();
+
+    const std::string contents = utils::read_file(fs::path("trace.json"));
+    ATF_REQUIRE_MATCH(
+        "\\{\"name\":\"first\",\"cat\":\"kyua\",\"ph\":\"X\",\"pid\":1,"
+        "\"tid\":3,\"ts\":100,\"dur\":250\\},", contents);
+    ATF_REQUIRE_MATCH(
+        "\\{\"name\":\"second\",\"cat\":\"kyua\",\"ph\":\"X\",\"pid\":1,"
+        "\"tid\":4,\"ts\":200,\"dur\":50,\"args\":\\{\"detail\":\"a:b\"\\}\\},",
+        contents);
+    ATF_REQUIRE_MATCH(
+        "\\{\"name\":\"in_flight\",\"ph\":\"C\",\"pid\":1,\"ts\":300,"
+        "\"args\":\\{\"value\":2\\}\\}\n\\]\n$", contents);
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(events__escape);
+ATF_TEST_CASE_BODY(events__escape)
+{
+    start_at_origin(fs::path("trace.json"));
+    trace::complete("a\"b", 1, at(0), at(1), "c\\d\ne");
+    trace::finish();
+
+    const std::string contents = utils::read_file(fs::path("trace.json"));
+    ATF_REQUIRE(contents.find("\"name\":\"a\\\"b\"") != std::string::npos);
+    ATF_REQUIRE(contents.find("\"detail\":\"c\\\\d\\u000ae\"") !=
+                std::string::npos);
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(span);
+ATF_TEST_CASE_BODY(span)
+{
+    start_at_origin(fs::path("trace.json"));
+    {
+        datetime::set_mock_now(at(1000));
+        trace::span span("scope", 7, "detail");
+        datetime::set_mock_now(at(1500));
+    }
+    trace::finish();
+
+    ATF_REQUIRE_MATCH(
+        "\\{\"name\":\"scope\",\"cat\":\"kyua\",\"ph\":\"X\",\"pid\":1,"
+        "\"tid\":7,\"ts\":1000,\"dur\":500,"
+        "\"args\":\\{\"detail\":\"detail\"\\}\\}",
+        utils::read_file(fs::path("trace.json")));
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(track_pool);
+ATF_TEST_CASE_BODY(track_pool)
+{
+    start_at_origin(fs::path("trace.json"));
+    trace::track_pool pool(10, "slot");
+    ATF_REQUIRE_EQ(10, pool.acquire());
+    ATF_REQUIRE_EQ(11, pool.acquire());
+    ATF_REQUIRE_EQ(12, pool.acquire());
+    pool.release(11);
+    pool.release(10);
+    ATF_REQUIRE_EQ(10, pool.acquire());
+    ATF_REQUIRE_EQ(11, pool.acquire());
+    ATF_REQUIRE_EQ(13, pool.acquire());
+    trace::finish();
+
+    const std::string contents = utils::read_file(fs::path("trace.json"));
+    ATF_REQUIRE_MATCH("\"tid\":10,\"args\":\\{\"name\":\"slot 1\"\\}",
+                      contents);
+    ATF_REQUIRE_MATCH("\"tid\":13,\"args\":\\{\"name\":\"slot 4\"\\}",
+                      contents);
+    ATF_REQUIRE(contents.find("slot 5") == std::string::npos);
+}
+
+
+ATF_INIT_TEST_CASES(tcs)
+{
+    ATF_ADD_TEST_CASE(tcs, disabled);
+    ATF_ADD_TEST_CASE(tcs, start__fail);
+    ATF_ADD_TEST_CASE(tcs, empty);
+    ATF_ADD_TEST_CASE(tcs, events);
+    ATF_ADD_TEST_CASE(tcs, events__escape);
+    ATF_ADD_TEST_CASE(tcs, span);
+    ATF_ADD_TEST_CASE(tcs, track_pool);
+}